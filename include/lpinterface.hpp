@@ -1,11 +1,25 @@
 #ifndef LPINTERFACE_H
 #define LPINTERFACE_H
 
+#include "lpinterface/change_log.hpp"
 #include "lpinterface/common.hpp"
+#include "lpinterface/concurrent_builder.hpp"
+#include "lpinterface/compact_batch.hpp"
+#include "lpinterface/constraint_batch.hpp"
+#include "lpinterface/constraint_cursor.hpp"
 #include "lpinterface/data_objects.hpp"
+#include "lpinterface/dualize.hpp"
+#include "lpinterface/entity_id.hpp"
 #include "lpinterface/errors.hpp"
+#include "lpinterface/linexpr.hpp"
 #include "lpinterface/lp.hpp"
 #include "lpinterface/lpinterface.hpp"
+#include "lpinterface/model_diff.hpp"
+#include "lpinterface/model_statistics.hpp"
 #include "lpinterface/parameter_type.hpp"
+#include "lpinterface/presolve.hpp"
+#include "lpinterface/scaling.hpp"
+#include "lpinterface/staged_solver.hpp"
+#include "lpinterface/triplet_batch.hpp"
 
 #endif  // LPINTERFACE_H
\ No newline at end of file
@@ -0,0 +1,302 @@
+#ifndef LPINTERFACE_AUTO_SOLVER_H
+#define LPINTERFACE_AUTO_SOLVER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+
+#include "common.hpp"
+#include "data_objects.hpp"
+#include "detail/parallel.hpp"
+#include "detail/parameter_log.hpp"
+#include "dualize.hpp"
+#include "errors.hpp"
+#include "lp.hpp"
+#include "lpinterface.hpp"
+#include "model_statistics.hpp"
+#include "native/lphandle_native.hpp"
+#include "native/lpinterface_interior_point.hpp"
+#include "native/lpinterface_pdhg.hpp"
+#include "native/lpinterface_simplex.hpp"
+#include "parameter_type.hpp"
+#include "scaling.hpp"
+
+namespace lpint {
+
+/// Backends implemented in this library that AutoSolver chooses from.
+enum class NativeBackend : char {
+  //! NativeSimplexSolver.
+  Simplex,
+  //! NativeInteriorPointSolver, with crossover.
+  InteriorPoint,
+  //! NativePdhgSolver.
+  FirstOrder,
+};
+
+/// Decisions made by a SelectionPolicy before a solve.
+struct SolverChoice {
+  NativeBackend backend = NativeBackend::Simplex;
+  //! Whether to solve the explicit dual LP instead of the primal one.
+  bool dualize = false;
+  //! Whether to scale the model, see ScaledSolver.
+  bool scale = false;
+  //! Number of threads for the backend.
+  std::size_t threads = 1;
+};
+
+/// Statistics of the last solve of an AutoSolver.
+struct SolveStatistics {
+  ModelStatistics model;
+  SolverChoice choice;
+  Status status = Status::NoInformation;
+  //! Seconds spent on analyzing the model and choosing the backend.
+  double analysis_seconds = 0.0;
+  //! Seconds spent on building the backend model and solving it.
+  double solve_seconds = 0.0;
+};
+
+/**
+ * @brief Rules for choosing a backend and its settings from the
+ * statistics of a model.
+ * The simplex method is fastest on small models and on models that are
+ * mostly inequalities. The interior point method wins on models that are
+ * mostly equalities, where the dual simplex needs many iterations to
+ * become primal feasible, and on large models, where its factorizations
+ * use all threads. The first-order method is only chosen for models too
+ * large to factorize. The explicit dual is solved when there are many
+ * more rows than columns, unless ranged rows would double the size of
+ * the dual, and the model is scaled when its coefficients span many
+ * orders of magnitude. The thresholds are public, to be tuned per
+ * application.
+ */
+struct SelectionPolicy {
+  //! Nonzeros above which the interior point method is chosen for models
+  //! that are mostly equalities.
+  std::size_t equality_interior_point_nonzeros = 5000;
+  //! Fraction of equality rows above which a model is mostly equalities.
+  double interior_point_equality_fraction = 0.5;
+  //! Nonzeros above which the interior point method is always chosen.
+  std::size_t interior_point_nonzeros = 1000000;
+  //! Nonzeros above which the first-order method is chosen.
+  std::size_t first_order_nonzeros = 20000000;
+  //! Smallest ratio of rows to columns at which the dual is solved.
+  double dualize_ratio = 2.0;
+  //! Largest fraction of ranged rows at which the dual is solved.
+  double dualize_ranged_fraction = 0.5;
+  //! Smallest coefficient range at which the model is scaled.
+  double scaling_range = 1e4;
+  //! Smallest number of nonzeros worth an extra thread.
+  std::size_t nonzeros_per_thread = 50000;
+
+  /**
+   * @brief Choose a backend and its settings for a model.
+   *
+   * @param model Statistics of the model.
+   * @param max_threads Largest number of threads to use, or zero for the
+   * number of hardware threads.
+   */
+  SolverChoice choose(const ModelStatistics& model,
+                      const std::size_t max_threads = 0) const {
+    SolverChoice choice;
+    const auto nonzero = model.num_nonzero;
+    if (nonzero >= first_order_nonzeros) {
+      choice.backend = NativeBackend::FirstOrder;
+    } else if (nonzero >= interior_point_nonzeros ||
+               (nonzero >= equality_interior_point_nonzeros &&
+                model.equality_fraction >=
+                    interior_point_equality_fraction)) {
+      choice.backend = NativeBackend::InteriorPoint;
+    }
+
+    // the first-order method gains nothing from the dual, and does its
+    // own scaling
+    if (choice.backend != NativeBackend::FirstOrder) {
+      choice.dualize =
+          model.num_columns > 0 &&
+          static_cast<double>(model.num_rows) >=
+              dualize_ratio * static_cast<double>(model.num_columns) &&
+          model.ranged_fraction <= dualize_ranged_fraction;
+      choice.scale = model.coefficient_range() >= scaling_range;
+    }
+
+    // the simplex method is sequential
+    if (choice.backend != NativeBackend::Simplex) {
+      choice.threads = detail::num_threads_for(nonzero, nonzeros_per_thread);
+      if (max_threads > 0) {
+        choice.threads = std::min(choice.threads, max_threads);
+      }
+    }
+    return choice;
+  }
+};
+
+namespace detail {
+
+//! NativeInteriorPointSolver that always finishes with crossover.
+class CrossoverInteriorPointSolver : public NativeInteriorPointSolver {
+ public:
+  CrossoverInteriorPointSolver()
+      : CrossoverInteriorPointSolver(OptimizationType::Maximize) {}
+
+  explicit CrossoverInteriorPointSolver(const OptimizationType sense)
+      : NativeInteriorPointSolver(sense, true) {}
+};
+
+}  // namespace detail
+
+/**
+ * @brief Solver which picks a native backend for every model.
+ * Every solve() analyzes the model with analyze_model(), lets its
+ * SelectionPolicy choose the backend, formulation, scaling and thread
+ * count, and loads the model or its dual into a fresh backend, so that
+ * get_solution() always refers to the model in linear_program(). The
+ * statistics and decisions of the last solve are kept in statistics():
+ *
+ * ~~~cpp
+ * AutoSolver solver(OptimizationType::Minimize);
+ * build_model(solver.linear_program());
+ * solver.solve();
+ * const auto backend = solver.statistics().choice.backend;
+ * ~~~
+ *
+ * Param::Threads sets the largest number of threads the policy may
+ * choose; the other parameters are forwarded to every backend that
+ * supports them.
+ */
+class AutoSolver : public LinearProgramSolver {
+ public:
+  AutoSolver() : AutoSolver(OptimizationType::Maximize) {}
+
+  explicit AutoSolver(const OptimizationType sense,
+                      const SelectionPolicy& policy = SelectionPolicy())
+      : lp_(sense), policy_(policy) {}
+
+  const ILinearProgramHandle& linear_program() const override { return lp_; }
+
+  ILinearProgramHandle& linear_program() override { return lp_; }
+
+  bool parameter_supported(const Param param) const override {
+    return param == Param::Threads || param == Param::Verbosity ||
+           param == Param::IterationLimit || param == Param::TimeLimit;
+  }
+
+  void set_parameter(const Param param, const int value) override {
+    if (!parameter_supported(param)) throw UnsupportedParameterException();
+    if (value < 0) throw FailedToSetParameterException();
+    if (param == Param::Threads) {
+      max_threads_ = static_cast<std::size_t>(value);
+    } else {
+      params_.record(param, value);
+    }
+  }
+
+  void set_parameter(const Param param, const double value) override {
+    if (!parameter_supported(param)) throw UnsupportedParameterException();
+    if (value < 0.0) throw FailedToSetParameterException();
+    if (param == Param::Threads) {
+      max_threads_ = static_cast<std::size_t>(value);
+    } else {
+      params_.record(param, value);
+    }
+  }
+
+  Status solve() override {
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    statistics_ = SolveStatistics();
+    statistics_.model = analyze_model(lp_, max_threads_);
+    statistics_.choice = policy_.choose(statistics_.model, max_threads_);
+    const auto& choice = statistics_.choice;
+    const auto analyzed = Clock::now();
+
+    if (choice.dualize) {
+      Dualizer dualizer(lp_);
+      create_backend(OptimizationType::Maximize);
+      dualizer.load_dual(backend_->linear_program());
+      status_ = Dualizer::primal_status(backend_->solve());
+      if (status_ == Status::Optimal) {
+        solution_ = dualizer.map_solution(backend_->get_solution());
+      }
+    } else {
+      create_backend(lp_.optimization_type());
+      detail::copy_model(lp_, backend_->linear_program());
+      status_ = backend_->solve();
+      if (status_ == Status::Optimal) {
+        solution_ = backend_->get_solution();
+      }
+    }
+
+    const auto solved = Clock::now();
+    statistics_.status = status_;
+    statistics_.analysis_seconds =
+        std::chrono::duration<double>(analyzed - start).count();
+    statistics_.solve_seconds =
+        std::chrono::duration<double>(solved - analyzed).count();
+    return status_;
+  }
+
+  Status solution_status() const override { return status_; }
+
+  const Solution<double>& get_solution() const override {
+    if (status_ != Status::Optimal) {
+      throw ModelNotSolvedException();
+    }
+    return solution_;
+  }
+
+  //! Get the statistics and decisions of the last solve().
+  const SolveStatistics& statistics() const { return statistics_; }
+
+  //! Get the policy used to choose the backend.
+  SelectionPolicy& policy() { return policy_; }
+
+  //! Get the policy used to choose the backend.
+  const SelectionPolicy& policy() const { return policy_; }
+
+ private:
+  template <class Solver>
+  static LinearProgramSolver* make_solver(const OptimizationType sense,
+                                          const bool scale) {
+    if (scale) {
+      return new ScaledSolver<Solver>(sense);
+    }
+    return new Solver(sense);
+  }
+
+  void create_backend(const OptimizationType sense) {
+    const auto& choice = statistics_.choice;
+    switch (choice.backend) {
+      case NativeBackend::InteriorPoint:
+        backend_.reset(make_solver<detail::CrossoverInteriorPointSolver>(
+            sense, choice.scale));
+        break;
+      case NativeBackend::FirstOrder:
+        backend_.reset(make_solver<NativePdhgSolver>(sense, choice.scale));
+        break;
+      case NativeBackend::Simplex:
+      default:
+        backend_.reset(make_solver<NativeSimplexSolver>(sense, choice.scale));
+        break;
+    }
+    params_.replay_supported(*backend_);
+    if (backend_->parameter_supported(Param::Threads)) {
+      backend_->set_parameter(Param::Threads,
+                              static_cast<int>(choice.threads));
+    }
+  }
+
+  LinearProgramHandleNative lp_;
+  SelectionPolicy policy_;
+  std::unique_ptr<LinearProgramSolver> backend_;
+  detail::ParameterLog params_;
+  std::size_t max_threads_ = 0;
+
+  Status status_ = Status::NoInformation;
+  Solution<double> solution_;
+  SolveStatistics statistics_;
+};
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_AUTO_SOLVER_H
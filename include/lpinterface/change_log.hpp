@@ -0,0 +1,382 @@
+#ifndef LPINTERFACE_CHANGE_LOG_H
+#define LPINTERFACE_CHANGE_LOG_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "constraint_batch.hpp"
+#include "data_objects.hpp"
+#include "entity_id.hpp"
+#include "errors.hpp"
+#include "lp.hpp"
+
+namespace lpint {
+
+namespace detail {
+struct PendingConstraintTag {};
+struct PendingVariableTag {};
+}  // namespace detail
+
+//! Identifier of a constraint staged for addition in a ChangeLog.
+using PendingConstraintId = EntityId<detail::PendingConstraintTag>;
+
+//! Identifier of a variable staged for addition in a ChangeLog.
+using PendingVariableId = EntityId<detail::PendingVariableTag>;
+
+/**
+ * @brief Staging area for changes to a linear program.
+ * Changes are recorded instead of being sent to the backend, and are
+ * coalesced as they come in, so that apply() only sends the net
+ * difference:
+ *
+ * - removing a staged addition cancels the addition;
+ * - repeated bound or objective changes of an entity keep the last value;
+ * - changes to an entity that is removed afterwards are dropped;
+ * - changes to a staged addition are folded into the addition.
+ *
+ * Entities already in the linear program are referred to by their stable
+ * ids, and staged additions by the pending ids returned when staging them.
+ * Once applied, the ids the additions received are available through
+ * resolve(). Rows of staged constraints refer to variable positions in the
+ * model as it is after all staged changes have been applied.
+ */
+class ChangeLog {
+ public:
+  //! Return whether there are no staged changes.
+  bool empty() const {
+    return std::find(constraint_live_.begin(), constraint_live_.end(),
+                     true) == constraint_live_.end() &&
+           std::find(variable_live_.begin(), variable_live_.end(), true) ==
+               variable_live_.end() &&
+           removed_constraints_.empty() && removed_variables_.empty() &&
+           constraint_bounds_.empty() && variable_bounds_.empty() &&
+           objective_.empty();
+  }
+
+  //! Stage the addition of a constraint.
+  PendingConstraintId add_constraint(Constraint<double>&& constraint) {
+    added_constraints_.push_back(std::move(constraint));
+    constraint_live_.push_back(true);
+    return PendingConstraintId(first_pending_constraint_ +
+                               added_constraints_.size() - 1);
+  }
+
+  //! Stage the addition of a variable with the given objective coefficient.
+  PendingVariableId add_variable(const Variable& variable,
+                                 const double objective = 0.0) {
+    added_variables_.push_back(variable);
+    added_objective_.push_back(objective);
+    variable_live_.push_back(true);
+    return PendingVariableId(first_pending_variable_ +
+                             added_variables_.size() - 1);
+  }
+
+  //! Cancel the staged addition of a constraint.
+  void remove_constraint(const PendingConstraintId id) {
+    constraint_live_[pending_index(id)] = false;
+  }
+
+  //! Stage the removal of a constraint.
+  void remove_constraint(const ConstraintId id) {
+    constraint_bounds_.erase(id);
+    removed_constraints_.insert(id);
+  }
+
+  //! Cancel the staged addition of a variable.
+  void remove_variable(const PendingVariableId id) {
+    variable_live_[pending_index(id)] = false;
+  }
+
+  //! Stage the removal of a variable.
+  void remove_variable(const VariableId id) {
+    variable_bounds_.erase(id);
+    objective_.erase(id);
+    removed_variables_.insert(id);
+  }
+
+  //! Change the bounds of a staged constraint.
+  void set_constraint_bounds(const PendingConstraintId id, const double lower,
+                             const double upper) {
+    auto& constraint = added_constraints_[pending_index(id)];
+    constraint.lower_bound = lower;
+    constraint.upper_bound = upper;
+  }
+
+  //! Stage a change of the bounds of a constraint.
+  void set_constraint_bounds(const ConstraintId id, const double lower,
+                             const double upper) {
+    check_not_removed(removed_constraints_, id);
+    constraint_bounds_[id] = std::make_pair(lower, upper);
+  }
+
+  //! Change the bounds of a staged variable.
+  void set_variable_bounds(const PendingVariableId id, const double lower,
+                           const double upper) {
+    const auto i = pending_index(id);
+    added_variables_[i] = Variable(lower, upper);
+  }
+
+  //! Stage a change of the bounds of a variable.
+  void set_variable_bounds(const VariableId id, const double lower,
+                           const double upper) {
+    if (lower > upper) {
+      throw InvalidVariableBoundsException();
+    }
+    check_not_removed(removed_variables_, id);
+    variable_bounds_[id] = std::make_pair(lower, upper);
+  }
+
+  //! Change the objective coefficient of a staged variable.
+  void set_objective_coefficient(const PendingVariableId id,
+                                 const double value) {
+    added_objective_[pending_index(id)] = value;
+  }
+
+  //! Stage a change of the objective coefficient of a variable.
+  void set_objective_coefficient(const VariableId id, const double value) {
+    check_not_removed(removed_variables_, id);
+    objective_[id] = value;
+  }
+
+  /**
+   * @brief Apply all staged changes to a linear program, and clear them.
+   * Bounds are changed first, then removals are carried out from the last
+   * position to the first, after which all staged additions are added in
+   * one call per kind of entity, and all objective coefficients are set in
+   * one call. Staged ids and the rows of staged constraints are all
+   * checked before anything is changed: if this throws InvalidIdException,
+   * or InvalidMatrixEntryException because a row refers to a position past
+   * the variables the model will have, the linear program and the staged
+   * changes are left untouched.
+   *
+   * @param lp Linear program to apply the changes to.
+   */
+  void apply(ILinearProgramHandle& lp) {
+    for (const auto& id : removed_constraints_) {
+      lp.position(id);
+    }
+    for (const auto& id : removed_variables_) {
+      lp.position(id);
+    }
+    for (const auto& change : constraint_bounds_) {
+      lp.position(change.first);
+    }
+    for (const auto& change : variable_bounds_) {
+      lp.position(change.first);
+    }
+    for (const auto& change : objective_) {
+      lp.position(change.first);
+    }
+    const auto num_vars =
+        lp.num_vars() - removed_variables_.size() +
+        static_cast<std::size_t>(
+            std::count(variable_live_.begin(), variable_live_.end(), true));
+    ConstraintBatch<double> batch;
+    std::vector<std::size_t> constraint_ranks(added_constraints_.size(),
+                                              not_added());
+    for (std::size_t k = 0; k < added_constraints_.size(); k++) {
+      if (!constraint_live_[k]) {
+        continue;
+      }
+      constraint_ranks[k] = batch.num_rows();
+      const auto& constraint = added_constraints_[k];
+      batch.begin_row(constraint.lower_bound, constraint.upper_bound);
+      for (std::size_t e = 0; e < constraint.row.num_nonzero(); e++) {
+        const auto j = constraint.row.nonzero_indices()[e];
+        batch.push(j, constraint.row.values()[e]);
+        if (static_cast<std::size_t>(j) >= num_vars) {
+          throw InvalidMatrixEntryException();
+        }
+      }
+      batch.end_row();
+    }
+
+    for (const auto& change : constraint_bounds_) {
+      lp.set_constraint_bounds(lp.position(change.first), change.second.first,
+                               change.second.second);
+    }
+    for (const auto& change : variable_bounds_) {
+      lp.set_variable_bounds(lp.position(change.first), change.second.first,
+                             change.second.second);
+    }
+    remove_all(removed_constraints_, lp,
+               [&lp](const std::size_t i) { lp.remove_constraint(i); });
+    remove_all(removed_variables_, lp,
+               [&lp](const std::size_t i) { lp.remove_variable(i); });
+
+    std::vector<Variable> variables;
+    std::vector<double> objective_values;
+    std::vector<int> objective_indices;
+    for (const auto& change : objective_) {
+      objective_values.push_back(change.second);
+      objective_indices.push_back(static_cast<int>(lp.position(change.first)));
+    }
+    flushed_variable_ranks_.assign(added_variables_.size(), not_added());
+    for (std::size_t k = 0; k < added_variables_.size(); k++) {
+      if (!variable_live_[k]) {
+        continue;
+      }
+      flushed_variable_ranks_[k] = variables.size();
+      if (added_objective_[k] != 0.0) {
+        objective_values.push_back(added_objective_[k]);
+        objective_indices.push_back(
+            static_cast<int>(lp.num_vars() + variables.size()));
+      }
+      variables.push_back(added_variables_[k]);
+    }
+    flushed_variables_ =
+        variables.empty() ? VariableIdRange() : lp.add_variables(variables);
+
+    flushed_constraint_ranks_ = std::move(constraint_ranks);
+    flushed_constraints_ =
+        batch.empty() ? ConstraintIdRange() : lp.add_constraints(batch);
+
+    // a sparse objective would zero every coefficient it does not list, so
+    // the changes are merged into the full objective
+    if (!objective_values.empty()) {
+      auto objective = lp.cached_objective().values;
+      objective.resize(lp.num_vars(), 0.0);
+      for (std::size_t k = 0; k < objective_values.size(); k++) {
+        objective[static_cast<std::size_t>(objective_indices[k])] =
+            objective_values[k];
+      }
+      lp.set_objective(Objective<double>(std::move(objective)));
+    }
+
+    flushed_first_constraint_ = first_pending_constraint_;
+    flushed_first_variable_ = first_pending_variable_;
+    first_pending_constraint_ += added_constraints_.size();
+    first_pending_variable_ += added_variables_.size();
+    clear();
+  }
+
+  /**
+   * @brief Return the id a staged constraint received when the changes
+   * were last applied.
+   * Throws InvalidIdException if the constraint was not added by the last
+   * call to apply().
+   */
+  ConstraintId resolve(const PendingConstraintId id) const {
+    return flushed_constraints_[flushed_rank(
+        id.value(), flushed_first_constraint_, flushed_constraint_ranks_)];
+  }
+
+  /**
+   * @brief Return the id a staged variable received when the changes were
+   * last applied.
+   * Throws InvalidIdException if the variable was not added by the last
+   * call to apply().
+   */
+  VariableId resolve(const PendingVariableId id) const {
+    return flushed_variables_[flushed_rank(
+        id.value(), flushed_first_variable_, flushed_variable_ranks_)];
+  }
+
+  //! Drop all staged changes.
+  void clear() {
+    added_constraints_.clear();
+    constraint_live_.clear();
+    added_variables_.clear();
+    added_objective_.clear();
+    variable_live_.clear();
+    removed_constraints_.clear();
+    removed_variables_.clear();
+    constraint_bounds_.clear();
+    variable_bounds_.clear();
+    objective_.clear();
+  }
+
+ private:
+  // rank of a staged addition that was cancelled before apply()
+  static std::size_t not_added() {
+    return std::numeric_limits<std::size_t>::max();
+  }
+
+  std::size_t pending_index(const PendingConstraintId id) const {
+    return checked_pending_index(id.value(), first_pending_constraint_,
+                                 constraint_live_);
+  }
+
+  std::size_t pending_index(const PendingVariableId id) const {
+    return checked_pending_index(id.value(), first_pending_variable_,
+                                 variable_live_);
+  }
+
+  static std::size_t checked_pending_index(const std::uint64_t value,
+                                           const std::uint64_t first,
+                                           const std::vector<bool>& live) {
+    if (value < first || value - first >= live.size() ||
+        !live[static_cast<std::size_t>(value - first)]) {
+      throw InvalidIdException();
+    }
+    return static_cast<std::size_t>(value - first);
+  }
+
+  static std::size_t flushed_rank(const std::uint64_t value,
+                                  const std::uint64_t first,
+                                  const std::vector<std::size_t>& ranks) {
+    if (value < first || value - first >= ranks.size() ||
+        ranks[static_cast<std::size_t>(value - first)] == not_added()) {
+      throw InvalidIdException();
+    }
+    return ranks[static_cast<std::size_t>(value - first)];
+  }
+
+  template <class Id>
+  static void check_not_removed(const std::set<Id>& removed, const Id id) {
+    if (removed.count(id)) {
+      throw InvalidIdException();
+    }
+  }
+
+  // remove the given entities from the last position to the first, so that
+  // no removal shifts the position of an entity still to be removed
+  template <class Id, class Remove>
+  static void remove_all(const std::set<Id>& ids,
+                         const ILinearProgramHandle& lp, Remove remove) {
+    std::vector<std::size_t> positions;
+    positions.reserve(ids.size());
+    for (const auto& id : ids) {
+      positions.push_back(lp.position(id));
+    }
+    std::sort(positions.begin(), positions.end(), std::greater<std::size_t>());
+    for (const auto i : positions) {
+      remove(i);
+    }
+  }
+
+  // staged additions, indexed by pending id minus the first pending id
+  std::vector<Constraint<double>> added_constraints_;
+  std::vector<bool> constraint_live_;
+  std::vector<Variable> added_variables_;
+  std::vector<double> added_objective_;
+  std::vector<bool> variable_live_;
+  std::uint64_t first_pending_constraint_ = 0;
+  std::uint64_t first_pending_variable_ = 0;
+
+  std::set<ConstraintId> removed_constraints_;
+  std::set<VariableId> removed_variables_;
+  std::map<ConstraintId, std::pair<double, double>> constraint_bounds_;
+  std::map<VariableId, std::pair<double, double>> variable_bounds_;
+  std::map<VariableId, double> objective_;
+
+  // ids received by the additions of the last call to apply(); a staged
+  // addition of rank k received id flushed_*_[k]
+  ConstraintIdRange flushed_constraints_;
+  VariableIdRange flushed_variables_;
+  std::vector<std::size_t> flushed_constraint_ranks_;
+  std::vector<std::size_t> flushed_variable_ranks_;
+  std::uint64_t flushed_first_constraint_ = 0;
+  std::uint64_t flushed_first_variable_ = 0;
+};
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_CHANGE_LOG_H
@@ -0,0 +1,140 @@
+#ifndef LPINTERFACE_COMPACT_BATCH_H
+#define LPINTERFACE_COMPACT_BATCH_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "constraint_batch.hpp"
+#include "detail/util.hpp"
+#include "errors.hpp"
+#include "lp.hpp"
+
+namespace lpint {
+
+/**
+ * @brief Compact staging storage for constraint sets.
+ * Coefficients are stored as float and column indices as 16-bit
+ * unsigned integers, which roughly halves the memory taken by a staged
+ * model compared to ConstraintBatch<double>. This representation is
+ * only valid for models with fewer than 65536 columns whose data is
+ * exactly representable in single precision; use
+ * is_losslessly_convertible() to check this, and the checked
+ * begin_row_checked()/push_checked() members to fill such a batch
+ * from double precision data.
+ */
+using CompactConstraintBatch = ConstraintBatch<float, std::uint16_t>;
+
+namespace detail {
+
+template <class T, class U>
+bool exactly_representable(const U value) {
+  return value != value || (in_floating_range<T>(value) &&
+                            static_cast<U>(static_cast<T>(value)) == value);
+}
+
+template <class I, class J>
+bool index_representable(const J index) {
+  return !is_negative(index, std::is_signed<J>()) &&
+         static_cast<std::uintmax_t>(index) <=
+             static_cast<std::uintmax_t>(std::numeric_limits<I>::max());
+}
+
+}  // namespace detail
+
+/**
+ * @brief Check whether a batch can be stored as ConstraintBatch<T, I>
+ * without losing any information, i.e. whether all coefficients and
+ * bounds are exactly representable as a T and all column indices fit
+ * in an I.
+ *
+ * @tparam T Target value type.
+ * @tparam I Target index type.
+ * @param batch Batch to check.
+ */
+template <class T, class I, class U, class J>
+bool is_losslessly_convertible(const ConstraintBatch<U, J>& batch) {
+  const auto& values = batch.values();
+  const auto& indices = batch.indices();
+  const auto& lower = batch.lower_bounds();
+  const auto& upper = batch.upper_bounds();
+  return std::all_of(values.begin(), values.end(),
+                     detail::exactly_representable<T, U>) &&
+         std::all_of(lower.begin(), lower.end(),
+                     detail::exactly_representable<T, U>) &&
+         std::all_of(upper.begin(), upper.end(),
+                     detail::exactly_representable<T, U>) &&
+         std::all_of(indices.begin(), indices.end(),
+                     detail::index_representable<I, J>);
+}
+
+/**
+ * @brief Convert a batch to a different value and index type.
+ * Throws LossyConversionException or IndexOverflowException if
+ * the conversion would lose information.
+ *
+ * @tparam T Target value type.
+ * @tparam I Target index type.
+ * @param batch Batch to convert.
+ */
+template <class T, class I, class U, class J>
+ConstraintBatch<T, I> convert_batch(const ConstraintBatch<U, J>& batch) {
+  ConstraintBatch<T, I> converted;
+  converted.reserve(batch.num_rows(), batch.num_nonzero());
+  const auto& starts = batch.row_starts();
+  for (std::size_t i = 0; i < batch.num_rows(); i++) {
+    converted.begin_row_checked(batch.lower_bounds()[i],
+                                batch.upper_bounds()[i]);
+    for (auto k = starts[i]; k < starts[i + 1]; k++) {
+      converted.push_checked(batch.indices()[k], batch.values()[k]);
+    }
+    converted.end_row();
+  }
+  return converted;
+}
+
+/**
+ * @brief Load a staged batch of any value and index type into an LP,
+ * widening it to double precision on the fly.
+ * The batch is widened in chunks of at most max_chunk_nonzeros nonzeros
+ * (but at least one row), each of which is loaded with a single bulk
+ * add_constraints() call, so the double precision copy of the data never
+ * exceeds one chunk.
+ *
+ * @param lp Linear program to add the constraints to.
+ * @param batch Staged constraints.
+ * @param max_chunk_nonzeros Upper bound on the size of a widened chunk.
+ */
+template <class T, class I>
+void add_constraints_widened(ILinearProgramHandle& lp,
+                             const ConstraintBatch<T, I>& batch,
+                             const std::size_t max_chunk_nonzeros = 1 << 20) {
+  ConstraintBatch<double> chunk;
+  const auto& starts = batch.row_starts();
+  std::size_t i = 0;
+  while (i < batch.num_rows()) {
+    // find the last row that keeps the chunk within bounds
+    std::size_t end = i + 1;
+    while (end < batch.num_rows() &&
+           starts[end + 1] - starts[i] <= max_chunk_nonzeros) {
+      end++;
+    }
+    chunk.clear();
+    chunk.reserve(end - i, starts[end] - starts[i]);
+    for (; i < end; i++) {
+      chunk.begin_row(static_cast<double>(batch.lower_bounds()[i]),
+                      static_cast<double>(batch.upper_bounds()[i]));
+      for (auto k = starts[i]; k < starts[i + 1]; k++) {
+        chunk.push(detail::checked_narrow<int>(batch.indices()[k]),
+                   static_cast<double>(batch.values()[k]));
+      }
+      chunk.end_row();
+    }
+    lp.add_constraints(chunk);
+  }
+}
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_COMPACT_BATCH_H
@@ -0,0 +1,478 @@
+#ifndef LPINTERFACE_CONCURRENT_BUILDER_H
+#define LPINTERFACE_CONCURRENT_BUILDER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "constraint_batch.hpp"
+#include "data_objects.hpp"
+#include "errors.hpp"
+#include "lp.hpp"
+
+namespace lpint {
+
+/**
+ * @brief Rows and columns collected from all producers of a
+ * ConcurrentModelBuilder, in deterministic order.
+ */
+struct ModelBlock {
+  ConstraintBatch<double> constraints;
+  std::vector<Variable> variables;
+  //! Objective coefficients of the variables.
+  std::vector<double> objective;
+  //! Offsets of each row into local_indices and local_values, with one
+  //! element more than there are rows.
+  std::vector<std::size_t> local_starts = std::vector<std::size_t>(1, 0);
+  //! Entries of the rows that refer to variables of this block, by
+  //! position in variables.
+  std::vector<std::size_t> local_indices;
+  std::vector<double> local_values;
+};
+
+/**
+ * @brief Builder letting several threads construct one linear program.
+ * Every producer thread gets its own Producer, which fills a private
+ * block of rows and columns without any synchronization. Full blocks are
+ * handed to the consumer through a lock-free queue, and the consumer
+ * loads all published blocks into a linear program in one bulk call per
+ * kind of entity:
+ *
+ * ~~~cpp
+ * ConcurrentModelBuilder builder;
+ * std::vector<std::thread> threads;
+ * for (std::size_t t = 0; t < nthreads; t++) {
+ *   threads.emplace_back([&builder, t]() {
+ *     auto producer = builder.producer(t);
+ *     generate_rows(producer, t);
+ *   });  // the producer publishes its last block when destroyed
+ * }
+ * for (auto& thread : threads) {
+ *   thread.join();
+ * }
+ * builder.flush(lp);
+ * ~~~
+ *
+ * Blocks are loaded ordered by producer id, and in production order for
+ * each producer, so the resulting model does not depend on how the
+ * threads were scheduled, as long as flush() is called once all
+ * producers are done. Producer ids must therefore be unique: producer()
+ * throws DuplicateProducerIdException for the id of a producer that is
+ * still alive, or whose blocks have not been collected yet.
+ *
+ * Producer::push() takes variable positions in the linear program after
+ * the flush. Producer::push_local() takes the index returned by
+ * Producer::add_variable(), which counts the variables of that producer
+ * from zero, and flush() shifts it by the position of the first new
+ * variable. A row may only refer to local variables that are flushed
+ * along with it.
+ */
+class ConcurrentModelBuilder {
+  struct Block {
+    Block(const std::size_t producer_id, const std::uint64_t seq)
+        : producer(producer_id), sequence(seq) {}
+
+    std::size_t producer;
+    std::uint64_t sequence;
+    //! Local index of the first variable of the block.
+    std::size_t first_variable = 0;
+    ModelBlock data;
+    Block* next = nullptr;
+  };
+
+ public:
+  /**
+   * @brief Appends rows and columns on behalf of one thread.
+   * A producer must only be used by one thread at a time.
+   */
+  class Producer {
+   public:
+    Producer(Producer&& other)
+        : builder_(other.builder_), id_(other.id_),
+          num_variables_(other.num_variables_),
+          block_(std::move(other.block_)) {
+      other.builder_ = nullptr;
+    }
+    Producer(const Producer&) = delete;
+    Producer& operator=(const Producer&) = delete;
+    Producer& operator=(Producer&&) = delete;
+
+    //! Publish the remaining completed rows and the columns; a row that
+    //! is still open is dropped.
+    ~Producer() {
+      if (builder_) {
+        if (block_->data.constraints.row_open()) {
+          block_->data.constraints.discard_row();
+          auto& data = block_->data;
+          data.local_indices.resize(data.local_starts.back());
+          data.local_values.resize(data.local_starts.back());
+        }
+        publish();
+        builder_->release_id(id_);
+      }
+    }
+
+    //! Open a new row with the given bounds.
+    void begin_row(const double lower_bound, const double upper_bound) {
+      block_->data.constraints.begin_row(lower_bound, upper_bound);
+    }
+
+    //! Append a nonzero entry to the currently open row.
+    void push(const int index, const double value) {
+      block_->data.constraints.push(index, value);
+    }
+
+    /**
+     * @brief Append an entry for a variable of this producer to the
+     * currently open row. Duplicates are detected by flush().
+     * Throws InvalidMatrixEntryException if the variable has not been
+     * added yet.
+     *
+     * @param variable Index returned by add_variable().
+     * @param value Value of the nonzero entry.
+     */
+    void push_local(const std::size_t variable, const double value) {
+      if (!block_->data.constraints.row_open()) {
+        throw InvalidRowStateException();
+      }
+      if (variable >= num_variables_) {
+        throw InvalidMatrixEntryException();
+      }
+      block_->data.local_indices.push_back(variable);
+      block_->data.local_values.push_back(value);
+    }
+
+    //! Close the currently open row, publishing the block if it is full.
+    void end_row() {
+      block_->data.constraints.end_row();
+      block_->data.local_starts.push_back(block_->data.local_indices.size());
+      if (block_->data.constraints.num_rows() >= builder_->block_rows_) {
+        publish();
+      }
+    }
+
+    /**
+     * @brief Append a variable with the given objective coefficient.
+     * Returns the local index of the variable, for push_local().
+     */
+    std::size_t add_variable(const Variable& variable,
+                             const double objective = 0.0) {
+      block_->data.variables.push_back(variable);
+      block_->data.objective.push_back(objective);
+      return num_variables_++;
+    }
+
+    /**
+     * @brief Hand the rows and columns appended so far to the consumer.
+     * Throws InvalidRowStateException if a row is open.
+     */
+    void publish() {
+      if (block_->data.constraints.row_open()) {
+        throw InvalidRowStateException();
+      }
+      if (block_->data.constraints.empty() && block_->data.variables.empty()) {
+        return;
+      }
+      auto next = std::unique_ptr<Block>(new Block(id_, block_->sequence + 1));
+      next->first_variable = num_variables_;
+      builder_->push(block_.release());
+      block_ = std::move(next);
+    }
+
+   private:
+    friend class ConcurrentModelBuilder;
+
+    Producer(ConcurrentModelBuilder* builder, const std::size_t id)
+        : builder_(builder), id_(id), block_(new Block(id, 0)) {}
+
+    ConcurrentModelBuilder* builder_;
+    std::size_t id_;
+    std::size_t num_variables_ = 0;
+    std::unique_ptr<Block> block_;
+  };
+
+  /**
+   * @brief Construct a builder.
+   *
+   * @param block_rows Number of rows after which a producer publishes its
+   * block; larger blocks mean less contention on the queue.
+   */
+  explicit ConcurrentModelBuilder(const std::size_t block_rows = 4096)
+      : block_rows_(block_rows) {}
+
+  ConcurrentModelBuilder(const ConcurrentModelBuilder&) = delete;
+  ConcurrentModelBuilder& operator=(const ConcurrentModelBuilder&) = delete;
+
+  ~ConcurrentModelBuilder() {
+    auto* block = head_.exchange(nullptr);
+    while (block) {
+      auto* next = block->next;
+      delete block;
+      block = next;
+    }
+  }
+
+  /**
+   * @brief Create a producer.
+   * Producer ids determine the order in which the rows and columns of
+   * different producers end up in the linear program. Throws
+   * DuplicateProducerIdException if a producer with the same id is alive,
+   * or has published blocks that have not been collected yet.
+   */
+  Producer producer(const std::size_t id) {
+    {
+      std::lock_guard<std::mutex> lock(ids_mutex_);
+      if (!used_ids_.insert(id).second) {
+        throw DuplicateProducerIdException();
+      }
+      live_ids_.insert(id);
+    }
+    return Producer(this, id);
+  }
+
+  /**
+   * @brief Take all published blocks, ordered by producer id and then by
+   * production order, and merge them. This is the consumer side of the
+   * queue, and must only be called from one thread at a time.
+   * Local indices are translated to positions in the merged variables;
+   * throws InvalidMatrixEntryException if a row refers to a local variable
+   * that was collected before, in which case the blocks are kept.
+   */
+  ModelBlock collect() {
+    auto blocks = take();
+    ModelBlock merged;
+    if (!merge(blocks, merged)) {
+      give_back(blocks);
+      throw InvalidMatrixEntryException();
+    }
+    return merged;
+  }
+
+  /**
+   * @brief Load all published blocks into a linear program.
+   * The variables are added first, so rows may refer to them, and their
+   * objective coefficients are merged into the existing objective.
+   * All rows are built and checked before the linear program is changed:
+   * throws InvalidMatrixEntryException if a row refers to a variable
+   * twice, to a variable past the new ones, or to a local variable that
+   * was collected before, and IndexOverflowException if a shifted local
+   * index does not fit in an int. In that case neither the linear program
+   * nor the published blocks are changed.
+   *
+   * @param lp Linear program to add the rows and columns to.
+   */
+  void flush(ILinearProgramHandle& lp) {
+    auto blocks = take();
+    ModelBlock block;
+    if (!merge(blocks, block)) {
+      give_back(blocks);
+      throw InvalidMatrixEntryException();
+    }
+    const auto first = lp.num_vars();
+    const auto num_vars = first + block.variables.size();
+    const auto& indices = block.constraints.indices();
+    if (std::any_of(indices.begin(), indices.end(), [&](const int j) {
+          return static_cast<std::size_t>(j) >= num_vars;
+        })) {
+      give_back(blocks);
+      throw InvalidMatrixEntryException();
+    }
+    const bool has_local = !block.local_indices.empty();
+    if (has_local &&
+        num_vars > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+      give_back(blocks);
+      throw IndexOverflowException();
+    }
+    ConstraintBatch<double> rows;
+    if (has_local && !shift_local(block, first, rows)) {
+      give_back(blocks);
+      throw InvalidMatrixEntryException();
+    }
+
+    if (!block.variables.empty()) {
+      lp.add_variables(block.variables);
+    }
+    // a sparse objective would zero the coefficients of the existing
+    // variables, so the new ones are appended to the full objective
+    const auto has_objective =
+        std::any_of(block.objective.begin(), block.objective.end(),
+                    [](const double value) { return value != 0.0; });
+    if (has_objective) {
+      auto objective = lp.cached_objective().values;
+      objective.resize(first, 0.0);
+      objective.insert(objective.end(), block.objective.begin(),
+                       block.objective.end());
+      lp.set_objective(Objective<double>(std::move(objective)));
+    }
+    if (has_local) {
+      lp.add_constraints(rows);
+    } else if (!block.constraints.empty()) {
+      lp.add_constraints(block.constraints);
+    }
+  }
+
+ private:
+  using Blocks = std::vector<std::unique_ptr<Block>>;
+
+  // take all published blocks, ordered by producer id and then by
+  // production order, and make the ids of finished producers available
+  // again
+  Blocks take() {
+    // producers release their id only after publishing their last block,
+    // so every id released before the exchange has all its blocks taken
+    std::lock_guard<std::mutex> lock(ids_mutex_);
+    Blocks blocks;
+    auto* block = head_.exchange(nullptr, std::memory_order_acquire);
+    while (block) {
+      auto* next = block->next;
+      blocks.emplace_back(block);
+      block = next;
+    }
+    std::sort(blocks.begin(), blocks.end(),
+              [](const std::unique_ptr<Block>& left,
+                 const std::unique_ptr<Block>& right) {
+                return std::make_pair(left->producer, left->sequence) <
+                       std::make_pair(right->producer, right->sequence);
+              });
+    used_ids_ = live_ids_;
+    return blocks;
+  }
+
+  // publish taken blocks again, after a failed collect() or flush()
+  void give_back(Blocks& blocks) {
+    std::lock_guard<std::mutex> lock(ids_mutex_);
+    for (auto& block : blocks) {
+      used_ids_.insert(block->producer);
+      push(block.release());
+    }
+    blocks.clear();
+  }
+
+  void release_id(const std::size_t id) {
+    std::lock_guard<std::mutex> lock(ids_mutex_);
+    live_ids_.erase(id);
+  }
+
+  // merge sorted blocks; returns false if a row refers to a local
+  // variable of a block that is not among them
+  static bool merge(const Blocks& blocks, ModelBlock& merged) {
+    std::size_t nrows = 0;
+    std::size_t nnz = 0;
+    std::size_t nvars = 0;
+    std::size_t nlocal = 0;
+    for (const auto& b : blocks) {
+      nrows += b->data.constraints.num_rows();
+      nnz += b->data.constraints.num_nonzero();
+      nvars += b->data.variables.size();
+      nlocal += b->data.local_indices.size();
+    }
+    merged.constraints.reserve(nrows, nnz);
+    merged.variables.reserve(nvars);
+    merged.objective.reserve(nvars);
+    merged.local_starts.reserve(nrows + 1);
+    merged.local_indices.reserve(nlocal);
+    merged.local_values.reserve(nlocal);
+    // local index and merged position of the first collected variable of
+    // the current producer
+    std::size_t first_local = 0;
+    std::size_t first_position = 0;
+    for (std::size_t k = 0; k < blocks.size(); k++) {
+      const auto& b = blocks[k];
+      if (k == 0 || b->producer != blocks[k - 1]->producer) {
+        first_local = b->first_variable;
+        first_position = merged.variables.size();
+      }
+      const auto offset = merged.local_indices.size();
+      for (std::size_t i = 1; i < b->data.local_starts.size(); i++) {
+        merged.local_starts.push_back(offset + b->data.local_starts[i]);
+      }
+      for (const auto variable : b->data.local_indices) {
+        if (variable < first_local) {
+          return false;
+        }
+        merged.local_indices.push_back(first_position + variable -
+                                       first_local);
+      }
+      merged.local_values.insert(merged.local_values.end(),
+                                 b->data.local_values.begin(),
+                                 b->data.local_values.end());
+      merged.constraints.extend(b->data.constraints);
+      merged.variables.insert(merged.variables.end(),
+                              b->data.variables.begin(),
+                              b->data.variables.end());
+      merged.objective.insert(merged.objective.end(),
+                              b->data.objective.begin(),
+                              b->data.objective.end());
+    }
+    return true;
+  }
+
+  // build the rows of a merged block with the local entries shifted by
+  // first; returns false if a row refers to a variable twice
+  static bool shift_local(const ModelBlock& block, const std::size_t first,
+                          ConstraintBatch<double>& rows) {
+    const auto& constraints = block.constraints;
+    rows.reserve(constraints.num_rows(),
+                 constraints.num_nonzero() + block.local_indices.size());
+    std::vector<int> indices;
+    for (std::size_t i = 0; i < constraints.num_rows(); i++) {
+      const auto begin = constraints.row_starts()[i];
+      const auto end = constraints.row_starts()[i + 1];
+      indices.assign(constraints.indices().begin() +
+                         static_cast<std::ptrdiff_t>(begin),
+                     constraints.indices().begin() +
+                         static_cast<std::ptrdiff_t>(end));
+      for (auto k = block.local_starts[i]; k < block.local_starts[i + 1];
+           k++) {
+        indices.push_back(static_cast<int>(first + block.local_indices[k]));
+      }
+      std::sort(indices.begin(), indices.end());
+      if (std::adjacent_find(indices.begin(), indices.end()) !=
+          indices.end()) {
+        return false;
+      }
+      rows.begin_row(constraints.lower_bounds()[i],
+                     constraints.upper_bounds()[i]);
+      for (auto k = begin; k < end; k++) {
+        rows.push(constraints.indices()[k], constraints.values()[k]);
+      }
+      for (auto k = block.local_starts[i]; k < block.local_starts[i + 1];
+           k++) {
+        rows.push(static_cast<int>(first + block.local_indices[k]),
+                  block.local_values[k]);
+      }
+      rows.end_row();
+    }
+    return true;
+  }
+
+  // lock-free push onto an intrusive stack; the consumer takes the whole
+  // stack at once, so the ABA problem cannot occur
+  void push(Block* block) {
+    block->next = head_.load(std::memory_order_relaxed);
+    while (!head_.compare_exchange_weak(block->next, block,
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+    }
+  }
+
+  std::size_t block_rows_;
+  std::atomic<Block*> head_{nullptr};
+
+  std::mutex ids_mutex_;
+  // ids of the live producers, and of the producers whose blocks have
+  // not been collected yet
+  std::set<std::size_t> live_ids_;
+  std::set<std::size_t> used_ids_;
+};
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_CONCURRENT_BUILDER_H
@@ -0,0 +1,371 @@
+#ifndef LPINTERFACE_CONSTRAINT_BATCH_H
+#define LPINTERFACE_CONSTRAINT_BATCH_H
+
+#include <cstddef>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "data_objects.hpp"
+#include "detail/util.hpp"
+#include "errors.hpp"
+
+namespace lpint {
+
+template <typename T, typename I>
+class TripletBatch;
+
+/**
+ * @brief Builder for large sets of constraints sharing a single arena.
+ * Instead of allocating a Row<T> per constraint, all rows in a batch are
+ * stored back-to-back in one set of CSR arrays: the nonzero values and
+ * column indices of every row live in one monotonically growing buffer,
+ * and row i occupies the half-open range [row_starts()[i],
+ * row_starts()[i+1]) of that buffer. Rows are appended with
+ * begin_row(), push() and end_row():
+ *
+ * ~~~cpp
+ * ConstraintBatch<double> batch;
+ * batch.reserve(nrows, nnz);
+ * batch.begin_row(-LPINT_INFINITY, 4.0);
+ * batch.push(0, 1.0);
+ * batch.push(2, 3.0);
+ * batch.end_row();
+ * lp.add_constraints(batch);
+ * ~~~
+ *
+ * Since the storage does not depend on the number of rows, releasing a
+ * batch costs a constant number of deallocations.
+ *
+ * Row offsets are always 64-bit, so a single batch can hold more than
+ * 2^31 nonzeros in total; backends that are limited to 32-bit sizes
+ * throw IndexOverflowException when handed such a batch.
+ *
+ * @tparam T Type of the coefficients and bounds.
+ * @tparam I Type of the column indices.
+ */
+template <typename T, typename I = int>
+class ConstraintBatch {
+  static_assert(std::is_arithmetic<T>::value,
+                "ConstraintBatch<T> requires T to be arithmetic");
+
+ public:
+  using Index = typename MatrixEntry<T, I>::Index;
+  using SizeType = std::size_t;
+
+  ConstraintBatch() : row_starts_(1, 0) {}
+  ConstraintBatch(ConstraintBatch<T, I>&&) = default;
+  ConstraintBatch(const ConstraintBatch<T, I>&) = delete;
+  ConstraintBatch<T, I>& operator=(const ConstraintBatch<T, I>&) = delete;
+  ConstraintBatch<T, I>& operator=(ConstraintBatch<T, I>&&) = default;
+
+  /**
+   * @brief Reserve storage up front, so that appending rows never
+   * reallocates the arena.
+   *
+   * @param nrows Expected number of rows in the batch.
+   * @param nnz Expected total number of nonzeros in the batch.
+   */
+  void reserve(const SizeType nrows, const SizeType nnz) {
+    row_starts_.reserve(nrows + 1);
+    lower_bounds_.reserve(nrows);
+    upper_bounds_.reserve(nrows);
+    values_.reserve(nnz);
+    indices_.reserve(nnz);
+  }
+
+  /**
+   * @brief Open a new row with the given bounds.
+   * Throws InvalidRowStateException if a row is already open.
+   */
+  void begin_row(const T lower_bound, const T upper_bound) {
+    if (row_open_) {
+      throw InvalidRowStateException();
+    }
+    lower_bounds_.push_back(lower_bound);
+    upper_bounds_.push_back(upper_bound);
+    reset_open_row_positions();
+    row_open_ = true;
+  }
+
+  /**
+   * @brief Append a nonzero entry to the currently open row.
+   * Throws InvalidMatrixEntryException if the row already contains
+   * an entry at this index.
+   *
+   * @param index Column index of the nonzero entry.
+   * @param value Value of the nonzero entry.
+   */
+  void push(const Index index, const T value) {
+    if (position_in_open_row(index) != 0) {
+      throw InvalidMatrixEntryException();
+    }
+    append(index, value);
+  }
+
+  /**
+   * @brief Add a value to the entry at the given index in the currently
+   * open row, creating the entry if the row does not contain it yet.
+   * This merges duplicate terms in O(1) on average; terms that cancel out
+   * are kept as explicit zeros until drop_zeros() is called.
+   *
+   * @param index Column index of the entry.
+   * @param value Value to add to the entry.
+   */
+  void accumulate(const Index index, const T value) {
+    const auto position = position_in_open_row(index);
+    if (position != 0) {
+      values_[position - 1] += value;
+    } else {
+      append(index, value);
+    }
+  }
+
+  /**
+   * @brief Open a new row, converting the bounds to T.
+   * This is meant for filling batches with a narrower value type than
+   * the source data, such as ConstraintBatch<float>.
+   * Throws LossyConversionException if a bound is not exactly
+   * representable as a T.
+   */
+  template <class U>
+  void begin_row_checked(const U lower_bound, const U upper_bound) {
+    begin_row(detail::lossless_cast<T>(lower_bound),
+              detail::lossless_cast<T>(upper_bound));
+  }
+
+  /**
+   * @brief Append a nonzero entry to the currently open row, converting
+   * the index to Index and the value to T.
+   * Throws IndexOverflowException if the index does not fit in Index, and
+   * LossyConversionException if the value is not exactly representable
+   * as a T.
+   */
+  template <class J, class U>
+  void push_checked(const J index, const U value) {
+    push(detail::checked_narrow<Index>(index), detail::lossless_cast<T>(value));
+  }
+
+  /**
+   * @brief Remove the entries with value zero from the currently open
+   * row, keeping the order of the others.
+   */
+  void drop_zeros() {
+    if (!row_open_) {
+      throw InvalidRowStateException();
+    }
+    auto end = row_starts_.back();
+    for (auto k = end; k < values_.size(); k++) {
+      if (values_[k] != T(0)) {
+        values_[end] = values_[k];
+        indices_[end] = indices_[k];
+        end++;
+      }
+    }
+    if (end == values_.size()) {
+      return;
+    }
+    values_.resize(end);
+    indices_.resize(end);
+    reset_open_row_positions();
+  }
+
+  /**
+   * @brief Close the currently open row.
+   */
+  void end_row() {
+    if (!row_open_) {
+      throw InvalidRowStateException();
+    }
+    row_starts_.push_back(values_.size());
+    row_open_ = false;
+  }
+
+  /**
+   * @brief Drop the currently open row and its entries.
+   */
+  void discard_row() {
+    if (!row_open_) {
+      throw InvalidRowStateException();
+    }
+    values_.resize(row_starts_.back());
+    indices_.resize(row_starts_.back());
+    lower_bounds_.pop_back();
+    upper_bounds_.pop_back();
+    reset_open_row_positions();
+    row_open_ = false;
+  }
+
+  /**
+   * @brief Append all rows of another batch.
+   * Throws InvalidRowStateException if a row is open in either batch.
+   */
+  void extend(const ConstraintBatch<T, I>& other) {
+    if (row_open_ || other.row_open_) {
+      throw InvalidRowStateException();
+    }
+    const auto offset = values_.size();
+    values_.insert(values_.end(), other.values_.begin(), other.values_.end());
+    indices_.insert(indices_.end(), other.indices_.begin(),
+                    other.indices_.end());
+    lower_bounds_.insert(lower_bounds_.end(), other.lower_bounds_.begin(),
+                         other.lower_bounds_.end());
+    upper_bounds_.insert(upper_bounds_.end(), other.upper_bounds_.begin(),
+                         other.upper_bounds_.end());
+    for (SizeType i = 1; i < other.row_starts_.size(); i++) {
+      row_starts_.push_back(offset + other.row_starts_[i]);
+    }
+  }
+
+  //! Return the number of completed rows in the batch.
+  SizeType num_rows() const { return row_starts_.size() - 1; }
+
+  //! Return the total number of nonzero entries in completed rows.
+  SizeType num_nonzero() const { return row_starts_.back(); }
+
+  //! Return whether the batch contains no rows.
+  bool empty() const { return num_rows() == 0; }
+
+  //! Return whether a row has been opened but not yet closed.
+  bool row_open() const { return row_open_; }
+
+  //! Get the nonzero values of all rows, stored contiguously.
+  const std::vector<T>& values() const { return values_; }
+
+  //! Get the column indices of all rows, stored contiguously.
+  const std::vector<Index>& indices() const { return indices_; }
+
+  //! Get the offsets of each row into values() and indices(),
+  //! with num_rows() + 1 elements.
+  const std::vector<SizeType>& row_starts() const { return row_starts_; }
+
+  //! Get the lower bounds of all rows.
+  const std::vector<T>& lower_bounds() const { return lower_bounds_; }
+
+  //! Get the upper bounds of all rows.
+  const std::vector<T>& upper_bounds() const { return upper_bounds_; }
+
+  //! Return the number of nonzeros in row i.
+  SizeType row_size(const SizeType i) const {
+    return row_starts_[i + 1] - row_starts_[i];
+  }
+
+  /**
+   * @brief Copy row i out of the arena into a stand-alone Constraint<T, I>.
+   */
+  Constraint<T, I> constraint(const SizeType i) const {
+    using Diff = typename std::vector<T>::difference_type;
+    const auto begin = static_cast<Diff>(row_starts_[i]);
+    const auto end = static_cast<Diff>(row_starts_[i + 1]);
+    Row<T, I> row(
+        std::vector<T>(values_.begin() + begin, values_.begin() + end),
+        std::vector<Index>(indices_.begin() + begin, indices_.begin() + end));
+    return Constraint<T, I>(std::move(row), lower_bounds_[i],
+                            upper_bounds_[i]);
+  }
+
+  /**
+   * @brief Remove all rows from the batch, retaining the allocated storage
+   * so that the batch can be refilled without regrowth.
+   */
+  void clear() {
+    values_.clear();
+    indices_.clear();
+    row_starts_.assign(1, 0);
+    lower_bounds_.clear();
+    upper_bounds_.clear();
+    reset_open_row_positions();
+    row_open_ = false;
+  }
+
+  /**
+   * @brief Remove all rows from the batch and give the storage back.
+   */
+  void release() { *this = ConstraintBatch<T, I>(); }
+
+ private:
+  friend class TripletBatch<T, I>;
+
+  // adopt CSR arrays whose rows are known to be free of duplicates
+  ConstraintBatch(std::vector<T>&& values, std::vector<Index>&& indices,
+                  std::vector<SizeType>&& row_starts,
+                  std::vector<T>&& lower_bounds,
+                  std::vector<T>&& upper_bounds)
+      : values_(std::move(values)),
+        indices_(std::move(indices)),
+        row_starts_(std::move(row_starts)),
+        lower_bounds_(std::move(lower_bounds)),
+        upper_bounds_(std::move(upper_bounds)) {}
+
+  std::vector<T> values_;
+  std::vector<Index> indices_;
+  std::vector<SizeType> row_starts_;
+  std::vector<T> lower_bounds_;
+  std::vector<T> upper_bounds_;
+
+  // position (plus one) of every entry of the open row by column index,
+  // filled only once the row is too long to scan; its size depends on the
+  // length of the row rather than on the largest column index
+  std::unordered_map<Index, SizeType> open_row_positions_;
+
+  bool row_open_ = false;
+
+  // rows up to this length are searched for duplicates linearly
+  static constexpr SizeType max_scanned_row_size = 16;
+
+  // Returns the position (plus one) of index in the open row, or zero if
+  // the open row does not contain index.
+  SizeType position_in_open_row(const Index index) {
+    if (!row_open_) {
+      throw InvalidRowStateException();
+    }
+    if (detail::is_negative(index, std::is_signed<Index>())) {
+      throw InvalidMatrixEntryException();
+    }
+    const auto begin = row_starts_.back();
+    if (values_.size() - begin <= max_scanned_row_size) {
+      for (auto k = begin; k < values_.size(); k++) {
+        if (indices_[k] == index) {
+          return k + 1;
+        }
+      }
+      return 0;
+    }
+    if (open_row_positions_.empty()) {
+      open_row_positions_.reserve(2 * (values_.size() - begin));
+      for (auto k = begin; k < values_.size(); k++) {
+        open_row_positions_.emplace(indices_[k], k + 1);
+      }
+    }
+    const auto it = open_row_positions_.find(index);
+    return it != open_row_positions_.end() ? it->second : 0;
+  }
+
+  void append(const Index index, const T value) {
+    values_.push_back(value);
+    indices_.push_back(index);
+    if (!open_row_positions_.empty()) {
+      open_row_positions_.emplace(index, values_.size());
+    }
+  }
+
+  // Forget the entries of the previous open row. Clearing costs time in
+  // the number of buckets, so a table grown by a much longer row is
+  // dropped instead.
+  void reset_open_row_positions() {
+    if (open_row_positions_.empty()) {
+      return;
+    }
+    if (open_row_positions_.bucket_count() >
+        4 * open_row_positions_.size()) {
+      std::unordered_map<Index, SizeType>().swap(open_row_positions_);
+    } else {
+      open_row_positions_.clear();
+    }
+  }
+};
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_CONSTRAINT_BATCH_H
@@ -0,0 +1,116 @@
+#ifndef LPINTERFACE_CONSTRAINT_CURSOR_H
+#define LPINTERFACE_CONSTRAINT_CURSOR_H
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+
+#include "data_objects.hpp"
+#include "lp.hpp"
+
+namespace lpint {
+
+/**
+ * @brief Forward cursor over the constraints of a linear program.
+ * The cursor reads one constraint at a time from the backend into a
+ * single buffer which is reused for every row, so visiting all constraints
+ * of a model takes memory proportional to its longest row rather than to
+ * its number of nonzeros:
+ *
+ * ~~~cpp
+ * ConstraintCursor cursor(lp);
+ * while (cursor.next()) {
+ *   export_row(cursor.index(), cursor.current());
+ * }
+ * ~~~
+ *
+ * The cursor can also be used in a range-based for loop, in which case it
+ * can be iterated only once. The linear program must not be modified while
+ * a cursor is in use.
+ */
+class ConstraintCursor {
+ public:
+  //! Single-pass iterator adapting a cursor to range-based for loops.
+  class iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Constraint<double>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Constraint<double>*;
+    using reference = const Constraint<double>&;
+
+    explicit iterator(ConstraintCursor* cursor) : cursor_(cursor) {}
+
+    reference operator*() const { return cursor_->current(); }
+
+    pointer operator->() const { return &cursor_->current(); }
+
+    iterator& operator++() {
+      if (!cursor_->next()) {
+        cursor_ = nullptr;
+      }
+      return *this;
+    }
+
+    bool operator==(const iterator& other) const {
+      return cursor_ == other.cursor_;
+    }
+
+    bool operator!=(const iterator& other) const { return !(*this == other); }
+
+   private:
+    // nullptr once the cursor is exhausted
+    ConstraintCursor* cursor_;
+  };
+
+  //! Create a cursor over all constraints of lp.
+  explicit ConstraintCursor(const ILinearProgramHandle& lp)
+      : ConstraintCursor(lp, 0, lp.num_constraints()) {}
+
+  /**
+   * @brief Create a cursor over the constraints of lp with indices in
+   * [first, last).
+   * Throws std::out_of_range if the range is not contained in
+   * [0, lp.num_constraints()).
+   */
+  ConstraintCursor(const ILinearProgramHandle& lp, const std::size_t first,
+                   const std::size_t last)
+      : lp_(&lp), next_(first), last_(last) {
+    if (first > last || last > lp.num_constraints()) {
+      throw std::out_of_range("Out of range constraint range");
+    }
+  }
+
+  /**
+   * @brief Read the next constraint into the buffer.
+   *
+   * @return bool False if there are no constraints left.
+   */
+  bool next() {
+    if (next_ == last_) {
+      return false;
+    }
+    lp_->read_constraint(next_++, buffer_);
+    return true;
+  }
+
+  //! Get the constraint read by the last successful call to next().
+  const Constraint<double>& current() const { return buffer_; }
+
+  //! Get the index of the constraint read by the last call to next().
+  std::size_t index() const { return next_ - 1; }
+
+  iterator begin() { return next() ? iterator(this) : end(); }
+
+  iterator end() { return iterator(nullptr); }
+
+ private:
+  const ILinearProgramHandle* lp_;
+  std::size_t next_;
+  std::size_t last_;
+  Constraint<double> buffer_;
+};
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_CONSTRAINT_CURSOR_H
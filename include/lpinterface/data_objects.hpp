@@ -6,6 +6,7 @@
 #include <cstddef>
 #include <set>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "common.hpp"
@@ -14,7 +15,8 @@
 namespace lpint {
 
 // matrix entry is templated over T, with T restricted to
-// arithmetic types i.e. numbers
+// arithmetic types i.e. numbers, and over the index type I,
+// restricted to integral types
 /**
  * @brief Matrix entry type, for use in sparse matrix.
  * The matrix entry base class is specialized as Row and Column,
@@ -23,31 +25,38 @@ namespace lpint {
  * entries. Its operator[] is overloaded to provide
  * access as if it is a dense vector. Access using operator[]
  * is O(n) in time, with n the number of nonzero entries.
+ *
+ * @tparam T Type of the nonzero values.
+ * @tparam I Type of the nonzero indices. Defaults to int, which is
+ * what the solver backends accept; use a 64-bit type for
+ * structures with more than 2^31 entries.
  */
-template <typename T>
+template <typename T, typename I = int>
 class MatrixEntry {
   static_assert(std::is_arithmetic<T>::value,
                 "MatrixEntry<T> requires T to be arithmetic");
+  static_assert(std::is_integral<I>::value,
+                "MatrixEntry<T, I> requires I to be integral");
 
  private:
   using iterator = typename std::vector<T>::iterator;
   using const_iterator = typename std::vector<T>::const_iterator;
 
  public:
-  using Index = int;
+  using Index = I;
   using SizeType = std::size_t;
 
   using iterator_category = std::forward_iterator_tag;
   using value_type = T;
-  using difference_type = int;
+  using difference_type = std::ptrdiff_t;
   using pointer = value_type*;
   using reference = value_type&;
 
   MatrixEntry() = default;
-  MatrixEntry(MatrixEntry<T>&&) = default;
-  MatrixEntry(const MatrixEntry<T>&) = delete;
-  MatrixEntry<T>& operator=(const MatrixEntry<T>&) = delete;
-  MatrixEntry<T>& operator=(MatrixEntry<T>&&) = default;
+  MatrixEntry(MatrixEntry<T, I>&&) = default;
+  MatrixEntry(const MatrixEntry<T, I>&) = delete;
+  MatrixEntry<T, I>& operator=(const MatrixEntry<T, I>&) = delete;
+  MatrixEntry<T, I>& operator=(MatrixEntry<T, I>&&) = default;
 
   explicit MatrixEntry(const std::size_t size)
       : values_(size), nonzero_indices_(size) {}
@@ -141,8 +150,9 @@ class MatrixEntry {
 // TODO: fix this for the case that left and right are non-equal permutations
 // of each other, e.g. left == Entry {[1, 2] [0, 1]}, right == Entry {[2, 1],
 // [0, 1]}. This example currently incorrectly evaluates as equal.
-template <class T>
-bool operator==(const MatrixEntry<T>& left, const MatrixEntry<T>& right) {
+template <class T, class I>
+bool operator==(const MatrixEntry<T, I>& left,
+                const MatrixEntry<T, I>& right) {
   return std::is_permutation(left.nonzero_indices().begin(),
                              left.nonzero_indices().end(),
                              right.nonzero_indices().begin()) &&
@@ -150,32 +160,32 @@ bool operator==(const MatrixEntry<T>& left, const MatrixEntry<T>& right) {
                              right.values().begin());
 }
 
-template <typename T>
-class Column : public MatrixEntry<T> {
+template <typename T, typename I = int>
+class Column : public MatrixEntry<T, I> {
  public:
-  using Index = typename MatrixEntry<T>::Index;
-  using SizeType = typename MatrixEntry<T>::SizeType;
+  using Index = typename MatrixEntry<T, I>::Index;
+  using SizeType = typename MatrixEntry<T, I>::SizeType;
 
  public:
-  explicit Column(const std::size_t size) : MatrixEntry<T>(size) {}
+  explicit Column(const std::size_t size) : MatrixEntry<T, I>(size) {}
   Column() = default;
   Column(const std::vector<T>& values, const std::vector<Index>& indices)
-      : MatrixEntry<T>(values, indices) {}
-  explicit Column(MatrixEntry<T>&& m) : MatrixEntry<T>(std::move(m)) {}
+      : MatrixEntry<T, I>(values, indices) {}
+  explicit Column(MatrixEntry<T, I>&& m) : MatrixEntry<T, I>(std::move(m)) {}
 };
 
-template <typename T>
-class Row : public MatrixEntry<T> {
+template <typename T, typename I = int>
+class Row : public MatrixEntry<T, I> {
  public:
-  using Index = typename MatrixEntry<T>::Index;
-  using SizeType = typename MatrixEntry<T>::SizeType;
+  using Index = typename MatrixEntry<T, I>::Index;
+  using SizeType = typename MatrixEntry<T, I>::SizeType;
 
  public:
-  explicit Row(const std::size_t size) : MatrixEntry<T>(size) {}
+  explicit Row(const std::size_t size) : MatrixEntry<T, I>(size) {}
   Row() = default;
   Row(const std::vector<T>& values, const std::vector<Index>& indices)
-      : MatrixEntry<T>(values, indices) {}
-  explicit Row(MatrixEntry<T>&& m) : MatrixEntry<T>(std::move(m)) {}
+      : MatrixEntry<T, I>(values, indices) {}
+  explicit Row(MatrixEntry<T, I>&& m) : MatrixEntry<T, I>(std::move(m)) {}
 };
 
 /**
@@ -188,23 +198,23 @@ class Row : public MatrixEntry<T> {
  such as \f$\leq\f$. This struct represents one element of the right-hand side
  of such a constraint, together with the elementwise comparison.
  */
-template <typename T>
+template <typename T, typename I = int>
 struct Constraint {
   static_assert(std::is_arithmetic<T>::value,
                 "T must be arithmetic in order to be ordered");
   Constraint() : row(), lower_bound(), upper_bound() {}
-  Constraint(Row<T>&& r, T lb, T ub)
+  Constraint(Row<T, I>&& r, T lb, T ub)
       : row(std::move(r)), lower_bound(lb), upper_bound(ub) {}
 
-  Row<T> row;
+  Row<T, I> row;
   //! Lower bound of constraint equation.
   T lower_bound;
   //! Upper bound of constraint equation.
   T upper_bound;
 };
 
-template <class T>
-bool operator==(const Constraint<T>& left, const Constraint<T>& right) {
+template <class T, class I>
+bool operator==(const Constraint<T, I>& left, const Constraint<T, I>& right) {
   return fabs(left.upper_bound - right.upper_bound) < DOUBLE_TOLERANCE &&
          fabs(left.lower_bound - right.lower_bound) < DOUBLE_TOLERANCE &&
          left.row == right.row;
@@ -236,6 +246,32 @@ bool operator==(const Objective<T>& left, const Objective<T>& right) {
   return left.values == right.values;
 }
 
+/**
+ * @brief Sparse representation of the objective vector.
+ * Only the nonzero coefficients of \f$c\f$ are stored, together with
+ * the indices of the variables they belong to; all other coefficients
+ * are zero. For models with many variables but few nonzero costs this
+ * is much cheaper to store and to transfer to a solver backend than
+ * Objective<T>.
+ *
+ * @tparam T Type of elements in the objective vector.
+ * @tparam I Type of the variable indices.
+ */
+template <typename T, typename I = int>
+class SparseObjective : public MatrixEntry<T, I> {
+ public:
+  using Index = typename MatrixEntry<T, I>::Index;
+  using SizeType = typename MatrixEntry<T, I>::SizeType;
+
+ public:
+  SparseObjective() = default;
+  SparseObjective(const std::vector<T>& values,
+                  const std::vector<Index>& indices)
+      : MatrixEntry<T, I>(values, indices) {}
+  explicit SparseObjective(MatrixEntry<T, I>&& m)
+      : MatrixEntry<T, I>(std::move(m)) {}
+};
+
 /**
  * @brief Class representing a variable in the LP.
  * 
@@ -289,6 +325,129 @@ inline std::ostream& operator<<(std::ostream& os, const Variable& var) {
   return os;
 }
 
+/**
+ * @brief Block of variables stored as a structure of arrays.
+ * Where std::vector<Variable> interleaves the bounds of each variable,
+ * a VariableBlock keeps all lower bounds and all upper bounds in two
+ * contiguous arrays. These map directly onto the array-based calls of
+ * the solver backends, and can be moved into and out of a block without
+ * touching individual elements. The bounds are validated once, in a
+ * single pass over both arrays, when the block is constructed.
+ */
+class VariableBlock {
+ public:
+  VariableBlock() = default;
+
+  /**
+   * @brief Construct a block of n non-negative variables.
+   */
+  explicit VariableBlock(const std::size_t n)
+      : lower_(n, 0.0), upper_(n, LPINT_INFINITY) {}
+
+  /**
+   * @brief Construct a block from arrays of lower and upper bounds.
+   * Throws MismatchedDimensionsException if the arrays differ in length,
+   * and InvalidVariableBoundsException if any lower bound is larger than
+   * the corresponding upper bound.
+   *
+   * @param lower Lower bounds of the variables.
+   * @param upper Upper bounds of the variables.
+   */
+  VariableBlock(std::vector<double> lower, std::vector<double> upper)
+      : lower_(std::move(lower)), upper_(std::move(upper)) {
+    if (lower_.size() != upper_.size()) {
+      throw MismatchedDimensionsException();
+    }
+    check_bounds_valid();
+  }
+
+  /**
+   * @brief Construct a block from a vector of variables.
+   */
+  explicit VariableBlock(const std::vector<Variable>& vars)
+      : lower_(vars.size()), upper_(vars.size()) {
+    for (std::size_t i = 0; i < vars.size(); i++) {
+      lower_[i] = vars[i].lower();
+      upper_[i] = vars[i].upper();
+    }
+  }
+
+  //! Return the number of variables in the block.
+  std::size_t size() const { return lower_.size(); }
+
+  //! Return whether the block contains no variables.
+  bool empty() const { return lower_.empty(); }
+
+  //! Get the lower bounds of the variables.
+  const std::vector<double>& lower() const& { return lower_; }
+
+  //! Get the upper bounds of the variables.
+  const std::vector<double>& upper() const& { return upper_; }
+
+  /**
+   * @brief Move the lower bounds out of the block.
+   * Only the lower bounds are moved, so both arrays can be taken out:
+   *
+   * ~~~cpp
+   * auto lower = std::move(block).lower();
+   * auto upper = std::move(block).upper();
+   * ~~~
+   */
+  std::vector<double> lower() && { return std::move(lower_); }
+
+  //! Move the upper bounds out of the block, see lower() &&.
+  std::vector<double> upper() && { return std::move(upper_); }
+
+  //! Retrieve variable i of the block.
+  Variable variable(const std::size_t i) const {
+    return Variable(lower_[i], upper_[i]);
+  }
+
+  //! Convert the block to a vector of variables.
+  std::vector<Variable> variables() const {
+    std::vector<Variable> vars;
+    vars.reserve(size());
+    for (std::size_t i = 0; i < size(); i++) {
+      vars.emplace_back(lower_[i], upper_[i]);
+    }
+    return vars;
+  }
+
+  /**
+   * @brief Append a variable to the block.
+   * Throws InvalidVariableBoundsException if lb > ub.
+   */
+  void push_back(const double lb, const double ub) {
+    if (lb > ub) {
+      throw InvalidVariableBoundsException();
+    }
+    lower_.push_back(lb);
+    upper_.push_back(ub);
+  }
+
+ private:
+  std::vector<double> lower_;
+  std::vector<double> upper_;
+
+  void check_bounds_valid() const {
+    // accumulate without branching, so the compiler can vectorize the loop
+    const auto n = lower_.size();
+    const double* lower = lower_.data();
+    const double* upper = upper_.data();
+    unsigned invalid = 0;
+    for (std::size_t i = 0; i < n; i++) {
+      invalid |= static_cast<unsigned>(lower[i] > upper[i]);
+    }
+    if (invalid) {
+      throw InvalidVariableBoundsException();
+    }
+  }
+};
+
+inline bool operator==(const VariableBlock& left, const VariableBlock& right) {
+  return left.lower() == right.lower() && left.upper() == right.upper();
+}
+
 /**
  * @brief Struct representing the solution of a linear program.
  *
@@ -305,9 +464,9 @@ struct Solution {
 };
 
 // LCOV_EXCL_START
-template <typename T>
+template <typename T, typename I>
 inline std::ostream& operator<<(std::ostream& os,
-                                const Constraint<T>& constraint) {
+                                const Constraint<T, I>& constraint) {
   os << constraint.lower_bound << " <= " << constraint.row
      << " <= " << constraint.upper_bound;
   return os;
@@ -328,8 +487,9 @@ inline std::ostream& operator<<(std::ostream& os, const Objective<T>& obj) {
   return os;
 }
 
-template <typename T>
-inline std::ostream& operator<<(std::ostream& os, const MatrixEntry<T>& row) {
+template <typename T, typename I>
+inline std::ostream& operator<<(std::ostream& os,
+                                const MatrixEntry<T, I>& row) {
   if (row.num_nonzero() == 0) {
     os << "Entry {[] []}";
     return os;
@@ -0,0 +1,134 @@
+#ifndef LPINTERFACE_ID_MAP_H
+#define LPINTERFACE_ID_MAP_H
+
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "lpinterface/entity_id.hpp"
+#include "lpinterface/errors.hpp"
+
+namespace lpint {
+
+namespace detail {
+
+/**
+ * @brief Bidirectional map between stable ids and positions.
+ * Backend handles keep one of these for constraints and one for variables.
+ * Ids are handed out consecutively and never reused, so the id to position
+ * table is a plain vector indexed by id value, giving O(1) lookups in both
+ * directions. Erasing an entity shifts all later positions down by one,
+ * like the backends do, at a cost linear in the number of entities after
+ * the erased one.
+ */
+template <class Id>
+class IdMap {
+ public:
+  //! Append n entities and return their ids.
+  IdRange<Id> add(const std::size_t n) {
+    const Id first(static_cast<typename Id::ValueType>(positions_.size()));
+    positions_.reserve(positions_.size() + n);
+    ids_.reserve(ids_.size() + n);
+    for (std::size_t k = 0; k < n; k++) {
+      positions_.push_back(ids_.size());
+      ids_.push_back(first.value() + k);
+    }
+    return IdRange<Id>(first, n);
+  }
+
+  /**
+   * @brief Return the current position of the entity with the given id.
+   * Throws InvalidIdException if the entity was removed, or if the id was
+   * not handed out by this map.
+   */
+  std::size_t position(const Id id) const {
+    if (id.value() >= positions_.size() ||
+        positions_[static_cast<std::size_t>(id.value())] == removed) {
+      throw InvalidIdException();
+    }
+    return positions_[static_cast<std::size_t>(id.value())];
+  }
+
+  //! Return the id of the entity at the given position.
+  Id id(const std::size_t position) const {
+    if (position >= ids_.size()) {
+      throw std::out_of_range("Out of range access in IdMap");
+    }
+    return Id(ids_[position]);
+  }
+
+  //! Remove the entity at the given position.
+  void erase(const std::size_t position) {
+    positions_[static_cast<std::size_t>(id(position).value())] = removed;
+    using Diff = typename std::vector<typename Id::ValueType>::difference_type;
+    ids_.erase(ids_.begin() + static_cast<Diff>(position));
+    for (auto k = position; k < ids_.size(); k++) {
+      positions_[static_cast<std::size_t>(ids_[k])] = k;
+    }
+  }
+
+  //! Put back a previously erased entity with the given id at position.
+  void insert(const std::size_t position, const Id id) {
+    using Diff = typename std::vector<typename Id::ValueType>::difference_type;
+    ids_.insert(ids_.begin() + static_cast<Diff>(position), id.value());
+    for (auto k = position; k < ids_.size(); k++) {
+      positions_[static_cast<std::size_t>(ids_[k])] = k;
+    }
+  }
+
+  /**
+   * @brief Put back previously erased entities, given with their final
+   * positions in increasing order, updating all positions in one pass.
+   */
+  void insert(const std::vector<std::pair<std::size_t, Id>>& entries) {
+    if (entries.empty()) {
+      return;
+    }
+    std::vector<typename Id::ValueType> ids;
+    ids.reserve(ids_.size() + entries.size());
+    std::size_t next = 0;
+    for (const auto& entry : entries) {
+      while (ids.size() < entry.first) {
+        ids.push_back(ids_[next++]);
+      }
+      ids.push_back(entry.second.value());
+    }
+    ids.insert(ids.end(), ids_.begin() + static_cast<std::ptrdiff_t>(next),
+               ids_.end());
+    ids_.swap(ids);
+    for (auto k = entries.front().first; k < ids_.size(); k++) {
+      positions_[static_cast<std::size_t>(ids_[k])] = k;
+    }
+  }
+
+  //! Remove all entities from position n on.
+  void truncate(const std::size_t n) {
+    for (auto k = n; k < ids_.size(); k++) {
+      positions_[static_cast<std::size_t>(ids_[k])] = removed;
+    }
+    ids_.resize(n);
+  }
+
+  //! Return the number of entities currently in the map.
+  std::size_t size() const { return ids_.size(); }
+
+ private:
+  static constexpr std::size_t removed =
+      std::numeric_limits<std::size_t>::max();
+
+  // position of each entity, indexed by id value
+  std::vector<std::size_t> positions_;
+  // id value of each entity, indexed by position
+  std::vector<typename Id::ValueType> ids_;
+};
+
+template <class Id>
+constexpr std::size_t IdMap<Id>::removed;
+
+}  // namespace detail
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_ID_MAP_H
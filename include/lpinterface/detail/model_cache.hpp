@@ -0,0 +1,125 @@
+#ifndef LPINTERFACE_MODEL_CACHE_H
+#define LPINTERFACE_MODEL_CACHE_H
+
+#include <cstddef>
+#include <vector>
+
+#include "lpinterface/constraint_batch.hpp"
+#include "lpinterface/data_objects.hpp"
+
+namespace lpint {
+
+namespace detail {
+
+/**
+ * @brief Read-through mirror of the model data stored in a backend.
+ * Each kind of entity (constraints, objective, variables) is loaded from
+ * the backend on first access and kept until a mutator of the handle
+ * invalidates it, so repeated reads cost nothing. Changes to one kind of
+ * entity leave the others cached, and added constraints are appended to
+ * the cached ones. A disabled cache loads the data on every access and
+ * keeps only the result of the last load. The cache is not thread safe.
+ */
+class ModelCache {
+ public:
+  //! Return the cached constraints, loading them with load() if needed.
+  template <class Load>
+  const std::vector<Constraint<double>>& constraints(Load load) {
+    if (!constraints_valid_) {
+      constraints_ = load();
+      constraints_valid_ = enabled_;
+    }
+    return constraints_;
+  }
+
+  //! Return the cached objective, loading it with load() if needed.
+  template <class Load>
+  const Objective<double>& objective(Load load) {
+    if (!objective_valid_) {
+      objective_ = load();
+      objective_valid_ = enabled_;
+    }
+    return objective_;
+  }
+
+  //! Return the cached variables, loading them with load() if needed.
+  template <class Load>
+  const std::vector<Variable>& variables(Load load) {
+    if (!variables_valid_) {
+      variables_ = load();
+      variables_valid_ = enabled_;
+    }
+    return variables_;
+  }
+
+  void invalidate_constraints() { constraints_valid_ = false; }
+
+  void invalidate_objective() { objective_valid_ = false; }
+
+  void invalidate_variables() { variables_valid_ = false; }
+
+  //! Mirror the addition of constraints, without reloading the others.
+  void append_constraints(const std::vector<Constraint<double>>& added) {
+    if (!constraints_valid_) {
+      return;
+    }
+    constraints_.reserve(constraints_.size() + added.size());
+    for (const auto& constraint : added) {
+      constraints_.emplace_back(
+          Row<double>(constraint.row.values(),
+                      constraint.row.nonzero_indices()),
+          constraint.lower_bound, constraint.upper_bound);
+    }
+  }
+
+  //! Mirror the addition of the rows of a batch.
+  void append_constraints(const ConstraintBatch<double>& batch) {
+    if (!constraints_valid_) {
+      return;
+    }
+    constraints_.reserve(constraints_.size() + batch.num_rows());
+    for (std::size_t i = 0; i < batch.num_rows(); i++) {
+      constraints_.push_back(batch.constraint(i));
+    }
+  }
+
+  //! Mirror the removal of constraint i, without reloading the others.
+  void erase_constraint(const std::size_t i) {
+    if (constraints_valid_) {
+      constraints_.erase(
+          constraints_.begin() +
+          static_cast<std::vector<Constraint<double>>::difference_type>(i));
+    }
+  }
+
+  //! Drop all cached data and give its storage back.
+  void clear() {
+    const auto enabled = enabled_;
+    *this = ModelCache();
+    enabled_ = enabled;
+  }
+
+  //! Turn caching on or off; turning it off drops the cached data.
+  void set_enabled(const bool enabled) {
+    if (!enabled) {
+      clear();
+    }
+    enabled_ = enabled;
+  }
+
+ private:
+  std::vector<Constraint<double>> constraints_;
+  Objective<double> objective_;
+  std::vector<Variable> variables_;
+
+  bool constraints_valid_ = false;
+  bool objective_valid_ = false;
+  bool variables_valid_ = false;
+  bool enabled_ = true;
+};
+
+}  // namespace detail
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_MODEL_CACHE_H
@@ -0,0 +1,106 @@
+#ifndef LPINTERFACE_OBJECTIVE_SUPPORT_H
+#define LPINTERFACE_OBJECTIVE_SUPPORT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include "lpinterface/data_objects.hpp"
+#include "lpinterface/errors.hpp"
+
+namespace lpint {
+
+namespace detail {
+
+/**
+ * @brief Keeps track of which objective coefficients may be nonzero.
+ * Backend handles use this to push only nonzero coefficients when a
+ * SparseObjective is set, and to query only those coefficients when
+ * the sparse objective is retrieved. Indices are kept sorted.
+ */
+class ObjectiveSupport {
+ public:
+  //! Replace the support by the nonzero entries of a dense objective.
+  void assign_dense(const std::vector<double>& values) {
+    indices_.clear();
+    for (std::size_t i = 0; i < values.size(); i++) {
+      if (values[i] != 0.0) {
+        indices_.push_back(static_cast<int>(i));
+      }
+    }
+  }
+
+  /**
+   * @brief Replace the support by the indices of a sparse objective.
+   *
+   * @return std::vector<int> Indices in the old support that are not in the
+   * new one; their coefficients have to be reset to zero in the backend.
+   */
+  std::vector<int> assign_sparse(const std::vector<int>& indices) {
+    std::vector<int> sorted(indices);
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<int> cleared;
+    std::set_difference(indices_.begin(), indices_.end(), sorted.begin(),
+                        sorted.end(), std::back_inserter(cleared));
+    indices_ = std::move(sorted);
+    return cleared;
+  }
+
+  //! Update the support after variable i has been removed from the LP.
+  void remove_index(const std::size_t i) {
+    const auto removed = static_cast<int>(i);
+    auto it = std::lower_bound(indices_.begin(), indices_.end(), removed);
+    if (it != indices_.end() && *it == removed) {
+      it = indices_.erase(it);
+    }
+    for (; it != indices_.end(); ++it) {
+      --*it;
+    }
+  }
+
+  //! Update the support after a variable has been inserted at index i,
+  //! with a nonzero coefficient if nonzero is true.
+  void insert_index(const std::size_t i, const bool nonzero) {
+    const auto inserted = static_cast<int>(i);
+    auto it = std::lower_bound(indices_.begin(), indices_.end(), inserted);
+    for (auto shifted = it; shifted != indices_.end(); ++shifted) {
+      ++*shifted;
+    }
+    if (nonzero) {
+      indices_.insert(it, inserted);
+    }
+  }
+
+  //! Update the support after all variables from index n on were removed.
+  void truncate(const std::size_t n) {
+    indices_.erase(std::lower_bound(indices_.begin(), indices_.end(),
+                                    static_cast<int>(n)),
+                   indices_.end());
+  }
+
+  //! Get the sorted indices of the possibly nonzero coefficients.
+  const std::vector<int>& indices() const { return indices_; }
+
+ private:
+  std::vector<int> indices_;
+};
+
+/**
+ * @brief Check that a sparse objective fits an LP with nvars variables.
+ * Throws MismatchedDimensionsException otherwise.
+ */
+inline void check_sparse_objective(const SparseObjective<double>& objective,
+                                   const std::size_t nvars) {
+  for (const auto i : objective.nonzero_indices()) {
+    if (i < 0 || static_cast<std::size_t>(i) >= nvars) {
+      throw MismatchedDimensionsException();
+    }
+  }
+}
+
+}  // namespace detail
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_OBJECTIVE_SUPPORT_H
@@ -0,0 +1,61 @@
+#ifndef LPINTERFACE_PARALLEL_H
+#define LPINTERFACE_PARALLEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace lpint {
+
+namespace detail {
+
+/**
+ * @brief Return the number of threads to use for work of the given size.
+ * Small inputs are handled by the calling thread alone, since starting
+ * threads costs more than it saves.
+ *
+ * @param work Number of elements to process.
+ * @param min_work_per_thread Smallest number of elements worth a thread.
+ */
+inline std::size_t num_threads_for(const std::size_t work,
+                                   const std::size_t min_work_per_thread) {
+  const std::size_t hardware =
+      std::max(std::thread::hardware_concurrency(), 1u);
+  return std::max<std::size_t>(
+      1, std::min(hardware, work / std::max<std::size_t>(
+                                       min_work_per_thread, 1)));
+}
+
+/**
+ * @brief Call f(t) for t in [0, nthreads), each call on its own thread,
+ * and wait for all calls to return. The call with t = 0 runs on the
+ * calling thread.
+ */
+template <class F>
+void run_parallel(const std::size_t nthreads, F f) {
+  std::vector<std::thread> threads;
+  threads.reserve(nthreads > 0 ? nthreads - 1 : 0);
+  for (std::size_t t = 1; t < nthreads; t++) {
+    threads.emplace_back([&f, t]() { f(t); });
+  }
+  f(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+/**
+ * @brief Return the start of the t-th of nparts nearly equal parts of
+ * [0, n).
+ */
+inline std::size_t part_begin(const std::size_t n, const std::size_t nparts,
+                              const std::size_t t) {
+  return n / nparts * t + std::min(t, n % nparts);
+}
+
+}  // namespace detail
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_PARALLEL_H
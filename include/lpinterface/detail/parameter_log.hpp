@@ -0,0 +1,67 @@
+#ifndef LPINTERFACE_PARAMETER_LOG_H
+#define LPINTERFACE_PARAMETER_LOG_H
+
+#include <vector>
+
+#include "lpinterface/lpinterface.hpp"
+#include "lpinterface/parameter_type.hpp"
+
+namespace lpint {
+
+namespace detail {
+
+/**
+ * @brief Parameters set on a solver that creates its backends on demand,
+ * kept so that they can be set again on every new backend.
+ */
+class ParameterLog {
+  struct Entry {
+    Param param;
+    bool is_int;
+    int int_value;
+    double double_value;
+  };
+
+ public:
+  void record(const Param param, const int value) {
+    entries_.push_back({param, true, value, 0.0});
+  }
+
+  void record(const Param param, const double value) {
+    entries_.push_back({param, false, 0, value});
+  }
+
+  //! Set all recorded parameters on a solver, in the order they were set.
+  void replay(LinearProgramSolver& solver) const {
+    for (const auto& entry : entries_) {
+      if (entry.is_int) {
+        solver.set_parameter(entry.param, entry.int_value);
+      } else {
+        solver.set_parameter(entry.param, entry.double_value);
+      }
+    }
+  }
+
+  //! Like replay(), but skip the parameters the solver does not support.
+  void replay_supported(LinearProgramSolver& solver) const {
+    for (const auto& entry : entries_) {
+      if (!solver.parameter_supported(entry.param)) {
+        continue;
+      }
+      if (entry.is_int) {
+        solver.set_parameter(entry.param, entry.int_value);
+      } else {
+        solver.set_parameter(entry.param, entry.double_value);
+      }
+    }
+  }
+
+ private:
+  std::vector<Entry> entries_;
+};
+
+}  // namespace detail
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_PARAMETER_LOG_H
@@ -0,0 +1,282 @@
+#ifndef LPINTERFACE_TRANSACTION_LOG_H
+#define LPINTERFACE_TRANSACTION_LOG_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "lpinterface/data_objects.hpp"
+#include "lpinterface/entity_id.hpp"
+#include "lpinterface/errors.hpp"
+#include "lpinterface/lp.hpp"
+
+namespace lpint {
+
+namespace detail {
+
+/**
+ * @brief Undo log of the changes made to a linear program during a
+ * transaction.
+ * Backend handles record every change while a transaction is active, and
+ * replay the log backwards to roll the transaction back. Only what is
+ * needed to undo a change is stored: additions are stored as the position
+ * the added entities start at, and consecutive additions are merged so
+ * they are undone by a single bulk removal; removed entities and replaced
+ * objectives are stored in full.
+ *
+ * rollback() calls the following members of the handle, which are
+ * expected to modify the backend without recording anything:
+ *
+ *     void truncate_constraints(std::size_t n);
+ *     void truncate_variables(std::size_t n);
+ *     void insert_constraints(
+ *         const std::vector<TransactionLog::RemovedConstraint>&);
+ *     void insert_variables(
+ *         const std::vector<TransactionLog::RemovedVariable>&);
+ *
+ * Consecutive removals are reinserted by one call, one after another in
+ * the order of the vector, so that backends which can only append
+ * entities rebuild the affected tail once.
+ *
+ * Objective, objective sense and bound changes are undone through the
+ * public interface of the handle.
+ */
+class TransactionLog {
+ public:
+  //! Constraint to put back at position by insert_constraints().
+  struct RemovedConstraint {
+    std::size_t position;
+    const Constraint<double>* constraint;
+    ConstraintId id;
+  };
+
+  //! Variable to put back at position by insert_variables().
+  struct RemovedVariable {
+    std::size_t position;
+    Variable variable;
+    const Column<double>* column;
+    double objective;
+    VariableId id;
+  };
+
+  //! Return whether a transaction is active.
+  bool active() const { return active_; }
+
+  //! Start recording changes.
+  void begin() {
+    if (active_) {
+      throw InvalidTransactionStateException();
+    }
+    active_ = true;
+  }
+
+  //! Stop recording changes and forget the recorded ones.
+  void commit() {
+    if (!active_) {
+      throw InvalidTransactionStateException();
+    }
+    clear();
+  }
+
+  //! Undo all recorded changes, most recent first, and stop recording.
+  template <class Handle>
+  void rollback(Handle& handle) {
+    if (!active_) {
+      throw InvalidTransactionStateException();
+    }
+    // the handle's mutators record nothing while no transaction is active
+    active_ = false;
+    for (auto it = entries_.rbegin(); it != entries_.rend(); ++it) {
+      const auto& entry = *it;
+      switch (entry.kind) {
+        case Kind::AddConstraints:
+          handle.truncate_constraints(entry.position);
+          break;
+        case Kind::AddVariables:
+          handle.truncate_variables(entry.position);
+          break;
+        case Kind::RemoveConstraint: {
+          std::vector<RemovedConstraint> removed;
+          const auto end = run_end(it, entries_.rend());
+          for (; it != end; ++it) {
+            removed.push_back({it->position, &constraints_[it->payload],
+                               ConstraintId(it->id)});
+          }
+          --it;
+          handle.insert_constraints(removed);
+          break;
+        }
+        case Kind::RemoveVariable: {
+          std::vector<RemovedVariable> removed;
+          const auto end = run_end(it, entries_.rend());
+          for (; it != end; ++it) {
+            removed.push_back({it->position, Variable(it->lower, it->upper),
+                               &columns_[it->payload], it->value,
+                               VariableId(it->id)});
+          }
+          --it;
+          handle.insert_variables(removed);
+          break;
+        }
+        case Kind::Objective:
+          handle.set_objective(objectives_[entry.payload]);
+          break;
+        case Kind::ObjectiveSense:
+          handle.set_objective_sense(entry.sense);
+          break;
+        case Kind::VariableBounds:
+          handle.set_variable_bounds(entry.position, entry.lower, entry.upper);
+          break;
+        case Kind::ConstraintBounds:
+          handle.set_constraint_bounds(entry.position, entry.lower,
+                                       entry.upper);
+          break;
+        default:
+          throw NotImplementedError();
+      }
+    }
+    clear();
+  }
+
+  //! Record that constraints were appended, starting at position first.
+  void record_add_constraints(const std::size_t first) {
+    record_add(Kind::AddConstraints, first);
+  }
+
+  //! Record that variables were appended, starting at position first.
+  void record_add_variables(const std::size_t first) {
+    record_add(Kind::AddVariables, first);
+  }
+
+  //! Record that constraint i is about to be removed.
+  void record_remove_constraint(const std::size_t i,
+                                Constraint<double>&& constraint,
+                                const ConstraintId id) {
+    Entry entry(Kind::RemoveConstraint, i);
+    entry.payload = constraints_.size();
+    entry.id = id.value();
+    constraints_.push_back(std::move(constraint));
+    entries_.push_back(entry);
+  }
+
+  //! Record that variable i is about to be removed.
+  void record_remove_variable(const std::size_t i, const Variable& variable,
+                              Column<double>&& column,
+                              const double objective, const VariableId id) {
+    Entry entry(Kind::RemoveVariable, i);
+    entry.payload = columns_.size();
+    entry.lower = variable.lower();
+    entry.upper = variable.upper();
+    entry.value = objective;
+    entry.id = id.value();
+    columns_.push_back(std::move(column));
+    entries_.push_back(entry);
+  }
+
+  //! Record the objective that is about to be replaced.
+  void record_objective(SparseObjective<double>&& previous) {
+    Entry entry(Kind::Objective, 0);
+    entry.payload = objectives_.size();
+    objectives_.push_back(std::move(previous));
+    entries_.push_back(entry);
+  }
+
+  //! Record the objective sense that is about to be replaced.
+  void record_objective_sense(const OptimizationType previous) {
+    Entry entry(Kind::ObjectiveSense, 0);
+    entry.sense = previous;
+    entries_.push_back(entry);
+  }
+
+  //! Record the bounds of variable i that are about to be replaced.
+  void record_variable_bounds(const std::size_t i, const double lower,
+                              const double upper) {
+    record_bounds(Kind::VariableBounds, i, lower, upper);
+  }
+
+  //! Record the bounds of constraint i that are about to be replaced.
+  void record_constraint_bounds(const std::size_t i, const double lower,
+                                const double upper) {
+    record_bounds(Kind::ConstraintBounds, i, lower, upper);
+  }
+
+ private:
+  enum class Kind {
+    AddConstraints,
+    AddVariables,
+    RemoveConstraint,
+    RemoveVariable,
+    Objective,
+    ObjectiveSense,
+    VariableBounds,
+    ConstraintBounds,
+  };
+
+  struct Entry {
+    Entry(const Kind k, const std::size_t pos) : kind(k), position(pos) {}
+
+    Kind kind;
+    std::size_t position;
+    // index into the payload vector belonging to kind
+    std::size_t payload = 0;
+    double lower = 0.0;
+    double upper = 0.0;
+    double value = 0.0;
+    std::uint64_t id = 0;
+    OptimizationType sense = OptimizationType::Maximize;
+  };
+
+  void record_add(const Kind kind, const std::size_t first) {
+    // consecutive additions of the same kind are undone by one truncation
+    if (!entries_.empty() && entries_.back().kind == kind) {
+      entries_.back().position = std::min(entries_.back().position, first);
+      return;
+    }
+    entries_.emplace_back(kind, first);
+  }
+
+  // end of the run of entries of the same kind as the one at it
+  template <class Iterator>
+  static Iterator run_end(Iterator it, const Iterator end) {
+    const auto kind = it->kind;
+    while (it != end && it->kind == kind) {
+      ++it;
+    }
+    return it;
+  }
+
+  void record_bounds(const Kind kind, const std::size_t i, const double lower,
+                     const double upper) {
+    // repeated changes of the same bounds only need the oldest value
+    if (!entries_.empty() && entries_.back().kind == kind &&
+        entries_.back().position == i) {
+      return;
+    }
+    Entry entry(kind, i);
+    entry.lower = lower;
+    entry.upper = upper;
+    entries_.push_back(entry);
+  }
+
+  void clear() {
+    entries_.clear();
+    constraints_.clear();
+    columns_.clear();
+    objectives_.clear();
+    active_ = false;
+  }
+
+  std::vector<Entry> entries_;
+  std::vector<Constraint<double>> constraints_;
+  std::vector<Column<double>> columns_;
+  std::vector<SparseObjective<double>> objectives_;
+
+  bool active_ = false;
+};
+
+}  // namespace detail
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_TRANSACTION_LOG_H
@@ -1,8 +1,14 @@
 #ifndef LPINTERFACE_INCLUDE_UTIL_H
 #define LPINTERFACE_INCLUDE_UTIL_H
 
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
 #include <vector>
 
+#include "lpinterface/errors.hpp"
+
 namespace lpint {
 
 namespace detail {
@@ -28,6 +34,36 @@ std::vector<T> rankify(const std::vector<T>& list) {
   return out;
 }
 
+/**
+ * @brief Removes rank r from a list of ranks in place, by shifting all
+ * ranks above r down by one. This is the linear-time equivalent of
+ * calling rankify() on a list from which the element of rank r was just
+ * erased.
+ *
+ * @param ranks List of ranks, not containing r.
+ * @param r The removed rank.
+ */
+template <class T>
+void remove_rank(std::vector<T>& ranks, const T r) {
+  for (auto& rank : ranks) {
+    rank -= rank > r ? T(1) : T(0);
+  }
+}
+
+/**
+ * @brief Makes room for rank r in a list of ranks in place, by shifting all
+ * ranks at or above r up by one. This is the inverse of remove_rank().
+ *
+ * @param ranks List of ranks.
+ * @param r The rank to make room for.
+ */
+template <class T>
+void insert_rank(std::vector<T>& ranks, const T r) {
+  for (auto& rank : ranks) {
+    rank += rank >= r ? T(1) : T(0);
+  }
+}
+
 /**
  * @brief Computes the inverse of the given permutation.
  *
@@ -43,6 +79,89 @@ inline std::vector<std::size_t> inverse_permutation(
   return inv;
 }
 
+template <class T>
+constexpr bool is_negative(const T value, std::true_type) {
+  return value < T(0);
+}
+
+template <class T>
+constexpr bool is_negative(const T, std::false_type) {
+  return false;
+}
+
+/**
+ * @brief Convert an integer to a (possibly narrower) integer type,
+ * checking that the value is representable in the target type.
+ * Backends such as SoPlex only accept int sizes and indices; this
+ * is used wherever a size or index is handed to such a backend.
+ *
+ * @tparam To Integer type to convert to.
+ * @tparam From Integer type to convert from.
+ * @param value Value to convert.
+ * @return To The converted value.
+ * @throws IndexOverflowException if the value is out of range of To.
+ */
+template <class To, class From>
+To checked_narrow(const From value) {
+  static_assert(std::is_integral<To>::value && std::is_integral<From>::value,
+                "checked_narrow requires integral types");
+  if (is_negative(value, std::is_signed<From>())) {
+    if (!std::is_signed<To>::value ||
+        static_cast<std::intmax_t>(value) <
+            static_cast<std::intmax_t>(std::numeric_limits<To>::min())) {
+      throw IndexOverflowException();
+    }
+  } else if (static_cast<std::uintmax_t>(value) >
+             static_cast<std::uintmax_t>(std::numeric_limits<To>::max())) {
+    throw IndexOverflowException();
+  }
+  return static_cast<To>(value);
+}
+
+/**
+ * @brief Check whether a value can be converted to the floating point
+ * type To without overflowing, i.e. whether it is NaN, infinite or
+ * within the finite range of To. Converting any other value is
+ * undefined behaviour.
+ *
+ * @tparam To Floating point type to convert to.
+ * @tparam From Arithmetic type to convert from.
+ * @param value Value to check.
+ */
+template <class To, class From>
+bool in_floating_range(const From value) {
+  const auto wide = static_cast<long double>(value);
+  return std::isinf(wide) ||
+         !(wide > static_cast<long double>(std::numeric_limits<To>::max()) ||
+           wide < static_cast<long double>(std::numeric_limits<To>::lowest()));
+}
+
+/**
+ * @brief Convert a floating point value to another floating point type,
+ * checking that no precision is lost in the conversion.
+ * NaN values are passed through unchanged.
+ *
+ * @tparam To Floating point type to convert to.
+ * @tparam From Arithmetic type to convert from.
+ * @param value Value to convert.
+ * @return To The converted value.
+ * @throws LossyConversionException if value is out of range of To or not
+ * exactly representable as a To.
+ */
+template <class To, class From>
+To lossless_cast(const From value) {
+  static_assert(std::is_floating_point<To>::value,
+                "lossless_cast requires a floating point target type");
+  if (!in_floating_range<To>(value)) {
+    throw LossyConversionException();
+  }
+  const auto converted = static_cast<To>(value);
+  if (static_cast<From>(converted) != value && value == value) {
+    throw LossyConversionException();
+  }
+  return converted;
+}
+
 }  // namespace detail
 
 }  // namespace lpint
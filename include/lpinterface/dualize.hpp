@@ -0,0 +1,378 @@
+#ifndef LPINTERFACE_DUALIZE_H
+#define LPINTERFACE_DUALIZE_H
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "common.hpp"
+#include "constraint_batch.hpp"
+#include "data_objects.hpp"
+#include "detail/parameter_log.hpp"
+#include "errors.hpp"
+#include "lp.hpp"
+#include "lpinterface.hpp"
+#include "native/lphandle_native.hpp"
+#include "parameter_type.hpp"
+
+namespace lpint {
+
+/**
+ * @brief Explicit dual of a linear program.
+ * A model min c^T x s.t. l <= A x <= u, lx <= x <= ux (a maximization
+ * problem is first turned into one by negating c) has the dual
+ *
+ *     max  l^T p + u^T q + (lx - ux)^T w - (A s)^T (p + q) + c^T s
+ *     s.t. A^T (p + q) - w  <= c  for columns with a finite lower bound,
+ *          A^T (p + q)      >= c  for columns with only an upper bound,
+ *          A^T (p + q)       = c  for free columns,
+ *
+ * where s is the finite bound of every column that is used to eliminate
+ * its reduced cost (lx, or ux if only that is finite, or zero for a free
+ * column), p >= 0 exists for every row with a finite lower bound, q <= 0
+ * for every row with a finite upper bound, w >= 0 for every column with
+ * two finite bounds, and p + q is the row dual y. An equality row gets a
+ * single free variable. The dual has a row for every column of the
+ * original model, so solving it is attractive when the original model has
+ * many more rows than columns:
+ *
+ * ~~~cpp
+ * Dualizer dualizer(lp);
+ * dualizer.load_dual(backend.linear_program());
+ * const auto status = dualizer.primal_status(backend.solve());
+ * const auto solution = dualizer.map_solution(backend.get_solution());
+ * ~~~
+ *
+ * The values of the original variables are x = s + z, where z are the row
+ * duals of the dual.
+ */
+class Dualizer {
+ public:
+  /**
+   * @brief Copy the matrix, bounds and objective of a linear program.
+   */
+  explicit Dualizer(const ILinearProgramHandle& lp)
+      : sense_(lp.optimization_type()),
+        objective_(lp.cached_objective().values) {
+    const auto& variables = lp.cached_variables();
+    const auto& constraints = lp.cached_constraints();
+    const auto nvars = variables.size();
+    const auto nrows = constraints.size();
+    const double sign = sense_ == OptimizationType::Maximize ? -1.0 : 1.0;
+    objective_.resize(nvars, 0.0);
+
+    shift_.resize(nvars);
+    column_lower_.resize(nvars);
+    column_upper_.resize(nvars);
+    column_boxed_.resize(nvars);
+    for (std::size_t j = 0; j < nvars; j++) {
+      const auto lower = variables[j].lower();
+      const auto upper = variables[j].upper();
+      const auto cost = sign * objective_[j];
+      column_boxed_[j] = finite(lower) && finite(upper);
+      shift_[j] = finite(lower) ? lower : finite(upper) ? upper : 0.0;
+      column_lower_[j] = finite(lower) ? -LPINT_INFINITY : cost;
+      column_upper_[j] = finite(lower) || !finite(upper) ? cost
+                                                         : LPINT_INFINITY;
+    }
+
+    // the transpose of the matrix, and the row activities at the shift
+    std::vector<double> shifted_activity(nrows, 0.0);
+    column_starts_.assign(nvars + 1, 0);
+    for (std::size_t i = 0; i < nrows; i++) {
+      const auto& row = constraints[i].row;
+      for (std::size_t k = 0; k < row.num_nonzero(); k++) {
+        const auto j = static_cast<std::size_t>(row.nonzero_indices()[k]);
+        column_starts_[j + 1]++;
+        shifted_activity[i] += row.values()[k] * shift_[j];
+      }
+    }
+    for (std::size_t j = 0; j < nvars; j++) {
+      column_starts_[j + 1] += column_starts_[j];
+    }
+    column_rows_.resize(column_starts_.back());
+    column_values_.resize(column_starts_.back());
+    auto next = column_starts_;
+    for (std::size_t i = 0; i < nrows; i++) {
+      const auto& row = constraints[i].row;
+      for (std::size_t k = 0; k < row.num_nonzero(); k++) {
+        const auto j = static_cast<std::size_t>(row.nonzero_indices()[k]);
+        column_rows_[next[j]] = i;
+        column_values_[next[j]] = row.values()[k];
+        next[j]++;
+      }
+    }
+
+    // the dual variables of the rows, p and q
+    row_variables_.assign(nrows + 1, 0);
+    for (std::size_t i = 0; i < nrows; i++) {
+      const auto lower = constraints[i].lower_bound;
+      const auto upper = constraints[i].upper_bound;
+      if (finite(lower) && finite(upper) && lower == upper) {
+        add_dual_variable(-LPINT_INFINITY, LPINT_INFINITY,
+                          lower - shifted_activity[i]);
+      } else {
+        if (finite(lower)) {
+          add_dual_variable(0.0, LPINT_INFINITY,
+                            lower - shifted_activity[i]);
+        }
+        if (finite(upper)) {
+          add_dual_variable(-LPINT_INFINITY, 0.0,
+                            upper - shifted_activity[i]);
+        }
+      }
+      row_variables_[i + 1] = dual_variables_.size();
+    }
+    // the variables w of the boxed columns
+    for (std::size_t j = 0; j < nvars; j++) {
+      if (column_boxed_[j]) {
+        dual_variables_.emplace_back(0.0, LPINT_INFINITY);
+        dual_objective_.push_back(variables[j].lower() -
+                                  variables[j].upper());
+      }
+    }
+  }
+
+  /**
+   * @brief Decide whether solving the dual is likely to be faster.
+   * This is the case when the original model has at least ratio times as
+   * many rows as columns, since the dual has one row per column.
+   *
+   * @param lp Linear program to decide for.
+   * @param ratio Smallest ratio of rows to columns at which to dualize.
+   */
+  static bool worthwhile(const ILinearProgramHandle& lp,
+                         const double ratio = 2.0) {
+    const auto nvars = lp.num_vars();
+    return nvars > 0 && static_cast<double>(lp.num_constraints()) >=
+                            ratio * static_cast<double>(nvars);
+  }
+
+  //! Get the number of variables of the dual.
+  std::size_t num_dual_vars() const { return dual_variables_.size(); }
+
+  //! Get the number of constraints of the dual.
+  std::size_t num_dual_constraints() const { return shift_.size(); }
+
+  /**
+   * @brief Load the dual into an empty linear program.
+   * The dual is a maximization problem, whatever the sense of the
+   * original model.
+   */
+  void load_dual(ILinearProgramHandle& lp) const {
+    lp.set_objective_sense(OptimizationType::Maximize);
+    if (!dual_variables_.empty()) {
+      lp.add_variables(dual_variables_);
+      lp.set_objective(Objective<double>(std::vector<double>(dual_objective_)));
+    }
+    if (shift_.empty()) {
+      return;
+    }
+
+    ConstraintBatch<double> batch;
+    batch.reserve(shift_.size(), 2 * column_values_.size());
+    auto boxed = row_variables_.back();
+    for (std::size_t j = 0; j < shift_.size(); j++) {
+      batch.begin_row(column_lower_[j], column_upper_[j]);
+      for (auto k = column_starts_[j]; k < column_starts_[j + 1]; k++) {
+        const auto i = column_rows_[k];
+        for (auto v = row_variables_[i]; v < row_variables_[i + 1]; v++) {
+          batch.push(static_cast<int>(v), column_values_[k]);
+        }
+      }
+      if (column_boxed_[j]) {
+        batch.push(static_cast<int>(boxed), -1.0);
+        boxed++;
+      }
+      batch.end_row();
+    }
+    lp.add_constraints(batch);
+  }
+
+  /**
+   * @brief Map the status of a solve of the dual to that of the original
+   * model. An unbounded dual means an infeasible original model, while an
+   * infeasible dual only says the original model is not both feasible
+   * and bounded.
+   */
+  static Status primal_status(const Status dual_status) {
+    switch (dual_status) {
+      case Status::Unbounded:
+        return Status::Infeasible;
+      case Status::Infeasible:
+        return Status::InfeasibleOrUnbounded;
+      default:
+        return dual_status;
+    }
+  }
+
+  /**
+   * @brief Map an optimal solution of the dual to primal and dual values
+   * of the original model.
+   */
+  Solution<double> map_solution(const Solution<double>& dual) const {
+    if (dual.primal.size() != dual_variables_.size() ||
+        dual.dual.size() != shift_.size()) {
+      throw MismatchedDimensionsException();
+    }
+    const double sign = sense_ == OptimizationType::Maximize ? -1.0 : 1.0;
+    Solution<double> solution;
+    solution.primal.resize(shift_.size());
+    solution.objective_value = 0.0;
+    for (std::size_t j = 0; j < shift_.size(); j++) {
+      solution.primal[j] = shift_[j] + dual.dual[j];
+      solution.objective_value += objective_[j] * solution.primal[j];
+    }
+    const auto nrows = row_variables_.size() - 1;
+    solution.dual.assign(nrows, 0.0);
+    for (std::size_t i = 0; i < nrows; i++) {
+      for (auto v = row_variables_[i]; v < row_variables_[i + 1]; v++) {
+        solution.dual[i] += sign * dual.primal[v];
+      }
+    }
+    return solution;
+  }
+
+ private:
+  static bool finite(const double value) {
+    return std::abs(value) < LPINT_INFINITY;
+  }
+
+  void add_dual_variable(const double lower, const double upper,
+                         const double cost) {
+    dual_variables_.emplace_back(lower, upper);
+    dual_objective_.push_back(cost);
+  }
+
+  OptimizationType sense_;
+  std::vector<double> objective_;
+
+  // per column of the original model
+  std::vector<double> shift_;
+  std::vector<double> column_lower_;
+  std::vector<double> column_upper_;
+  std::vector<bool> column_boxed_;
+  // entries of column j are at column_starts_[j] up to column_starts_[j + 1]
+  std::vector<std::size_t> column_starts_;
+  std::vector<std::size_t> column_rows_;
+  std::vector<double> column_values_;
+
+  // the dual variables of row i are row_variables_[i] up to
+  // row_variables_[i + 1], and the w variables follow those of all rows
+  std::vector<std::size_t> row_variables_;
+  std::vector<Variable> dual_variables_;
+  std::vector<double> dual_objective_;
+};
+
+namespace detail {
+
+//! Copy the variables, objective and constraints into an empty model.
+inline void copy_model(const ILinearProgramHandle& from,
+                       ILinearProgramHandle& to) {
+  to.set_objective_sense(from.optimization_type());
+  if (from.num_vars() == 0) {
+    return;
+  }
+  to.add_variables(from.cached_variables());
+  to.set_objective(from.cached_objective());
+  if (from.num_constraints() > 0) {
+    to.add_constraints(from.cached_constraints());
+  }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Solver which solves the explicit dual of its linear program when
+ * that is likely to be faster, as decided by Dualizer::worthwhile().
+ * Like ScaledSolver, the model is kept in memory and every solve() loads
+ * either the model itself or its dual into a fresh backend, so
+ * get_solution() always refers to the model in linear_program().
+ *
+ * @tparam Solver Type of the backend solver.
+ */
+template <class Solver>
+class DualizedSolver : public LinearProgramSolver {
+ public:
+  DualizedSolver() : DualizedSolver(OptimizationType::Maximize) {}
+
+  /**
+   * @brief Construct a solver.
+   *
+   * @param sense Objective sense of the linear program.
+   * @param ratio Smallest ratio of rows to columns at which the dual is
+   * solved, see Dualizer::worthwhile().
+   */
+  explicit DualizedSolver(const OptimizationType sense,
+                          const double ratio = 2.0)
+      : lp_(sense), solver_(new Solver(sense)), ratio_(ratio) {}
+
+  const ILinearProgramHandle& linear_program() const override { return lp_; }
+
+  ILinearProgramHandle& linear_program() override { return lp_; }
+
+  bool parameter_supported(const Param param) const override {
+    return solver_->parameter_supported(param);
+  }
+
+  void set_parameter(const Param param, const int value) override {
+    solver_->set_parameter(param, value);
+    params_.record(param, value);
+  }
+
+  void set_parameter(const Param param, const double value) override {
+    solver_->set_parameter(param, value);
+    params_.record(param, value);
+  }
+
+  Status solve() override {
+    dualized_ = Dualizer::worthwhile(lp_, ratio_);
+    if (dualized_) {
+      Dualizer dualizer(lp_);
+      solver_.reset(new Solver(OptimizationType::Maximize));
+      params_.replay(*solver_);
+      dualizer.load_dual(solver_->linear_program());
+      status_ = Dualizer::primal_status(solver_->solve());
+      if (status_ == Status::Optimal) {
+        solution_ = dualizer.map_solution(solver_->get_solution());
+      }
+    } else {
+      solver_.reset(new Solver(lp_.optimization_type()));
+      params_.replay(*solver_);
+      detail::copy_model(lp_, solver_->linear_program());
+      status_ = solver_->solve();
+      if (status_ == Status::Optimal) {
+        solution_ = solver_->get_solution();
+      }
+    }
+    return status_;
+  }
+
+  Status solution_status() const override { return status_; }
+
+  const Solution<double>& get_solution() const override {
+    if (status_ != Status::Optimal) {
+      throw ModelNotSolvedException();
+    }
+    return solution_;
+  }
+
+  //! Return whether the last solve() solved the dual.
+  bool dualized() const { return dualized_; }
+
+ private:
+  LinearProgramHandleNative lp_;
+  std::unique_ptr<Solver> solver_;
+  detail::ParameterLog params_;
+
+  double ratio_;
+  bool dualized_ = false;
+
+  Status status_ = Status::NoInformation;
+  Solution<double> solution_;
+};
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_DUALIZE_H
@@ -0,0 +1,139 @@
+#ifndef LPINTERFACE_ENTITY_ID_H
+#define LPINTERFACE_ENTITY_ID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+
+namespace lpint {
+
+/**
+ * @brief Stable, opaque identifier of an entity in a linear program.
+ * Unlike positional indices, an id keeps referring to the same constraint
+ * or variable when other entities are removed, and is never reused within
+ * a single ILinearProgramHandle. The handle translates ids to positions
+ * in O(1).
+ *
+ * @tparam Tag Type distinguishing constraint ids from variable ids.
+ */
+template <class Tag>
+class EntityId {
+ public:
+  using ValueType = std::uint64_t;
+
+  EntityId() = default;
+  explicit EntityId(const ValueType value) : value_(value) {}
+
+  //! Return the raw value of the id.
+  ValueType value() const { return value_; }
+
+ private:
+  ValueType value_ = 0;
+};
+
+template <class Tag>
+bool operator==(const EntityId<Tag> left, const EntityId<Tag> right) {
+  return left.value() == right.value();
+}
+
+template <class Tag>
+bool operator!=(const EntityId<Tag> left, const EntityId<Tag> right) {
+  return !(left == right);
+}
+
+template <class Tag>
+bool operator<(const EntityId<Tag> left, const EntityId<Tag> right) {
+  return left.value() < right.value();
+}
+
+// LCOV_EXCL_START
+template <class Tag>
+std::ostream& operator<<(std::ostream& os, const EntityId<Tag> id) {
+  os << "Id { " << id.value() << " }";
+  return os;
+}
+// LCOV_EXCL_STOP
+
+namespace detail {
+struct ConstraintTag {};
+struct VariableTag {};
+}  // namespace detail
+
+//! Stable identifier of a constraint.
+using ConstraintId = EntityId<detail::ConstraintTag>;
+
+//! Stable identifier of a variable.
+using VariableId = EntityId<detail::VariableTag>;
+
+/**
+ * @brief Range of consecutive ids, as returned by a single call adding
+ * entities to a linear program. The k-th added entity has id
+ * operator[](k); the range itself stores only its first id and size.
+ */
+template <class Id>
+class IdRange {
+ public:
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Id;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Id*;
+    using reference = Id;
+
+    explicit const_iterator(const typename Id::ValueType value)
+        : value_(value) {}
+
+    Id operator*() const { return Id(value_); }
+
+    const_iterator& operator++() {
+      value_++;
+      return *this;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      return value_ == other.value_;
+    }
+
+    bool operator!=(const const_iterator& other) const {
+      return !(*this == other);
+    }
+
+   private:
+    typename Id::ValueType value_;
+  };
+
+  IdRange() = default;
+  IdRange(const Id first, const std::size_t size)
+      : first_(first), size_(size) {}
+
+  //! Return the id of the i-th entity in the range.
+  Id operator[](const std::size_t i) const {
+    return Id(first_.value() + static_cast<typename Id::ValueType>(i));
+  }
+
+  //! Return the number of ids in the range.
+  std::size_t size() const { return size_; }
+
+  //! Return whether the range is empty.
+  bool empty() const { return size_ == 0; }
+
+  const_iterator begin() const { return const_iterator(first_.value()); }
+
+  const_iterator end() const {
+    return const_iterator(first_.value() +
+                          static_cast<typename Id::ValueType>(size_));
+  }
+
+ private:
+  Id first_;
+  std::size_t size_ = 0;
+};
+
+using ConstraintIdRange = IdRange<ConstraintId>;
+using VariableIdRange = IdRange<VariableId>;
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_ENTITY_ID_H
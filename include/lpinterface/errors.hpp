@@ -125,6 +125,61 @@ class MismatchedDimensionsException : public LpException {
       : LpException("Array dimensions mismatched") {}
 };
 
+//! Attempt to pass a size or index to a backend that cannot represent it.
+class IndexOverflowException : public LpException {
+ public:
+  IndexOverflowException()
+      : LpException(
+            "Size or index exceeds the range supported by the backend") {}
+};
+
+//! Attempt to store a value in a type that cannot represent it exactly.
+class LossyConversionException : public LpException {
+ public:
+  LossyConversionException()
+      : LpException("Value is not exactly representable in the target type") {}
+};
+
+//! Attempt to modify a row of a ConstraintBatch that was not opened, or to
+//! open a row while another one is still open.
+class InvalidRowStateException : public LpException {
+ public:
+  InvalidRowStateException()
+      : LpException(
+            "Invalid row state; rows must be opened with begin_row() and "
+            "closed with end_row()") {}
+};
+
+//! Attempt to use the id of a constraint or variable that was removed,
+//! or that was never handed out by this linear program.
+class InvalidIdException : public LpException {
+ public:
+  InvalidIdException()
+      : LpException(
+            "Invalid id; was the constraint or variable it refers to "
+            "removed?") {}
+};
+
+//! Attempt to begin a transaction while another one is active, or to
+//! commit or roll back while no transaction is active.
+class InvalidTransactionStateException : public LpException {
+ public:
+  InvalidTransactionStateException()
+      : LpException(
+            "Invalid transaction state; transactions cannot be nested, and "
+            "commit() and rollback() require an active transaction") {}
+};
+
+//! Attempt to create a producer of a ConcurrentModelBuilder with an id
+//! whose blocks could be interleaved with those of another producer.
+class DuplicateProducerIdException : public LpException {
+ public:
+  DuplicateProducerIdException()
+      : LpException(
+            "Duplicate producer id; ids must be unique among the producers "
+            "whose blocks are collected together") {}
+};
+
 /// Enum class representing LP solution status.
 enum class Status : int {
   //! No Linear Program has been loaded.
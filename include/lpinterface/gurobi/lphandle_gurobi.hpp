@@ -3,12 +3,18 @@
 
 #include <cstddef>
 #include <memory>
+#include <numeric>
 #include <type_traits>
 #include <vector>
 
 #include "gurobi_c.h"
 
 #include "lpinterface/badge.hpp"
+#include "lpinterface/detail/id_map.hpp"
+#include "lpinterface/detail/model_cache.hpp"
+#include "lpinterface/detail/objective_support.hpp"
+#include "lpinterface/detail/transaction_log.hpp"
+#include "lpinterface/detail/util.hpp"
 #include "lpinterface/gurobi/lputil_gurobi.hpp"
 #include "lpinterface/lp.hpp"
 
@@ -29,31 +35,91 @@ class LinearProgramHandleGurobi : public ILinearProgramHandle {
 
   void set_objective_sense(const OptimizationType objsense) override;
 
+  // the id-based overloads of the interface
+  using ILinearProgramHandle::constraint;
+  using ILinearProgramHandle::begin_transaction;
+  using ILinearProgramHandle::constraints;
+  using ILinearProgramHandle::remove_constraint;
+  using ILinearProgramHandle::remove_variable;
+  using ILinearProgramHandle::set_constraint_bounds;
+  using ILinearProgramHandle::set_variable_bounds;
+  using ILinearProgramHandle::variable;
+
   Variable variable(std::size_t i) const override;
 
   std::vector<Variable> variables() const override;
 
-  void add_variables(const std::vector<Variable>& vars) override;
+  VariableBlock variable_block() const override;
+
+  VariableIdRange add_variables(const std::vector<Variable>& vars) override;
 
-  void add_variables(const std::size_t num_vars) override;
+  VariableIdRange add_variables(const VariableBlock& vars) override;
 
-  void add_constraints(
+  VariableIdRange add_variables(const std::size_t num_vars) override;
+
+  ConstraintIdRange add_constraints(
       const std::vector<Constraint<double>>& constraints) override;
 
+  ConstraintIdRange add_constraints(
+      const ConstraintBatch<double>& batch) override;
+
   void remove_variable(const std::size_t i) override;
 
   void remove_constraint(std::size_t i) override;
 
+  void set_variable_bounds(const std::size_t i, const double lower,
+                           const double upper) override;
+
+  void set_constraint_bounds(const std::size_t i, const double lower,
+                             const double upper) override;
+
+  void begin_transaction(const bool restore_basis) override;
+
+  void commit() override;
+
+  void rollback() override;
+
+  bool in_transaction() const override;
+
+  std::size_t position(const ConstraintId id) const override;
+
+  std::size_t position(const VariableId id) const override;
+
+  ConstraintId constraint_id(const std::size_t i) const override;
+
+  VariableId variable_id(const std::size_t i) const override;
+
   OptimizationType optimization_type() const override;
 
   void set_objective(const Objective<double>& objective) override;
 
+  void set_objective(const SparseObjective<double>& objective) override;
+
   virtual Constraint<double> constraint(std::size_t i) const override;
 
+  void read_constraint(std::size_t i,
+                       Constraint<double>& buffer) const override;
+
+  Column<double> column(std::size_t j) const override;
+
+  std::vector<Column<double>> columns() const override;
+
   std::vector<Constraint<double>> constraints() const override;
 
   Objective<double> objective() const override;
 
+  SparseObjective<double> sparse_objective() const override;
+
+  const std::vector<Constraint<double>>& cached_constraints() const override;
+
+  const Objective<double>& cached_objective() const override;
+
+  const std::vector<Variable>& cached_variables() const override;
+
+  void clear_cache() override;
+
+  void set_cache_enabled(bool enabled) override;
+
   std::shared_ptr<GRBmodel> gurobi_model(detail::Badge<GurobiSolver>) const;
   std::shared_ptr<GRBenv> gurobi_env(detail::Badge<GurobiSolver>) const;
 
@@ -63,12 +129,43 @@ class LinearProgramHandleGurobi : public ILinearProgramHandle {
   }
 
  private:
+  friend class detail::TransactionLog;
+
+  void append_constraints(const ConstraintBatch<double>& batch);
+  void delete_constraints_from(const std::size_t n);
+  void delete_variables_from(const std::size_t n);
+  // gurobi column index of the range variable of every constraint
+  std::vector<int> range_variables() const;
+
+  // undo primitives for rollback(); these do not record anything
+  void truncate_constraints(const std::size_t n);
+  void truncate_variables(const std::size_t n);
+  void insert_constraints(
+      const std::vector<detail::TransactionLog::RemovedConstraint>& removed);
+  void insert_variables(
+      const std::vector<detail::TransactionLog::RemovedVariable>& removed);
+
   std::shared_ptr<GRBenv> grb_env_;
   std::shared_ptr<GRBmodel> grb_model_;
 
   std::vector<double> upper_bounds;
   std::vector<double> lower_bounds;
 
+  detail::ObjectiveSupport objective_support_;
+
+  detail::IdMap<ConstraintId> constraint_ids_;
+  detail::IdMap<VariableId> variable_ids_;
+
+  mutable detail::ModelCache cache_;
+
+  detail::TransactionLog transaction_;
+  // basis at the start of the transaction; empty if the basis is not
+  // to be restored
+  std::vector<int> saved_vbasis_;
+  std::vector<int> saved_cbasis_;
+  // basis status of the range variable of every constraint
+  std::vector<int> saved_range_basis_;
+
   std::size_t num_vars_ = 0;
   std::size_t num_constraints_ = 0;
 };
@@ -0,0 +1,315 @@
+#ifndef LPINTERFACE_LINEXPR_H
+#define LPINTERFACE_LINEXPR_H
+
+#include <cstddef>
+#include <stdexcept>
+
+#include "common.hpp"
+#include "constraint_batch.hpp"
+
+namespace lpint {
+
+// Linear expressions are built as expression templates: every operator
+// below returns a small value type describing the shape of the expression,
+// and nothing is evaluated until the expression is written into a batch.
+// Each node provides
+//   template <class Sink> void emit(Sink& sink, double scale) const;
+//   double constant() const;
+// where emit() calls sink.accumulate(index, coefficient) once per term.
+// Nodes are held by value rather than by reference, since they are no
+// larger than a few doubles and the temporaries making up an expression
+// like 3*x[i] + y do not outlive the full expression.
+
+/**
+ * @brief Base class of all linear expression nodes.
+ *
+ * @tparam E Type of the derived expression.
+ */
+template <class E>
+class LinExpr {
+ public:
+  //! Get the derived expression.
+  const E& self() const { return static_cast<const E&>(*this); }
+};
+
+/**
+ * @brief Reference to a single variable of a linear program,
+ * usable as a term in a linear expression.
+ */
+class Var : public LinExpr<Var> {
+ public:
+  explicit Var(const int index) : index_(index) {}
+
+  //! Return the column index of the variable.
+  int index() const { return index_; }
+
+  template <class Sink>
+  void emit(Sink& sink, const double scale) const {
+    sink.accumulate(index_, scale);
+  }
+
+  double constant() const { return 0.0; }
+
+ private:
+  int index_;
+};
+
+/**
+ * @brief Contiguous range of variables, indexable like an array of Var.
+ */
+class VarRange {
+ public:
+  VarRange(const int first, const std::size_t size)
+      : first_(first), size_(size) {}
+
+  //! Return the i-th variable in the range.
+  Var operator[](const std::size_t i) const {
+#ifndef NDEBUG
+    if (i >= size_) {
+      throw std::out_of_range("Out of range access in VarRange");
+    }
+#endif
+    return Var(first_ + static_cast<int>(i));
+  }
+
+  //! Return the number of variables in the range.
+  std::size_t size() const { return size_; }
+
+ private:
+  int first_;
+  std::size_t size_;
+};
+
+/**
+ * @brief Constant term of a linear expression.
+ */
+class LinConstant : public LinExpr<LinConstant> {
+ public:
+  explicit LinConstant(const double value) : value_(value) {}
+
+  template <class Sink>
+  void emit(Sink&, const double) const {}
+
+  double constant() const { return value_; }
+
+ private:
+  double value_;
+};
+
+/**
+ * @brief Linear expression multiplied by a scalar.
+ */
+template <class E>
+class LinScaled : public LinExpr<LinScaled<E>> {
+ public:
+  LinScaled(const double factor, const E& expr)
+      : factor_(factor), expr_(expr) {}
+
+  template <class Sink>
+  void emit(Sink& sink, const double scale) const {
+    expr_.emit(sink, scale * factor_);
+  }
+
+  double constant() const { return factor_ * expr_.constant(); }
+
+ private:
+  double factor_;
+  E expr_;
+};
+
+/**
+ * @brief Sum of two linear expressions.
+ */
+template <class L, class R>
+class LinSum : public LinExpr<LinSum<L, R>> {
+ public:
+  LinSum(const L& lhs, const R& rhs) : lhs_(lhs), rhs_(rhs) {}
+
+  template <class Sink>
+  void emit(Sink& sink, const double scale) const {
+    lhs_.emit(sink, scale);
+    rhs_.emit(sink, scale);
+  }
+
+  double constant() const { return lhs_.constant() + rhs_.constant(); }
+
+ private:
+  L lhs_;
+  R rhs_;
+};
+
+/**
+ * @brief Sum of all variables in a range.
+ */
+class LinRangeSum : public LinExpr<LinRangeSum> {
+ public:
+  explicit LinRangeSum(const VarRange& range) : range_(range) {}
+
+  template <class Sink>
+  void emit(Sink& sink, const double scale) const {
+    for (std::size_t i = 0; i < range_.size(); i++) {
+      sink.accumulate(range_[i].index(), scale);
+    }
+  }
+
+  double constant() const { return 0.0; }
+
+ private:
+  VarRange range_;
+};
+
+//! Return the sum of all variables in a range.
+inline LinRangeSum sum(const VarRange& range) { return LinRangeSum(range); }
+
+template <class L, class R>
+LinSum<L, R> operator+(const LinExpr<L>& lhs, const LinExpr<R>& rhs) {
+  return LinSum<L, R>(lhs.self(), rhs.self());
+}
+
+template <class E>
+LinSum<E, LinConstant> operator+(const LinExpr<E>& lhs, const double rhs) {
+  return LinSum<E, LinConstant>(lhs.self(), LinConstant(rhs));
+}
+
+template <class E>
+LinSum<E, LinConstant> operator+(const double lhs, const LinExpr<E>& rhs) {
+  return rhs + lhs;
+}
+
+template <class E>
+LinScaled<E> operator*(const double lhs, const LinExpr<E>& rhs) {
+  return LinScaled<E>(lhs, rhs.self());
+}
+
+template <class E>
+LinScaled<E> operator*(const LinExpr<E>& lhs, const double rhs) {
+  return LinScaled<E>(rhs, lhs.self());
+}
+
+template <class E>
+LinScaled<E> operator/(const LinExpr<E>& lhs, const double rhs) {
+  return LinScaled<E>(1.0 / rhs, lhs.self());
+}
+
+template <class E>
+LinScaled<E> operator-(const LinExpr<E>& expr) {
+  return LinScaled<E>(-1.0, expr.self());
+}
+
+template <class L, class R>
+LinSum<L, LinScaled<R>> operator-(const LinExpr<L>& lhs,
+                                  const LinExpr<R>& rhs) {
+  return LinSum<L, LinScaled<R>>(lhs.self(), -rhs);
+}
+
+template <class E>
+LinSum<E, LinConstant> operator-(const LinExpr<E>& lhs, const double rhs) {
+  return lhs + (-rhs);
+}
+
+template <class E>
+LinSum<LinScaled<E>, LinConstant> operator-(const double lhs,
+                                            const LinExpr<E>& rhs) {
+  return -rhs + lhs;
+}
+
+/**
+ * @brief Linear constraint lower <= expr <= upper, produced by comparing
+ * a linear expression with a scalar or another expression.
+ * Constant terms of the expression are moved into the bounds.
+ */
+template <class E>
+struct LinConstraint {
+  LinConstraint(const E& e, const double lower, const double upper)
+      : expr(e),
+        lower_bound(lower - e.constant()),
+        upper_bound(upper - e.constant()) {}
+
+  E expr;
+  double lower_bound;
+  double upper_bound;
+};
+
+template <class E>
+LinConstraint<E> operator<=(const LinExpr<E>& lhs, const double rhs) {
+  return LinConstraint<E>(lhs.self(), -LPINT_INFINITY, rhs);
+}
+
+template <class E>
+LinConstraint<E> operator>=(const LinExpr<E>& lhs, const double rhs) {
+  return LinConstraint<E>(lhs.self(), rhs, LPINT_INFINITY);
+}
+
+template <class E>
+LinConstraint<E> operator==(const LinExpr<E>& lhs, const double rhs) {
+  return LinConstraint<E>(lhs.self(), rhs, rhs);
+}
+
+template <class E>
+LinConstraint<E> operator<=(const double lhs, const LinExpr<E>& rhs) {
+  return rhs >= lhs;
+}
+
+template <class E>
+LinConstraint<E> operator>=(const double lhs, const LinExpr<E>& rhs) {
+  return rhs <= lhs;
+}
+
+template <class E>
+LinConstraint<E> operator==(const double lhs, const LinExpr<E>& rhs) {
+  return rhs == lhs;
+}
+
+template <class L, class R>
+LinConstraint<LinSum<L, LinScaled<R>>> operator<=(const LinExpr<L>& lhs,
+                                                  const LinExpr<R>& rhs) {
+  return lhs - rhs <= 0.0;
+}
+
+template <class L, class R>
+LinConstraint<LinSum<L, LinScaled<R>>> operator>=(const LinExpr<L>& lhs,
+                                                  const LinExpr<R>& rhs) {
+  return lhs - rhs >= 0.0;
+}
+
+template <class L, class R>
+LinConstraint<LinSum<L, LinScaled<R>>> operator==(const LinExpr<L>& lhs,
+                                                  const LinExpr<R>& rhs) {
+  return lhs - rhs == 0.0;
+}
+
+//! Build the ranged constraint lower <= expr <= upper.
+template <class E>
+LinConstraint<E> ranged(const double lower, const LinExpr<E>& expr,
+                        const double upper) {
+  return LinConstraint<E>(expr.self(), lower, upper);
+}
+
+/**
+ * @brief Append a linear constraint to a batch as a single row.
+ * The terms of the expression are written straight into the batch's CSR
+ * arrays; repeated occurrences of a variable are merged into one entry,
+ * and variables whose terms cancel out are left out of the row.
+ *
+ * ~~~cpp
+ * ConstraintBatch<double> batch;
+ * VarRange x(0, n);
+ * Var y(n);
+ * add_row(batch, 3 * x[i] + 2 * x[j] - y <= 5);
+ * ~~~
+ *
+ * @param batch Batch to append the row to.
+ * @param constraint Constraint to append.
+ */
+template <class E>
+void add_row(ConstraintBatch<double>& batch,
+             const LinConstraint<E>& constraint) {
+  batch.begin_row(constraint.lower_bound, constraint.upper_bound);
+  constraint.expr.emit(batch, 1.0);
+  batch.drop_zeros();
+  batch.end_row();
+}
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_LINEXPR_H
@@ -3,9 +3,12 @@
 #define LPINTERFACE_LP_H
 
 #include <iostream>
+#include <stdexcept>
 #include <vector>
 
+#include "constraint_batch.hpp"
 #include "data_objects.hpp"
+#include "entity_id.hpp"
 #include "errors.hpp"
 
 #include "common.hpp"
@@ -86,6 +89,14 @@ class ILinearProgramHandle {
    */
   virtual Variable variable(std::size_t i) const = 0;
 
+  /**
+   * @brief Retrieve a variable by its id.
+   * Throws InvalidIdException if the variable was removed.
+   */
+  Variable variable(const VariableId id) const {
+    return variable(position(id));
+  }
+
   /**
    * @brief Retrieve the variables from the internal LP solver.
    *
@@ -93,26 +104,61 @@ class ILinearProgramHandle {
    */
   virtual std::vector<Variable> variables() const = 0;
 
+  /**
+   * @brief Retrieve the variables from the internal LP solver as a
+   * structure of arrays. The bounds are read from the backend in bulk,
+   * which makes this much cheaper than variables() for large LPs.
+   *
+   * @return VariableBlock Block containing the bounds of all variables.
+   */
+  virtual VariableBlock variable_block() const = 0;
+
   /**
    * @brief Add variables to the LP.
    *
    * @param vars Vector of variables to add.
+   * @return VariableIdRange Ids of the added variables.
    */
-  virtual void add_variables(const std::vector<Variable>& vars) = 0;
+  virtual VariableIdRange add_variables(const std::vector<Variable>& vars) = 0;
+
+  /**
+   * @brief Add a block of variables to the LP.
+   * The bound arrays of the block are handed to the backend in bulk.
+   *
+   * @param vars Block of variables to add.
+   * @return VariableIdRange Ids of the added variables.
+   */
+  virtual VariableIdRange add_variables(const VariableBlock& vars) = 0;
 
   /**
    * @brief Add num_vars non-negative variables to the LP.
    * To be called before settings the objective function.
+   *
+   * @return VariableIdRange Ids of the added variables.
    */
-  virtual void add_variables(const std::size_t num_vars) = 0;
+  virtual VariableIdRange add_variables(const std::size_t num_vars) = 0;
 
   /**
    * @brief Add a set of constraints to the LP formulation. This
    * can only be called after calling set_objective().
+   *
+   * @return ConstraintIdRange Ids of the added constraints.
    */
-  virtual void add_constraints(
+  virtual ConstraintIdRange add_constraints(
       const std::vector<Constraint<double>>& constraints) = 0;
 
+  /**
+   * @brief Add all rows of a ConstraintBatch to the LP formulation.
+   * The batch is handed to the backend in one bulk call where
+   * the backend supports it, which avoids the per-row overhead
+   * of add_constraints(const std::vector<Constraint<double>>&).
+   *
+   * @param batch Batch of constraints to add. All its rows must be closed.
+   * @return ConstraintIdRange Ids of the added constraints, in row order.
+   */
+  virtual ConstraintIdRange add_constraints(
+      const ConstraintBatch<double>& batch) = 0;
+
   /**
    * @brief Remove a constraint from the LP.
    *
@@ -120,6 +166,15 @@ class ILinearProgramHandle {
    */
   virtual void remove_constraint(const std::size_t i) = 0;
 
+  /**
+   * @brief Remove a constraint from the LP by its id.
+   * The ids of all other constraints remain valid.
+   * Throws InvalidIdException if the constraint was already removed.
+   */
+  void remove_constraint(const ConstraintId id) {
+    remove_constraint(position(id));
+  }
+
   /**
    * @brief Remove a variable from the LP.
    *
@@ -127,6 +182,99 @@ class ILinearProgramHandle {
    */
   virtual void remove_variable(const std::size_t i) = 0;
 
+  /**
+   * @brief Remove a variable from the LP by its id.
+   * The ids of all other variables remain valid.
+   * Throws InvalidIdException if the variable was already removed.
+   */
+  void remove_variable(const VariableId id) { remove_variable(position(id)); }
+
+  /**
+   * @brief Change the bounds of variable i.
+   * Throws InvalidVariableBoundsException if lower > upper.
+   */
+  virtual void set_variable_bounds(const std::size_t i, const double lower,
+                                   const double upper) = 0;
+
+  //! Change the bounds of the variable with the given id.
+  void set_variable_bounds(const VariableId id, const double lower,
+                           const double upper) {
+    set_variable_bounds(position(id), lower, upper);
+  }
+
+  /**
+   * @brief Change the bounds of constraint i, so that it reads
+   * lower <= a_i^T x <= upper.
+   */
+  virtual void set_constraint_bounds(const std::size_t i, const double lower,
+                                     const double upper) = 0;
+
+  //! Change the bounds of the constraint with the given id.
+  void set_constraint_bounds(const ConstraintId id, const double lower,
+                             const double upper) {
+    set_constraint_bounds(position(id), lower, upper);
+  }
+
+  /**
+   * @brief Start recording changes to the LP, so that they can be undone
+   * with rollback().
+   * All changes made through this handle until the next commit() or
+   * rollback() are recorded in a compact undo log: additions only record
+   * where they start, so undoing them is a single bulk removal, while
+   * removed entities and replaced objectives and bounds are stored so
+   * they can be put back. Ids of entities removed during the transaction
+   * are valid again after a rollback.
+   * Throws InvalidTransactionStateException if a transaction is active.
+   *
+   * @param restore_basis Whether rollback() should also restore the basis
+   * the backend holds at the start of the transaction, so that the next
+   * solve is warm started from the pre-transaction optimum. Ignored if the
+   * backend holds no basis.
+   */
+  virtual void begin_transaction(const bool restore_basis) = 0;
+
+  //! Start a transaction without restoring the basis on rollback.
+  void begin_transaction() { begin_transaction(false); }
+
+  /**
+   * @brief Keep all changes made since begin_transaction().
+   * Throws InvalidTransactionStateException if no transaction is active.
+   */
+  virtual void commit() = 0;
+
+  /**
+   * @brief Undo all changes made since begin_transaction().
+   * Throws InvalidTransactionStateException if no transaction is active.
+   */
+  virtual void rollback() = 0;
+
+  //! Return whether a transaction is active.
+  virtual bool in_transaction() const = 0;
+
+  /**
+   * @brief Get the current index of the constraint with the given id.
+   * This is an O(1) lookup.
+   * Throws InvalidIdException if the constraint was removed.
+   */
+  virtual std::size_t position(const ConstraintId id) const = 0;
+
+  /**
+   * @brief Get the current index of the variable with the given id.
+   * This is an O(1) lookup.
+   * Throws InvalidIdException if the variable was removed.
+   */
+  virtual std::size_t position(const VariableId id) const = 0;
+
+  /**
+   * @brief Get the id of the constraint at index i.
+   */
+  virtual ConstraintId constraint_id(const std::size_t i) const = 0;
+
+  /**
+   * @brief Get the id of the variable at index i.
+   */
+  virtual VariableId variable_id(const std::size_t i) const = 0;
+
   /**
    * @brief Retrieve the objective sense of this ILinearProgramHandle.
    * The Optimization type can be either OptimizationType::Minimize or
@@ -141,6 +289,17 @@ class ILinearProgramHandle {
    */
   virtual void set_objective(const Objective<double>& objective) = 0;
 
+  /**
+   * @brief Set the objective function from its nonzero coefficients.
+   * All coefficients not present in the sparse objective are set to zero.
+   * Only the given coefficients, and those which were nonzero before,
+   * are transferred to the backend, so the cost of this call does not
+   * depend on the number of variables in the LP.
+   * Throws MismatchedDimensionsException if an index is not a valid
+   * variable index.
+   */
+  virtual void set_objective(const SparseObjective<double>& objective) = 0;
+
   /**
    * @brief Retrieve constraint i of the internal LP.
    * This method requests a constraint from the internal LP
@@ -154,6 +313,48 @@ class ILinearProgramHandle {
    */
   virtual Constraint<double> constraint(std::size_t i) const = 0;
 
+  /**
+   * @brief Retrieve a constraint by its id.
+   * Throws InvalidIdException if the constraint was removed.
+   */
+  Constraint<double> constraint(const ConstraintId id) const {
+    return constraint(position(id));
+  }
+
+  /**
+   * @brief Read constraint i of the internal LP into an existing
+   * Constraint. The storage of the buffer's row is reused, so reading
+   * many constraints one after another through the same buffer does not
+   * allocate once the buffer has grown to the largest row. This is the
+   * primitive used by ConstraintCursor to stream constraints out of the
+   * backend in constant memory.
+   *
+   * @param i Index of constraint.
+   * @param buffer Constraint to overwrite with constraint i.
+   */
+  virtual void read_constraint(std::size_t i,
+                               Constraint<double>& buffer) const = 0;
+
+  /**
+   * @brief Retrieve column j of the constraint matrix, i.e. the
+   * coefficients of variable j in all constraints. The indices of the
+   * returned column are constraint indices. Backends answer this from
+   * their own column-wise storage, so this does not scan the rows.
+   *
+   * @param j Index of the variable.
+   * @return Column<double>
+   */
+  virtual Column<double> column(std::size_t j) const = 0;
+
+  /**
+   * @brief Retrieve all columns of the constraint matrix.
+   * Like constraints(), this copies the whole matrix out of the backend,
+   * and so should not be called in a loop.
+   *
+   * @return std::vector<Column<double>>
+   */
+  virtual std::vector<Column<double>> columns() const = 0;
+
   /**
    * @brief Retrieve the constraints of the internal LP.
    * This method requests the constraints from the internal LP
@@ -166,6 +367,28 @@ class ILinearProgramHandle {
    */
   virtual std::vector<Constraint<double>> constraints() const = 0;
 
+  /**
+   * @brief Retrieve the constraints with indices in [first, last) from
+   * the internal LP. Only the requested constraints are copied from the
+   * backend. Use ConstraintCursor to visit all constraints without
+   * materializing them at once.
+   * Throws std::out_of_range if the range is not contained in
+   * [0, num_constraints()).
+   *
+   * @return std::vector<Constraint<double>>
+   */
+  std::vector<Constraint<double>> constraints(const std::size_t first,
+                                              const std::size_t last) const {
+    if (first > last || last > num_constraints()) {
+      throw std::out_of_range("Out of range constraint range");
+    }
+    std::vector<Constraint<double>> constraints(last - first);
+    for (std::size_t i = first; i < last; i++) {
+      read_constraint(i, constraints[i - first]);
+    }
+    return constraints;
+  }
+
   /**
    * @brief Retrieve the objective function of the internal LP.
    * This method requests the objective function values from
@@ -177,6 +400,60 @@ class ILinearProgramHandle {
    * @return Objective<double>
    */
   virtual Objective<double> objective() const = 0;
+
+  /**
+   * @brief Retrieve the objective function of the internal LP in sparse
+   * form. Only the coefficients that may be nonzero are requested from
+   * the backend, so for LPs with few nonzero costs this is much cheaper
+   * than objective(). The result may contain explicit zeros.
+   *
+   * @return SparseObjective<double>
+   */
+  virtual SparseObjective<double> sparse_objective() const = 0;
+
+  /**
+   * @brief Retrieve the constraints of the internal LP through the
+   * handle's model cache. The constraints are copied from the backend on
+   * the first call only; later calls return the cached copy until the
+   * constraints are changed through this handle. The reference stays
+   * valid until the next call modifying the LP or clearing the cache.
+   *
+   * @return const std::vector<Constraint<double>>&
+   */
+  virtual const std::vector<Constraint<double>>& cached_constraints()
+      const = 0;
+
+  /**
+   * @brief Retrieve the objective function of the internal LP through
+   * the handle's model cache. See cached_constraints().
+   *
+   * @return const Objective<double>&
+   */
+  virtual const Objective<double>& cached_objective() const = 0;
+
+  /**
+   * @brief Retrieve the variables of the internal LP through the handle's
+   * model cache. See cached_constraints().
+   *
+   * @return const std::vector<Variable>&
+   */
+  virtual const std::vector<Variable>& cached_variables() const = 0;
+
+  /**
+   * @brief Drop all data held in the model cache, releasing its memory.
+   * The cache is repopulated by the next call to one of the cached
+   * accessors.
+   */
+  virtual void clear_cache() = 0;
+
+  /**
+   * @brief Turn the model cache on or off. It is on by default. Without
+   * it, the cached accessors copy the data from the backend on every
+   * call, and the returned reference is only valid until the next call.
+   * Handles that store the model themselves have no cache and ignore
+   * this.
+   */
+  virtual void set_cache_enabled(bool enabled) = 0;
 };
 
 }  // namespace lpint
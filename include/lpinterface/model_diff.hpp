@@ -0,0 +1,230 @@
+#ifndef LPINTERFACE_MODEL_DIFF_H
+#define LPINTERFACE_MODEL_DIFF_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "change_log.hpp"
+#include "data_objects.hpp"
+#include "lp.hpp"
+
+namespace lpint {
+
+//! New bounds of the entity at a position in the old model.
+struct BoundChange {
+  std::size_t position;
+  double lower;
+  double upper;
+};
+
+/**
+ * @brief Difference between two linear programs, as computed by diff().
+ * Positions of removed entities and of bound changes refer to the old
+ * model. Variables are matched by position, so variables are only ever
+ * removed from or added to the end of the model; rows of added
+ * constraints and objective entries refer to variable positions in the
+ * new model.
+ */
+struct ModelDiff {
+  std::vector<std::size_t> removed_constraints;
+  std::vector<Constraint<double>> added_constraints;
+  std::vector<BoundChange> constraint_bounds;
+
+  std::vector<std::size_t> removed_variables;
+  std::vector<Variable> added_variables;
+  std::vector<BoundChange> variable_bounds;
+
+  //! Changed objective coefficients of variables in both models.
+  std::vector<std::pair<std::size_t, double>> objective;
+  //! Objective coefficients of the added variables.
+  std::vector<double> added_objective;
+
+  bool sense_changed = false;
+  OptimizationType sense = OptimizationType::Maximize;
+
+  //! Return whether both models are equal.
+  bool empty() const {
+    return removed_constraints.empty() && added_constraints.empty() &&
+           constraint_bounds.empty() && removed_variables.empty() &&
+           added_variables.empty() && variable_bounds.empty() &&
+           objective.empty() && !sense_changed;
+  }
+
+  /**
+   * @brief Turn the old model into the new one with minimal edits.
+   * Only the differing entities are touched, so the backend keeps the
+   * basis of everything else and the next solve is warm started. Added
+   * constraints end up behind the unchanged ones, so the constraints of
+   * lp are those of the new model, but not necessarily in the same order.
+   *
+   * @param lp Linear program holding the old model.
+   */
+  void apply(ILinearProgramHandle& lp) const {
+    ChangeLog changes;
+    for (const auto i : removed_constraints) {
+      changes.remove_constraint(lp.constraint_id(i));
+    }
+    for (const auto& change : constraint_bounds) {
+      changes.set_constraint_bounds(lp.constraint_id(change.position),
+                                    change.lower, change.upper);
+    }
+    for (const auto& constraint : added_constraints) {
+      changes.add_constraint(Constraint<double>(
+          Row<double>(constraint.row.values(),
+                      constraint.row.nonzero_indices()),
+          constraint.lower_bound, constraint.upper_bound));
+    }
+    for (const auto j : removed_variables) {
+      changes.remove_variable(lp.variable_id(j));
+    }
+    for (const auto& change : variable_bounds) {
+      changes.set_variable_bounds(lp.variable_id(change.position),
+                                  change.lower, change.upper);
+    }
+    for (const auto& change : objective) {
+      changes.set_objective_coefficient(lp.variable_id(change.first),
+                                        change.second);
+    }
+    for (std::size_t k = 0; k < added_variables.size(); k++) {
+      changes.add_variable(added_variables[k], added_objective[k]);
+    }
+    changes.apply(lp);
+    if (sense_changed) {
+      lp.set_objective_sense(sense);
+    }
+  }
+};
+
+namespace detail {
+
+// signature of a row which does not depend on the order of its entries,
+// so that rows read back from backends storing them differently match
+inline std::size_t row_signature(const Row<double>& row) {
+  std::size_t signature = row.num_nonzero();
+  for (std::size_t k = 0; k < row.num_nonzero(); k++) {
+    std::uint64_t h = std::hash<double>()(row.values()[k]) * 31u +
+                      std::hash<int>()(row.nonzero_indices()[k]);
+    // mix the bits before summing, so that swapped values and indices of
+    // two entries do not cancel out
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    signature += static_cast<std::size_t>(h);
+  }
+  return signature;
+}
+
+inline std::vector<std::pair<int, double>> sorted_entries(
+    const Row<double>& row) {
+  std::vector<std::pair<int, double>> entries(row.num_nonzero());
+  for (std::size_t k = 0; k < entries.size(); k++) {
+    entries[k] = std::make_pair(row.nonzero_indices()[k], row.values()[k]);
+  }
+  std::sort(entries.begin(), entries.end());
+  return entries;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Compute the edits turning one linear program into another.
+ * Constraints are matched on their coefficients through a hash of each
+ * row, in O(nnz) expected time; a constraint whose coefficients changed
+ * is removed and added again, and a constraint whose bounds changed is
+ * kept with new bounds. Variables are matched by position.
+ *
+ * ~~~cpp
+ * const auto d = diff(solver.linear_program(), regenerated);
+ * d.apply(solver.linear_program());
+ * solver.solve();  // warm started from the previous basis
+ * ~~~
+ *
+ * @param old_lp Linear program to compute the edits for.
+ * @param new_lp Linear program the edits should produce.
+ * @return ModelDiff Edits turning old_lp into new_lp.
+ */
+inline ModelDiff diff(const ILinearProgramHandle& old_lp,
+                      const ILinearProgramHandle& new_lp) {
+  ModelDiff result;
+
+  const auto& old_vars = old_lp.cached_variables();
+  const auto& new_vars = new_lp.cached_variables();
+  const auto& old_obj = old_lp.cached_objective().values;
+  const auto& new_obj = new_lp.cached_objective().values;
+  const auto common = std::min(old_vars.size(), new_vars.size());
+  for (std::size_t j = 0; j < common; j++) {
+    if (!(old_vars[j] == new_vars[j])) {
+      result.variable_bounds.push_back(
+          {j, new_vars[j].lower(), new_vars[j].upper()});
+    }
+    if (old_obj[j] != new_obj[j]) {
+      result.objective.emplace_back(j, new_obj[j]);
+    }
+  }
+  for (auto j = common; j < old_vars.size(); j++) {
+    result.removed_variables.push_back(j);
+  }
+  for (auto j = common; j < new_vars.size(); j++) {
+    result.added_variables.push_back(new_vars[j]);
+    result.added_objective.push_back(new_obj[j]);
+  }
+  if (old_lp.optimization_type() != new_lp.optimization_type()) {
+    result.sense_changed = true;
+    result.sense = new_lp.optimization_type();
+  }
+
+  const auto& old_rows = old_lp.cached_constraints();
+  const auto& new_rows = new_lp.cached_constraints();
+  std::unordered_multimap<std::size_t, std::size_t> by_signature;
+  by_signature.reserve(old_rows.size());
+  for (std::size_t i = 0; i < old_rows.size(); i++) {
+    by_signature.emplace(detail::row_signature(old_rows[i].row), i);
+  }
+  std::vector<bool> matched(old_rows.size(), false);
+  for (const auto& constraint : new_rows) {
+    const auto candidates =
+        by_signature.equal_range(detail::row_signature(constraint.row));
+    auto match = candidates.second;
+    for (auto it = candidates.first; it != candidates.second; ++it) {
+      // equal signatures almost always mean equal rows, but hash
+      // collisions are possible, so the entries are compared
+      const auto& old_row = old_rows[it->second].row;
+      if (old_row.num_nonzero() == constraint.row.num_nonzero() &&
+          detail::sorted_entries(old_row) ==
+              detail::sorted_entries(constraint.row)) {
+        match = it;
+        break;
+      }
+    }
+    if (match == candidates.second) {
+      result.added_constraints.emplace_back(
+          Row<double>(constraint.row.values(),
+                      constraint.row.nonzero_indices()),
+          constraint.lower_bound, constraint.upper_bound);
+      continue;
+    }
+    const auto i = match->second;
+    matched[i] = true;
+    by_signature.erase(match);
+    if (old_rows[i].lower_bound != constraint.lower_bound ||
+        old_rows[i].upper_bound != constraint.upper_bound) {
+      result.constraint_bounds.push_back(
+          {i, constraint.lower_bound, constraint.upper_bound});
+    }
+  }
+  for (std::size_t i = 0; i < old_rows.size(); i++) {
+    if (!matched[i]) {
+      result.removed_constraints.push_back(i);
+    }
+  }
+  return result;
+}
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_MODEL_DIFF_H
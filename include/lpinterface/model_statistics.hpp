@@ -0,0 +1,134 @@
+#ifndef LPINTERFACE_MODEL_STATISTICS_H
+#define LPINTERFACE_MODEL_STATISTICS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "common.hpp"
+#include "detail/parallel.hpp"
+#include "lp.hpp"
+
+namespace lpint {
+
+/**
+ * @brief Size and shape of a linear program, as computed by
+ * analyze_model().
+ */
+struct ModelStatistics {
+  std::size_t num_rows = 0;
+  std::size_t num_columns = 0;
+  //! Number of nonzero entries of the constraint matrix.
+  std::size_t num_nonzero = 0;
+  //! Fraction of the entries of the constraint matrix that are nonzero.
+  double density = 0.0;
+  //! Smallest absolute value of a nonzero, or zero if there are none.
+  double min_coefficient = 0.0;
+  //! Largest absolute value of a nonzero, or zero if there are none.
+  double max_coefficient = 0.0;
+  //! Fraction of rows with two different finite bounds.
+  double ranged_fraction = 0.0;
+  //! Fraction of rows with equal bounds.
+  double equality_fraction = 0.0;
+  //! Fraction of rows with a single nonzero, which only bound a variable.
+  double bound_fraction = 0.0;
+
+  //! Ratio of the largest to the smallest coefficient, at least one.
+  double coefficient_range() const {
+    return min_coefficient > 0.0 ? max_coefficient / min_coefficient : 1.0;
+  }
+};
+
+/**
+ * @brief Compute the statistics of a linear program in one pass over its
+ * rows. The rows are split between threads, each of which keeps its own
+ * counts, and the counts are summed at the end.
+ *
+ * @param lp Linear program to analyze.
+ * @param max_threads Largest number of threads to use, or zero for the
+ * number of hardware threads. Small models use fewer.
+ */
+inline ModelStatistics analyze_model(const ILinearProgramHandle& lp,
+                                     const std::size_t max_threads = 0) {
+  struct Counts {
+    std::size_t nonzero = 0;
+    std::size_t ranged = 0;
+    std::size_t equality = 0;
+    std::size_t bound = 0;
+    double min_coefficient = LPINT_INFINITY;
+    double max_coefficient = 0.0;
+  };
+  static constexpr std::size_t min_rows_per_thread = 1 << 14;
+
+  const auto& constraints = lp.cached_constraints();
+  const auto nrows = constraints.size();
+  auto nthreads = detail::num_threads_for(nrows, min_rows_per_thread);
+  if (max_threads > 0) {
+    nthreads = std::min(nthreads, max_threads);
+  }
+  std::vector<Counts> counts(nthreads);
+  detail::run_parallel(nthreads, [&](const std::size_t t) {
+    auto& count = counts[t];
+    const auto end = detail::part_begin(nrows, nthreads, t + 1);
+    for (auto i = detail::part_begin(nrows, nthreads, t); i < end; i++) {
+      const auto& constraint = constraints[i];
+      std::size_t nonzero = 0;
+      for (const auto value : constraint.row.values()) {
+        const auto magnitude = std::abs(value);
+        if (magnitude > 0.0) {
+          nonzero++;
+          count.min_coefficient = std::min(count.min_coefficient, magnitude);
+          count.max_coefficient = std::max(count.max_coefficient, magnitude);
+        }
+      }
+      count.nonzero += nonzero;
+      const auto lower = constraint.lower_bound;
+      const auto upper = constraint.upper_bound;
+      if (lower == upper) {
+        count.equality++;
+      } else if (lower > -LPINT_INFINITY && upper < LPINT_INFINITY) {
+        count.ranged++;
+      }
+      if (nonzero == 1) {
+        count.bound++;
+      }
+    }
+  });
+
+  ModelStatistics statistics;
+  statistics.num_rows = nrows;
+  statistics.num_columns = lp.num_vars();
+  Counts total;
+  for (const auto& count : counts) {
+    total.nonzero += count.nonzero;
+    total.ranged += count.ranged;
+    total.equality += count.equality;
+    total.bound += count.bound;
+    total.min_coefficient =
+        std::min(total.min_coefficient, count.min_coefficient);
+    total.max_coefficient =
+        std::max(total.max_coefficient, count.max_coefficient);
+  }
+  statistics.num_nonzero = total.nonzero;
+  if (total.nonzero > 0) {
+    statistics.min_coefficient = total.min_coefficient;
+    statistics.max_coefficient = total.max_coefficient;
+  }
+  if (nrows > 0) {
+    const auto rows = static_cast<double>(nrows);
+    statistics.ranged_fraction = static_cast<double>(total.ranged) / rows;
+    statistics.equality_fraction = static_cast<double>(total.equality) / rows;
+    statistics.bound_fraction = static_cast<double>(total.bound) / rows;
+    if (statistics.num_columns > 0) {
+      statistics.density =
+          static_cast<double>(total.nonzero) /
+          (rows * static_cast<double>(statistics.num_columns));
+    }
+  }
+  return statistics;
+}
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_MODEL_STATISTICS_H
@@ -0,0 +1,538 @@
+#ifndef LPINTERFACE_BATCH_SMALL_H
+#define LPINTERFACE_BATCH_SMALL_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "lpinterface/common.hpp"
+#include "lpinterface/data_objects.hpp"
+#include "lpinterface/errors.hpp"
+#include "lpinterface/native/lpinterface_small.hpp"
+
+namespace lpint {
+
+/**
+ * @brief Solver for large batches of tiny linear programs of the same
+ * shape, such as one model solved with different data per customer.
+ * The problems are solved Lanes at a time by a dense bounded primal
+ * simplex method with the pivoting rules of SmallLpSolver, on tableaus
+ * that are interleaved entry by entry. Each problem chooses its own
+ * pivots, but all of them pivot in the same iteration: pricing, the ratio
+ * test and the tableau update loop over the lanes innermost, so they
+ * compile to vector instructions, and a problem that has finished or only
+ * flips a bound is masked out of the update by a zero pivot column.
+ *
+ * Only the nonbasic columns are stored, so the tableau has D columns
+ * whatever the number of constraints. A lane starts on the next problem
+ * of the batch as soon as its last one is finished, so problems that need
+ * many iterations do not hold up the others. Problems with fewer
+ * constraints than the largest one of the batch are padded with free
+ * zero rows.
+ *
+ * Supports Param::IterationLimit, which applies to each problem.
+ */
+template <std::size_t D, std::size_t MaxRows = 64, std::size_t Lanes = 8>
+class BatchSmallLpSolver {
+  static_assert(Lanes == 4 || Lanes == 8 || Lanes == 16,
+                "Lanes must be 4, 8 or 16");
+
+ public:
+  /**
+   * @brief Solve all problems.
+   *
+   * @return The solution of each problem, in order. Problems that were
+   * not solved to optimality get an empty solution; their status is
+   * given by statuses().
+   */
+  std::vector<Solution<double>> solve(
+      const std::vector<SmallLp<D, MaxRows>>& problems);
+
+  /**
+   * @brief Get the status of each problem of the last solve(): one of
+   * Status::Optimal, Status::Infeasible, Status::Unbounded,
+   * Status::IterationLimit or Status::NumericFailure.
+   */
+  const std::vector<Status>& statuses() const { return statuses_; }
+
+  //! Get the number of iterations done for each problem by the last solve().
+  const std::vector<std::size_t>& iterations() const { return iterations_; }
+
+  bool parameter_supported(const Param param) const {
+    return param == Param::IterationLimit;
+  }
+
+  void set_parameter(const Param param, const int value) {
+    if (!parameter_supported(param)) throw UnsupportedParameterException();
+    if (value < 0) throw FailedToSetParameterException();
+    iteration_limit_ = static_cast<std::size_t>(value);
+  }
+
+ private:
+  enum class State : char { AtLower, AtUpper, AtZero };
+
+  // Variables in one position of the tableau, a basic row or a nonbasic
+  // column, with one entry for the problem in each lane.
+  struct Position {
+    std::array<std::size_t, Lanes> variable;
+    std::array<double, Lanes> value;
+    std::array<double, Lanes> lower;
+    std::array<double, Lanes> upper;
+    std::array<double, Lanes> cost;
+    // nonbasic columns only
+    std::array<State, Lanes> state;
+  };
+
+  // T(r, k) of all lanes
+  double* entries(const std::size_t r, const std::size_t k) {
+    return &tableau_[(r * D + k) * Lanes];
+  }
+
+  // starts problem_[l] in lane l
+  void load(std::size_t l);
+  void compute_basic_values(std::size_t l);
+  // marks problem l as finished, storing its solution if it is optimal
+  void finish(std::size_t l, Status status);
+  // one simplex iteration of all problems that are still running
+  void iterate();
+  void price();
+  void ratio_test();
+  void pivot();
+
+  static constexpr double tolerance = 1e-9;
+  static constexpr double pivot_tolerance = 1e-9;
+  static constexpr std::size_t degenerate_limit = 20;
+
+  std::size_t num_rows_ = 0;
+
+  // tableau T with x_B = T x_N over the D structurals and one logical
+  // s = a^T x per row, holding Lanes consecutive entries per position
+  std::vector<double> tableau_;
+  std::vector<Position> basic_;
+  std::array<Position, D> nonbasic_;
+  std::vector<std::array<double, Lanes>> basic_cost_;
+  std::array<std::array<double, Lanes>, D> reduced_cost_;
+  // pivot column, and pivot row over the pivot, of the current
+  // iteration; both are zero in the lanes that do not pivot
+  std::vector<std::array<double, Lanes>> column_;
+  std::array<std::array<double, Lanes>, D> pivot_row_;
+
+  std::array<const SmallLp<D, MaxRows>*, Lanes> problem_{};
+  std::array<Solution<double>*, Lanes> solution_{};
+  std::array<Status*, Lanes> status_{};
+  std::array<std::size_t*, Lanes> iteration_count_{};
+  std::array<bool, Lanes> running_{};
+  std::array<bool, Lanes> phase_one_{};
+  std::array<bool, Lanes> bland_{};
+  std::array<std::size_t, Lanes> degenerate_{};
+  // entering column, or D if none, and the sign of its change
+  std::array<std::size_t, Lanes> entering_{};
+  std::array<double, Lanes> direction_{};
+  // leaving row, or num_rows_ for a bound flip, the bound it leaves at
+  // and the step length
+  std::array<std::size_t, Lanes> leaving_{};
+  std::array<bool, Lanes> leaves_upper_{};
+  std::array<double, Lanes> step_{};
+
+  std::vector<Status> statuses_;
+  std::vector<std::size_t> iterations_;
+  std::size_t iteration_limit_ = static_cast<std::size_t>(-1);
+};
+
+template <std::size_t D, std::size_t MaxRows, std::size_t Lanes>
+std::vector<Solution<double>> BatchSmallLpSolver<D, MaxRows, Lanes>::solve(
+    const std::vector<SmallLp<D, MaxRows>>& problems) {
+  std::vector<Solution<double>> solutions(problems.size());
+  statuses_.assign(problems.size(), Status::NoInformation);
+  iterations_.assign(problems.size(), 0);
+  num_rows_ = 0;
+  for (const auto& problem : problems) {
+    num_rows_ = std::max(num_rows_, problem.num_rows);
+  }
+
+  // lanes without a problem still take part in the arithmetic, so they
+  // hold an empty one
+  tableau_.assign(num_rows_ * D * Lanes, 0.0);
+  Position empty;
+  empty.variable.fill(0);
+  empty.value.fill(0.0);
+  empty.lower.fill(0.0);
+  empty.upper.fill(0.0);
+  empty.cost.fill(0.0);
+  empty.state.fill(State::AtLower);
+  basic_.assign(num_rows_, empty);
+  nonbasic_.fill(empty);
+  basic_cost_.resize(num_rows_);
+  column_.resize(num_rows_);
+  running_.fill(false);
+  phase_one_.fill(false);
+
+  // a lane takes the next problem as soon as its last one is finished
+  std::size_t next = 0;
+  while (true) {
+    for (std::size_t l = 0; l < Lanes && next < problems.size(); l++) {
+      if (!running_[l]) {
+        problem_[l] = &problems[next];
+        solution_[l] = &solutions[next];
+        status_[l] = &statuses_[next];
+        iteration_count_[l] = &iterations_[next];
+        load(l);
+        next++;
+      }
+    }
+    if (std::none_of(running_.begin(), running_.end(),
+                     [](const bool running) { return running; })) {
+      break;
+    }
+    iterate();
+  }
+  return solutions;
+}
+
+template <std::size_t D, std::size_t MaxRows, std::size_t Lanes>
+void BatchSmallLpSolver<D, MaxRows, Lanes>::load(const std::size_t l) {
+  const auto& problem = *problem_[l];
+  running_[l] = true;
+  degenerate_[l] = 0;
+  const double sign =
+      problem.sense == OptimizationType::Maximize ? -1.0 : 1.0;
+  for (std::size_t j = 0; j < D; j++) {
+    auto& position = nonbasic_[j];
+    position.variable[l] = j;
+    position.lower[l] = problem.lower[j];
+    position.upper[l] = problem.upper[j];
+    position.cost[l] = sign * problem.objective[j];
+    if (!std::isinf(problem.lower[j])) {
+      position.state[l] = State::AtLower;
+      position.value[l] = problem.lower[j];
+    } else if (!std::isinf(problem.upper[j])) {
+      position.state[l] = State::AtUpper;
+      position.value[l] = problem.upper[j];
+    } else {
+      position.state[l] = State::AtZero;
+      position.value[l] = 0.0;
+    }
+  }
+  // the logicals form the starting basis, so T = A; padding rows are
+  // zero with a free logical, which never leaves the basis
+  for (std::size_t r = 0; r < num_rows_; r++) {
+    const auto padding = r >= problem.num_rows;
+    auto& position = basic_[r];
+    position.variable[l] = D + r;
+    position.lower[l] = padding ? -LPINT_INFINITY : problem.row_lower[r];
+    position.upper[l] = padding ? LPINT_INFINITY : problem.row_upper[r];
+    position.cost[l] = 0.0;
+    for (std::size_t k = 0; k < D; k++) {
+      entries(r, k)[l] = padding ? 0.0 : problem.rows[r][k];
+    }
+  }
+  compute_basic_values(l);
+  phase_one_[l] = false;
+  for (const auto& position : basic_) {
+    if (position.value[l] < position.lower[l] - tolerance ||
+        position.value[l] > position.upper[l] + tolerance) {
+      phase_one_[l] = true;
+    }
+  }
+}
+
+template <std::size_t D, std::size_t MaxRows, std::size_t Lanes>
+void BatchSmallLpSolver<D, MaxRows, Lanes>::compute_basic_values(
+    const std::size_t l) {
+  for (std::size_t r = 0; r < num_rows_; r++) {
+    double value = 0.0;
+    for (std::size_t k = 0; k < D; k++) {
+      value += entries(r, k)[l] * nonbasic_[k].value[l];
+    }
+    basic_[r].value[l] = value;
+  }
+}
+
+template <std::size_t D, std::size_t MaxRows, std::size_t Lanes>
+void BatchSmallLpSolver<D, MaxRows, Lanes>::finish(const std::size_t l,
+                                                   const Status status) {
+  running_[l] = false;
+  *status_[l] = status;
+  if (status != Status::Optimal) {
+    return;
+  }
+
+  const auto& problem = *problem_[l];
+  auto& solution = *solution_[l];
+  compute_basic_values(l);
+  const double sign =
+      problem.sense == OptimizationType::Maximize ? -1.0 : 1.0;
+  solution.primal.resize(D);
+  for (const auto& position : basic_) {
+    if (position.variable[l] < D) {
+      solution.primal[position.variable[l]] = position.value[l];
+    }
+  }
+  // the dual of a row is the reduced cost of its logical variable, which
+  // is zero while the logical is basic; price() left the phase two reduced
+  // costs of the nonbasic columns behind
+  solution.dual.assign(problem.num_rows, 0.0);
+  for (std::size_t k = 0; k < D; k++) {
+    const auto j = nonbasic_[k].variable[l];
+    if (j < D) {
+      solution.primal[j] = nonbasic_[k].value[l];
+    } else if (j - D < problem.num_rows) {
+      solution.dual[j - D] = sign * reduced_cost_[k][l];
+    }
+  }
+  solution.objective_value = 0.0;
+  for (std::size_t j = 0; j < D; j++) {
+    solution.objective_value += problem.objective[j] * solution.primal[j];
+  }
+}
+
+template <std::size_t D, std::size_t MaxRows, std::size_t Lanes>
+void BatchSmallLpSolver<D, MaxRows, Lanes>::iterate() {
+  for (std::size_t l = 0; l < Lanes; l++) {
+    if (running_[l] && *iteration_count_[l] >= iteration_limit_) {
+      finish(l, Status::IterationLimit);
+    }
+    bland_[l] = degenerate_[l] >= degenerate_limit;
+  }
+
+  price();
+  for (std::size_t l = 0; l < Lanes; l++) {
+    if (!running_[l]) {
+      entering_[l] = D;
+    }
+    if (!running_[l] || entering_[l] != D) {
+      continue;
+    }
+    // no improving column: the problem is solved, or phase one is over
+    if (!phase_one_[l]) {
+      finish(l, Status::Optimal);
+      continue;
+    }
+    compute_basic_values(l);
+    phase_one_[l] = false;
+    degenerate_[l] = 0;
+    for (const auto& position : basic_) {
+      if (position.value[l] < position.lower[l] - tolerance ||
+          position.value[l] > position.upper[l] + tolerance) {
+        finish(l, Status::Infeasible);
+        break;
+      }
+    }
+  }
+
+  for (std::size_t r = 0; r < num_rows_; r++) {
+    for (std::size_t l = 0; l < Lanes; l++) {
+      column_[r][l] = entering_[l] != D ? entries(r, entering_[l])[l] : 0.0;
+    }
+  }
+  ratio_test();
+  pivot();
+}
+
+template <std::size_t D, std::size_t MaxRows, std::size_t Lanes>
+void BatchSmallLpSolver<D, MaxRows, Lanes>::price() {
+  // the basic costs are those of the objective, or in phase one the
+  // gradient of the sum of the bound violations
+  for (std::size_t r = 0; r < num_rows_; r++) {
+    const auto& position = basic_[r];
+    for (std::size_t l = 0; l < Lanes; l++) {
+      const auto violation =
+          position.value[l] < position.lower[l] - tolerance
+              ? -1.0
+              : (position.value[l] > position.upper[l] + tolerance ? 1.0
+                                                                   : 0.0);
+      basic_cost_[r][l] = phase_one_[l] ? violation : position.cost[l];
+    }
+  }
+
+  // reduced costs c_N + T^T c_B
+  for (std::size_t k = 0; k < D; k++) {
+    for (std::size_t l = 0; l < Lanes; l++) {
+      reduced_cost_[k][l] = phase_one_[l] ? 0.0 : nonbasic_[k].cost[l];
+    }
+  }
+  for (std::size_t r = 0; r < num_rows_; r++) {
+    for (std::size_t k = 0; k < D; k++) {
+      const auto* row = entries(r, k);
+      for (std::size_t l = 0; l < Lanes; l++) {
+        reduced_cost_[k][l] += basic_cost_[r][l] * row[l];
+      }
+    }
+  }
+
+  // the largest reduced cost, or under Bland's rule the eligible variable
+  // with the smallest index
+  std::array<double, Lanes> best;
+  best.fill(0.0);
+  entering_.fill(D);
+  for (std::size_t k = 0; k < D; k++) {
+    const auto& position = nonbasic_[k];
+    for (std::size_t l = 0; l < Lanes; l++) {
+      const auto reduced_cost = reduced_cost_[k][l];
+      const auto sign =
+          reduced_cost < -tolerance && position.state[l] != State::AtUpper
+              ? 1.0
+              : (reduced_cost > tolerance &&
+                         position.state[l] != State::AtLower
+                     ? -1.0
+                     : 0.0);
+      const auto score =
+          bland_[l] ? -static_cast<double>(position.variable[l]) - 1.0
+                    : std::abs(reduced_cost);
+      const auto eligible = sign != 0.0 &&
+                            position.lower[l] != position.upper[l] &&
+                            (entering_[l] == D || score > best[l]);
+      entering_[l] = eligible ? k : entering_[l];
+      direction_[l] = eligible ? sign : direction_[l];
+      best[l] = eligible ? score : best[l];
+    }
+  }
+}
+
+template <std::size_t D, std::size_t MaxRows, std::size_t Lanes>
+void BatchSmallLpSolver<D, MaxRows, Lanes>::ratio_test() {
+  // basic variable r changes by alpha_r per unit step; in phase one,
+  // infeasible variables block where they become feasible
+  std::array<double, Lanes> leaving_alpha;
+  std::array<std::size_t, Lanes> leaving_variable;
+  for (std::size_t l = 0; l < Lanes; l++) {
+    const auto& position = nonbasic_[entering_[l] != D ? entering_[l] : 0];
+    step_[l] = position.upper[l] - position.lower[l];
+    leaving_[l] = num_rows_;
+    leaves_upper_[l] = false;
+    leaving_alpha[l] = 0.0;
+    leaving_variable[l] = 0;
+  }
+  for (std::size_t r = 0; r < num_rows_; r++) {
+    const auto& position = basic_[r];
+    for (std::size_t l = 0; l < Lanes; l++) {
+      const auto alpha = direction_[l] * column_[r][l];
+      const auto value = position.value[l];
+      const auto below = value < position.lower[l] - tolerance;
+      const auto above = value > position.upper[l] + tolerance;
+      const auto upper = alpha > 0.0 ? !below : above;
+      const auto bound =
+          alpha > 0.0 ? (below ? position.lower[l]
+                               : (above ? LPINT_INFINITY : position.upper[l]))
+                      : (above ? position.upper[l]
+                               : (below ? -LPINT_INFINITY : position.lower[l]));
+      const auto ratio = std::max((bound - value) / alpha, 0.0);
+      const auto better =
+          leaving_[l] == num_rows_ || ratio < step_[l] - tolerance ||
+          (bland_[l] ? position.variable[l] < leaving_variable[l]
+                     : std::abs(alpha) > std::abs(leaving_alpha[l]));
+      const auto take = entering_[l] != D &&
+                        std::abs(alpha) > pivot_tolerance &&
+                        !std::isinf(bound) &&
+                        ratio <= step_[l] + tolerance && better;
+      step_[l] = take ? ratio : step_[l];
+      leaving_[l] = take ? r : leaving_[l];
+      leaves_upper_[l] = take ? upper : leaves_upper_[l];
+      leaving_alpha[l] = take ? alpha : leaving_alpha[l];
+      leaving_variable[l] = take ? position.variable[l] : leaving_variable[l];
+    }
+  }
+
+  for (std::size_t l = 0; l < Lanes; l++) {
+    if (entering_[l] == D) {
+      step_[l] = 0.0;
+      continue;
+    }
+    if (std::isinf(step_[l])) {
+      finish(l, phase_one_[l] ? Status::NumericFailure : Status::Unbounded);
+      entering_[l] = D;
+      leaving_[l] = num_rows_;
+      step_[l] = 0.0;
+      continue;
+    }
+    (*iteration_count_[l])++;
+    degenerate_[l] = step_[l] <= tolerance ? degenerate_[l] + 1 : 0;
+  }
+
+  // the basic variables move along the column
+  for (std::size_t r = 0; r < num_rows_; r++) {
+    auto& position = basic_[r];
+    for (std::size_t l = 0; l < Lanes; l++) {
+      position.value[l] += direction_[l] * step_[l] * column_[r][l];
+    }
+  }
+  for (std::size_t l = 0; l < Lanes; l++) {
+    if (entering_[l] == D) {
+      continue;
+    }
+    auto& position = nonbasic_[entering_[l]];
+    if (leaving_[l] != num_rows_) {
+      position.value[l] += direction_[l] * step_[l];
+      continue;
+    }
+    // bound flip
+    const auto to_upper = direction_[l] > 0.0;
+    position.state[l] = to_upper ? State::AtUpper : State::AtLower;
+    position.value[l] = to_upper ? position.upper[l] : position.lower[l];
+  }
+}
+
+template <std::size_t D, std::size_t MaxRows, std::size_t Lanes>
+void BatchSmallLpSolver<D, MaxRows, Lanes>::pivot() {
+  for (std::size_t l = 0; l < Lanes; l++) {
+    const auto pivots = entering_[l] != D && leaving_[l] != num_rows_;
+    if (!pivots) {
+      for (std::size_t r = 0; r < num_rows_; r++) {
+        column_[r][l] = 0.0;
+      }
+    }
+    for (std::size_t k = 0; k < D; k++) {
+      pivot_row_[k][l] =
+          pivots ? entries(leaving_[l], k)[l] / column_[leaving_[l]][l] : 0.0;
+    }
+  }
+
+  // T - column * pivot_row is the new tableau outside the pivot row and
+  // column
+  for (std::size_t r = 0; r < num_rows_; r++) {
+    const auto& column = column_[r];
+    if (std::all_of(column.begin(), column.end(),
+                    [](const double factor) { return factor == 0.0; })) {
+      continue;
+    }
+    for (std::size_t k = 0; k < D; k++) {
+      auto* row = entries(r, k);
+      for (std::size_t l = 0; l < Lanes; l++) {
+        row[l] -= column[l] * pivot_row_[k][l];
+      }
+    }
+  }
+
+  // exchange the entering and leaving variables
+  for (std::size_t l = 0; l < Lanes; l++) {
+    if (entering_[l] == D || leaving_[l] == num_rows_) {
+      continue;
+    }
+    const auto p = leaving_[l];
+    const auto q = entering_[l];
+    const auto pivot = column_[p][l];
+    for (std::size_t k = 0; k < D; k++) {
+      entries(p, k)[l] = -pivot_row_[k][l];
+    }
+    for (std::size_t r = 0; r < num_rows_; r++) {
+      entries(r, q)[l] = column_[r][l] / pivot;
+    }
+    entries(p, q)[l] = 1.0 / pivot;
+
+    auto& row = basic_[p];
+    auto& column = nonbasic_[q];
+    std::swap(row.variable[l], column.variable[l]);
+    std::swap(row.value[l], column.value[l]);
+    std::swap(row.lower[l], column.lower[l]);
+    std::swap(row.upper[l], column.upper[l]);
+    std::swap(row.cost[l], column.cost[l]);
+    column.state[l] = leaves_upper_[l] ? State::AtUpper : State::AtLower;
+    column.value[l] = leaves_upper_[l] ? column.upper[l] : column.lower[l];
+  }
+}
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_BATCH_SMALL_H
@@ -0,0 +1,58 @@
+#ifndef LPINTERFACE_COMPUTATIONAL_FORM_H
+#define LPINTERFACE_COMPUTATIONAL_FORM_H
+
+#include <cstddef>
+#include <vector>
+
+#include "lpinterface/lp.hpp"
+
+namespace lpint {
+
+namespace detail {
+
+/**
+ * @brief Linear program in the computational form used by the native
+ * solvers:
+ *
+ *     min c^T x  s.t.  A x - s = 0,  l <= (x, s) <= u,
+ *
+ * with one logical variable s per row, so that the row bounds become
+ * bounds on s. Variables are numbered with the columns of A first,
+ * followed by the logical variables.
+ */
+struct ComputationalForm {
+  std::size_t num_rows = 0;
+  std::size_t num_columns = 0;
+
+  // A in compressed column format
+  std::vector<std::size_t> column_starts{0};
+  std::vector<std::size_t> row_indices;
+  std::vector<double> values;
+
+  //! Costs of the columns of A; logical variables have zero cost.
+  std::vector<double> cost;
+  //! Bounds of all num_columns + num_rows variables.
+  std::vector<double> lower;
+  std::vector<double> upper;
+};
+
+/**
+ * @brief Convert a linear program to computational form.
+ * Maximization problems are turned into minimization problems by negating
+ * the objective, so duals and objective values computed for the result
+ * must be negated for them.
+ */
+ComputationalForm make_computational_form(const ILinearProgramHandle& lp);
+
+/**
+ * @brief Check that no variable of a model, logical ones included, has a
+ * lower bound above its upper bound by more than tolerance. A model
+ * failing this check is infeasible.
+ */
+bool bounds_consistent(const ComputationalForm& model, double tolerance);
+
+}  // namespace detail
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_COMPUTATIONAL_FORM_H
@@ -0,0 +1,130 @@
+#ifndef LPINTERFACE_DUAL_SIMPLEX_H
+#define LPINTERFACE_DUAL_SIMPLEX_H
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+#include "lpinterface/errors.hpp"
+#include "lpinterface/native/computational_form.hpp"
+#include "lpinterface/native/sparse_lu.hpp"
+
+namespace lpint {
+
+namespace detail {
+
+/// Position of a variable with respect to the basis.
+enum class BasisStatus : char {
+  Basic,
+  AtLower,
+  AtUpper,
+  //! Nonbasic free variable, at zero.
+  AtZero,
+};
+
+/**
+ * @brief Bounded dual simplex method.
+ * Every iteration picks the basic variable with the largest bound
+ * violation to leave the basis, and uses a bound-flipping ratio test:
+ * boxed variables whose breakpoints are passed are moved to their other
+ * bound instead of entering the basis, which allows long dual steps.
+ * Dual feasibility of the starting basis is established by solving an
+ * auxiliary problem with the same method, in which every variable is
+ * boxed. Costs are perturbed slightly while iterating, to avoid stalling
+ * on degenerate problems. The basis is kept in a SparseLU, which is
+ * refactorized periodically.
+ */
+class DualSimplex {
+ public:
+  explicit DualSimplex(ComputationalForm model);
+
+  /**
+   * @brief Set the starting basis.
+   * Throws MismatchedDimensionsException if the size does not match the
+   * number of variables. A basis that does not have exactly one basic
+   * variable per row, or that is singular, is repaired by making logical
+   * variables basic.
+   */
+  void set_basis(const std::vector<BasisStatus>& basis);
+
+  /**
+   * @brief Solve from the current basis.
+   *
+   * @param iteration_limit Maximum number of iterations.
+   * @param time_limit Maximum number of seconds.
+   * @return Status::Optimal, Status::Infeasible, Status::Unbounded,
+   * Status::IterationLimit or Status::TimeOut.
+   */
+  Status solve(std::size_t iteration_limit, double time_limit);
+
+  //! Get the values of all variables, including the logical ones.
+  const std::vector<double>& primal() const { return x_; }
+
+  //! Get the row duals y, satisfying c = A^T y + d.
+  std::vector<double> dual() const;
+
+  //! Get the basis status of all variables.
+  const std::vector<BasisStatus>& basis() const { return status_; }
+
+  //! Return the number of iterations done by the last solve().
+  std::size_t iterations() const { return iterations_; }
+
+ private:
+  enum class LoopResult {
+    Optimal,
+    Infeasible,
+    //! Dual feasibility was lost to numerical error.
+    DualInfeasible,
+    IterationLimit,
+    TimeOut,
+  };
+
+  // entries of column j of [A -I]
+  template <class F>
+  void for_each_entry(std::size_t j, F f) const;
+
+  void factorize();
+  void compute_primal();
+  void compute_dual();
+  // Moves boxed variables to the bound matching the sign of their reduced
+  // cost, and returns the number of remaining dual infeasibilities.
+  std::size_t fix_dual_infeasibilities(bool flip);
+  void reset_nonbasic_values();
+  double nonbasic_value(std::size_t j) const;
+
+  LoopResult iterate(std::size_t iteration_limit, double time_limit);
+  LoopResult iterate_perturbed(std::size_t iteration_limit,
+                               double time_limit);
+  LoopResult run_phase_one(std::size_t iteration_limit, double time_limit,
+                           bool& dual_infeasible);
+  Status to_status(LoopResult result) const;
+
+  bool time_exceeded(double time_limit) const;
+
+  ComputationalForm model_;
+  std::size_t num_vars_;
+  //! Costs of all variables, possibly perturbed.
+  std::vector<double> cost_;
+
+  // the same matrix in compressed row format, for computing pivot rows
+  std::vector<std::size_t> row_starts_;
+  std::vector<std::size_t> column_indices_;
+  std::vector<double> row_values_;
+
+  std::vector<BasisStatus> status_;
+  //! Variable at each basis position.
+  std::vector<std::size_t> basic_;
+  std::vector<double> x_;
+  std::vector<double> d_;
+
+  SparseLU lu_;
+
+  std::size_t iterations_ = 0;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace detail
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_DUAL_SIMPLEX_H
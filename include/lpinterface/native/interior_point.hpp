@@ -0,0 +1,111 @@
+#ifndef LPINTERFACE_INTERIOR_POINT_H
+#define LPINTERFACE_INTERIOR_POINT_H
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+#include "lpinterface/errors.hpp"
+#include "lpinterface/native/computational_form.hpp"
+#include "lpinterface/native/sparse_cholesky.hpp"
+
+namespace lpint {
+
+namespace detail {
+
+/**
+ * @brief Primal-dual interior point method with Mehrotra's
+ * predictor-corrector steps.
+ * Every finite bound l <= x or x <= u of the computational form gets a
+ * slack w >= 0 and a dual z >= 0, and the method follows the central path
+ * w z = mu towards mu = 0 from a starting point that need not be
+ * feasible. The Newton systems are reduced to the normal equations
+ *
+ *     A Theta A^T dy = r,
+ *
+ * which are solved with a SparseCholesky; the ordering and structure of
+ * the factor are computed once per solve. Free variables are given a
+ * small regularization, so that Theta stays bounded.
+ */
+class InteriorPoint {
+ public:
+  explicit InteriorPoint(ComputationalForm model);
+
+  /**
+   * @brief Solve the problem.
+   *
+   * @param iteration_limit Maximum number of iterations.
+   * @param time_limit Maximum number of seconds.
+   * @param nthreads Number of threads to use.
+   * @return Status::Optimal, Status::InfeasibleOrUnbounded if the
+   * iterates diverge or stall, Status::IterationLimit or Status::TimeOut.
+   */
+  Status solve(std::size_t iteration_limit, double time_limit,
+               std::size_t nthreads);
+
+  //! Get the values of all variables, including the logical ones.
+  const std::vector<double>& primal() const { return x_; }
+
+  //! Get the row duals y, satisfying c = A^T y + d.
+  const std::vector<double>& dual() const { return y_; }
+
+  //! Get the reduced costs d of all variables.
+  std::vector<double> reduced_costs() const;
+
+  //! Return the number of iterations done by the last solve().
+  std::size_t iterations() const { return iterations_; }
+
+ private:
+  struct Direction {
+    std::vector<double> x, y, wl, wu, zl, zu;
+  };
+
+  // A x and A^T y for the matrix [A -I] of all variables
+  void multiply(const std::vector<double>& x,
+                std::vector<double>& result) const;
+  void multiply_transposed(const std::vector<double>& y,
+                           std::vector<double>& result) const;
+
+  void starting_point(std::size_t normal_threads,
+                      std::size_t factor_threads);
+  void compute_residuals();
+  void form_normal_matrix(std::size_t nthreads);
+  // Solves the Newton system for the given complementarity right-hand
+  // sides, with the normal matrix already factored.
+  void solve_newton(const std::vector<double>& rcl,
+                    const std::vector<double>& rcu, Direction& dir) const;
+  void step_lengths(const Direction& dir, double& primal,
+                    double& dual) const;
+  double complementarity() const;
+
+  ComputationalForm model_;
+  std::size_t num_vars_;
+  std::vector<bool> has_lower_;
+  std::vector<bool> has_upper_;
+  std::size_t num_bounds_ = 0;
+
+  // the matrix by row, for forming the normal equations
+  std::vector<std::size_t> row_starts_;
+  std::vector<std::size_t> column_indices_;
+  std::vector<double> row_values_;
+
+  // iterate
+  std::vector<double> x_, y_, wl_, wu_, zl_, zu_;
+  // residuals of A x = 0, x - wl = l, x + wu = u and the dual equations
+  std::vector<double> rp_, rl_, ru_, rd_;
+  std::vector<double> theta_;
+
+  SparseCholesky cholesky_;
+  std::vector<double> normal_values_;
+  // threads for multiply() and multiply_transposed()
+  std::size_t product_threads_ = 1;
+
+  std::size_t iterations_ = 0;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace detail
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_INTERIOR_POINT_H
@@ -0,0 +1,151 @@
+#ifndef LPINTERFACE_LPHANDLE_NATIVE_H
+#define LPINTERFACE_LPHANDLE_NATIVE_H
+
+#include <cstddef>
+#include <vector>
+
+#include "lpinterface/data_objects.hpp"
+#include "lpinterface/detail/id_map.hpp"
+#include "lpinterface/detail/transaction_log.hpp"
+#include "lpinterface/lp.hpp"
+
+namespace lpint {
+
+/**
+ * @brief Linear program stored in memory, without a backend.
+ * The constraints are kept as rows, so reading the model back is a copy
+ * and the cached_* accessors return the stored data directly. This handle
+ * holds the original model for solvers that transform it before passing
+ * it on to a backend, and for the solvers implemented in this library.
+ */
+class LinearProgramHandleNative : public ILinearProgramHandle {
+ public:
+  LinearProgramHandleNative() = default;
+
+  explicit LinearProgramHandleNative(const OptimizationType sense)
+      : sense_(sense) {}
+
+  // the id-based overloads of the interface
+  using ILinearProgramHandle::constraint;
+  using ILinearProgramHandle::begin_transaction;
+  using ILinearProgramHandle::constraints;
+  using ILinearProgramHandle::remove_constraint;
+  using ILinearProgramHandle::remove_variable;
+  using ILinearProgramHandle::set_constraint_bounds;
+  using ILinearProgramHandle::set_variable_bounds;
+  using ILinearProgramHandle::variable;
+
+  Variable variable(std::size_t i) const override;
+
+  std::vector<Variable> variables() const override;
+
+  VariableBlock variable_block() const override;
+
+  VariableIdRange add_variables(const std::vector<Variable>& vars) override;
+
+  VariableIdRange add_variables(const VariableBlock& vars) override;
+
+  VariableIdRange add_variables(std::size_t num_vars) override;
+
+  ConstraintIdRange add_constraints(
+      const std::vector<Constraint<double>>& constraints) override;
+
+  ConstraintIdRange add_constraints(
+      const ConstraintBatch<double>& batch) override;
+
+  void remove_variable(const std::size_t i) override;
+
+  void remove_constraint(std::size_t i) override;
+
+  void set_variable_bounds(const std::size_t i, const double lower,
+                           const double upper) override;
+
+  void set_constraint_bounds(const std::size_t i, const double lower,
+                             const double upper) override;
+
+  /**
+   * @brief Start a transaction. There is no basis to restore, so
+   * restore_basis is ignored.
+   */
+  void begin_transaction(const bool restore_basis) override;
+
+  void commit() override;
+
+  void rollback() override;
+
+  bool in_transaction() const override;
+
+  std::size_t position(const ConstraintId id) const override;
+
+  std::size_t position(const VariableId id) const override;
+
+  ConstraintId constraint_id(const std::size_t i) const override;
+
+  VariableId variable_id(const std::size_t i) const override;
+
+  std::size_t num_vars() const override;
+
+  std::size_t num_constraints() const override;
+
+  void set_objective_sense(const OptimizationType objsense) override;
+
+  void set_objective(const Objective<double>& objective) override;
+
+  void set_objective(const SparseObjective<double>& objective) override;
+
+  OptimizationType optimization_type() const override;
+
+  Constraint<double> constraint(std::size_t i) const override;
+
+  void read_constraint(std::size_t i,
+                       Constraint<double>& buffer) const override;
+
+  Column<double> column(std::size_t j) const override;
+
+  std::vector<Column<double>> columns() const override;
+
+  std::vector<Constraint<double>> constraints() const override;
+
+  Objective<double> objective() const override;
+
+  SparseObjective<double> sparse_objective() const override;
+
+  const std::vector<Constraint<double>>& cached_constraints() const override;
+
+  const Objective<double>& cached_objective() const override;
+
+  const std::vector<Variable>& cached_variables() const override;
+
+  void clear_cache() override;
+
+  void set_cache_enabled(bool enabled) override;
+
+ private:
+  friend class detail::TransactionLog;
+
+  // undo primitives for rollback(); these do not record anything
+  void truncate_constraints(const std::size_t n);
+  void truncate_variables(const std::size_t n);
+  void insert_constraint(const std::size_t i, const Constraint<double>& c,
+                         const ConstraintId id);
+  void insert_constraints(
+      const std::vector<detail::TransactionLog::RemovedConstraint>& removed);
+  void insert_variables(
+      const std::vector<detail::TransactionLog::RemovedVariable>& removed);
+
+  void append_variables(const std::vector<Variable>& vars);
+
+  std::vector<Constraint<double>> constraints_;
+  std::vector<Variable> variables_;
+  Objective<double> objective_;
+  OptimizationType sense_ = OptimizationType::Maximize;
+
+  detail::IdMap<ConstraintId> constraint_ids_;
+  detail::IdMap<VariableId> variable_ids_;
+
+  detail::TransactionLog transaction_;
+};
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_LPHANDLE_NATIVE_H
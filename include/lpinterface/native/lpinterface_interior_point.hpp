@@ -0,0 +1,79 @@
+#ifndef LPINTERFACE_LPINTERFACE_INTERIOR_POINT_H
+#define LPINTERFACE_LPINTERFACE_INTERIOR_POINT_H
+
+#include <cstddef>
+
+#include "lpinterface/data_objects.hpp"
+#include "lpinterface/errors.hpp"
+#include "lpinterface/lp.hpp"
+#include "lpinterface/lpinterface.hpp"
+#include "lpinterface/native/lphandle_native.hpp"
+
+namespace lpint {
+
+/**
+ * @brief Solver backend implemented in this library, using a primal-dual
+ * interior point method with a multithreaded supernodal Cholesky
+ * factorization of the normal equations.
+ * Interior point methods need few iterations on large sparse problems, and
+ * most of their work is in the factorization, which scales with the number
+ * of threads. Their solutions lie in the interior of the optimal face, not
+ * at a vertex.
+ *
+ * With crossover enabled, the interior solution is used to pick a starting
+ * basis for the native dual simplex method, which then finishes with an
+ * optimal basic solution. This also settles the status of problems on
+ * which the interior point method diverges: without crossover those are
+ * reported as Status::InfeasibleOrUnbounded.
+ *
+ * Supports Param::Threads (zero uses all hardware threads),
+ * Param::Verbosity (no output is produced either way),
+ * Param::IterationLimit and Param::TimeLimit. The limits apply to the
+ * interior point and the simplex iterations together.
+ */
+class NativeInteriorPointSolver : public LinearProgramSolver {
+ public:
+  NativeInteriorPointSolver() = default;
+
+  explicit NativeInteriorPointSolver(OptimizationType optim_type,
+                                     bool crossover = false);
+
+  bool parameter_supported(const Param param) const override;
+
+  void set_parameter(const Param param, const int value) override;
+
+  void set_parameter(const Param param, const double value) override;
+
+  Status solve() override;
+
+  Status solution_status() const override;
+
+  const ILinearProgramHandle& linear_program() const override;
+
+  ILinearProgramHandle& linear_program() override;
+
+  const Solution<double>& get_solution() const override;
+
+  //! Return the number of interior point iterations of the last solve().
+  std::size_t iterations() const { return iterations_; }
+
+  //! Return the number of crossover simplex iterations of the last solve().
+  std::size_t crossover_iterations() const { return crossover_iterations_; }
+
+ private:
+  LinearProgramHandleNative lp_;
+  bool crossover_ = false;
+
+  Solution<double> solution_;
+  Status status_ = Status::NoInformation;
+  std::size_t iterations_ = 0;
+  std::size_t crossover_iterations_ = 0;
+
+  std::size_t nthreads_ = 0;
+  std::size_t iteration_limit_ = static_cast<std::size_t>(-1);
+  double time_limit_ = LPINT_INFINITY;
+};
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_LPINTERFACE_INTERIOR_POINT_H
@@ -0,0 +1,77 @@
+#ifndef LPINTERFACE_LPINTERFACE_PDHG_H
+#define LPINTERFACE_LPINTERFACE_PDHG_H
+
+#include <cstddef>
+
+#include "lpinterface/data_objects.hpp"
+#include "lpinterface/errors.hpp"
+#include "lpinterface/lp.hpp"
+#include "lpinterface/lpinterface.hpp"
+#include "lpinterface/native/lphandle_native.hpp"
+
+namespace lpint {
+
+/**
+ * @brief Solver backend implemented in this library, using the restarted
+ * primal-dual hybrid gradient method (as in PDLP).
+ * The method only multiplies with the constraint matrix and its transpose,
+ * so it needs memory for little more than the problem itself and can
+ * solve problems far too large to factorize. The products are split over
+ * threads. Solutions are accurate to a relative tolerance, given at
+ * construction, in the primal residual, dual residual and duality gap;
+ * achieved_tolerance() reports the value actually reached, also when a
+ * limit stopped the solve.
+ *
+ * Supports Param::Threads (zero uses all hardware threads),
+ * Param::Verbosity (no output is produced either way),
+ * Param::IterationLimit and Param::TimeLimit.
+ */
+class NativePdhgSolver : public LinearProgramSolver {
+ public:
+  NativePdhgSolver() = default;
+
+  explicit NativePdhgSolver(OptimizationType optim_type,
+                            double tolerance = 1e-6);
+
+  bool parameter_supported(const Param param) const override;
+
+  void set_parameter(const Param param, const int value) override;
+
+  void set_parameter(const Param param, const double value) override;
+
+  Status solve() override;
+
+  Status solution_status() const override;
+
+  const ILinearProgramHandle& linear_program() const override;
+
+  ILinearProgramHandle& linear_program() override;
+
+  const Solution<double>& get_solution() const override;
+
+  //! Return the number of iterations of the last solve().
+  std::size_t iterations() const { return iterations_; }
+
+  /**
+   * @brief Return the largest of the relative primal residual, dual
+   * residual and duality gap reached by the last solve().
+   */
+  double achieved_tolerance() const { return achieved_tolerance_; }
+
+ private:
+  LinearProgramHandleNative lp_;
+  double tolerance_ = 1e-6;
+
+  Solution<double> solution_;
+  Status status_ = Status::NoInformation;
+  std::size_t iterations_ = 0;
+  double achieved_tolerance_ = LPINT_INFINITY;
+
+  std::size_t nthreads_ = 0;
+  std::size_t iteration_limit_ = static_cast<std::size_t>(-1);
+  double time_limit_ = LPINT_INFINITY;
+};
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_LPINTERFACE_PDHG_H
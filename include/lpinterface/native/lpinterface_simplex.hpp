@@ -0,0 +1,81 @@
+#ifndef LPINTERFACE_LPINTERFACE_SIMPLEX_H
+#define LPINTERFACE_LPINTERFACE_SIMPLEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include "lpinterface/data_objects.hpp"
+#include "lpinterface/errors.hpp"
+#include "lpinterface/lp.hpp"
+#include "lpinterface/lpinterface.hpp"
+#include "lpinterface/native/dual_simplex.hpp"
+#include "lpinterface/native/lphandle_native.hpp"
+
+namespace lpint {
+
+/**
+ * @brief Solver backend implemented in this library, using a bounded dual
+ * simplex method on a sparse LU factorization of the basis.
+ * The final basis of every solve is kept per constraint and variable id,
+ * so that solving again after editing the model starts from the previous
+ * basis: entities that were added since start out nonbasic (variables) or
+ * with their logical variable basic (constraints). After changing bounds
+ * or adding constraints, the old basis usually stays dual feasible, and
+ * few iterations are needed.
+ *
+ * Models whose matrix is a network matrix, possibly after negating some
+ * rows, such as minimum cost flow and transportation problems, are solved
+ * by a network simplex method instead, which works on a spanning tree
+ * rather than a factorization. Its final basis is kept the same way.
+ *
+ * Supports Param::Verbosity (no output is produced either way),
+ * Param::IterationLimit and Param::TimeLimit.
+ */
+class NativeSimplexSolver : public LinearProgramSolver {
+ public:
+  NativeSimplexSolver() = default;
+
+  explicit NativeSimplexSolver(OptimizationType optim_type);
+
+  bool parameter_supported(const Param param) const override;
+
+  void set_parameter(const Param param, const int value) override;
+
+  void set_parameter(const Param param, const double value) override;
+
+  Status solve() override;
+
+  Status solution_status() const override;
+
+  const ILinearProgramHandle& linear_program() const override;
+
+  ILinearProgramHandle& linear_program() override;
+
+  const Solution<double>& get_solution() const override;
+
+  //! Return the number of simplex iterations done by the last solve().
+  std::size_t iterations() const { return iterations_; }
+
+  //! Return whether the last solve() used the network simplex method.
+  bool used_network_simplex() const { return used_network_simplex_; }
+
+ private:
+  LinearProgramHandleNative lp_;
+
+  Solution<double> solution_;
+  Status status_ = Status::NoInformation;
+  std::size_t iterations_ = 0;
+  bool used_network_simplex_ = false;
+
+  std::size_t iteration_limit_ = static_cast<std::size_t>(-1);
+  double time_limit_ = LPINT_INFINITY;
+
+  // basis of the last solve, by id value
+  std::unordered_map<std::uint64_t, detail::BasisStatus> variable_basis_;
+  std::unordered_map<std::uint64_t, detail::BasisStatus> constraint_basis_;
+};
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_LPINTERFACE_SIMPLEX_H
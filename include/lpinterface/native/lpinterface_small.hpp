@@ -0,0 +1,495 @@
+#ifndef LPINTERFACE_LPINTERFACE_SMALL_H
+#define LPINTERFACE_LPINTERFACE_SMALL_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+#include "lpinterface/common.hpp"
+#include "lpinterface/data_objects.hpp"
+#include "lpinterface/errors.hpp"
+#include "lpinterface/lp.hpp"
+#include "lpinterface/lpinterface.hpp"
+#include "lpinterface/native/lphandle_native.hpp"
+
+namespace lpint {
+
+/**
+ * @brief Linear program with at most D variables and MaxRows constraints,
+ * stored in fixed-size arrays:
+ *
+ *     min/max c^T x  s.t.  row_lower <= A x <= row_upper,
+ *                          lower <= x <= upper.
+ *
+ * Variables are non-negative by default, like Variable.
+ */
+template <std::size_t D, std::size_t MaxRows = 64>
+struct SmallLp {
+  SmallLp() { upper.fill(LPINT_INFINITY); }
+
+  /**
+   * @brief Append a constraint.
+   * Throws MismatchedDimensionsException if MaxRows constraints are
+   * already present.
+   */
+  void add_row(const std::array<double, D>& row, const double lower_bound,
+               const double upper_bound) {
+    if (num_rows == MaxRows) {
+      throw MismatchedDimensionsException();
+    }
+    rows[num_rows] = row;
+    row_lower[num_rows] = lower_bound;
+    row_upper[num_rows] = upper_bound;
+    num_rows++;
+  }
+
+  OptimizationType sense = OptimizationType::Minimize;
+  std::array<double, D> objective{};
+  std::array<double, D> lower{};
+  std::array<double, D> upper;
+  std::array<std::array<double, D>, MaxRows> rows{};
+  std::array<double, MaxRows> row_lower{};
+  std::array<double, MaxRows> row_upper{};
+  std::size_t num_rows = 0;
+};
+
+/**
+ * @brief Solver backend for tiny linear programs, with the dimensions
+ * fixed at compile time.
+ * Solving through a general backend costs far more than the arithmetic
+ * of a problem with a handful of variables. This solver runs a dense
+ * bounded primal simplex method on a tableau in fixed-size arrays, and
+ * does not allocate. Phase one minimizes the sum of the bound violations
+ * of the starting slack basis; Bland's rule takes over after a run of
+ * degenerate pivots, so the method cannot cycle.
+ *
+ * The direct interface, solve(const SmallLp&) with primal(), dual() and
+ * objective_value(), uses no virtual calls and no heap memory, and is
+ * meant for solving many problems in a loop with one solver. The
+ * LinearProgramSolver interface copies its linear program, which may have
+ * up to D variables and MaxRows constraints, into a SmallLp first.
+ *
+ * Supports Param::Verbosity (no output is produced either way) and
+ * Param::IterationLimit.
+ */
+template <std::size_t D, std::size_t MaxRows = 64>
+class SmallLpSolver : public LinearProgramSolver {
+ public:
+  SmallLpSolver() = default;
+
+  explicit SmallLpSolver(OptimizationType optim_type) : lp_(optim_type) {}
+
+  /**
+   * @brief Solve a problem given directly.
+   *
+   * @return Status::Optimal, Status::Infeasible, Status::Unbounded,
+   * Status::IterationLimit or Status::NumericFailure.
+   */
+  Status solve(const SmallLp<D, MaxRows>& problem);
+
+  //! Get the primal solution of the last solve(const SmallLp&).
+  const std::array<double, D>& primal() const { return primal_; }
+
+  //! Get the row duals of the last solve(const SmallLp&).
+  const std::array<double, MaxRows>& dual() const { return dual_; }
+
+  //! Get the objective value of the last solve(const SmallLp&).
+  double objective_value() const { return objective_value_; }
+
+  //! Return the number of iterations done by the last solve.
+  std::size_t iterations() const { return iterations_; }
+
+  bool parameter_supported(const Param param) const override {
+    return param == Param::Verbosity || param == Param::IterationLimit;
+  }
+
+  void set_parameter(const Param param, const int value) override {
+    if (!parameter_supported(param)) throw UnsupportedParameterException();
+    if (value < 0) throw FailedToSetParameterException();
+    if (param == Param::IterationLimit) {
+      iteration_limit_ = static_cast<std::size_t>(value);
+    }
+  }
+
+  void set_parameter(const Param param, const double value) override {
+    if (!parameter_supported(param)) throw UnsupportedParameterException();
+    if (value < 0.0) throw FailedToSetParameterException();
+    if (param == Param::IterationLimit) {
+      iteration_limit_ = static_cast<std::size_t>(value);
+    }
+  }
+
+  Status solve() override;
+
+  Status solution_status() const override { return status_; }
+
+  const ILinearProgramHandle& linear_program() const override { return lp_; }
+
+  ILinearProgramHandle& linear_program() override { return lp_; }
+
+  const Solution<double>& get_solution() const override {
+    if (status_ != Status::Optimal) {
+      throw ModelNotSolvedException();
+    }
+    return solution_;
+  }
+
+ private:
+  // columns: the D structural variables, then one logical per row
+  static constexpr std::size_t num_columns = D + MaxRows;
+
+  enum class State : char { Basic, AtLower, AtUpper, AtZero };
+
+  double& entry(const std::size_t r, const std::size_t j) {
+    return tableau_[r * num_columns + j];
+  }
+  double entry(const std::size_t r, const std::size_t j) const {
+    return tableau_[r * num_columns + j];
+  }
+
+  void load(const SmallLp<D, MaxRows>& problem);
+  void compute_basic_values();
+  bool infeasible(std::size_t j) const;
+  // one primal simplex iteration with the phase one or phase two costs;
+  // returns false when no improving column is left
+  bool iterate(bool phase_one, Status& failure);
+
+  // primal feasibility and optimality tolerance
+  static constexpr double tolerance = 1e-9;
+  // smallest tableau entry accepted as a pivot
+  static constexpr double pivot_tolerance = 1e-9;
+  // Bland's rule is used after this many degenerate pivots in a row
+  static constexpr std::size_t degenerate_limit = 20;
+
+  // tableau B^-1 [A -I] of the problem A x - s = 0
+  std::array<double, MaxRows * num_columns> tableau_;
+  std::array<std::size_t, MaxRows> basis_;
+  std::array<State, num_columns> state_;
+  std::array<double, num_columns> value_;
+  std::array<double, num_columns> lower_;
+  std::array<double, num_columns> upper_;
+  std::array<double, num_columns> cost_;
+  std::array<double, MaxRows> basic_cost_;
+  std::size_t num_rows_ = 0;
+  std::size_t degenerate_ = 0;
+
+  std::array<double, D> primal_{};
+  std::array<double, MaxRows> dual_{};
+  double objective_value_ = 0.0;
+  std::size_t iterations_ = 0;
+  std::size_t iteration_limit_ = static_cast<std::size_t>(-1);
+
+  LinearProgramHandleNative lp_;
+  SmallLp<D, MaxRows> problem_;
+  Solution<double> solution_;
+  Status status_ = Status::NoInformation;
+};
+
+template <std::size_t D, std::size_t MaxRows>
+void SmallLpSolver<D, MaxRows>::load(const SmallLp<D, MaxRows>& problem) {
+  num_rows_ = problem.num_rows;
+  const double sign =
+      problem.sense == OptimizationType::Maximize ? -1.0 : 1.0;
+  for (std::size_t j = 0; j < D; j++) {
+    cost_[j] = sign * problem.objective[j];
+    lower_[j] = problem.lower[j];
+    upper_[j] = problem.upper[j];
+  }
+  for (std::size_t r = 0; r < num_rows_; r++) {
+    cost_[D + r] = 0.0;
+    lower_[D + r] = problem.row_lower[r];
+    upper_[D + r] = problem.row_upper[r];
+  }
+
+  // the logicals form the starting basis, with B = -I, and the
+  // structural variables sit at one of their bounds
+  for (std::size_t r = 0; r < num_rows_; r++) {
+    for (std::size_t j = 0; j < D; j++) {
+      entry(r, j) = -problem.rows[r][j];
+    }
+    for (std::size_t k = 0; k < num_rows_; k++) {
+      entry(r, D + k) = r == k ? 1.0 : 0.0;
+    }
+    basis_[r] = D + r;
+    state_[D + r] = State::Basic;
+  }
+  for (std::size_t j = 0; j < D; j++) {
+    if (!std::isinf(lower_[j])) {
+      state_[j] = State::AtLower;
+      value_[j] = lower_[j];
+    } else if (!std::isinf(upper_[j])) {
+      state_[j] = State::AtUpper;
+      value_[j] = upper_[j];
+    } else {
+      state_[j] = State::AtZero;
+      value_[j] = 0.0;
+    }
+  }
+  compute_basic_values();
+}
+
+template <std::size_t D, std::size_t MaxRows>
+void SmallLpSolver<D, MaxRows>::compute_basic_values() {
+  // z_B = -B^-1 N z_N
+  for (std::size_t r = 0; r < num_rows_; r++) {
+    double value = 0.0;
+    for (std::size_t j = 0; j < D + num_rows_; j++) {
+      if (state_[j] != State::Basic) {
+        value -= entry(r, j) * value_[j];
+      }
+    }
+    value_[basis_[r]] = value;
+  }
+}
+
+template <std::size_t D, std::size_t MaxRows>
+bool SmallLpSolver<D, MaxRows>::infeasible(const std::size_t j) const {
+  return value_[j] < lower_[j] - tolerance ||
+         value_[j] > upper_[j] + tolerance;
+}
+
+template <std::size_t D, std::size_t MaxRows>
+bool SmallLpSolver<D, MaxRows>::iterate(const bool phase_one,
+                                        Status& failure) {
+  const auto num_vars = D + num_rows_;
+  for (std::size_t r = 0; r < num_rows_; r++) {
+    const auto j = basis_[r];
+    if (!phase_one) {
+      basic_cost_[r] = cost_[j];
+    } else if (value_[j] < lower_[j] - tolerance) {
+      basic_cost_[r] = -1.0;
+    } else if (value_[j] > upper_[j] + tolerance) {
+      basic_cost_[r] = 1.0;
+    } else {
+      basic_cost_[r] = 0.0;
+    }
+  }
+
+  // pricing: the largest reduced cost, or the first one under Bland's rule
+  const auto bland = degenerate_ >= degenerate_limit;
+  std::size_t entering = num_vars;
+  double direction = 0.0;
+  double best = 0.0;
+  for (std::size_t j = 0; j < num_vars; j++) {
+    if (state_[j] == State::Basic || lower_[j] == upper_[j]) {
+      continue;
+    }
+    double reduced_cost = phase_one ? 0.0 : cost_[j];
+    for (std::size_t r = 0; r < num_rows_; r++) {
+      reduced_cost -= basic_cost_[r] * entry(r, j);
+    }
+    double sign = 0.0;
+    if (reduced_cost < -tolerance && state_[j] != State::AtUpper) {
+      sign = 1.0;
+    } else if (reduced_cost > tolerance && state_[j] != State::AtLower) {
+      sign = -1.0;
+    }
+    if (sign != 0.0 && std::abs(reduced_cost) > best) {
+      entering = j;
+      direction = sign;
+      best = std::abs(reduced_cost);
+      if (bland) {
+        break;
+      }
+    }
+  }
+  if (entering == num_vars) {
+    return false;
+  }
+
+  // ratio test: basic variable r changes by alpha_r per unit step; in
+  // phase one, infeasible variables block where they become feasible
+  double step = upper_[entering] - lower_[entering];
+  std::size_t leaving = num_rows_;
+  State leaving_state = State::AtLower;
+  double leaving_alpha = 0.0;
+  for (std::size_t r = 0; r < num_rows_; r++) {
+    const auto alpha = -direction * entry(r, entering);
+    if (std::abs(alpha) <= pivot_tolerance) {
+      continue;
+    }
+    const auto j = basis_[r];
+    const auto value = value_[j];
+    double bound = LPINT_INFINITY;
+    State state = State::AtLower;
+    if (alpha > 0.0) {
+      if (value < lower_[j] - tolerance) {
+        bound = lower_[j];
+      } else if (value <= upper_[j] + tolerance) {
+        bound = upper_[j];
+        state = State::AtUpper;
+      }
+    } else {
+      if (value > upper_[j] + tolerance) {
+        bound = upper_[j];
+        state = State::AtUpper;
+      } else if (value >= lower_[j] - tolerance) {
+        bound = lower_[j];
+      }
+    }
+    if (std::isinf(bound)) {
+      continue;
+    }
+    const auto ratio = std::max((bound - value) / alpha, 0.0);
+    const auto better =
+        leaving == num_rows_ || ratio < step - tolerance ||
+        (ratio <= step + tolerance &&
+         (bland ? j < basis_[leaving]
+                : std::abs(alpha) > std::abs(leaving_alpha)));
+    if (ratio <= step + tolerance && better) {
+      step = ratio;
+      leaving = r;
+      leaving_state = state;
+      leaving_alpha = alpha;
+    }
+  }
+  if (std::isinf(step)) {
+    failure = phase_one ? Status::NumericFailure : Status::Unbounded;
+    return false;
+  }
+
+  degenerate_ = step <= tolerance ? degenerate_ + 1 : 0;
+  value_[entering] += direction * step;
+  for (std::size_t r = 0; r < num_rows_; r++) {
+    value_[basis_[r]] -= direction * step * entry(r, entering);
+  }
+  if (leaving == num_rows_) {
+    // bound flip
+    state_[entering] =
+        direction > 0.0 ? State::AtUpper : State::AtLower;
+    value_[entering] =
+        direction > 0.0 ? upper_[entering] : lower_[entering];
+    return true;
+  }
+
+  const auto left = basis_[leaving];
+  state_[left] = leaving_state;
+  value_[left] =
+      leaving_state == State::AtLower ? lower_[left] : upper_[left];
+  state_[entering] = State::Basic;
+  basis_[leaving] = entering;
+  const auto pivot = entry(leaving, entering);
+  for (std::size_t j = 0; j < num_vars; j++) {
+    entry(leaving, j) /= pivot;
+  }
+  for (std::size_t r = 0; r < num_rows_; r++) {
+    const auto factor = entry(r, entering);
+    if (r == leaving || factor == 0.0) {
+      continue;
+    }
+    for (std::size_t j = 0; j < num_vars; j++) {
+      entry(r, j) -= factor * entry(leaving, j);
+    }
+  }
+  return true;
+}
+
+template <std::size_t D, std::size_t MaxRows>
+Status SmallLpSolver<D, MaxRows>::solve(
+    const SmallLp<D, MaxRows>& problem) {
+  load(problem);
+  iterations_ = 0;
+  degenerate_ = 0;
+  Status failure = Status::Optimal;
+  bool phase_one = false;
+  for (std::size_t j = 0; j < D + num_rows_; j++) {
+    if (infeasible(j)) {
+      phase_one = true;
+    }
+  }
+
+  while (true) {
+    if (iterations_ >= iteration_limit_) {
+      return Status::IterationLimit;
+    }
+    if (iterate(phase_one, failure)) {
+      iterations_++;
+      continue;
+    }
+    if (failure != Status::Optimal) {
+      return failure;
+    }
+    if (!phase_one) {
+      break;
+    }
+    compute_basic_values();
+    for (std::size_t r = 0; r < num_rows_; r++) {
+      if (infeasible(basis_[r])) {
+        return Status::Infeasible;
+      }
+    }
+    phase_one = false;
+    degenerate_ = 0;
+  }
+
+  compute_basic_values();
+  const double sign =
+      problem.sense == OptimizationType::Maximize ? -1.0 : 1.0;
+  objective_value_ = 0.0;
+  for (std::size_t j = 0; j < D; j++) {
+    primal_[j] = value_[j];
+    objective_value_ += problem.objective[j] * value_[j];
+  }
+  // the dual of row r is the reduced cost of its logical variable
+  for (std::size_t r = 0; r < num_rows_; r++) {
+    basic_cost_[r] = cost_[basis_[r]];
+  }
+  for (std::size_t k = 0; k < num_rows_; k++) {
+    double reduced_cost = 0.0;
+    for (std::size_t r = 0; r < num_rows_; r++) {
+      reduced_cost -= basic_cost_[r] * entry(r, D + k);
+    }
+    dual_[k] = sign * reduced_cost;
+  }
+  return Status::Optimal;
+}
+
+template <std::size_t D, std::size_t MaxRows>
+Status SmallLpSolver<D, MaxRows>::solve() {
+  const auto& variables = lp_.cached_variables();
+  const auto& constraints = lp_.cached_constraints();
+  const auto& objective = lp_.cached_objective().values;
+  if (variables.size() > D || constraints.size() > MaxRows) {
+    throw MismatchedDimensionsException();
+  }
+
+  // unused variables are fixed at zero
+  problem_ = SmallLp<D, MaxRows>();
+  problem_.sense = lp_.optimization_type();
+  for (std::size_t j = 0; j < D; j++) {
+    if (j < variables.size()) {
+      problem_.lower[j] = variables[j].lower();
+      problem_.upper[j] = variables[j].upper();
+    } else {
+      problem_.upper[j] = 0.0;
+    }
+    problem_.objective[j] = j < objective.size() ? objective[j] : 0.0;
+  }
+  std::array<double, D> row;
+  for (const auto& constraint : constraints) {
+    row.fill(0.0);
+    const auto& indices = constraint.row.nonzero_indices();
+    const auto& values = constraint.row.values();
+    for (std::size_t k = 0; k < indices.size(); k++) {
+      row[static_cast<std::size_t>(indices[k])] = values[k];
+    }
+    problem_.add_row(row, constraint.lower_bound, constraint.upper_bound);
+  }
+
+  status_ = solve(problem_);
+  if (status_ == Status::Optimal) {
+    solution_.primal.assign(
+        primal_.begin(),
+        primal_.begin() + static_cast<std::ptrdiff_t>(variables.size()));
+    solution_.dual.assign(
+        dual_.begin(),
+        dual_.begin() + static_cast<std::ptrdiff_t>(constraints.size()));
+    solution_.objective_value = objective_value_;
+  }
+  return status_;
+}
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_LPINTERFACE_SMALL_H
@@ -0,0 +1,153 @@
+#ifndef LPINTERFACE_NETWORK_SIMPLEX_H
+#define LPINTERFACE_NETWORK_SIMPLEX_H
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+#include "lpinterface/errors.hpp"
+#include "lpinterface/native/computational_form.hpp"
+#include "lpinterface/native/dual_simplex.hpp"
+
+namespace lpint {
+
+namespace detail {
+
+/// Kind of network structure of a constraint matrix.
+enum class NetworkKind : char {
+  //! Some column has more than two entries.
+  None,
+  //! Every column has at most two entries, of any value. Such models
+  //! are solved by the dual simplex.
+  Generalized,
+  /**
+   * Every column has at most two entries, which are +1 or -1 and, after
+   * multiplying some rows by -1, of opposite sign when there are two.
+   */
+  Pure,
+};
+
+/// Network structure found by detect_network().
+struct NetworkStructure {
+  NetworkKind kind = NetworkKind::None;
+  //! For a pure network, the factor +1 or -1 of every row.
+  std::vector<double> row_signs;
+};
+
+/**
+ * @brief Detect whether the matrix of a model is the incidence matrix of a
+ * network, or of a generalized network with gains, possibly after
+ * reflecting some rows. The row signs are found by two-coloring the graph
+ * connecting the two rows of every column.
+ * Only pure networks are solved by NetworkSimplex; generalized networks
+ * are reported, but there is no generalized network simplex, so they are
+ * left to the dual simplex like any other model.
+ */
+NetworkStructure detect_network(const ComputationalForm& model);
+
+/**
+ * @brief Primal network simplex method for models with pure network
+ * structure.
+ * The reflected rows are nodes and every variable is an arc: a column
+ * joins its two rows, or its row and an extra root node, and the logical
+ * variable of a row joins it to the root, so that the model becomes a
+ * minimum cost circulation with bounds on the arcs. The basis is a
+ * spanning tree kept with parent pointers and child lists, with node
+ * potentials as the duals; after a pivot only the subtree that is moved
+ * is updated.
+ *
+ * The starting tree consists of artificial arcs between every node and
+ * the root, directed so that the tree is strongly feasible; phase one
+ * drives their flow to zero. Entering arcs are chosen by block search
+ * pricing, and ties in the ratio test are broken so that the tree stays
+ * strongly feasible, which prevents cycling.
+ */
+class NetworkSimplex {
+ public:
+  /**
+   * @brief Set up the network of a model.
+   * The structure must have been detected as NetworkKind::Pure for it.
+   */
+  NetworkSimplex(const ComputationalForm& model,
+                 const NetworkStructure& structure);
+
+  /**
+   * @brief Solve the problem.
+   *
+   * @param iteration_limit Maximum number of iterations.
+   * @param time_limit Maximum number of seconds.
+   * @return Status::Optimal, Status::Infeasible, Status::Unbounded,
+   * Status::IterationLimit or Status::TimeOut.
+   */
+  Status solve(std::size_t iteration_limit, double time_limit);
+
+  //! Get the values of all variables, including the logical ones.
+  std::vector<double> primal() const;
+
+  //! Get the row duals y, satisfying c = A^T y + d.
+  std::vector<double> dual() const;
+
+  //! Get the basis status of all variables, for starting DualSimplex.
+  std::vector<BasisStatus> basis() const;
+
+  //! Return the number of iterations done by the last solve().
+  std::size_t iterations() const { return iterations_; }
+
+ private:
+  enum class State : char { Tree, AtLower, AtUpper, AtZero };
+
+  enum class LoopResult { Optimal, Unbounded, IterationLimit, TimeOut };
+
+  LoopResult iterate(std::size_t iteration_limit, double time_limit);
+  // reduced cost of arc k
+  double reduced_cost(std::size_t k) const {
+    return cost_[k] + potential_[tail_[k]] - potential_[head_[k]];
+  }
+  // next eligible arc by block search, or num_arcs_ if there is none
+  std::size_t find_entering(double& direction);
+  // returns false if the cycle of the entering arc is unbounded
+  bool pivot(std::size_t entering, double direction);
+  void add_child(std::size_t parent, std::size_t child);
+  void remove_child(std::size_t parent, std::size_t child);
+  // depths and potentials of the subtree of node from those of its parent
+  void update_subtree(std::size_t node);
+  bool time_exceeded(double time_limit) const;
+
+  std::size_t num_rows_;
+  std::size_t num_columns_;
+  std::size_t num_nodes_;
+  std::size_t num_arcs_;
+  std::size_t root_;
+  std::vector<double> row_signs_;
+
+  // arcs: the columns, the logicals and one artificial arc per row
+  std::vector<std::size_t> tail_, head_;
+  std::vector<double> cost_, lower_, upper_, flow_;
+  std::vector<State> state_;
+  // phase two costs of all arcs
+  std::vector<double> original_cost_;
+  // reduced costs below this are taken as zero
+  double tolerance_ = 0.0;
+
+  // spanning tree
+  std::vector<std::size_t> parent_;
+  std::vector<std::size_t> parent_arc_;
+  std::vector<std::size_t> first_child_;
+  std::vector<std::size_t> next_sibling_;
+  std::vector<std::size_t> previous_sibling_;
+  std::vector<std::size_t> depth_;
+  std::vector<double> potential_;
+  std::vector<std::size_t> stack_;
+
+  std::size_t block_size_ = 1;
+  std::size_t next_arc_ = 0;
+
+  std::size_t iterations_ = 0;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace detail
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_NETWORK_SIMPLEX_H
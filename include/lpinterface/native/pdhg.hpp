@@ -0,0 +1,131 @@
+#ifndef LPINTERFACE_PDHG_H
+#define LPINTERFACE_PDHG_H
+
+#include <cstddef>
+#include <vector>
+
+#include "lpinterface/common.hpp"
+#include "lpinterface/errors.hpp"
+#include "lpinterface/native/computational_form.hpp"
+
+namespace lpint {
+
+namespace detail {
+
+/**
+ * @brief Restarted primal-dual hybrid gradient method for the saddle point
+ * problem
+ *
+ *     min_{l <= x <= u} max_y  c^T x - y^T A x + sum_i min(y_i a_i, y_i b_i)
+ *
+ * of the linear program min c^T x s.t. a <= A x <= b, l <= x <= u.
+ * The method only needs products with A and A^T, so its memory use is
+ * linear in the size of the problem, but it converges to a given
+ * tolerance rather than finishing at an exact vertex.
+ *
+ * The matrix is first equilibrated by Ruiz scaling followed by one
+ * Pock-Chambolle scaling. Step sizes are chosen adaptively, the primal
+ * weight balancing the primal and dual steps is updated at every restart,
+ * and the method restarts from the current or the average iterate when
+ * the KKT error has decreased enough since the last restart. Both products
+ * are split over threads by rows and columns respectively.
+ *
+ * Infeasibility and unboundedness are detected from the differences
+ * between the iterate and the last restart point or the previous iterate,
+ * which converge to a Farkas ray of the infeasible side when there is one.
+ */
+class Pdhg {
+ public:
+  explicit Pdhg(ComputationalForm model);
+
+  /**
+   * @brief Solve the problem.
+   *
+   * @param tolerance Relative primal residual, dual residual and duality
+   * gap at which the solution is accepted.
+   * @param iteration_limit Maximum number of iterations.
+   * @param time_limit Maximum number of seconds.
+   * @param nthreads Number of threads to use.
+   * @return Status::Optimal, Status::Infeasible, Status::Unbounded,
+   * Status::InfeasibleOrUnbounded if a primal ray is found before a
+   * feasible point, Status::IterationLimit or Status::TimeOut.
+   */
+  Status solve(double tolerance, std::size_t iteration_limit,
+               double time_limit, std::size_t nthreads);
+
+  //! Get the values of the columns of A.
+  const std::vector<double>& primal() const { return primal_; }
+
+  //! Get the row duals y, satisfying c = A^T y + d.
+  const std::vector<double>& dual() const { return dual_; }
+
+  /**
+   * @brief Return the largest of the relative primal residual, dual
+   * residual and duality gap of the solution found by the last solve().
+   */
+  double achieved_tolerance() const { return achieved_tolerance_; }
+
+  //! Return the number of iterations done by the last solve().
+  std::size_t iterations() const { return iterations_; }
+
+ private:
+  // Iterate in the scaled problem, with the products A x and A^T y.
+  struct Point {
+    std::vector<double> x, y, ax, aty;
+  };
+
+  // Residuals and objectives of a point in the unscaled problem.
+  struct Measures {
+    double primal_residual = 0.0;
+    double dual_residual = 0.0;
+    double primal_objective = 0.0;
+    double dual_objective = 0.0;
+  };
+
+  void scale();
+  void multiply(const std::vector<double>& x, std::vector<double>& result,
+                std::size_t nthreads) const;
+  // one step from current_ into next_, which are then swapped
+  void step(std::size_t nthreads);
+  Measures measure(const Point& point) const;
+  double relative_error(const Measures& measures) const;
+  double kkt_error(const Measures& measures) const;
+  bool primal_infeasible(const Point& from, const Point& to) const;
+  bool dual_infeasible(const Point& from, const Point& to) const;
+  void store_solution(const Point& point);
+
+  std::size_t m_;
+  std::size_t n_;
+
+  // scaled matrix by column and by row
+  std::vector<std::size_t> column_starts_;
+  std::vector<std::size_t> row_indices_;
+  std::vector<double> column_values_;
+  std::vector<std::size_t> row_starts_;
+  std::vector<std::size_t> column_indices_;
+  std::vector<double> row_values_;
+
+  // scaled data; the unscaled x is column_scale_ * x and the unscaled y
+  // is row_scale_ * y
+  std::vector<double> cost_;
+  std::vector<double> lower_, upper_;
+  std::vector<double> row_lower_, row_upper_;
+  std::vector<double> column_scale_, row_scale_;
+  double cost_norm_ = 0.0;
+  double bound_norm_ = 0.0;
+
+  Point current_, next_, sum_, average_, restart_;
+  double sum_weight_ = 0.0;
+  double step_size_ = 0.0;
+  double primal_weight_ = 1.0;
+
+  std::vector<double> primal_, dual_;
+  double achieved_tolerance_ = LPINT_INFINITY;
+  std::size_t iterations_ = 0;
+};
+
+}  // namespace detail
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_PDHG_H
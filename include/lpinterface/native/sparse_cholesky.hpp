@@ -0,0 +1,113 @@
+#ifndef LPINTERFACE_SPARSE_CHOLESKY_H
+#define LPINTERFACE_SPARSE_CHOLESKY_H
+
+#include <cstddef>
+#include <vector>
+
+namespace lpint {
+
+namespace detail {
+
+/**
+ * @brief Supernodal sparse Cholesky factorization L L^T of a symmetric
+ * positive definite matrix.
+ * analyze() orders the matrix by minimum degree to reduce fill, computes
+ * the structure of L and groups columns with the same structure into
+ * supernodes. factorize() can then be called for any values with that
+ * pattern. It uses the multifrontal method: every supernode assembles a
+ * dense frontal matrix from the original entries and the update matrices
+ * of its children, factors its own columns and passes the remaining
+ * Schur complement on to its parent.
+ *
+ * Independent subtrees of the supernode tree are factored concurrently;
+ * the large supernodes near the root, where the tree offers little
+ * parallelism, are factored one at a time with their Schur complement
+ * update split over all threads.
+ */
+class SparseCholesky {
+ public:
+  /**
+   * @brief Compute the ordering and the structure of the factor.
+   *
+   * @param size Dimension of the matrix.
+   * @param adjacency For every row, the columns of its off-diagonal
+   * nonzeros. Must be symmetric.
+   */
+  void analyze(std::size_t size,
+               const std::vector<std::vector<std::size_t>>& adjacency);
+
+  //! Return the position of every row in the elimination order.
+  const std::vector<std::size_t>& position() const { return position_; }
+
+  /**
+   * @brief Return the layout of the values passed to factorize(): the
+   * lower triangle of the reordered matrix by column, with the diagonal
+   * entry first in every column and the other rows in increasing order.
+   */
+  const std::vector<std::size_t>& matrix_starts() const {
+    return matrix_starts_;
+  }
+  const std::vector<std::size_t>& matrix_rows() const {
+    return matrix_rows_;
+  }
+
+  /**
+   * @brief Factorize the matrix with the given values.
+   * Pivots that are tiny relative to the diagonal of the matrix are
+   * replaced by a huge value, which drops the corresponding direction
+   * from the solution instead of failing.
+   *
+   * @param values Values in the layout of matrix_starts() and
+   * matrix_rows().
+   * @param nthreads Number of threads to use.
+   * @return The number of pivots that were replaced.
+   */
+  std::size_t factorize(const std::vector<double>& values,
+                        std::size_t nthreads);
+
+  //! Solve L L^T x = rhs in place, in the original ordering.
+  void solve(std::vector<double>& rhs) const;
+
+  //! Return the number of nonzeros in L.
+  std::size_t factor_nonzeros() const { return factor_nonzeros_; }
+
+ private:
+  struct Supernode {
+    std::size_t first_column;
+    std::size_t width;
+    //! Rows of the supernode's columns of L, starting with its columns.
+    std::vector<std::size_t> rows;
+    std::size_t parent;
+    std::vector<std::size_t> children;
+  };
+
+  // returns the number of replaced pivots
+  std::size_t factorize_supernode(std::size_t s,
+                                  const std::vector<double>& values,
+                                  std::vector<std::size_t>& local,
+                                  std::size_t nthreads);
+
+  std::size_t size_ = 0;
+  std::vector<std::size_t> position_;
+  std::vector<std::size_t> order_;
+
+  std::vector<std::size_t> matrix_starts_;
+  std::vector<std::size_t> matrix_rows_;
+
+  std::vector<Supernode> supernodes_;
+  //! Supernodes whose front is too large to be worth a thread of its own.
+  std::vector<bool> large_;
+  std::size_t factor_nonzeros_ = 0;
+
+  // dense columns of L for every supernode, column-major, and the pending
+  // Schur complement updates of the supernodes
+  std::vector<std::vector<double>> factor_;
+  std::vector<std::vector<double>> updates_;
+  double pivot_tolerance_ = 0.0;
+};
+
+}  // namespace detail
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_SPARSE_CHOLESKY_H
@@ -0,0 +1,103 @@
+#ifndef LPINTERFACE_SPARSE_LU_H
+#define LPINTERFACE_SPARSE_LU_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace lpint {
+
+namespace detail {
+
+/**
+ * @brief Sparse LU factorization of a simplex basis, with product-form
+ * updates.
+ * The factorization is computed by Gaussian elimination with Markowitz
+ * pivoting: among the sparsest columns, the pivot minimizing the
+ * Markowitz count (r - 1)(c - 1) is chosen, subject to a threshold on its
+ * magnitude relative to the largest entry of its column. Columns of the
+ * basis are identified by their position in the basis heading, rows by
+ * their constraint index.
+ *
+ * After a basis change, update() appends an eta matrix instead of
+ * refactorizing; callers should refactorize after a number of updates to
+ * bound the cost of the solves.
+ *
+ * The solves skip all work for zero entries of the partial results, so
+ * that sparse right-hand sides stay cheap.
+ */
+class SparseLU {
+ public:
+  //! Column of the basis, as (row, value) pairs.
+  using SparseColumn = std::vector<std::pair<std::size_t, double>>;
+
+  /**
+   * @brief Factorize a square matrix given by its columns.
+   * If the matrix is singular, the factorization covers the pivoted part
+   * only, and the positions of the columns that could not be pivoted are
+   * returned, each paired with a row that was not pivoted either. Replacing
+   * those columns by the unit columns of the paired rows (up to sign)
+   * gives a nonsingular matrix.
+   */
+  std::vector<std::pair<std::size_t, std::size_t>> factorize(
+      std::size_t size, const std::vector<SparseColumn>& columns);
+
+  /**
+   * @brief Solve B z = a in place.
+   * On input, rhs is indexed by row; on output, by basis position.
+   */
+  void ftran(std::vector<double>& rhs) const;
+
+  /**
+   * @brief Solve B^T y = e in place.
+   * On input, rhs is indexed by basis position; on output, by row.
+   */
+  void btran(std::vector<double>& rhs) const;
+
+  /**
+   * @brief Replace the column at a basis position.
+   *
+   * @param position Position of the replaced column.
+   * @param alpha Solution of B z = a for the new column a, as returned by
+   * ftran() before the update.
+   */
+  void update(std::size_t position, const std::vector<double>& alpha);
+
+  //! Return the number of updates since the last factorization.
+  std::size_t num_updates() const { return etas_.size(); }
+
+ private:
+  struct Eta {
+    std::size_t position;
+    double pivot;
+    //! Entries of the replacing column at all other positions.
+    SparseColumn column;
+  };
+
+  std::size_t size_ = 0;
+
+  // pivot k eliminated row pivot_row_[k] using column pivot_column_[k]
+  std::vector<std::size_t> pivot_row_;
+  std::vector<std::size_t> pivot_column_;
+  std::vector<double> pivot_value_;
+
+  // multipliers of elimination step k, as (row, multiplier) pairs, and
+  // the multipliers applied to the pivot row of step k, as (pivot row of
+  // the eliminating step, multiplier) pairs
+  std::vector<SparseColumn> lower_;
+  std::vector<SparseColumn> lower_rows_;
+  // off-diagonal entries of U by step, once as (column, value) pairs of
+  // the pivot row, and once as (row, value) pairs of the pivot column
+  std::vector<SparseColumn> upper_rows_;
+  std::vector<SparseColumn> upper_columns_;
+
+  std::vector<Eta> etas_;
+
+  mutable std::vector<double> work_;
+};
+
+}  // namespace detail
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_SPARSE_LU_H
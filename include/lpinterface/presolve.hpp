@@ -0,0 +1,686 @@
+#ifndef LPINTERFACE_PRESOLVE_H
+#define LPINTERFACE_PRESOLVE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common.hpp"
+#include "constraint_batch.hpp"
+#include "data_objects.hpp"
+#include "detail/parallel.hpp"
+#include "detail/parameter_log.hpp"
+#include "errors.hpp"
+#include "lp.hpp"
+#include "lpinterface.hpp"
+#include "native/lphandle_native.hpp"
+#include "parameter_type.hpp"
+
+namespace lpint {
+
+/// Kind of reduction applied by Presolver. \ingroup Enumerations
+enum class ReductionKind {
+  //! Column with equal bounds, substituted into the rows.
+  FixedColumn,
+  //! Row without nonzeros, or without finite bounds.
+  RemovedRow,
+  //! Row with a single nonzero, turned into bounds on its variable.
+  SingletonRow,
+  //! Row that is a multiple of another row, merged into that row.
+  ParallelRow,
+  //! Column whose optimal value is one of its bounds, fixed there.
+  DominatedColumn,
+};
+
+/**
+ * @brief Reduction on the postsolve stack of a Presolver.
+ * For singleton rows, column is the variable that received the bounds,
+ * value is the coefficient of the row, and lower and upper tell which
+ * variable bounds were tightened by the row. For parallel rows, column
+ * is the row that was kept, value is the factor by which the removed row
+ * is a multiple of it, and lower and upper tell which bounds of the kept
+ * row were tightened by the removed one.
+ */
+struct Reduction {
+  ReductionKind kind;
+  std::size_t row;
+  std::size_t column;
+  double value;
+  bool lower;
+  bool upper;
+};
+
+/**
+ * @brief Backend-independent presolve and postsolve.
+ * A Presolver copies a linear program and repeatedly applies cheap
+ * reductions to it until none applies anymore:
+ *
+ * - fixed columns are substituted into the row bounds;
+ * - empty rows and rows without finite bounds are dropped, after checking
+ *   that they are feasible;
+ * - singleton rows become bounds on their variable;
+ * - parallel rows, including duplicates, are found by hashing the rows
+ *   normalized by their first coefficient in parallel, and merged by
+ *   intersecting their bounds;
+ * - dominated columns, which can move towards a better objective without
+ *   ever violating a row, are fixed at that bound.
+ *
+ * The reduced model is loaded into a backend with load_reduced(), and
+ * postsolve() maps the backend's solution back to the original model by
+ * undoing the reductions in reverse order. Duals of removed rows are
+ * recovered from the reduced costs of the columns they bounded, or from
+ * the row they were merged into, so the duals returned are those of the
+ * original model, with the same sign convention as the backend.
+ */
+class Presolver {
+ public:
+  //! Absolute tolerance used to decide feasibility of removed rows.
+  static constexpr double tolerance() { return 1e-9; }
+
+  /**
+   * @brief Copy a linear program to presolve. Explicit zeros in the rows
+   * are dropped.
+   */
+  explicit Presolver(const ILinearProgramHandle& lp)
+      : sense_(lp.optimization_type()),
+        objective_(lp.cached_objective().values) {
+    const auto& variables = lp.cached_variables();
+    const auto& constraints = lp.cached_constraints();
+    const auto nvars = variables.size();
+    objective_.resize(nvars, 0.0);
+    for (const auto& var : variables) {
+      lower_.push_back(var.lower());
+      upper_.push_back(var.upper());
+    }
+    column_removed_.assign(nvars, false);
+    columns_.resize(nvars);
+
+    rows_.reserve(constraints.size());
+    for (std::size_t i = 0; i < constraints.size(); i++) {
+      const auto& row = constraints[i].row;
+      std::vector<std::pair<int, double>> entries;
+      for (std::size_t k = 0; k < row.num_nonzero(); k++) {
+        if (row.values()[k] != 0.0) {
+          entries.emplace_back(row.nonzero_indices()[k], row.values()[k]);
+        }
+      }
+      std::sort(entries.begin(), entries.end());
+      Row<double> sorted;
+      for (const auto& entry : entries) {
+        const auto j = static_cast<std::size_t>(entry.first);
+        sorted.nonzero_indices().push_back(entry.first);
+        sorted.values().push_back(entry.second);
+        columns_[j].nonzero_indices().push_back(static_cast<int>(i));
+        columns_[j].values().push_back(entry.second);
+      }
+      row_size_.push_back(entries.size());
+      rows_.push_back(std::move(sorted));
+      row_lower_.push_back(constraints[i].lower_bound);
+      row_upper_.push_back(constraints[i].upper_bound);
+    }
+    row_removed_.assign(rows_.size(), false);
+  }
+
+  /**
+   * @brief Apply reductions until none applies anymore.
+   *
+   * @param nthreads Number of threads used to hash the rows, or zero to
+   * choose automatically based on the number of nonzeros.
+   * @return Status::Infeasible or Status::InfeasibleOrUnbounded if the
+   * reductions proved so, Status::Optimal if they removed the entire
+   * model, and Status::NoInformation if a reduced model is left to solve.
+   */
+  Status presolve(const std::size_t nthreads = 0) {
+    status_ = Status::NoInformation;
+    bool changed = true;
+    while (changed && status_ == Status::NoInformation) {
+      changed = remove_fixed_columns();
+      changed = remove_empty_rows() || changed;
+      changed = remove_singleton_rows() || changed;
+      if (status_ == Status::NoInformation) {
+        changed = remove_parallel_rows(nthreads) || changed;
+      }
+      if (status_ == Status::NoInformation) {
+        changed = remove_dominated_columns() || changed;
+      }
+    }
+    if (status_ == Status::NoInformation && num_reduced_vars() == 0 &&
+        num_reduced_constraints() == 0) {
+      status_ = Status::Optimal;
+    }
+    return status_;
+  }
+
+  //! Get the reductions applied so far, in the order they were applied.
+  const std::vector<Reduction>& reductions() const { return reductions_; }
+
+  //! Return the number of variables left in the reduced model.
+  std::size_t num_reduced_vars() const {
+    return static_cast<std::size_t>(
+        std::count(column_removed_.begin(), column_removed_.end(), false));
+  }
+
+  //! Return the number of constraints left in the reduced model.
+  std::size_t num_reduced_constraints() const {
+    return static_cast<std::size_t>(
+        std::count(row_removed_.begin(), row_removed_.end(), false));
+  }
+
+  /**
+   * @brief Load the reduced model into an empty linear program.
+   * Variables and rows keep their relative order.
+   */
+  void load_reduced(ILinearProgramHandle& lp) const {
+    lp.set_objective_sense(sense_);
+    std::vector<int> position(column_removed_.size(), -1);
+    std::vector<Variable> variables;
+    std::vector<double> objective;
+    for (std::size_t j = 0; j < column_removed_.size(); j++) {
+      if (!column_removed_[j]) {
+        position[j] = static_cast<int>(variables.size());
+        variables.emplace_back(lower_[j], upper_[j]);
+        objective.push_back(objective_[j]);
+      }
+    }
+    if (variables.empty()) {
+      return;
+    }
+    lp.add_variables(variables);
+    lp.set_objective(Objective<double>(std::move(objective)));
+
+    ConstraintBatch<double> batch;
+    for (std::size_t i = 0; i < rows_.size(); i++) {
+      if (row_removed_[i]) {
+        continue;
+      }
+      batch.begin_row(row_lower_[i], row_upper_[i]);
+      const auto& row = rows_[i];
+      for (std::size_t k = 0; k < row.num_nonzero(); k++) {
+        const auto j = static_cast<std::size_t>(row.nonzero_indices()[k]);
+        if (!column_removed_[j]) {
+          batch.push(position[j], row.values()[k]);
+        }
+      }
+      batch.end_row();
+    }
+    if (!batch.empty()) {
+      lp.add_constraints(batch);
+    }
+  }
+
+  /**
+   * @brief Map a solution of the reduced model to the original model.
+   * The objective value is recomputed from the original objective.
+   */
+  Solution<double> postsolve(const Solution<double>& reduced) const {
+    if (reduced.primal.size() != num_reduced_vars() ||
+        reduced.dual.size() != num_reduced_constraints()) {
+      throw MismatchedDimensionsException();
+    }
+    Solution<double> solution;
+    solution.primal.resize(column_removed_.size());
+    std::size_t k = 0;
+    for (std::size_t j = 0; j < column_removed_.size(); j++) {
+      // removed columns are always fixed
+      solution.primal[j] = column_removed_[j] ? lower_[j] : reduced.primal[k++];
+    }
+    solution.dual.assign(rows_.size(), 0.0);
+    k = 0;
+    for (std::size_t i = 0; i < rows_.size(); i++) {
+      if (!row_removed_[i]) {
+        solution.dual[i] = reduced.dual[k++];
+      }
+    }
+
+    // rows removed earlier than a reduction still have zero duals when the
+    // reduction is undone, as they were not part of the model at that time
+    auto& dual = solution.dual;
+    for (auto it = reductions_.rbegin(); it != reductions_.rend(); ++it) {
+      if (it->kind == ReductionKind::SingletonRow) {
+        const auto& col = columns_[it->column];
+        double reduced_cost = objective_[it->column];
+        for (std::size_t e = 0; e < col.num_nonzero(); e++) {
+          reduced_cost -=
+              col.values()[e] *
+              dual[static_cast<std::size_t>(col.nonzero_indices()[e])];
+        }
+        // the variable sits at the bound its reduced cost pushes it to;
+        // if that bound came from the row, the row takes the reduced cost
+        const auto toward_lower = minimization_sign() * reduced_cost;
+        if ((toward_lower > 0.0 && it->lower) ||
+            (toward_lower < 0.0 && it->upper)) {
+          dual[it->row] = reduced_cost / it->value;
+        }
+      } else if (it->kind == ReductionKind::ParallelRow) {
+        const auto toward_lower = minimization_sign() * dual[it->column];
+        if ((toward_lower > 0.0 && it->lower) ||
+            (toward_lower < 0.0 && it->upper)) {
+          dual[it->row] = dual[it->column] / it->value;
+          dual[it->column] = 0.0;
+        }
+      }
+    }
+
+    solution.objective_value = 0.0;
+    for (std::size_t j = 0; j < objective_.size(); j++) {
+      solution.objective_value += objective_[j] * solution.primal[j];
+    }
+    return solution;
+  }
+
+ private:
+  static constexpr std::size_t min_nonzeros_per_thread = 1 << 16;
+
+  // +1 when minimizing, -1 when maximizing, so that multiplying a reduced
+  // cost or row dual with it gives a value that is positive when the
+  // lower bound is the one that is active
+  double minimization_sign() const {
+    return sense_ == OptimizationType::Minimize ? 1.0 : -1.0;
+  }
+
+  void remove_row(const std::size_t i) { row_removed_[i] = true; }
+
+  bool remove_fixed_columns() {
+    bool changed = false;
+    for (std::size_t j = 0; j < column_removed_.size(); j++) {
+      if (column_removed_[j] || lower_[j] != upper_[j]) {
+        continue;
+      }
+      const auto value = lower_[j];
+      const auto& col = columns_[j];
+      for (std::size_t k = 0; k < col.num_nonzero(); k++) {
+        const auto i = static_cast<std::size_t>(col.nonzero_indices()[k]);
+        if (row_removed_[i]) {
+          continue;
+        }
+        row_lower_[i] -= col.values()[k] * value;
+        row_upper_[i] -= col.values()[k] * value;
+        row_size_[i]--;
+      }
+      column_removed_[j] = true;
+      reductions_.push_back(
+          {ReductionKind::FixedColumn, 0, j, value, false, false});
+      changed = true;
+    }
+    return changed;
+  }
+
+  bool remove_empty_rows() {
+    bool changed = false;
+    for (std::size_t i = 0; i < rows_.size(); i++) {
+      if (row_removed_[i]) {
+        continue;
+      }
+      const bool unbounded = row_lower_[i] == -LPINT_INFINITY &&
+                        row_upper_[i] == LPINT_INFINITY;
+      if (row_size_[i] > 0 && !unbounded) {
+        continue;
+      }
+      if (row_size_[i] == 0 &&
+          (row_lower_[i] > tolerance() || row_upper_[i] < -tolerance())) {
+        status_ = Status::Infeasible;
+        return changed;
+      }
+      remove_row(i);
+      reductions_.push_back(
+          {ReductionKind::RemovedRow, i, 0, 0.0, false, false});
+      changed = true;
+    }
+    return changed;
+  }
+
+  bool remove_singleton_rows() {
+    bool changed = false;
+    for (std::size_t i = 0; i < rows_.size(); i++) {
+      if (row_removed_[i] || row_size_[i] != 1) {
+        continue;
+      }
+      const auto& row = rows_[i];
+      std::size_t k = 0;
+      while (column_removed_[static_cast<std::size_t>(
+          row.nonzero_indices()[k])]) {
+        k++;
+      }
+      const auto j = static_cast<std::size_t>(row.nonzero_indices()[k]);
+      const auto a = row.values()[k];
+      auto implied_lower = row_lower_[i] / a;
+      auto implied_upper = row_upper_[i] / a;
+      if (a < 0.0) {
+        std::swap(implied_lower, implied_upper);
+      }
+      const bool tightens_lower = implied_lower > lower_[j];
+      const bool tightens_upper = implied_upper < upper_[j];
+      if (tightens_lower) {
+        lower_[j] = implied_lower;
+      }
+      if (tightens_upper) {
+        upper_[j] = implied_upper;
+      }
+      if (!fix_crossed_bounds(lower_[j], upper_[j])) {
+        return changed;
+      }
+      remove_row(i);
+      reductions_.push_back({ReductionKind::SingletonRow, i, j, a,
+                             tightens_lower, tightens_upper});
+      changed = true;
+    }
+    return changed;
+  }
+
+  // Returns false, and marks the model infeasible, if the bounds cross by
+  // more than the tolerance; otherwise closes any gap left by rounding.
+  bool fix_crossed_bounds(double& lower, double& upper) {
+    if (lower > upper + tolerance()) {
+      status_ = Status::Infeasible;
+      return false;
+    }
+    if (lower > upper) {
+      upper = lower;
+    }
+    return true;
+  }
+
+  // Hash of the remaining entries of row i, normalized by the first
+  // remaining coefficient, so that parallel rows hash equally.
+  std::uint64_t row_hash(const std::size_t i) const {
+    const auto& row = rows_[i];
+    std::uint64_t hash = 14695981039346656037ull;
+    double scale = 0.0;
+    for (std::size_t k = 0; k < row.num_nonzero(); k++) {
+      const auto j = static_cast<std::size_t>(row.nonzero_indices()[k]);
+      if (column_removed_[j]) {
+        continue;
+      }
+      if (scale == 0.0) {
+        scale = row.values()[k];
+      }
+      const double normalized = row.values()[k] / scale;
+      std::uint64_t bits;
+      std::memcpy(&bits, &normalized, sizeof(bits));
+      hash = (hash ^ j) * 1099511628211ull;
+      hash = (hash ^ bits) * 1099511628211ull;
+    }
+    return hash;
+  }
+
+  // Returns the factor f such that row k is f times row r, or zero if the
+  // rows are not parallel.
+  double parallel_factor(const std::size_t k, const std::size_t r) const {
+    const auto& left = rows_[k];
+    const auto& right = rows_[r];
+    std::size_t a = 0;
+    std::size_t b = 0;
+    double factor = 0.0;
+    while (true) {
+      while (a < left.num_nonzero() &&
+             column_removed_[static_cast<std::size_t>(
+                 left.nonzero_indices()[a])]) {
+        a++;
+      }
+      while (b < right.num_nonzero() &&
+             column_removed_[static_cast<std::size_t>(
+                 right.nonzero_indices()[b])]) {
+        b++;
+      }
+      if (a == left.num_nonzero() || b == right.num_nonzero()) {
+        return a == left.num_nonzero() && b == right.num_nonzero() ? factor
+                                                                   : 0.0;
+      }
+      if (left.nonzero_indices()[a] != right.nonzero_indices()[b]) {
+        return 0.0;
+      }
+      const auto ratio = left.values()[a] / right.values()[b];
+      if (factor == 0.0) {
+        factor = ratio;
+      } else if (std::abs(ratio - factor) > 1e-12 * std::abs(factor)) {
+        return 0.0;
+      }
+      a++;
+      b++;
+    }
+  }
+
+  bool remove_parallel_rows(std::size_t nthreads) {
+    const auto nrows = rows_.size();
+    std::size_t nnz = 0;
+    for (std::size_t i = 0; i < nrows; i++) {
+      nnz += row_removed_[i] ? 0 : row_size_[i];
+    }
+    if (nthreads == 0) {
+      nthreads = detail::num_threads_for(nnz, min_nonzeros_per_thread);
+    }
+    // hashing touches every nonzero, so it is split between threads;
+    // rows_ and column_removed_ are only read here
+    std::vector<std::pair<std::uint64_t, std::size_t>> hashes(nrows);
+    detail::run_parallel(nthreads, [&](const std::size_t t) {
+      const auto end = detail::part_begin(nrows, nthreads, t + 1);
+      for (auto i = detail::part_begin(nrows, nthreads, t); i < end; i++) {
+        hashes[i] = std::make_pair(
+            row_removed_[i] || row_size_[i] < 2 ? 0 : row_hash(i), i);
+      }
+    });
+    std::sort(hashes.begin(), hashes.end());
+
+    bool changed = false;
+    std::size_t group = 0;
+    while (group < nrows) {
+      auto end = group + 1;
+      while (end < nrows && hashes[end].first == hashes[group].first) {
+        end++;
+      }
+      for (auto k = group + 1; k < end && hashes[group].first != 0; k++) {
+        const auto removed = hashes[k].second;
+        for (auto r = group; r < k; r++) {
+          const auto kept = hashes[r].second;
+          if (row_removed_[kept]) {
+            continue;
+          }
+          const auto factor = parallel_factor(removed, kept);
+          if (factor == 0.0) {
+            continue;
+          }
+          if (!merge_rows(removed, kept, factor)) {
+            return changed;
+          }
+          changed = true;
+          break;
+        }
+      }
+      group = end;
+    }
+    return changed;
+  }
+
+  // Merge row k, which is factor times row r, into row r.
+  bool merge_rows(const std::size_t k, const std::size_t r,
+                  const double factor) {
+    auto lower = row_lower_[k] / factor;
+    auto upper = row_upper_[k] / factor;
+    if (factor < 0.0) {
+      std::swap(lower, upper);
+    }
+    const bool tightens_lower = lower > row_lower_[r];
+    const bool tightens_upper = upper < row_upper_[r];
+    if (tightens_lower) {
+      row_lower_[r] = lower;
+    }
+    if (tightens_upper) {
+      row_upper_[r] = upper;
+    }
+    if (!fix_crossed_bounds(row_lower_[r], row_upper_[r])) {
+      return false;
+    }
+    remove_row(k);
+    reductions_.push_back({ReductionKind::ParallelRow, k, r, factor,
+                           tightens_lower, tightens_upper});
+    return true;
+  }
+
+  bool remove_dominated_columns() {
+    bool changed = false;
+    for (std::size_t j = 0; j < column_removed_.size(); j++) {
+      if (column_removed_[j]) {
+        continue;
+      }
+      // whether moving x_j down or up can never violate a remaining row
+      bool down = true;
+      bool up = true;
+      const auto& col = columns_[j];
+      for (std::size_t k = 0; k < col.num_nonzero(); k++) {
+        const auto i = static_cast<std::size_t>(col.nonzero_indices()[k]);
+        if (row_removed_[i]) {
+          continue;
+        }
+        const bool lower_free = row_lower_[i] == -LPINT_INFINITY;
+        const bool upper_free = row_upper_[i] == LPINT_INFINITY;
+        const bool positive = col.values()[k] > 0.0;
+        down = down && (positive ? lower_free : upper_free);
+        up = up && (positive ? upper_free : lower_free);
+      }
+      // cost in the minimization sense
+      const auto cost = minimization_sign() * objective_[j];
+      double value;
+      if (cost > 0.0 && down) {
+        value = lower_[j];
+      } else if (cost < 0.0 && up) {
+        value = upper_[j];
+      } else if (cost == 0.0 && down && lower_[j] != -LPINT_INFINITY) {
+        value = lower_[j];
+      } else if (cost == 0.0 && up && upper_[j] != LPINT_INFINITY) {
+        value = upper_[j];
+      } else if (cost == 0.0 && down && up) {
+        value = 0.0;
+      } else {
+        continue;
+      }
+      if (std::isinf(value)) {
+        // the objective improves without limit, if the model is feasible
+        status_ = Status::InfeasibleOrUnbounded;
+        return changed;
+      }
+      lower_[j] = value;
+      upper_[j] = value;
+      reductions_.push_back(
+          {ReductionKind::DominatedColumn, 0, j, value, false, false});
+      changed = true;
+    }
+    return changed;
+  }
+
+  OptimizationType sense_;
+  std::vector<double> objective_;
+
+  // bounds of the columns, tightened during presolve
+  std::vector<double> lower_;
+  std::vector<double> upper_;
+  std::vector<bool> column_removed_;
+  std::vector<Column<double>> columns_;
+
+  // entries are never removed from the rows; entries of removed columns
+  // are skipped instead, and their values are moved into the row bounds
+  std::vector<Row<double>> rows_;
+  std::vector<double> row_lower_;
+  std::vector<double> row_upper_;
+  std::vector<bool> row_removed_;
+  //! Number of remaining columns with a nonzero in each row.
+  std::vector<std::size_t> row_size_;
+
+  std::vector<Reduction> reductions_;
+  Status status_ = Status::NoInformation;
+};
+
+/**
+ * @brief Solver which presolves its linear program before handing it to
+ * a backend.
+ * The model is kept in memory, and every solve() presolves it, loads the
+ * reduced model into a fresh backend and postsolves the result, so that
+ * get_solution() always refers to the model in linear_program():
+ *
+ * ~~~cpp
+ * PresolvedSolver<SoplexSolver> solver(OptimizationType::Maximize);
+ * build_model(solver.linear_program());
+ * solver.solve();
+ * const auto& solution = solver.get_solution();
+ * ~~~
+ *
+ * Parameters are forwarded to every backend created by solve(). If
+ * presolve alone proves the model infeasible or unbounded, the backend is
+ * not called at all.
+ *
+ * @tparam Solver Type of the backend solver.
+ */
+template <class Solver>
+class PresolvedSolver : public LinearProgramSolver {
+ public:
+  PresolvedSolver() : PresolvedSolver(OptimizationType::Maximize) {}
+
+  explicit PresolvedSolver(const OptimizationType sense)
+      : lp_(sense), solver_(new Solver(sense)) {}
+
+  const ILinearProgramHandle& linear_program() const override { return lp_; }
+
+  ILinearProgramHandle& linear_program() override { return lp_; }
+
+  bool parameter_supported(const Param param) const override {
+    return solver_->parameter_supported(param);
+  }
+
+  void set_parameter(const Param param, const int value) override {
+    solver_->set_parameter(param, value);
+    params_.record(param, value);
+  }
+
+  void set_parameter(const Param param, const double value) override {
+    solver_->set_parameter(param, value);
+    params_.record(param, value);
+  }
+
+  Status solve() override {
+    Presolver presolver(lp_);
+    status_ = presolver.presolve();
+    if (status_ == Status::NoInformation) {
+      solver_.reset(new Solver(lp_.optimization_type()));
+      params_.replay(*solver_);
+      presolver.load_reduced(solver_->linear_program());
+      status_ = solver_->solve();
+      if (status_ == Status::Optimal) {
+        solution_ = presolver.postsolve(solver_->get_solution());
+      }
+    } else if (status_ == Status::Optimal) {
+      solution_ = presolver.postsolve(Solution<double>());
+    }
+    reductions_ = presolver.reductions();
+    return status_;
+  }
+
+  Status solution_status() const override { return status_; }
+
+  const Solution<double>& get_solution() const override {
+    if (status_ != Status::Optimal) {
+      throw ModelNotSolvedException();
+    }
+    return solution_;
+  }
+
+  //! Get the reductions applied by the last solve().
+  const std::vector<Reduction>& reductions() const { return reductions_; }
+
+ private:
+  LinearProgramHandleNative lp_;
+  std::unique_ptr<Solver> solver_;
+
+  detail::ParameterLog params_;
+
+  Status status_ = Status::NoInformation;
+  Solution<double> solution_;
+  std::vector<Reduction> reductions_;
+};
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_PRESOLVE_H
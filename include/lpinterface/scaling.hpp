@@ -0,0 +1,355 @@
+#ifndef LPINTERFACE_SCALING_H
+#define LPINTERFACE_SCALING_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "common.hpp"
+#include "constraint_batch.hpp"
+#include "data_objects.hpp"
+#include "detail/parallel.hpp"
+#include "detail/parameter_log.hpp"
+#include "errors.hpp"
+#include "lp.hpp"
+#include "lpinterface.hpp"
+#include "native/lphandle_native.hpp"
+#include "parameter_type.hpp"
+
+namespace lpint {
+
+/**
+ * @brief Row and column scaling of a linear program.
+ * Scaling replaces the constraint matrix A by R A S and the objective c
+ * by w S c, for diagonal matrices R and S and a scalar w, which brings the
+ * nonzeros closer to one and so makes the backend's job numerically
+ * easier. The scaled model is solved in the variables x' = S^-1 x, and
+ * unscale() maps its solution back:
+ *
+ * ~~~cpp
+ * Scaler scaler(lp);
+ * scaler.scale();
+ * scaler.load_scaled(backend.linear_program());
+ * backend.solve();
+ * const auto solution = scaler.unscale(backend.get_solution());
+ * ~~~
+ *
+ * The factors are computed by a number of geometric-mean passes, which
+ * divide every row and then every column by the geometric mean of its
+ * largest and smallest nonzero, followed by an equilibration pass, which
+ * divides by the largest nonzero so that it becomes one. All factors are
+ * rounded to powers of two, so that scaling does not introduce any
+ * rounding error.
+ */
+class Scaler {
+ public:
+  /**
+   * @brief Copy the matrix, bounds and objective of a linear program.
+   * All factors start out as one.
+   */
+  explicit Scaler(const ILinearProgramHandle& lp)
+      : sense_(lp.optimization_type()),
+        variables_(lp.cached_variables()),
+        objective_(lp.cached_objective().values) {
+    const auto& constraints = lp.cached_constraints();
+    const auto nvars = variables_.size();
+    const auto nrows = constraints.size();
+    objective_.resize(nvars, 0.0);
+    for (const auto& constraint : constraints) {
+      batch_.begin_row(constraint.lower_bound, constraint.upper_bound);
+      const auto& row = constraint.row;
+      for (std::size_t k = 0; k < row.num_nonzero(); k++) {
+        batch_.push(row.nonzero_indices()[k], row.values()[k]);
+      }
+      batch_.end_row();
+    }
+
+    // the transpose of the matrix, as positions into the batch arrays
+    column_starts_.assign(nvars + 1, 0);
+    for (const auto j : batch_.indices()) {
+      column_starts_[static_cast<std::size_t>(j) + 1]++;
+    }
+    for (std::size_t j = 0; j < nvars; j++) {
+      column_starts_[j + 1] += column_starts_[j];
+    }
+    column_entries_.resize(batch_.num_nonzero());
+    column_rows_.resize(batch_.num_nonzero());
+    auto next = column_starts_;
+    for (std::size_t i = 0; i < nrows; i++) {
+      for (auto k = batch_.row_starts()[i]; k < batch_.row_starts()[i + 1];
+           k++) {
+        const auto j = static_cast<std::size_t>(batch_.indices()[k]);
+        column_entries_[next[j]] = k;
+        column_rows_[next[j]] = i;
+        next[j]++;
+      }
+    }
+
+    row_scale_.assign(nrows, 1.0);
+    column_scale_.assign(nvars, 1.0);
+  }
+
+  /**
+   * @brief Compute the scaling factors.
+   *
+   * @param geometric_passes Number of geometric-mean passes over the rows
+   * and columns.
+   * @param equilibrate Whether to finish with an equilibration pass.
+   * @param nthreads Number of threads to use, or zero to choose
+   * automatically based on the number of nonzeros.
+   */
+  void scale(const std::size_t geometric_passes = 4,
+             const bool equilibrate = true, std::size_t nthreads = 0) {
+    if (nthreads == 0) {
+      nthreads = detail::num_threads_for(batch_.num_nonzero(),
+                                         min_nonzeros_per_thread);
+    }
+    for (std::size_t pass = 0; pass < geometric_passes; pass++) {
+      scale_rows(nthreads, true);
+      scale_columns(nthreads, true);
+    }
+    if (equilibrate) {
+      scale_rows(nthreads, false);
+      scale_columns(nthreads, false);
+    }
+
+    double largest = 0.0;
+    for (std::size_t j = 0; j < objective_.size(); j++) {
+      largest = std::max(largest, std::abs(objective_[j] * column_scale_[j]));
+    }
+    objective_scale_ = largest > 0.0 ? power_of_two(1.0 / largest) : 1.0;
+  }
+
+  //! Get the factors by which the rows are multiplied.
+  const std::vector<double>& row_scale() const { return row_scale_; }
+
+  //! Get the factors by which the columns are multiplied.
+  const std::vector<double>& column_scale() const { return column_scale_; }
+
+  //! Get the factor by which the objective is multiplied.
+  double objective_scale() const { return objective_scale_; }
+
+  /**
+   * @brief Load the scaled model into an empty linear program.
+   */
+  void load_scaled(ILinearProgramHandle& lp) const {
+    lp.set_objective_sense(sense_);
+    const auto nvars = variables_.size();
+    if (nvars == 0) {
+      return;
+    }
+    std::vector<Variable> variables;
+    std::vector<double> objective(nvars);
+    variables.reserve(nvars);
+    for (std::size_t j = 0; j < nvars; j++) {
+      variables.emplace_back(variables_[j].lower() / column_scale_[j],
+                             variables_[j].upper() / column_scale_[j]);
+      objective[j] = objective_[j] * column_scale_[j] * objective_scale_;
+    }
+    lp.add_variables(variables);
+    lp.set_objective(Objective<double>(std::move(objective)));
+
+    ConstraintBatch<double> scaled;
+    scaled.reserve(batch_.num_rows(), batch_.num_nonzero());
+    for (std::size_t i = 0; i < batch_.num_rows(); i++) {
+      scaled.begin_row(batch_.lower_bounds()[i] * row_scale_[i],
+                       batch_.upper_bounds()[i] * row_scale_[i]);
+      for (auto k = batch_.row_starts()[i]; k < batch_.row_starts()[i + 1];
+           k++) {
+        const auto j = batch_.indices()[k];
+        scaled.push(j, batch_.values()[k] * row_scale_[i] *
+                           column_scale_[static_cast<std::size_t>(j)]);
+      }
+      scaled.end_row();
+    }
+    if (!scaled.empty()) {
+      lp.add_constraints(scaled);
+    }
+  }
+
+  /**
+   * @brief Map a solution of the scaled model to the original model.
+   */
+  Solution<double> unscale(const Solution<double>& scaled) const {
+    if (scaled.primal.size() != column_scale_.size() ||
+        scaled.dual.size() != row_scale_.size()) {
+      throw MismatchedDimensionsException();
+    }
+    Solution<double> solution;
+    solution.primal.resize(scaled.primal.size());
+    for (std::size_t j = 0; j < scaled.primal.size(); j++) {
+      solution.primal[j] = scaled.primal[j] * column_scale_[j];
+    }
+    solution.dual.resize(scaled.dual.size());
+    for (std::size_t i = 0; i < scaled.dual.size(); i++) {
+      solution.dual[i] = scaled.dual[i] * row_scale_[i] / objective_scale_;
+    }
+    solution.objective_value = scaled.objective_value / objective_scale_;
+    return solution;
+  }
+
+ private:
+  static constexpr std::size_t min_nonzeros_per_thread = 1 << 16;
+
+  static double power_of_two(const double value) {
+    return std::exp2(std::round(std::log2(value)));
+  }
+
+  // Returns the factor that brings the scaled nonzeros in [smallest,
+  // largest] closest to one, or one if there are no nonzeros.
+  static double factor(const double smallest, const double largest,
+                       const bool geometric) {
+    if (largest == 0.0) {
+      return 1.0;
+    }
+    return power_of_two(geometric ? 1.0 / std::sqrt(smallest * largest)
+                                  : 1.0 / largest);
+  }
+
+  // every row only reads the column factors, so the rows are independent
+  void scale_rows(const std::size_t nthreads, const bool geometric) {
+    const auto nrows = batch_.num_rows();
+    detail::run_parallel(nthreads, [&](const std::size_t t) {
+      const auto end = detail::part_begin(nrows, nthreads, t + 1);
+      for (auto i = detail::part_begin(nrows, nthreads, t); i < end; i++) {
+        double smallest = LPINT_INFINITY;
+        double largest = 0.0;
+        for (auto k = batch_.row_starts()[i]; k < batch_.row_starts()[i + 1];
+             k++) {
+          const auto value = std::abs(
+              batch_.values()[k] *
+              column_scale_[static_cast<std::size_t>(batch_.indices()[k])]);
+          if (value > 0.0) {
+            smallest = std::min(smallest, value);
+            largest = std::max(largest, value);
+          }
+        }
+        row_scale_[i] = factor(smallest, largest, geometric);
+      }
+    });
+  }
+
+  void scale_columns(const std::size_t nthreads, const bool geometric) {
+    const auto nvars = column_scale_.size();
+    detail::run_parallel(nthreads, [&](const std::size_t t) {
+      const auto end = detail::part_begin(nvars, nthreads, t + 1);
+      for (auto j = detail::part_begin(nvars, nthreads, t); j < end; j++) {
+        double smallest = LPINT_INFINITY;
+        double largest = 0.0;
+        for (auto k = column_starts_[j]; k < column_starts_[j + 1]; k++) {
+          const auto value = std::abs(batch_.values()[column_entries_[k]] *
+                                      row_scale_[column_rows_[k]]);
+          if (value > 0.0) {
+            smallest = std::min(smallest, value);
+            largest = std::max(largest, value);
+          }
+        }
+        column_scale_[j] = factor(smallest, largest, geometric);
+      }
+    });
+  }
+
+  OptimizationType sense_;
+  std::vector<Variable> variables_;
+  std::vector<double> objective_;
+
+  ConstraintBatch<double> batch_;
+  // entries of column j are column_entries_[column_starts_[j]] up to
+  // column_entries_[column_starts_[j + 1]], positions into batch_
+  std::vector<std::size_t> column_starts_;
+  std::vector<std::size_t> column_entries_;
+  std::vector<std::size_t> column_rows_;
+
+  std::vector<double> row_scale_;
+  std::vector<double> column_scale_;
+  double objective_scale_ = 1.0;
+};
+
+/**
+ * @brief Solver which scales its linear program before handing it to a
+ * backend, and unscales the solution.
+ * Like PresolvedSolver, the model is kept in memory, and every solve()
+ * loads the scaled model into a fresh backend, so get_solution() always
+ * refers to the model in linear_program(). Both can be combined, as in
+ * ScaledSolver<PresolvedSolver<SoplexSolver>>.
+ *
+ * @tparam Solver Type of the backend solver.
+ */
+template <class Solver>
+class ScaledSolver : public LinearProgramSolver {
+ public:
+  ScaledSolver() : ScaledSolver(OptimizationType::Maximize) {}
+
+  /**
+   * @brief Construct a solver.
+   *
+   * @param sense Objective sense of the linear program.
+   * @param geometric_passes Number of geometric-mean passes, see
+   * Scaler::scale().
+   * @param equilibrate Whether to finish with an equilibration pass.
+   */
+  explicit ScaledSolver(const OptimizationType sense,
+                        const std::size_t geometric_passes = 4,
+                        const bool equilibrate = true)
+      : lp_(sense),
+        solver_(new Solver(sense)),
+        geometric_passes_(geometric_passes),
+        equilibrate_(equilibrate) {}
+
+  const ILinearProgramHandle& linear_program() const override { return lp_; }
+
+  ILinearProgramHandle& linear_program() override { return lp_; }
+
+  bool parameter_supported(const Param param) const override {
+    return solver_->parameter_supported(param);
+  }
+
+  void set_parameter(const Param param, const int value) override {
+    solver_->set_parameter(param, value);
+    params_.record(param, value);
+  }
+
+  void set_parameter(const Param param, const double value) override {
+    solver_->set_parameter(param, value);
+    params_.record(param, value);
+  }
+
+  Status solve() override {
+    Scaler scaler(lp_);
+    scaler.scale(geometric_passes_, equilibrate_);
+    solver_.reset(new Solver(lp_.optimization_type()));
+    params_.replay(*solver_);
+    scaler.load_scaled(solver_->linear_program());
+    status_ = solver_->solve();
+    if (status_ == Status::Optimal) {
+      solution_ = scaler.unscale(solver_->get_solution());
+    }
+    return status_;
+  }
+
+  Status solution_status() const override { return status_; }
+
+  const Solution<double>& get_solution() const override {
+    if (status_ != Status::Optimal) {
+      throw ModelNotSolvedException();
+    }
+    return solution_;
+  }
+
+ private:
+  LinearProgramHandleNative lp_;
+  std::unique_ptr<Solver> solver_;
+  detail::ParameterLog params_;
+
+  std::size_t geometric_passes_;
+  bool equilibrate_;
+
+  Status status_ = Status::NoInformation;
+  Solution<double> solution_;
+};
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_SCALING_H
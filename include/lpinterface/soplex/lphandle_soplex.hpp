@@ -9,6 +9,10 @@
 #include "soplex.h"
 
 #include "lpinterface/badge.hpp"
+#include "lpinterface/detail/id_map.hpp"
+#include "lpinterface/detail/model_cache.hpp"
+#include "lpinterface/detail/objective_support.hpp"
+#include "lpinterface/detail/transaction_log.hpp"
 #include "lpinterface/detail/util.hpp"
 #include "lpinterface/lp.hpp"
 
@@ -27,21 +31,60 @@ class LinearProgramHandleSoplex : public ILinearProgramHandle {
     inverse_permutation_vars_ = detail::inverse_permutation(permutation_vars_);
   }
 
+  // the id-based overloads of the interface
+  using ILinearProgramHandle::constraint;
+  using ILinearProgramHandle::begin_transaction;
+  using ILinearProgramHandle::constraints;
+  using ILinearProgramHandle::remove_constraint;
+  using ILinearProgramHandle::remove_variable;
+  using ILinearProgramHandle::set_constraint_bounds;
+  using ILinearProgramHandle::set_variable_bounds;
+  using ILinearProgramHandle::variable;
+
   Variable variable(std::size_t i) const override;
 
   std::vector<Variable> variables() const override;
 
-  void add_variables(const std::vector<Variable>& vars) override;
+  VariableBlock variable_block() const override;
+
+  VariableIdRange add_variables(const std::vector<Variable>& vars) override;
 
-  void add_variables(std::size_t num_vars) override;
+  VariableIdRange add_variables(const VariableBlock& vars) override;
 
-  void add_constraints(
+  VariableIdRange add_variables(std::size_t num_vars) override;
+
+  ConstraintIdRange add_constraints(
       const std::vector<Constraint<double>>& constraints) override;
 
+  ConstraintIdRange add_constraints(
+      const ConstraintBatch<double>& batch) override;
+
   void remove_variable(const std::size_t i) override;
 
   void remove_constraint(std::size_t i) override;
 
+  void set_variable_bounds(const std::size_t i, const double lower,
+                           const double upper) override;
+
+  void set_constraint_bounds(const std::size_t i, const double lower,
+                             const double upper) override;
+
+  void begin_transaction(const bool restore_basis) override;
+
+  void commit() override;
+
+  void rollback() override;
+
+  bool in_transaction() const override;
+
+  std::size_t position(const ConstraintId id) const override;
+
+  std::size_t position(const VariableId id) const override;
+
+  ConstraintId constraint_id(const std::size_t i) const override;
+
+  VariableId variable_id(const std::size_t i) const override;
+
   std::size_t num_vars() const override;
 
   std::size_t num_constraints() const override;
@@ -50,19 +93,60 @@ class LinearProgramHandleSoplex : public ILinearProgramHandle {
 
   void set_objective(const Objective<double>& objective) override;
 
+  void set_objective(const SparseObjective<double>& objective) override;
+
   OptimizationType optimization_type() const override;
 
   Constraint<double> constraint(std::size_t i) const override;
 
+  void read_constraint(std::size_t i,
+                       Constraint<double>& buffer) const override;
+
+  Column<double> column(std::size_t j) const override;
+
+  std::vector<Column<double>> columns() const override;
+
   std::vector<Constraint<double>> constraints() const override;
 
   Objective<double> objective() const override;
 
+  SparseObjective<double> sparse_objective() const override;
+
+  const std::vector<Constraint<double>>& cached_constraints() const override;
+
+  const Objective<double>& cached_objective() const override;
+
+  const std::vector<Variable>& cached_variables() const override;
+
+  void clear_cache() override;
+
+  void set_cache_enabled(bool enabled) override;
+
   std::shared_ptr<soplex::SoPlex> soplex(detail::Badge<SoplexSolver>) {
     return soplex_;
   }
 
  private:
+  friend class detail::TransactionLog;
+
+  // undo primitives for rollback(); these do not record anything
+  void truncate_constraints(const std::size_t n);
+  void truncate_variables(const std::size_t n);
+  void insert_constraint(const std::size_t i, const Constraint<double>& c,
+                         const ConstraintId id);
+  void insert_variable(const std::size_t i, const Variable& var,
+                       const Column<double>& col, const double objective,
+                       const VariableId id);
+  void insert_constraints(
+      const std::vector<detail::TransactionLog::RemovedConstraint>& removed);
+  void insert_variables(
+      const std::vector<detail::TransactionLog::RemovedVariable>& removed);
+
+  //! Translate a variable index to the internal soplex column index.
+  int internal_column(std::size_t i) const {
+    return detail::checked_narrow<int>(inverse_permutation_vars_[i]);
+  }
+
   std::vector<std::size_t> permutation_;
   std::vector<std::size_t> inverse_permutation_;
 
@@ -71,6 +155,19 @@ class LinearProgramHandleSoplex : public ILinearProgramHandle {
 
   std::shared_ptr<soplex::SoPlex> soplex_;
 
+  detail::ObjectiveSupport objective_support_;
+
+  detail::IdMap<ConstraintId> constraint_ids_;
+  detail::IdMap<VariableId> variable_ids_;
+
+  mutable detail::ModelCache cache_;
+
+  detail::TransactionLog transaction_;
+  // basis at the start of the transaction, in logical order; empty if
+  // the basis is not to be restored
+  std::vector<soplex::SPxSolver::VarStatus> saved_row_basis_;
+  std::vector<soplex::SPxSolver::VarStatus> saved_col_basis_;
+
   OptimizationType sense_ = OptimizationType::Maximize;
 };
 
@@ -0,0 +1,98 @@
+#ifndef LPINTERFACE_STAGED_SOLVER_H
+#define LPINTERFACE_STAGED_SOLVER_H
+
+#include <utility>
+
+#include "change_log.hpp"
+#include "common.hpp"
+#include "data_objects.hpp"
+#include "lp.hpp"
+#include "lpinterface.hpp"
+#include "parameter_type.hpp"
+
+namespace lpint {
+
+/**
+ * @brief Solver which stages changes to its linear program and sends
+ * them to the backend in bulk.
+ * Edits made through changes() are coalesced in a ChangeLog and only
+ * applied right before the next solve, which saves the backend from
+ * redundant work when edits arrive as long streams of small changes:
+ *
+ * ~~~cpp
+ * StagedSolver<SoplexSolver> solver(OptimizationType::Maximize);
+ * for (const auto& event : events) {
+ *   solver.changes().set_variable_bounds(event.id, event.lower, event.upper);
+ * }
+ * solver.solve();  // one bound change per variable reaches the backend
+ * ~~~
+ *
+ * Mutable access to linear_program() applies the staged changes first,
+ * so the linear program reflects every edit made so far.
+ *
+ * @tparam Solver Type of the solver to wrap.
+ */
+template <class Solver>
+class StagedSolver : public LinearProgramSolver {
+ public:
+  //! Construct the wrapped solver from the given arguments.
+  template <class... Args>
+  explicit StagedSolver(Args&&... args)
+      : solver_(std::forward<Args>(args)...) {}
+
+  //! Get the staged changes.
+  ChangeLog& changes() { return changes_; }
+
+  //! Apply the staged changes to the backend.
+  void flush() {
+    changes_.apply(solver_.linear_program());
+  }
+
+  //! Get the wrapped solver; staged changes are not applied to it.
+  Solver& solver() { return solver_; }
+
+  /**
+   * @brief Get immutable access to the linear program.
+   * Staged changes cannot be applied through a const solver, so they are
+   * not visible until the next call to flush() or solve().
+   */
+  const ILinearProgramHandle& linear_program() const override {
+    return solver_.linear_program();
+  }
+
+  ILinearProgramHandle& linear_program() override {
+    flush();
+    return solver_.linear_program();
+  }
+
+  bool parameter_supported(const Param param) const override {
+    return solver_.parameter_supported(param);
+  }
+
+  void set_parameter(const Param param, const int value) override {
+    solver_.set_parameter(param, value);
+  }
+
+  void set_parameter(const Param param, const double value) override {
+    solver_.set_parameter(param, value);
+  }
+
+  Status solve() override {
+    flush();
+    return solver_.solve();
+  }
+
+  Status solution_status() const override { return solver_.solution_status(); }
+
+  const Solution<double>& get_solution() const override {
+    return solver_.get_solution();
+  }
+
+ private:
+  Solver solver_;
+  ChangeLog changes_;
+};
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_STAGED_SOLVER_H
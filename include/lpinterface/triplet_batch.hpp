@@ -0,0 +1,235 @@
+#ifndef LPINTERFACE_TRIPLET_BATCH_H
+#define LPINTERFACE_TRIPLET_BATCH_H
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "constraint_batch.hpp"
+#include "detail/parallel.hpp"
+#include "detail/util.hpp"
+#include "errors.hpp"
+
+namespace lpint {
+
+/**
+ * @brief Constraints given as (row, column, value) triplets in arbitrary
+ * order, also known as coordinate (COO) format.
+ * The rows are declared with their bounds first, after which the
+ * nonzeros can be added in any order; to_batch() converts the triplets to
+ * the CSR layout of ConstraintBatch, which can be loaded into a linear
+ * program in one call:
+ *
+ * ~~~cpp
+ * TripletBatch<double> triplets;
+ * const auto r = triplets.add_row(-LPINT_INFINITY, 4.0);
+ * triplets.add(r, 2, 3.0);
+ * triplets.add(r, 0, 1.0);
+ * lp.add_constraints(triplets.to_batch());
+ * ~~~
+ *
+ * Triplets with the same row and column are summed, and entries that
+ * sum to zero are left out.
+ *
+ * @tparam T Type of the coefficients and bounds.
+ * @tparam I Type of the column indices.
+ */
+template <typename T, typename I = int>
+class TripletBatch {
+  static_assert(std::is_arithmetic<T>::value,
+                "TripletBatch<T> requires T to be arithmetic");
+
+ public:
+  using Index = typename ConstraintBatch<T, I>::Index;
+  using SizeType = typename ConstraintBatch<T, I>::SizeType;
+
+  /**
+   * @brief Reserve storage up front.
+   *
+   * @param nrows Expected number of rows.
+   * @param nnz Expected number of triplets.
+   */
+  void reserve(const SizeType nrows, const SizeType nnz) {
+    lower_bounds_.reserve(nrows);
+    upper_bounds_.reserve(nrows);
+    rows_.reserve(nnz);
+    columns_.reserve(nnz);
+    values_.reserve(nnz);
+  }
+
+  //! Declare a row with the given bounds, and return its index.
+  SizeType add_row(const T lower_bound, const T upper_bound) {
+    lower_bounds_.push_back(lower_bound);
+    upper_bounds_.push_back(upper_bound);
+    return lower_bounds_.size() - 1;
+  }
+
+  /**
+   * @brief Add a triplet.
+   * Throws std::out_of_range if the row has not been declared, and
+   * InvalidMatrixEntryException if the column index is negative.
+   */
+  void add(const SizeType row, const Index column, const T value) {
+    if (row >= lower_bounds_.size()) {
+      throw std::out_of_range("Triplet refers to undeclared row");
+    }
+    if (detail::is_negative(column, std::is_signed<Index>())) {
+      throw InvalidMatrixEntryException();
+    }
+    rows_.push_back(row);
+    columns_.push_back(column);
+    values_.push_back(value);
+  }
+
+  //! Return the number of declared rows.
+  SizeType num_rows() const { return lower_bounds_.size(); }
+
+  //! Return the number of triplets, counting duplicates separately.
+  SizeType num_triplets() const { return values_.size(); }
+
+  /**
+   * @brief Convert the triplets to a ConstraintBatch.
+   * The triplets are sorted by row with a parallel counting sort, which is
+   * a radix sort with a single digit, since row indices are bounded by the
+   * number of rows. The sort is stable, so within a row the entries keep
+   * the order in which their columns were first added. Duplicates are then
+   * summed per row in parallel, and zero sums dropped, in O(nnz) in total.
+   *
+   * @param nthreads Number of threads to use, or zero to choose
+   * automatically based on the number of triplets.
+   */
+  ConstraintBatch<T, I> to_batch(std::size_t nthreads = 0) const {
+    const auto nrows = num_rows();
+    const auto nnz = num_triplets();
+    if (nthreads == 0) {
+      nthreads = detail::num_threads_for(nnz, min_triplets_per_thread);
+    }
+
+    // count the triplets of each row in each thread's part of the input
+    std::vector<std::vector<SizeType>> offsets(nthreads);
+    detail::run_parallel(nthreads, [&](const std::size_t t) {
+      offsets[t].assign(nrows, 0);
+      const auto end = detail::part_begin(nnz, nthreads, t + 1);
+      for (auto k = detail::part_begin(nnz, nthreads, t); k < end; k++) {
+        offsets[t][rows_[k]]++;
+      }
+    });
+
+    // turn the counts into the position at which each thread writes its
+    // first triplet of each row; threads write rows in input order
+    std::vector<SizeType> row_starts(nrows + 1, 0);
+    SizeType position = 0;
+    for (SizeType r = 0; r < nrows; r++) {
+      row_starts[r] = position;
+      for (std::size_t t = 0; t < nthreads; t++) {
+        const auto count = offsets[t][r];
+        offsets[t][r] = position;
+        position += count;
+      }
+    }
+    row_starts[nrows] = position;
+
+    std::vector<Index> sorted_columns(nnz);
+    std::vector<T> sorted_values(nnz);
+    detail::run_parallel(nthreads, [&](const std::size_t t) {
+      const auto end = detail::part_begin(nnz, nthreads, t + 1);
+      for (auto k = detail::part_begin(nnz, nthreads, t); k < end; k++) {
+        const auto dest = offsets[t][rows_[k]]++;
+        sorted_columns[dest] = columns_[k];
+        sorted_values[dest] = values_[k];
+      }
+    });
+    offsets.clear();
+
+    // sum duplicates within each row in place, splitting the rows between
+    // threads so that every thread gets about the same number of triplets
+    std::vector<SizeType> row_sizes(nrows, 0);
+    detail::run_parallel(nthreads, [&](const std::size_t t) {
+      const auto first_row = static_cast<SizeType>(
+          std::lower_bound(row_starts.begin(), row_starts.end() - 1,
+                           detail::part_begin(nnz, nthreads, t)) -
+          row_starts.begin());
+      const auto last_row = static_cast<SizeType>(
+          std::lower_bound(row_starts.begin(), row_starts.end() - 1,
+                           detail::part_begin(nnz, nthreads, t + 1)) -
+          row_starts.begin());
+      const auto rows_end = t + 1 == nthreads ? nrows : last_row;
+      // position (plus one) of each column in the row being compacted
+      std::vector<SizeType> last_position;
+      for (auto r = first_row; r < rows_end; r++) {
+        auto write = row_starts[r];
+        for (auto k = row_starts[r]; k < row_starts[r + 1]; k++) {
+          const auto column = static_cast<SizeType>(sorted_columns[k]);
+          if (column >= last_position.size()) {
+            last_position.resize(column + 1, 0);
+          }
+          if (last_position[column] > row_starts[r]) {
+            sorted_values[last_position[column] - 1] += sorted_values[k];
+            continue;
+          }
+          sorted_columns[write] = sorted_columns[k];
+          sorted_values[write] = sorted_values[k];
+          last_position[column] = ++write;
+        }
+        // drop the entries whose triplets summed to zero
+        const auto summed_end = write;
+        write = row_starts[r];
+        for (auto k = row_starts[r]; k < summed_end; k++) {
+          if (sorted_values[k] != T(0)) {
+            sorted_columns[write] = sorted_columns[k];
+            sorted_values[write] = sorted_values[k];
+            write++;
+          }
+        }
+        row_sizes[r] = write - row_starts[r];
+      }
+    });
+
+    // close the gaps left by the duplicates
+    std::vector<SizeType> starts(nrows + 1, 0);
+    for (SizeType r = 0; r < nrows; r++) {
+      starts[r + 1] = starts[r] + row_sizes[r];
+    }
+    if (starts[nrows] == nnz) {
+      return ConstraintBatch<T, I>(
+          std::move(sorted_values), std::move(sorted_columns),
+          std::move(row_starts), std::vector<T>(lower_bounds_),
+          std::vector<T>(upper_bounds_));
+    }
+    std::vector<Index> columns(starts[nrows]);
+    std::vector<T> values(starts[nrows]);
+    detail::run_parallel(nthreads, [&](const std::size_t t) {
+      const auto end = detail::part_begin(nrows, nthreads, t + 1);
+      for (auto r = detail::part_begin(nrows, nthreads, t); r < end; r++) {
+        using Diff = typename std::vector<T>::difference_type;
+        const auto from = static_cast<Diff>(row_starts[r]);
+        const auto to = static_cast<Diff>(starts[r]);
+        const auto size = static_cast<Diff>(row_sizes[r]);
+        std::copy(sorted_columns.begin() + from,
+                  sorted_columns.begin() + from + size, columns.begin() + to);
+        std::copy(sorted_values.begin() + from,
+                  sorted_values.begin() + from + size, values.begin() + to);
+      }
+    });
+    return ConstraintBatch<T, I>(std::move(values), std::move(columns),
+                                 std::move(starts),
+                                 std::vector<T>(lower_bounds_),
+                                 std::vector<T>(upper_bounds_));
+  }
+
+ private:
+  static constexpr std::size_t min_triplets_per_thread = 1 << 16;
+
+  std::vector<T> lower_bounds_;
+  std::vector<T> upper_bounds_;
+
+  std::vector<SizeType> rows_;
+  std::vector<Index> columns_;
+  std::vector<T> values_;
+};
+
+}  // namespace lpint
+
+#endif  // LPINTERFACE_TRIPLET_BATCH_H
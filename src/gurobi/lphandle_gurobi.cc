@@ -1,5 +1,9 @@
 #include "lpinterface/gurobi/lphandle_gurobi.hpp"
 
+#include <algorithm>
+
+#include "lpinterface/constraint_cursor.hpp"
+
 namespace lpint {
 
 std::size_t LinearProgramHandleGurobi::num_vars() const { return num_vars_; }
@@ -10,6 +14,9 @@ std::size_t LinearProgramHandleGurobi::num_constraints() const {
 
 void LinearProgramHandleGurobi::set_objective_sense(
     const OptimizationType objsense) {
+  if (transaction_.active()) {
+    transaction_.record_objective_sense(optimization_type());
+  }
   detail::gurobi_function_checked(
       GRBsetintattr, grb_model_.get(), GRB_INT_ATTR_MODELSENSE,
       objsense == OptimizationType::Maximize ? GRB_MAXIMIZE : GRB_MINIMIZE);
@@ -17,42 +24,71 @@ void LinearProgramHandleGurobi::set_objective_sense(
 }
 
 Variable LinearProgramHandleGurobi::variable(std::size_t i) const {
+  const auto col = detail::checked_narrow<int>(i);
   double lb, ub;
   detail::gurobi_function_checked(GRBgetdblattrelement, grb_model_.get(),
-                                  GRB_DBL_ATTR_LB, i, &lb);
+                                  GRB_DBL_ATTR_LB, col, &lb);
   detail::gurobi_function_checked(GRBgetdblattrelement, grb_model_.get(),
-                                  GRB_DBL_ATTR_UB, i, &ub);
+                                  GRB_DBL_ATTR_UB, col, &ub);
   return Variable(lb, ub);
 }
 
 std::vector<Variable> LinearProgramHandleGurobi::variables() const {
-  std::vector<Variable> vars;
-  for (std::size_t i = 0; i < num_vars_; i++) {
-    vars.emplace_back(variable(i));
+  return variable_block().variables();
+}
+
+VariableBlock LinearProgramHandleGurobi::variable_block() const {
+  std::vector<double> lower(num_vars_);
+  std::vector<double> upper(num_vars_);
+  if (num_vars_ > 0) {
+    const auto nvars = detail::checked_narrow<int>(num_vars_);
+    detail::gurobi_function_checked(GRBgetdblattrarray, grb_model_.get(),
+                                    GRB_DBL_ATTR_LB, 0, nvars, lower.data());
+    detail::gurobi_function_checked(GRBgetdblattrarray, grb_model_.get(),
+                                    GRB_DBL_ATTR_UB, 0, nvars, upper.data());
   }
-  return vars;
+  return VariableBlock(std::move(lower), std::move(upper));
 }
 
-void LinearProgramHandleGurobi::add_variables(
+VariableIdRange LinearProgramHandleGurobi::add_variables(
     const std::vector<Variable>& vars) {
-  num_vars_ += vars.size();
-  for (const auto& var : vars) {
-    detail::gurobi_function_checked(GRBaddvar, grb_model_.get(), 0, nullptr,
-                                    nullptr, 0.0, var.lower(), var.upper(),
-                                    GRB_CONTINUOUS, nullptr);
+  return add_variables(VariableBlock(vars));
+}
+
+VariableIdRange LinearProgramHandleGurobi::add_variables(
+    const VariableBlock& vars) {
+  if (vars.empty()) {
+    return variable_ids_.add(0);
+  }
+  if (transaction_.active()) {
+    transaction_.record_add_variables(num_vars_);
   }
+  detail::gurobi_function_checked(
+      GRBaddvars, grb_model_.get(), detail::checked_narrow<int>(vars.size()),
+      0, nullptr, nullptr, nullptr, nullptr,
+      const_cast<double*>(vars.lower().data()),
+      const_cast<double*>(vars.upper().data()), nullptr, nullptr);
   detail::gurobi_function_checked(GRBupdatemodel, grb_model_.get());
+  num_vars_ += vars.size();
+  cache_.invalidate_variables();
+  cache_.invalidate_objective();
+  return variable_ids_.add(vars.size());
 }
 
-void LinearProgramHandleGurobi::add_variables(const std::size_t num_vars) {
-  add_variables(std::vector<Variable>(num_vars));
+VariableIdRange LinearProgramHandleGurobi::add_variables(
+    const std::size_t num_vars) {
+  return add_variables(VariableBlock(num_vars));
 }
 
-void LinearProgramHandleGurobi::add_constraints(
+ConstraintIdRange LinearProgramHandleGurobi::add_constraints(
     const std::vector<Constraint<double>>& constraints) {
+  if (transaction_.active()) {
+    transaction_.record_add_constraints(num_constraints_);
+  }
   for (const auto& constraint : constraints) {
     detail::gurobi_function_checked(
-        GRBaddrangeconstr, grb_model_.get(), constraint.row.num_nonzero(),
+        GRBaddrangeconstr, grb_model_.get(),
+        detail::checked_narrow<int>(constraint.row.num_nonzero()),
         const_cast<Constraint<double>&>(constraint)
             .row.nonzero_indices()
             .data(),
@@ -65,31 +101,494 @@ void LinearProgramHandleGurobi::add_constraints(
     num_constraints_++;
   }
   detail::gurobi_function_checked(GRBupdatemodel, grb_model_.get());
+  cache_.append_constraints(constraints);
+  return constraint_ids_.add(constraints.size());
+}
+
+ConstraintIdRange LinearProgramHandleGurobi::add_constraints(
+    const ConstraintBatch<double>& batch) {
+  if (batch.empty()) {
+    return constraint_ids_.add(0);
+  }
+  if (transaction_.active()) {
+    transaction_.record_add_constraints(num_constraints_);
+  }
+  append_constraints(batch);
+  return constraint_ids_.add(batch.num_rows());
+}
+
+void LinearProgramHandleGurobi::append_constraints(
+    const ConstraintBatch<double>& batch) {
+  // the batch is already in CSR format, so it can be handed to
+  // gurobi in a single call; the extended API takes 64-bit offsets,
+  // so the total number of nonzeros is not limited to 2^31
+  detail::gurobi_function_checked(
+      GRBXaddrangeconstrs, grb_model_.get(),
+      detail::checked_narrow<int>(batch.num_rows()), batch.num_nonzero(),
+      const_cast<std::size_t*>(batch.row_starts().data()),
+      const_cast<int*>(batch.indices().data()),
+      const_cast<double*>(batch.values().data()),
+      const_cast<double*>(batch.lower_bounds().data()),
+      const_cast<double*>(batch.upper_bounds().data()), nullptr);
+  lower_bounds.insert(lower_bounds.end(), batch.lower_bounds().begin(),
+                      batch.lower_bounds().end());
+  upper_bounds.insert(upper_bounds.end(), batch.upper_bounds().begin(),
+                      batch.upper_bounds().end());
+  num_constraints_ += batch.num_rows();
+  detail::gurobi_function_checked(GRBupdatemodel, grb_model_.get());
+  cache_.append_constraints(batch);
 }
 
 void LinearProgramHandleGurobi::remove_variable(const std::size_t i) {
-  auto to_del = static_cast<int>(i);
+  if (transaction_.active()) {
+    double obj;
+    detail::gurobi_function_checked(GRBgetdblattrelement, grb_model_.get(),
+                                    GRB_DBL_ATTR_OBJ,
+                                    detail::checked_narrow<int>(i), &obj);
+    transaction_.record_remove_variable(i, variable(i), column(i), obj,
+                                        variable_ids_.id(i));
+  }
+  auto to_del = detail::checked_narrow<int>(i);
   detail::gurobi_function_checked(GRBdelvars, grb_model_.get(), 1, &to_del);
   detail::gurobi_function_checked(GRBupdatemodel, grb_model_.get());
+  objective_support_.remove_index(i);
+  variable_ids_.erase(i);
+  // removing a column shifts the indices of all later columns, so every
+  // cached entity is stale
+  cache_.invalidate_constraints();
+  cache_.invalidate_objective();
+  cache_.invalidate_variables();
   num_vars_--;
 }
 
 void LinearProgramHandleGurobi::remove_constraint(std::size_t i) {
-  int to_del = static_cast<int>(i);
+  if (transaction_.active()) {
+    transaction_.record_remove_constraint(i, constraint(i),
+                                          constraint_ids_.id(i));
+  }
+  auto to_del = detail::checked_narrow<int>(i);
   detail::gurobi_function_checked(GRBdelconstrs, grb_model_.get(), 1, &to_del);
   detail::gurobi_function_checked(GRBupdatemodel, grb_model_.get());
+  using Diff = std::vector<double>::difference_type;
+  lower_bounds.erase(lower_bounds.begin() + static_cast<Diff>(i));
+  upper_bounds.erase(upper_bounds.begin() + static_cast<Diff>(i));
+  constraint_ids_.erase(i);
+  cache_.erase_constraint(i);
   num_constraints_--;
 }
 
+void LinearProgramHandleGurobi::set_variable_bounds(const std::size_t i,
+                                                    const double lower,
+                                                    const double upper) {
+  if (lower > upper) {
+    throw InvalidVariableBoundsException();
+  }
+  if (transaction_.active()) {
+    const auto var = variable(i);
+    transaction_.record_variable_bounds(i, var.lower(), var.upper());
+  }
+  const auto col = detail::checked_narrow<int>(i);
+  detail::gurobi_function_checked(GRBsetdblattrelement, grb_model_.get(),
+                                  GRB_DBL_ATTR_LB, col, lower);
+  detail::gurobi_function_checked(GRBsetdblattrelement, grb_model_.get(),
+                                  GRB_DBL_ATTR_UB, col, upper);
+  detail::gurobi_function_checked(GRBupdatemodel, grb_model_.get());
+  cache_.invalidate_variables();
+}
+
+void LinearProgramHandleGurobi::set_constraint_bounds(const std::size_t i,
+                                                      const double lower,
+                                                      const double upper) {
+  if (transaction_.active()) {
+    transaction_.record_constraint_bounds(i, lower_bounds[i],
+                                          upper_bounds[i]);
+  }
+  // gurobi stores lower <= a^T x <= upper as a^T x - s = lower with a
+  // range variable 0 <= s <= upper - lower, which is the last entry of
+  // the row
+  const auto row = detail::checked_narrow<int>(i);
+  int nnz;
+  detail::gurobi_function_checked(GRBgetconstrs, grb_model_.get(), &nnz,
+                                  nullptr, nullptr, nullptr, row, 1);
+  std::vector<int> indices(static_cast<std::size_t>(nnz));
+  std::vector<double> values(static_cast<std::size_t>(nnz));
+  int cbeg;
+  detail::gurobi_function_checked(GRBgetconstrs, grb_model_.get(), &nnz,
+                                  &cbeg, indices.data(), values.data(), row,
+                                  1);
+  detail::gurobi_function_checked(GRBsetdblattrelement, grb_model_.get(),
+                                  GRB_DBL_ATTR_RHS, row, lower);
+  detail::gurobi_function_checked(GRBsetdblattrelement, grb_model_.get(),
+                                  GRB_DBL_ATTR_UB, indices.back(),
+                                  upper - lower);
+  detail::gurobi_function_checked(GRBupdatemodel, grb_model_.get());
+  lower_bounds[i] = lower;
+  upper_bounds[i] = upper;
+  cache_.invalidate_constraints();
+}
+
+void LinearProgramHandleGurobi::begin_transaction(const bool restore_basis) {
+  transaction_.begin();
+  saved_vbasis_.clear();
+  saved_cbasis_.clear();
+  saved_range_basis_.clear();
+  if (!restore_basis) {
+    return;
+  }
+  // gurobi adds a range variable for every constraint, which has a basis
+  // status of its own
+  int nvars;
+  detail::gurobi_function_checked(GRBgetintattr, grb_model_.get(),
+                                  GRB_INT_ATTR_NUMVARS, &nvars);
+  std::vector<int> vbasis(static_cast<std::size_t>(nvars));
+  std::vector<int> cbasis(num_constraints_);
+  // the basis attributes are only available after a simplex solve;
+  // without a basis there is nothing to restore
+  const auto has_basis =
+      GRBgetintattrarray(grb_model_.get(), GRB_INT_ATTR_VBASIS, 0, nvars,
+                         vbasis.data()) == 0 &&
+      GRBgetintattrarray(grb_model_.get(), GRB_INT_ATTR_CBASIS, 0,
+                         detail::checked_narrow<int>(num_constraints_),
+                         cbasis.data()) == 0;
+  if (!has_basis) {
+    return;
+  }
+  // rollback() may append the range variables in a different order, so
+  // their statuses are kept per constraint
+  const auto ranges = range_variables();
+  saved_range_basis_.reserve(ranges.size());
+  for (const auto j : ranges) {
+    saved_range_basis_.push_back(vbasis[static_cast<std::size_t>(j)]);
+  }
+  vbasis.resize(num_vars_);
+  saved_vbasis_ = std::move(vbasis);
+  saved_cbasis_ = std::move(cbasis);
+}
+
+void LinearProgramHandleGurobi::commit() {
+  transaction_.commit();
+  saved_vbasis_.clear();
+  saved_cbasis_.clear();
+  saved_range_basis_.clear();
+}
+
+void LinearProgramHandleGurobi::rollback() {
+  transaction_.rollback(*this);
+  if (saved_vbasis_.empty() && saved_cbasis_.empty()) {
+    return;
+  }
+  int nvars;
+  detail::gurobi_function_checked(GRBgetintattr, grb_model_.get(),
+                                  GRB_INT_ATTR_NUMVARS, &nvars);
+  auto vbasis = std::move(saved_vbasis_);
+  vbasis.resize(static_cast<std::size_t>(nvars), GRB_BASIC);
+  const auto ranges = range_variables();
+  for (std::size_t i = 0; i < ranges.size(); i++) {
+    vbasis[static_cast<std::size_t>(ranges[i])] = saved_range_basis_[i];
+  }
+  detail::gurobi_function_checked(GRBsetintattrarray, grb_model_.get(),
+                                  GRB_INT_ATTR_VBASIS, 0, nvars,
+                                  vbasis.data());
+  detail::gurobi_function_checked(
+      GRBsetintattrarray, grb_model_.get(), GRB_INT_ATTR_CBASIS, 0,
+      detail::checked_narrow<int>(saved_cbasis_.size()), saved_cbasis_.data());
+  detail::gurobi_function_checked(GRBupdatemodel, grb_model_.get());
+  saved_vbasis_.clear();
+  saved_cbasis_.clear();
+  saved_range_basis_.clear();
+}
+
+std::vector<int> LinearProgramHandleGurobi::range_variables() const {
+  // the range variable of a constraint is the last entry of its row
+  std::vector<int> ranges(num_constraints_);
+  if (num_constraints_ == 0) {
+    return ranges;
+  }
+  const auto nrows = detail::checked_narrow<int>(num_constraints_);
+  std::size_t nnz;
+  detail::gurobi_function_checked(GRBXgetconstrs, grb_model_.get(), &nnz,
+                                  nullptr, nullptr, nullptr, 0, nrows);
+  std::vector<std::size_t> cbeg(num_constraints_ + 1);
+  std::vector<int> indices(nnz);
+  std::vector<double> values(nnz);
+  detail::gurobi_function_checked(GRBXgetconstrs, grb_model_.get(), &nnz,
+                                  cbeg.data(), indices.data(), values.data(),
+                                  0, nrows);
+  cbeg[num_constraints_] = nnz;
+  for (std::size_t i = 0; i < num_constraints_; i++) {
+    ranges[i] = indices[cbeg[i + 1] - 1];
+  }
+  return ranges;
+}
+
+bool LinearProgramHandleGurobi::in_transaction() const {
+  return transaction_.active();
+}
+
+void LinearProgramHandleGurobi::delete_constraints_from(const std::size_t n) {
+  std::vector<int> to_del(num_constraints_ - n);
+  std::iota(to_del.begin(), to_del.end(), detail::checked_narrow<int>(n));
+  detail::gurobi_function_checked(GRBdelconstrs, grb_model_.get(),
+                                  detail::checked_narrow<int>(to_del.size()),
+                                  to_del.data());
+  detail::gurobi_function_checked(GRBupdatemodel, grb_model_.get());
+  lower_bounds.resize(n);
+  upper_bounds.resize(n);
+  num_constraints_ = n;
+  cache_.invalidate_constraints();
+}
+
+void LinearProgramHandleGurobi::delete_variables_from(const std::size_t n) {
+  std::vector<int> to_del(num_vars_ - n);
+  std::iota(to_del.begin(), to_del.end(), detail::checked_narrow<int>(n));
+  detail::gurobi_function_checked(GRBdelvars, grb_model_.get(),
+                                  detail::checked_narrow<int>(to_del.size()),
+                                  to_del.data());
+  detail::gurobi_function_checked(GRBupdatemodel, grb_model_.get());
+  num_vars_ = n;
+  cache_.invalidate_constraints();
+  cache_.invalidate_objective();
+  cache_.invalidate_variables();
+}
+
+void LinearProgramHandleGurobi::truncate_constraints(const std::size_t n) {
+  if (n >= num_constraints_) {
+    return;
+  }
+  delete_constraints_from(n);
+  constraint_ids_.truncate(n);
+}
+
+void LinearProgramHandleGurobi::truncate_variables(const std::size_t n) {
+  if (n >= num_vars_) {
+    return;
+  }
+  delete_variables_from(n);
+  objective_support_.truncate(n);
+  variable_ids_.truncate(n);
+}
+
+void LinearProgramHandleGurobi::insert_constraints(
+    const std::vector<detail::TransactionLog::RemovedConstraint>& removed) {
+  // gurobi can only append constraints, so the constraints from the first
+  // restored position on are read back once, the restored ones are put in
+  // between, and the whole tail is appended again in a single call
+  auto first = num_constraints_;
+  for (const auto& entry : removed) {
+    first = std::min(first, entry.position);
+  }
+  ConstraintBatch<double> tail;
+  auto append_row = [](ConstraintBatch<double>& rows, const double lower,
+                       const double upper, const int* indices,
+                       const double* values, const std::size_t nnz) {
+    rows.begin_row(lower, upper);
+    for (std::size_t k = 0; k < nnz; k++) {
+      rows.push(indices[k], values[k]);
+    }
+    rows.end_row();
+  };
+  ConstraintCursor cursor(*this, first, num_constraints_);
+  while (cursor.next()) {
+    const auto& c = cursor.current();
+    append_row(tail, c.lower_bound, c.upper_bound,
+               c.row.nonzero_indices().data(), c.row.values().data(),
+               c.row.num_nonzero());
+  }
+
+  // final order of the tail; entries below ntail refer to rows of tail,
+  // the others to restored constraints
+  const auto ntail = tail.num_rows();
+  std::vector<std::size_t> order(ntail);
+  std::iota(order.begin(), order.end(), std::size_t{0});
+  std::size_t nnz = tail.num_nonzero();
+  using Diff = std::vector<std::size_t>::difference_type;
+  for (std::size_t k = 0; k < removed.size(); k++) {
+    order.insert(order.begin() + static_cast<Diff>(removed[k].position - first),
+                 ntail + k);
+    nnz += removed[k].constraint->row.num_nonzero();
+  }
+  ConstraintBatch<double> rows;
+  rows.reserve(order.size(), nnz);
+  for (const auto k : order) {
+    if (k < ntail) {
+      const auto begin = tail.row_starts()[k];
+      append_row(rows, tail.lower_bounds()[k], tail.upper_bounds()[k],
+                 tail.indices().data() + begin, tail.values().data() + begin,
+                 tail.row_size(k));
+    } else {
+      const auto& c = *removed[k - ntail].constraint;
+      append_row(rows, c.lower_bound, c.upper_bound,
+                 c.row.nonzero_indices().data(), c.row.values().data(),
+                 c.row.num_nonzero());
+    }
+  }
+  delete_constraints_from(first);
+  append_constraints(rows);
+  for (const auto& entry : removed) {
+    constraint_ids_.insert(entry.position, entry.id);
+  }
+}
+
+void LinearProgramHandleGurobi::insert_variables(
+    const std::vector<detail::TransactionLog::RemovedVariable>& removed) {
+  // gurobi can only append variables, so the variables from the first
+  // restored position on are read back once with their coefficients, the
+  // restored ones are put in between, and all of them are appended again
+  // in a single call
+  auto first = num_vars_;
+  for (const auto& entry : removed) {
+    first = std::min(first, entry.position);
+  }
+  const auto ntail = num_vars_ - first;
+  const auto start = detail::checked_narrow<int>(first);
+  const auto len = detail::checked_narrow<int>(ntail);
+  std::size_t tail_nnz = 0;
+  std::vector<std::size_t> tail_beg(ntail + 1, 0);
+  std::vector<int> tail_ind;
+  std::vector<double> tail_val;
+  std::vector<double> tail_obj(ntail);
+  std::vector<double> tail_lb(ntail);
+  std::vector<double> tail_ub(ntail);
+  if (ntail > 0) {
+    detail::gurobi_function_checked(GRBXgetvars, grb_model_.get(), &tail_nnz,
+                                    nullptr, nullptr, nullptr, start, len);
+    tail_ind.resize(tail_nnz);
+    tail_val.resize(tail_nnz);
+    detail::gurobi_function_checked(GRBXgetvars, grb_model_.get(), &tail_nnz,
+                                    tail_beg.data(), tail_ind.data(),
+                                    tail_val.data(), start, len);
+    tail_beg[ntail] = tail_nnz;
+    detail::gurobi_function_checked(GRBgetdblattrarray, grb_model_.get(),
+                                    GRB_DBL_ATTR_OBJ, start, len,
+                                    tail_obj.data());
+    detail::gurobi_function_checked(GRBgetdblattrarray, grb_model_.get(),
+                                    GRB_DBL_ATTR_LB, start, len,
+                                    tail_lb.data());
+    detail::gurobi_function_checked(GRBgetdblattrarray, grb_model_.get(),
+                                    GRB_DBL_ATTR_UB, start, len,
+                                    tail_ub.data());
+  }
+
+  // final order of the tail; entries below ntail refer to tail columns,
+  // the others to restored variables
+  std::vector<std::size_t> order(ntail);
+  std::iota(order.begin(), order.end(), std::size_t{0});
+  auto nnz = tail_nnz;
+  using Diff = std::vector<std::size_t>::difference_type;
+  for (std::size_t k = 0; k < removed.size(); k++) {
+    order.insert(order.begin() + static_cast<Diff>(removed[k].position - first),
+                 ntail + k);
+    nnz += removed[k].column->num_nonzero();
+  }
+  std::vector<std::size_t> vbeg;
+  std::vector<int> vind;
+  std::vector<double> vval;
+  std::vector<double> obj;
+  std::vector<double> lb;
+  std::vector<double> ub;
+  vbeg.reserve(order.size());
+  vind.reserve(nnz);
+  vval.reserve(nnz);
+  obj.reserve(order.size());
+  lb.reserve(order.size());
+  ub.reserve(order.size());
+  for (const auto k : order) {
+    vbeg.push_back(vind.size());
+    if (k < ntail) {
+      using IndexDiff = std::vector<int>::difference_type;
+      const auto begin = static_cast<IndexDiff>(tail_beg[k]);
+      const auto end = static_cast<IndexDiff>(tail_beg[k + 1]);
+      vind.insert(vind.end(), tail_ind.begin() + begin,
+                  tail_ind.begin() + end);
+      vval.insert(vval.end(), tail_val.begin() + begin,
+                  tail_val.begin() + end);
+      obj.push_back(tail_obj[k]);
+      lb.push_back(tail_lb[k]);
+      ub.push_back(tail_ub[k]);
+    } else {
+      const auto& entry = removed[k - ntail];
+      vind.insert(vind.end(), entry.column->nonzero_indices().begin(),
+                  entry.column->nonzero_indices().end());
+      vval.insert(vval.end(), entry.column->values().begin(),
+                  entry.column->values().end());
+      obj.push_back(entry.objective);
+      lb.push_back(entry.variable.lower());
+      ub.push_back(entry.variable.upper());
+    }
+  }
+  if (ntail > 0) {
+    delete_variables_from(first);
+  }
+  detail::gurobi_function_checked(
+      GRBXaddvars, grb_model_.get(), detail::checked_narrow<int>(order.size()),
+      vind.size(), vbeg.data(), vind.data(), vval.data(), obj.data(),
+      lb.data(), ub.data(), nullptr, nullptr);
+  detail::gurobi_function_checked(GRBupdatemodel, grb_model_.get());
+  num_vars_ = first + order.size();
+  for (const auto& entry : removed) {
+    objective_support_.insert_index(entry.position, entry.objective != 0.0);
+    variable_ids_.insert(entry.position, entry.id);
+  }
+  cache_.invalidate_constraints();
+  cache_.invalidate_objective();
+  cache_.invalidate_variables();
+}
+
+std::size_t LinearProgramHandleGurobi::position(const ConstraintId id) const {
+  return constraint_ids_.position(id);
+}
+
+std::size_t LinearProgramHandleGurobi::position(const VariableId id) const {
+  return variable_ids_.position(id);
+}
+
+ConstraintId LinearProgramHandleGurobi::constraint_id(
+    const std::size_t i) const {
+  return constraint_ids_.id(i);
+}
+
+VariableId LinearProgramHandleGurobi::variable_id(const std::size_t i) const {
+  return variable_ids_.id(i);
+}
+
 void LinearProgramHandleGurobi::set_objective(
     const Objective<double>& objective) {
   if (num_vars_ != objective.values.size()) {
     throw MismatchedDimensionsException();
   }
+  if (transaction_.active()) {
+    transaction_.record_objective(sparse_objective());
+  }
   detail::gurobi_function_checked(
-      GRBsetdblattrarray, grb_model_.get(), GRB_DBL_ATTR_OBJ, 0, num_vars_,
+      GRBsetdblattrarray, grb_model_.get(), GRB_DBL_ATTR_OBJ, 0,
+      detail::checked_narrow<int>(num_vars_),
       const_cast<Objective<double>&>(objective).values.data());
   detail::gurobi_function_checked(GRBupdatemodel, grb_model_.get());
+  objective_support_.assign_dense(objective.values);
+  cache_.invalidate_objective();
+}
+
+void LinearProgramHandleGurobi::set_objective(
+    const SparseObjective<double>& objective) {
+  detail::check_sparse_objective(objective, num_vars_);
+  if (transaction_.active()) {
+    transaction_.record_objective(sparse_objective());
+  }
+  auto cleared = objective_support_.assign_sparse(objective.nonzero_indices());
+  if (!cleared.empty()) {
+    std::vector<double> zeros(cleared.size(), 0.0);
+    detail::gurobi_function_checked(
+        GRBsetdblattrlist, grb_model_.get(), GRB_DBL_ATTR_OBJ,
+        detail::checked_narrow<int>(cleared.size()), cleared.data(),
+        zeros.data());
+  }
+  detail::gurobi_function_checked(
+      GRBsetdblattrlist, grb_model_.get(), GRB_DBL_ATTR_OBJ,
+      detail::checked_narrow<int>(objective.num_nonzero()),
+      const_cast<int*>(objective.nonzero_indices().data()),
+      const_cast<double*>(objective.values().data()));
+  detail::gurobi_function_checked(GRBupdatemodel, grb_model_.get());
+  cache_.invalidate_objective();
 }
 
 OptimizationType LinearProgramHandleGurobi::optimization_type() const {
@@ -101,19 +600,79 @@ OptimizationType LinearProgramHandleGurobi::optimization_type() const {
 }
 
 Constraint<double> LinearProgramHandleGurobi::constraint(std::size_t i) const {
+  Constraint<double> constraint;
+  read_constraint(i, constraint);
+  return constraint;
+}
+
+void LinearProgramHandleGurobi::read_constraint(
+    std::size_t i, Constraint<double>& buffer) const {
+  const auto start = detail::checked_narrow<int>(i);
   int nnz;
   detail::gurobi_function_checked(GRBgetconstrs, grb_model_.get(), &nnz,
-                                  nullptr, nullptr, nullptr, i, 1);
-  // allocate data
-  std::vector<double> values(static_cast<std::size_t>(nnz));
-  std::vector<int> indices(static_cast<std::size_t>(nnz));
+                                  nullptr, nullptr, nullptr, start, 1);
+  // resizing keeps the capacity of the buffer, so reused buffers
+  // only allocate when a row is longer than any row read before
+  auto& values = buffer.row.values();
+  auto& indices = buffer.row.nonzero_indices();
+  values.resize(static_cast<std::size_t>(nnz));
+  indices.resize(static_cast<std::size_t>(nnz));
   int cbeg;
   detail::gurobi_function_checked(GRBgetconstrs, grb_model_.get(), &nnz,
-                                  &cbeg, indices.data(), values.data(), i, 1);
+                                  &cbeg, indices.data(), values.data(), start,
+                                  1);
+  // the last entry belongs to the range variable gurobi adds
+  // for range constraints
+  if (nnz > 0) {
+    values.pop_back();
+    indices.pop_back();
+  }
+  buffer.lower_bound = lower_bounds[i];
+  buffer.upper_bound = upper_bounds[i];
+}
 
-  Row<double> row(std::vector<double>(values.begin(), values.end() - 1),
-                  std::vector<int>(indices.begin(), indices.end() - 1));
-  return Constraint<double>(std::move(row), lower_bounds[i], upper_bounds[i]);
+Column<double> LinearProgramHandleGurobi::column(std::size_t j) const {
+  const auto start = detail::checked_narrow<int>(j);
+  int nnz;
+  detail::gurobi_function_checked(GRBgetvars, grb_model_.get(), &nnz,
+                                  nullptr, nullptr, nullptr, start, 1);
+  std::vector<double> values(static_cast<std::size_t>(nnz));
+  std::vector<int> indices(static_cast<std::size_t>(nnz));
+  int vbeg;
+  detail::gurobi_function_checked(GRBgetvars, grb_model_.get(), &nnz, &vbeg,
+                                  indices.data(), values.data(), start, 1);
+  return Column<double>(values, indices);
+}
+
+std::vector<Column<double>> LinearProgramHandleGurobi::columns() const {
+  std::vector<Column<double>> cols;
+  if (num_vars_ == 0) {
+    return cols;
+  }
+  // read the whole matrix column-wise in a single call; the extended
+  // API uses 64-bit offsets, so the number of nonzeros is not limited
+  // to 2^31
+  const auto nvars = detail::checked_narrow<int>(num_vars_);
+  std::size_t nnz;
+  detail::gurobi_function_checked(GRBXgetvars, grb_model_.get(), &nnz,
+                                  nullptr, nullptr, nullptr, 0, nvars);
+  std::vector<std::size_t> vbeg(num_vars_ + 1);
+  std::vector<int> indices(nnz);
+  std::vector<double> values(nnz);
+  detail::gurobi_function_checked(GRBXgetvars, grb_model_.get(), &nnz,
+                                  vbeg.data(), indices.data(), values.data(),
+                                  0, nvars);
+  vbeg[num_vars_] = nnz;
+  cols.reserve(num_vars_);
+  using Diff = std::vector<double>::difference_type;
+  for (std::size_t j = 0; j < num_vars_; j++) {
+    const auto begin = static_cast<Diff>(vbeg[j]);
+    const auto end = static_cast<Diff>(vbeg[j + 1]);
+    cols.emplace_back(
+        std::vector<double>(values.begin() + begin, values.begin() + end),
+        std::vector<int>(indices.begin() + begin, indices.begin() + end));
+  }
+  return cols;
 }
 
 std::vector<Constraint<double>> LinearProgramHandleGurobi::constraints() const {
@@ -131,12 +690,45 @@ Objective<double> LinearProgramHandleGurobi::objective() const {
   for (std::size_t i = 0; i < nvars; i++) {
     double obj;
     detail::gurobi_function_checked(GRBgetdblattrelement, grb_model_.get(),
-                                    GRB_DBL_ATTR_OBJ, i, &obj);
+                                    GRB_DBL_ATTR_OBJ,
+                                    detail::checked_narrow<int>(i), &obj);
     values.push_back(obj);
   }
   return Objective<double>(std::move(values));
 }
 
+SparseObjective<double> LinearProgramHandleGurobi::sparse_objective() const {
+  auto indices = objective_support_.indices();
+  std::vector<double> values(indices.size());
+  if (!indices.empty()) {
+    detail::gurobi_function_checked(
+        GRBgetdblattrlist, grb_model_.get(), GRB_DBL_ATTR_OBJ,
+        detail::checked_narrow<int>(indices.size()), indices.data(),
+        values.data());
+  }
+  return SparseObjective<double>(values, indices);
+}
+
+const std::vector<Constraint<double>>&
+LinearProgramHandleGurobi::cached_constraints() const {
+  return cache_.constraints([this] { return constraints(); });
+}
+
+const Objective<double>& LinearProgramHandleGurobi::cached_objective() const {
+  return cache_.objective([this] { return objective(); });
+}
+
+const std::vector<Variable>& LinearProgramHandleGurobi::cached_variables()
+    const {
+  return cache_.variables([this] { return variables(); });
+}
+
+void LinearProgramHandleGurobi::clear_cache() { cache_.clear(); }
+
+void LinearProgramHandleGurobi::set_cache_enabled(const bool enabled) {
+  cache_.set_enabled(enabled);
+}
+
 std::shared_ptr<GRBmodel> LinearProgramHandleGurobi::gurobi_model(
     detail::Badge<GurobiSolver>) const {
   return grb_model_;
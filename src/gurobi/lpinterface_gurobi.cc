@@ -68,14 +68,15 @@ Status GurobiSolver::solve() {
   auto num_vars = lp_handle_.num_vars();
   solution_.primal.resize(num_vars);
   detail::gurobi_function_checked(GRBgetdblattrarray, gurobi_model_.get(),
-                                  GRB_DBL_ATTR_X, 0, static_cast<int>(num_vars),
+                                  GRB_DBL_ATTR_X, 0,
+                                  detail::checked_narrow<int>(num_vars),
                                   solution_.primal.data());
 
   auto num_constraints = lp_handle_.num_constraints();
   solution_.dual.resize(num_constraints);
   detail::gurobi_function_checked(
       GRBgetdblattrarray, gurobi_model_.get(), GRB_DBL_ATTR_PI, 0,
-      static_cast<int>(num_constraints), solution_.dual.data());
+      detail::checked_narrow<int>(num_constraints), solution_.dual.data());
   return status;
 }
 
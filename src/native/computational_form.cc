@@ -0,0 +1,73 @@
+#include "lpinterface/native/computational_form.hpp"
+
+namespace lpint {
+
+namespace detail {
+
+ComputationalForm make_computational_form(const ILinearProgramHandle& lp) {
+  const auto& constraints = lp.cached_constraints();
+  const auto& variables = lp.cached_variables();
+  const auto& objective = lp.cached_objective().values;
+
+  ComputationalForm form;
+  form.num_rows = constraints.size();
+  form.num_columns = variables.size();
+
+  // count the entries of each column, then fill them in row order, so the
+  // row indices within each column end up sorted
+  form.column_starts.assign(form.num_columns + 1, 0);
+  for (const auto& constraint : constraints) {
+    for (const auto j : constraint.row.nonzero_indices()) {
+      form.column_starts[static_cast<std::size_t>(j) + 1]++;
+    }
+  }
+  for (std::size_t j = 0; j < form.num_columns; j++) {
+    form.column_starts[j + 1] += form.column_starts[j];
+  }
+  const auto nnz = form.column_starts.back();
+  form.row_indices.resize(nnz);
+  form.values.resize(nnz);
+  auto next = form.column_starts;
+  for (std::size_t i = 0; i < form.num_rows; i++) {
+    const auto& row = constraints[i].row;
+    for (std::size_t k = 0; k < row.num_nonzero(); k++) {
+      const auto j = static_cast<std::size_t>(row.nonzero_indices()[k]);
+      form.row_indices[next[j]] = i;
+      form.values[next[j]] = row.values()[k];
+      next[j]++;
+    }
+  }
+
+  const double sign =
+      lp.optimization_type() == OptimizationType::Maximize ? -1.0 : 1.0;
+  form.cost.assign(form.num_columns, 0.0);
+  for (std::size_t j = 0; j < form.num_columns && j < objective.size();
+       j++) {
+    form.cost[j] = sign * objective[j];
+  }
+  form.lower.reserve(form.num_columns + form.num_rows);
+  form.upper.reserve(form.num_columns + form.num_rows);
+  for (const auto& var : variables) {
+    form.lower.push_back(var.lower());
+    form.upper.push_back(var.upper());
+  }
+  for (const auto& constraint : constraints) {
+    form.lower.push_back(constraint.lower_bound);
+    form.upper.push_back(constraint.upper_bound);
+  }
+  return form;
+}
+
+bool bounds_consistent(const ComputationalForm& model,
+                       const double tolerance) {
+  for (std::size_t j = 0; j < model.lower.size(); j++) {
+    if (model.lower[j] > model.upper[j] + tolerance) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace detail
+
+}  // namespace lpint
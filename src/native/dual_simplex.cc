@@ -0,0 +1,604 @@
+#include "lpinterface/native/dual_simplex.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace lpint {
+
+namespace detail {
+
+namespace {
+
+// bound violations below this are considered feasible
+constexpr double primal_tolerance = 1e-9;
+// reduced costs of the wrong sign below this are considered feasible
+constexpr double dual_tolerance = 1e-9;
+// pivot row entries below this are never chosen as pivots
+constexpr double pivot_tolerance = 1e-9;
+// breakpoints this close to each other are considered tied
+constexpr double tie_tolerance = 1e-12;
+// number of basis updates after which the basis is refactorized
+constexpr std::size_t refactor_interval = 100;
+// number of times dual feasibility is restored after numerical trouble
+constexpr std::size_t max_restarts = 5;
+// relative size of the cost perturbation against stalling
+constexpr double perturbation = 5e-7;
+
+struct Breakpoint {
+  std::size_t variable;
+  double ratio;
+  double magnitude;
+};
+
+}  // namespace
+
+DualSimplex::DualSimplex(ComputationalForm model)
+    : model_(std::move(model)),
+      num_vars_(model_.num_columns + model_.num_rows),
+      cost_(num_vars_, 0.0) {
+  const auto m = model_.num_rows;
+  const auto n = model_.num_columns;
+  std::copy(model_.cost.begin(), model_.cost.end(), cost_.begin());
+  row_starts_.assign(m + 1, 0);
+  for (const auto i : model_.row_indices) {
+    row_starts_[i + 1]++;
+  }
+  for (std::size_t i = 0; i < m; i++) {
+    row_starts_[i + 1] += row_starts_[i];
+  }
+  column_indices_.resize(row_starts_.back());
+  row_values_.resize(row_starts_.back());
+  auto next = row_starts_;
+  for (std::size_t j = 0; j < n; j++) {
+    for (auto k = model_.column_starts[j]; k < model_.column_starts[j + 1];
+         k++) {
+      const auto i = model_.row_indices[k];
+      column_indices_[next[i]] = j;
+      row_values_[next[i]] = model_.values[k];
+      next[i]++;
+    }
+  }
+
+  // slack basis
+  std::vector<BasisStatus> basis(num_vars_, BasisStatus::AtLower);
+  std::fill(basis.begin() + static_cast<std::ptrdiff_t>(n), basis.end(),
+            BasisStatus::Basic);
+  set_basis(basis);
+}
+
+template <class F>
+void DualSimplex::for_each_entry(const std::size_t j, F f) const {
+  if (j < model_.num_columns) {
+    for (auto k = model_.column_starts[j]; k < model_.column_starts[j + 1];
+         k++) {
+      f(model_.row_indices[k], model_.values[k]);
+    }
+  } else {
+    f(j - model_.num_columns, -1.0);
+  }
+}
+
+void DualSimplex::set_basis(const std::vector<BasisStatus>& basis) {
+  if (basis.size() != num_vars_) {
+    throw MismatchedDimensionsException();
+  }
+  status_ = basis;
+  const auto m = model_.num_rows;
+  const auto n = model_.num_columns;
+
+  // keep at most one basic variable per row, preferring structural ones
+  std::size_t num_basic = 0;
+  for (std::size_t j = 0; j < num_vars_; j++) {
+    if (status_[j] == BasisStatus::Basic) {
+      if (num_basic < m) {
+        num_basic++;
+      } else {
+        status_[j] = BasisStatus::AtLower;
+      }
+    }
+  }
+  for (std::size_t i = 0; i < m && num_basic < m; i++) {
+    if (status_[n + i] != BasisStatus::Basic) {
+      status_[n + i] = BasisStatus::Basic;
+      num_basic++;
+    }
+  }
+  basic_.clear();
+  for (std::size_t j = 0; j < num_vars_; j++) {
+    if (status_[j] == BasisStatus::Basic) {
+      basic_.push_back(j);
+    }
+  }
+
+  x_.assign(num_vars_, 0.0);
+  d_.assign(num_vars_, 0.0);
+  reset_nonbasic_values();
+  factorize();
+}
+
+double DualSimplex::nonbasic_value(const std::size_t j) const {
+  switch (status_[j]) {
+    case BasisStatus::AtLower:
+      return model_.lower[j];
+    case BasisStatus::AtUpper:
+      return model_.upper[j];
+    case BasisStatus::Basic:
+    case BasisStatus::AtZero:
+    default:
+      return 0.0;
+  }
+}
+
+void DualSimplex::reset_nonbasic_values() {
+  for (std::size_t j = 0; j < num_vars_; j++) {
+    auto& status = status_[j];
+    if (status == BasisStatus::Basic) {
+      continue;
+    }
+    // put the variable at a finite bound if there is one
+    const bool has_lower = !std::isinf(model_.lower[j]);
+    const bool has_upper = !std::isinf(model_.upper[j]);
+    if (status == BasisStatus::AtLower && !has_lower) {
+      status = has_upper ? BasisStatus::AtUpper : BasisStatus::AtZero;
+    } else if (status == BasisStatus::AtUpper && !has_upper) {
+      status = has_lower ? BasisStatus::AtLower : BasisStatus::AtZero;
+    } else if (status == BasisStatus::AtZero && (has_lower || has_upper)) {
+      status = has_lower ? BasisStatus::AtLower : BasisStatus::AtUpper;
+    }
+    x_[j] = nonbasic_value(j);
+  }
+}
+
+void DualSimplex::factorize() {
+  const auto m = model_.num_rows;
+  std::vector<SparseLU::SparseColumn> columns(m);
+  // replace the columns that could not be pivoted by logical ones until the
+  // basis is nonsingular; a basis of logical columns always is
+  while (true) {
+    for (std::size_t p = 0; p < m; p++) {
+      columns[p].clear();
+      for_each_entry(basic_[p], [&](const std::size_t i, const double value) {
+        columns[p].emplace_back(i, value);
+      });
+    }
+    const auto singular = lu_.factorize(m, columns);
+    if (singular.empty()) {
+      return;
+    }
+    for (const auto& entry : singular) {
+      const auto removed = basic_[entry.first];
+      const auto logical = model_.num_columns + entry.second;
+      status_[removed] = BasisStatus::AtLower;
+      status_[logical] = BasisStatus::Basic;
+      basic_[entry.first] = logical;
+    }
+    reset_nonbasic_values();
+  }
+}
+
+void DualSimplex::compute_primal() {
+  const auto m = model_.num_rows;
+  reset_nonbasic_values();
+  // B x_B = -N x_N
+  std::vector<double> rhs(m, 0.0);
+  for (std::size_t j = 0; j < num_vars_; j++) {
+    if (status_[j] == BasisStatus::Basic || x_[j] == 0.0) {
+      continue;
+    }
+    const auto value = x_[j];
+    for_each_entry(j, [&](const std::size_t i, const double a) {
+      rhs[i] -= a * value;
+    });
+  }
+  lu_.ftran(rhs);
+  for (std::size_t p = 0; p < m; p++) {
+    x_[basic_[p]] = rhs[p];
+  }
+}
+
+std::vector<double> DualSimplex::dual() const {
+  std::vector<double> y(model_.num_rows, 0.0);
+  for (std::size_t p = 0; p < model_.num_rows; p++) {
+    y[p] = cost_[basic_[p]];
+  }
+  lu_.btran(y);
+  return y;
+}
+
+void DualSimplex::compute_dual() {
+  const auto y = dual();
+  for (std::size_t j = 0; j < num_vars_; j++) {
+    if (status_[j] == BasisStatus::Basic) {
+      d_[j] = 0.0;
+    } else {
+      double value = cost_[j];
+      for_each_entry(j, [&](const std::size_t i, const double a) {
+        value -= a * y[i];
+      });
+      d_[j] = value;
+    }
+  }
+}
+
+std::size_t DualSimplex::fix_dual_infeasibilities(const bool flip) {
+  std::size_t num_infeasible = 0;
+  for (std::size_t j = 0; j < num_vars_; j++) {
+    auto& status = status_[j];
+    if (status == BasisStatus::Basic) {
+      continue;
+    }
+    const bool boxed =
+        !std::isinf(model_.lower[j]) && !std::isinf(model_.upper[j]);
+    if (boxed) {
+      if (flip && status == BasisStatus::AtLower && d_[j] < -dual_tolerance) {
+        status = BasisStatus::AtUpper;
+      } else if (flip && status == BasisStatus::AtUpper &&
+                 d_[j] > dual_tolerance) {
+        status = BasisStatus::AtLower;
+      }
+    }
+    if ((status == BasisStatus::AtLower && d_[j] < -dual_tolerance) ||
+        (status == BasisStatus::AtUpper && d_[j] > dual_tolerance) ||
+        (status == BasisStatus::AtZero && std::abs(d_[j]) > dual_tolerance)) {
+      num_infeasible++;
+    }
+  }
+  return num_infeasible;
+}
+
+bool DualSimplex::time_exceeded(const double time_limit) const {
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start_;
+  return elapsed.count() >= time_limit;
+}
+
+DualSimplex::LoopResult DualSimplex::iterate(
+    const std::size_t iteration_limit, const double time_limit) {
+  const auto m = model_.num_rows;
+  const auto n = model_.num_columns;
+  std::vector<double> rho(m);
+  std::vector<double> alpha_row(num_vars_);
+  // positions of the entries of alpha_row that were touched
+  std::vector<std::size_t> row_nonzeros;
+  std::vector<bool> in_row(num_vars_, false);
+  std::vector<double> alpha_column(m);
+  std::vector<Breakpoint> breakpoints;
+  std::vector<std::size_t> flips;
+
+  while (true) {
+    // limits are checked before optimality, so that a zero limit always
+    // stops the solve
+    if (time_exceeded(time_limit)) {
+      return LoopResult::TimeOut;
+    }
+    if (iterations_ >= iteration_limit) {
+      return LoopResult::IterationLimit;
+    }
+    if (lu_.num_updates() >= refactor_interval) {
+      factorize();
+      compute_dual();
+      if (fix_dual_infeasibilities(true) > 0) {
+        return LoopResult::DualInfeasible;
+      }
+      compute_primal();
+    }
+
+    // leaving variable: the largest bound violation
+    std::size_t r = m;
+    double largest = primal_tolerance;
+    for (std::size_t p = 0; p < m; p++) {
+      const auto j = basic_[p];
+      const auto violation =
+          std::max(model_.lower[j] - x_[j], x_[j] - model_.upper[j]);
+      if (violation > largest) {
+        largest = violation;
+        r = p;
+      }
+    }
+    if (r == m) {
+      if (lu_.num_updates() == 0) {
+        return LoopResult::Optimal;
+      }
+      // confirm optimality with fresh values
+      factorize();
+      compute_dual();
+      if (fix_dual_infeasibilities(true) > 0) {
+        return LoopResult::DualInfeasible;
+      }
+      compute_primal();
+      continue;
+    }
+    const auto leaving = basic_[r];
+    const bool to_lower = x_[leaving] < model_.lower[leaving];
+    const auto bound = to_lower ? model_.lower[leaving]
+                                : model_.upper[leaving];
+
+    // pivot row: alpha_j = e_r^T B^-1 a_j
+    std::fill(rho.begin(), rho.end(), 0.0);
+    rho[r] = 1.0;
+    lu_.btran(rho);
+    for (const auto j : row_nonzeros) {
+      alpha_row[j] = 0.0;
+      in_row[j] = false;
+    }
+    row_nonzeros.clear();
+    for (std::size_t i = 0; i < m; i++) {
+      const auto value = rho[i];
+      if (value == 0.0) {
+        continue;
+      }
+      for (auto k = row_starts_[i]; k < row_starts_[i + 1]; k++) {
+        const auto j = column_indices_[k];
+        if (!in_row[j]) {
+          in_row[j] = true;
+          row_nonzeros.push_back(j);
+        }
+        alpha_row[j] += value * row_values_[k];
+      }
+      in_row[n + i] = true;
+      row_nonzeros.push_back(n + i);
+      alpha_row[n + i] = -value;
+    }
+
+    // bound-flipping ratio test; the reduced cost of the leaving variable
+    // moves away from zero in the direction allowed by the bound it leaves
+    // at, and the reduced costs of the others move with -t * alpha_j
+    const double sign = to_lower ? -1.0 : 1.0;
+    breakpoints.clear();
+    for (const auto j : row_nonzeros) {
+      const auto status = status_[j];
+      if (status == BasisStatus::Basic ||
+          std::abs(alpha_row[j]) < pivot_tolerance) {
+        continue;
+      }
+      const auto a = sign * alpha_row[j];
+      if ((status == BasisStatus::AtLower && a > 0.0) ||
+          (status == BasisStatus::AtUpper && a < 0.0) ||
+          status == BasisStatus::AtZero) {
+        breakpoints.push_back(
+            {j, std::max(0.0, d_[j] / a), std::abs(alpha_row[j])});
+      }
+    }
+    // the breakpoints are kept in a heap, so that only the passed ones
+    // are ever ordered
+    const auto later = [](const Breakpoint& a, const Breakpoint& b) {
+      return a.ratio > b.ratio;
+    };
+    std::make_heap(breakpoints.begin(), breakpoints.end(), later);
+    const auto pop = [&breakpoints, &later]() {
+      std::pop_heap(breakpoints.begin(), breakpoints.end(), later);
+      const auto next = breakpoints.back();
+      breakpoints.pop_back();
+      return next;
+    };
+
+    // pass breakpoints of boxed variables as long as the dual objective
+    // keeps improving; the last breakpoint is never passed if flipping
+    // would only just remove the infeasibility
+    double slope = std::abs(x_[leaving] - bound);
+    bool blocked = false;
+    Breakpoint last{0, 0.0, 0.0};
+    flips.clear();
+    while (!blocked && !breakpoints.empty()) {
+      last = pop();
+      const auto j = last.variable;
+      const auto range = model_.upper[j] - model_.lower[j];
+      const auto next_slope = slope - last.magnitude * range;
+      if (std::isinf(range) || next_slope <= primal_tolerance) {
+        blocked = true;
+      } else {
+        slope = next_slope;
+        flips.push_back(j);
+      }
+    }
+    if (!blocked) {
+      return LoopResult::Infeasible;
+    }
+    // among tied breakpoints, take the largest pivot
+    auto chosen = last;
+    while (!breakpoints.empty() &&
+           breakpoints.front().ratio <= last.ratio + tie_tolerance) {
+      const auto tied = pop();
+      if (tied.magnitude > chosen.magnitude) {
+        chosen = tied;
+      }
+    }
+    const auto entering = chosen.variable;
+
+    // entering column: B^-1 a_q
+    std::fill(alpha_column.begin(), alpha_column.end(), 0.0);
+    for_each_entry(entering, [&](const std::size_t i, const double a) {
+      alpha_column[i] = a;
+    });
+    lu_.ftran(alpha_column);
+    const auto pivot = alpha_column[r];
+    if (std::abs(pivot - alpha_row[entering]) >
+            1e-7 * (1.0 + std::abs(pivot)) &&
+        lu_.num_updates() > 0) {
+      // the updated factorization has become inaccurate; start afresh
+      factorize();
+      compute_dual();
+      if (fix_dual_infeasibilities(true) > 0) {
+        return LoopResult::DualInfeasible;
+      }
+      compute_primal();
+      continue;
+    }
+
+    // move the passed variables to their other bound
+    if (!flips.empty()) {
+      std::vector<double> delta(m, 0.0);
+      for (const auto j : flips) {
+        const auto old_value = x_[j];
+        status_[j] = status_[j] == BasisStatus::AtLower ? BasisStatus::AtUpper
+                                                        : BasisStatus::AtLower;
+        x_[j] = nonbasic_value(j);
+        const auto change = x_[j] - old_value;
+        for_each_entry(j, [&](const std::size_t i, const double a) {
+          delta[i] += a * change;
+        });
+      }
+      lu_.ftran(delta);
+      for (std::size_t p = 0; p < m; p++) {
+        x_[basic_[p]] -= delta[p];
+      }
+    }
+
+    // update the reduced costs
+    const auto theta_dual = d_[entering] / alpha_row[entering];
+    for (const auto j : row_nonzeros) {
+      if (status_[j] != BasisStatus::Basic && alpha_row[j] != 0.0) {
+        d_[j] -= theta_dual * alpha_row[j];
+      }
+    }
+    d_[entering] = 0.0;
+    d_[leaving] = -theta_dual;
+
+    // update the primal values
+    const auto theta_primal = (x_[leaving] - bound) / pivot;
+    for (std::size_t p = 0; p < m; p++) {
+      if (alpha_column[p] != 0.0) {
+        x_[basic_[p]] -= theta_primal * alpha_column[p];
+      }
+    }
+    x_[entering] += theta_primal;
+    x_[leaving] = bound;
+
+    status_[leaving] =
+        to_lower ? BasisStatus::AtLower : BasisStatus::AtUpper;
+    status_[entering] = BasisStatus::Basic;
+    basic_[r] = entering;
+    lu_.update(r, alpha_column);
+    iterations_++;
+  }
+}
+
+DualSimplex::LoopResult DualSimplex::iterate_perturbed(
+    const std::size_t iteration_limit, const double time_limit) {
+  // Shift the costs of the nonbasic variables away from zero reduced cost,
+  // which keeps the basis dual feasible but breaks the ties between
+  // breakpoints that make degenerate problems stall. The shifts are
+  // removed at the end, and any iterations needed to restore optimality
+  // for the original costs are done without them.
+  const auto cost = cost_;
+  std::mt19937 generator(static_cast<std::mt19937::result_type>(num_vars_));
+  std::uniform_real_distribution<double> random(1.0, 2.0);
+  for (std::size_t j = 0; j < num_vars_; j++) {
+    const auto shift =
+        perturbation * (1.0 + std::abs(cost_[j])) * random(generator);
+    if (status_[j] == BasisStatus::AtLower) {
+      cost_[j] += shift;
+    } else if (status_[j] == BasisStatus::AtUpper) {
+      cost_[j] -= shift;
+    }
+  }
+  compute_dual();
+  const auto result = iterate(iteration_limit, time_limit);
+  cost_ = cost;
+  compute_dual();
+  if (result != LoopResult::Optimal) {
+    return result;
+  }
+  if (fix_dual_infeasibilities(true) > 0) {
+    return LoopResult::DualInfeasible;
+  }
+  compute_primal();
+  return iterate(iteration_limit, time_limit);
+}
+
+DualSimplex::LoopResult DualSimplex::run_phase_one(
+    const std::size_t iteration_limit, const double time_limit,
+    bool& dual_infeasible) {
+  // auxiliary problem with every variable boxed, whose optimal basis is
+  // dual feasible for the original problem unless that is dual infeasible
+  const auto lower = model_.lower;
+  const auto upper = model_.upper;
+  for (std::size_t j = 0; j < num_vars_; j++) {
+    const bool has_lower = !std::isinf(lower[j]);
+    const bool has_upper = !std::isinf(upper[j]);
+    model_.lower[j] = has_lower ? 0.0 : -1.0;
+    model_.upper[j] = has_upper ? 0.0 : 1.0;
+    if (status_[j] != BasisStatus::Basic) {
+      status_[j] = d_[j] >= 0.0 ? BasisStatus::AtLower : BasisStatus::AtUpper;
+    }
+  }
+  compute_primal();
+  const auto result = iterate_perturbed(iteration_limit, time_limit);
+
+  model_.lower = lower;
+  model_.upper = upper;
+  for (std::size_t j = 0; j < num_vars_; j++) {
+    if (status_[j] != BasisStatus::Basic) {
+      status_[j] = d_[j] >= 0.0 ? BasisStatus::AtLower : BasisStatus::AtUpper;
+    }
+  }
+  reset_nonbasic_values();
+  dual_infeasible = fix_dual_infeasibilities(true) > 0;
+  return result;
+}
+
+Status DualSimplex::to_status(const LoopResult result) const {
+  switch (result) {
+    case LoopResult::Optimal:
+      return Status::Optimal;
+    case LoopResult::Infeasible:
+      return Status::Infeasible;
+    case LoopResult::IterationLimit:
+      return Status::IterationLimit;
+    case LoopResult::TimeOut:
+      return Status::TimeOut;
+    case LoopResult::DualInfeasible:
+    default:
+      return Status::NumericFailure;
+  }
+}
+
+Status DualSimplex::solve(const std::size_t iteration_limit,
+                          const double time_limit) {
+  start_ = std::chrono::steady_clock::now();
+  iterations_ = 0;
+  // crossed bounds cannot be repaired by pivoting, and phase one would
+  // treat them like a feasible box
+  if (!bounds_consistent(model_, primal_tolerance)) {
+    return Status::Infeasible;
+  }
+  factorize();
+  for (std::size_t restart = 0; restart < max_restarts; restart++) {
+    compute_dual();
+    if (fix_dual_infeasibilities(true) > 0) {
+      bool dual_infeasible = false;
+      const auto result =
+          run_phase_one(iteration_limit, time_limit, dual_infeasible);
+      if (result != LoopResult::Optimal) {
+        // the auxiliary problem is always feasible
+        return result == LoopResult::Infeasible ? Status::NumericFailure
+                                                : to_status(result);
+      }
+      if (dual_infeasible) {
+        // the problem is unbounded if it is feasible at all
+        const auto cost = cost_;
+        std::fill(cost_.begin(), cost_.end(), 0.0);
+        compute_dual();
+        compute_primal();
+        const auto result_feasibility =
+            iterate_perturbed(iteration_limit, time_limit);
+        cost_ = cost;
+        compute_dual();
+        return result_feasibility == LoopResult::Optimal
+                   ? Status::Unbounded
+                   : to_status(result_feasibility);
+      }
+    }
+    compute_primal();
+    const auto result = iterate_perturbed(iteration_limit, time_limit);
+    if (result != LoopResult::DualInfeasible) {
+      return to_status(result);
+    }
+  }
+  return Status::NumericFailure;
+}
+
+}  // namespace detail
+
+}  // namespace lpint
@@ -0,0 +1,544 @@
+#include "lpinterface/native/interior_point.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "lpinterface/common.hpp"
+#include "lpinterface/detail/parallel.hpp"
+
+namespace lpint {
+
+namespace detail {
+
+namespace {
+
+// relative residuals and duality gap accepted as optimal
+constexpr double optimality_tolerance = 1e-8;
+// fraction of the step to the boundary that is taken
+constexpr double step_fraction = 0.995;
+// Theta^-1 of free variables
+constexpr double free_regularization = 1e-8;
+// iterates beyond this size are taken as a sign of infeasibility
+constexpr double divergence_limit = 1e20;
+// the method gives up after this many iterations
+constexpr std::size_t max_iterations = 200;
+// smallest amount of work worth a thread
+constexpr std::size_t min_normal_entries_per_thread = 1 << 12;
+constexpr std::size_t min_factor_entries_per_thread = 1 << 14;
+constexpr std::size_t min_product_entries_per_thread = 1 << 15;
+
+double max_abs(const std::vector<double>& values) {
+  double result = 0.0;
+  for (const auto v : values) {
+    result = std::max(result, std::abs(v));
+  }
+  return result;
+}
+
+}  // namespace
+
+InteriorPoint::InteriorPoint(ComputationalForm model)
+    : model_(std::move(model)),
+      num_vars_(model_.num_columns + model_.num_rows) {
+  const auto m = model_.num_rows;
+  const auto n = model_.num_columns;
+  row_starts_.assign(m + 1, 0);
+  for (const auto i : model_.row_indices) {
+    row_starts_[i + 1]++;
+  }
+  for (std::size_t i = 0; i < m; i++) {
+    row_starts_[i + 1] += row_starts_[i];
+  }
+  column_indices_.resize(row_starts_.back());
+  row_values_.resize(row_starts_.back());
+  auto next = row_starts_;
+  for (std::size_t j = 0; j < n; j++) {
+    for (auto k = model_.column_starts[j]; k < model_.column_starts[j + 1];
+         k++) {
+      const auto i = model_.row_indices[k];
+      column_indices_[next[i]] = j;
+      row_values_[next[i]] = model_.values[k];
+      next[i]++;
+    }
+  }
+
+  has_lower_.resize(num_vars_);
+  has_upper_.resize(num_vars_);
+  for (std::size_t j = 0; j < num_vars_; j++) {
+    has_lower_[j] = !std::isinf(model_.lower[j]);
+    has_upper_[j] = !std::isinf(model_.upper[j]);
+    if (has_lower_[j]) {
+      num_bounds_++;
+    }
+    if (has_upper_[j]) {
+      num_bounds_++;
+    }
+  }
+}
+
+void InteriorPoint::multiply(const std::vector<double>& x,
+                             std::vector<double>& result) const {
+  const auto m = model_.num_rows;
+  const auto n = model_.num_columns;
+  const auto nthreads = product_threads_;
+  result.resize(m);
+  // every row gives one entry of the result
+  run_parallel(nthreads, [&](const std::size_t t) {
+    const auto end = part_begin(m, nthreads, t + 1);
+    for (auto i = part_begin(m, nthreads, t); i < end; i++) {
+      double value = -x[n + i];
+      for (auto k = row_starts_[i]; k < row_starts_[i + 1]; k++) {
+        value += row_values_[k] * x[column_indices_[k]];
+      }
+      result[i] = value;
+    }
+  });
+}
+
+void InteriorPoint::multiply_transposed(const std::vector<double>& y,
+                                        std::vector<double>& result) const {
+  const auto m = model_.num_rows;
+  const auto n = model_.num_columns;
+  const auto nthreads = product_threads_;
+  result.resize(num_vars_);
+  // every column gives one entry of the result
+  run_parallel(nthreads, [&](const std::size_t t) {
+    const auto end = part_begin(n, nthreads, t + 1);
+    for (auto j = part_begin(n, nthreads, t); j < end; j++) {
+      double value = 0.0;
+      for (auto k = model_.column_starts[j];
+           k < model_.column_starts[j + 1]; k++) {
+        value += model_.values[k] * y[model_.row_indices[k]];
+      }
+      result[j] = value;
+    }
+  });
+  for (std::size_t i = 0; i < m; i++) {
+    result[n + i] = -y[i];
+  }
+}
+
+void InteriorPoint::starting_point(const std::size_t normal_threads,
+                                   const std::size_t factor_threads) {
+  // Mehrotra's starting point: the least squares solutions of the primal
+  // and dual equations, shifted to make the bound slacks and duals
+  // positive and balanced
+  theta_.assign(num_vars_, 1.0);
+  form_normal_matrix(normal_threads);
+  cholesky_.factorize(normal_values_, factor_threads);
+
+  // x: the point nearest to the middle of the bounds with A x = s
+  x_.assign(num_vars_, 0.0);
+  for (std::size_t j = 0; j < num_vars_; j++) {
+    if (has_lower_[j] && has_upper_[j]) {
+      x_[j] = 0.5 * (model_.lower[j] + model_.upper[j]);
+    } else if (has_lower_[j]) {
+      x_[j] = model_.lower[j];
+    } else if (has_upper_[j]) {
+      x_[j] = model_.upper[j];
+    }
+  }
+  std::vector<double> rows;
+  std::vector<double> columns;
+  multiply(x_, rows);
+  cholesky_.solve(rows);
+  multiply_transposed(rows, columns);
+  for (std::size_t j = 0; j < num_vars_; j++) {
+    x_[j] -= columns[j];
+  }
+
+  // y: least squares duals of the cost, with the rest in the bound duals
+  std::vector<double> cost(num_vars_, 0.0);
+  std::copy(model_.cost.begin(), model_.cost.end(), cost.begin());
+  multiply(cost, y_);
+  cholesky_.solve(y_);
+  multiply_transposed(y_, columns);
+
+  wl_.assign(num_vars_, 0.0);
+  wu_.assign(num_vars_, 0.0);
+  zl_.assign(num_vars_, 0.0);
+  zu_.assign(num_vars_, 0.0);
+  double min_slack = LPINT_INFINITY;
+  double min_dual = LPINT_INFINITY;
+  for (std::size_t j = 0; j < num_vars_; j++) {
+    const auto reduced = cost[j] - columns[j];
+    if (has_lower_[j]) {
+      wl_[j] = x_[j] - model_.lower[j];
+      zl_[j] = has_upper_[j] ? std::max(reduced, 0.0) : reduced;
+      min_slack = std::min(min_slack, wl_[j]);
+      min_dual = std::min(min_dual, zl_[j]);
+    }
+    if (has_upper_[j]) {
+      wu_[j] = model_.upper[j] - x_[j];
+      zu_[j] = has_lower_[j] ? std::max(-reduced, 0.0) : -reduced;
+      min_slack = std::min(min_slack, wu_[j]);
+      min_dual = std::min(min_dual, zu_[j]);
+    }
+  }
+  if (num_bounds_ == 0) {
+    return;
+  }
+  const auto slack_shift = std::max(-1.5 * min_slack, 0.0);
+  const auto dual_shift = std::max(-1.5 * min_dual, 0.0);
+  double product = 0.0;
+  double slack_total = 0.0;
+  double dual_total = 0.0;
+  for (std::size_t j = 0; j < num_vars_; j++) {
+    if (has_lower_[j]) {
+      wl_[j] += slack_shift;
+      zl_[j] += dual_shift;
+      product += wl_[j] * zl_[j];
+      slack_total += wl_[j];
+      dual_total += zl_[j];
+    }
+    if (has_upper_[j]) {
+      wu_[j] += slack_shift;
+      zu_[j] += dual_shift;
+      product += wu_[j] * zu_[j];
+      slack_total += wu_[j];
+      dual_total += zu_[j];
+    }
+  }
+  // keep everything away from zero, also when the shifts above are zero
+  const auto balance_slack =
+      std::max(0.5 * product / std::max(dual_total, 1.0), 1.0);
+  const auto balance_dual =
+      std::max(0.5 * product / std::max(slack_total, 1.0), 1.0);
+  for (std::size_t j = 0; j < num_vars_; j++) {
+    if (has_lower_[j]) {
+      wl_[j] += balance_slack;
+      zl_[j] += balance_dual;
+    }
+    if (has_upper_[j]) {
+      wu_[j] += balance_slack;
+      zu_[j] += balance_dual;
+    }
+  }
+}
+
+void InteriorPoint::compute_residuals() {
+  const auto n = model_.num_columns;
+  multiply(x_, rp_);
+  for (auto& value : rp_) {
+    value = -value;
+  }
+  multiply_transposed(y_, rd_);
+  for (std::size_t j = 0; j < num_vars_; j++) {
+    rl_[j] = has_lower_[j] ? model_.lower[j] - x_[j] + wl_[j] : 0.0;
+    ru_[j] = has_upper_[j] ? model_.upper[j] - x_[j] - wu_[j] : 0.0;
+    const auto cost = j < n ? model_.cost[j] : 0.0;
+    rd_[j] = cost - rd_[j] - zl_[j] + zu_[j];
+  }
+}
+
+double InteriorPoint::complementarity() const {
+  if (num_bounds_ == 0) {
+    return 0.0;
+  }
+  double total = 0.0;
+  for (std::size_t j = 0; j < num_vars_; j++) {
+    total += wl_[j] * zl_[j] + wu_[j] * zu_[j];
+  }
+  return total / static_cast<double>(num_bounds_);
+}
+
+void InteriorPoint::form_normal_matrix(const std::size_t nthreads) {
+  const auto m = model_.num_rows;
+  const auto n = model_.num_columns;
+  const auto& position = cholesky_.position();
+  const auto& starts = cholesky_.matrix_starts();
+  const auto& rows = cholesky_.matrix_rows();
+  std::vector<std::size_t> order(m);
+  for (std::size_t i = 0; i < m; i++) {
+    order[position[i]] = i;
+  }
+
+  // every row of A Theta A^T fills one column of the reordered lower
+  // triangle, so rows can be formed independently
+  run_parallel(nthreads, [&](const std::size_t t) {
+    std::vector<double> accumulator(m, 0.0);
+    const auto begin = part_begin(m, nthreads, t);
+    const auto end = part_begin(m, nthreads, t + 1);
+    for (auto i = begin; i < end; i++) {
+      const auto p = position[i];
+      accumulator[i] += theta_[n + i];
+      for (auto k = row_starts_[i]; k < row_starts_[i + 1]; k++) {
+        const auto j = column_indices_[k];
+        const auto scaled = theta_[j] * row_values_[k];
+        for (auto e = model_.column_starts[j]; e < model_.column_starts[j + 1];
+             e++) {
+          const auto r = model_.row_indices[e];
+          if (position[r] >= p) {
+            accumulator[r] += scaled * model_.values[e];
+          }
+        }
+      }
+      for (auto e = starts[p]; e < starts[p + 1]; e++) {
+        const auto r = order[rows[e]];
+        normal_values_[e] = accumulator[r];
+        accumulator[r] = 0.0;
+      }
+    }
+  });
+}
+
+void InteriorPoint::solve_newton(const std::vector<double>& rcl,
+                                 const std::vector<double>& rcu,
+                                 Direction& dir) const {
+  const auto m = model_.num_rows;
+
+  // eliminate the bound slacks and duals: A^T dy - Theta^-1 dx = rhat
+  std::vector<double> scaled(num_vars_);
+  for (std::size_t j = 0; j < num_vars_; j++) {
+    double rhat = rd_[j];
+    if (has_lower_[j]) {
+      rhat -= (rcl[j] + zl_[j] * rl_[j]) / wl_[j];
+    }
+    if (has_upper_[j]) {
+      rhat += (rcu[j] - zu_[j] * ru_[j]) / wu_[j];
+    }
+    scaled[j] = rhat;
+  }
+
+  // A Theta A^T dy = rp + A Theta rhat
+  std::vector<double> product(num_vars_);
+  for (std::size_t j = 0; j < num_vars_; j++) {
+    product[j] = theta_[j] * scaled[j];
+  }
+  multiply(product, dir.y);
+  for (std::size_t i = 0; i < m; i++) {
+    dir.y[i] += rp_[i];
+  }
+  cholesky_.solve(dir.y);
+  multiply_transposed(dir.y, product);
+
+  dir.x.resize(num_vars_);
+  dir.wl.assign(num_vars_, 0.0);
+  dir.wu.assign(num_vars_, 0.0);
+  dir.zl.assign(num_vars_, 0.0);
+  dir.zu.assign(num_vars_, 0.0);
+  for (std::size_t j = 0; j < num_vars_; j++) {
+    dir.x[j] = theta_[j] * (product[j] - scaled[j]);
+    if (has_lower_[j]) {
+      dir.wl[j] = dir.x[j] - rl_[j];
+      dir.zl[j] = (rcl[j] - zl_[j] * dir.wl[j]) / wl_[j];
+    }
+    if (has_upper_[j]) {
+      dir.wu[j] = ru_[j] - dir.x[j];
+      dir.zu[j] = (rcu[j] - zu_[j] * dir.wu[j]) / wu_[j];
+    }
+  }
+}
+
+void InteriorPoint::step_lengths(const Direction& dir, double& primal,
+                                 double& dual) const {
+  primal = LPINT_INFINITY;
+  dual = LPINT_INFINITY;
+  for (std::size_t j = 0; j < num_vars_; j++) {
+    if (has_lower_[j]) {
+      if (dir.wl[j] < 0.0) {
+        primal = std::min(primal, -wl_[j] / dir.wl[j]);
+      }
+      if (dir.zl[j] < 0.0) {
+        dual = std::min(dual, -zl_[j] / dir.zl[j]);
+      }
+    }
+    if (has_upper_[j]) {
+      if (dir.wu[j] < 0.0) {
+        primal = std::min(primal, -wu_[j] / dir.wu[j]);
+      }
+      if (dir.zu[j] < 0.0) {
+        dual = std::min(dual, -zu_[j] / dir.zu[j]);
+      }
+    }
+  }
+}
+
+std::vector<double> InteriorPoint::reduced_costs() const {
+  std::vector<double> result(zl_.size());
+  for (std::size_t j = 0; j < zl_.size(); j++) {
+    result[j] = zl_[j] - zu_[j];
+  }
+  return result;
+}
+
+Status InteriorPoint::solve(const std::size_t iteration_limit,
+                            const double time_limit,
+                            const std::size_t nthreads) {
+  start_ = std::chrono::steady_clock::now();
+  iterations_ = 0;
+  const auto m = model_.num_rows;
+  const auto n = model_.num_columns;
+
+  // pattern of A A^T, ordered and analyzed once
+  std::vector<std::vector<std::size_t>> adjacency(m);
+  std::vector<bool> marked(m, false);
+  for (std::size_t i = 0; i < m; i++) {
+    marked[i] = true;
+    for (auto k = row_starts_[i]; k < row_starts_[i + 1]; k++) {
+      const auto j = column_indices_[k];
+      for (auto e = model_.column_starts[j]; e < model_.column_starts[j + 1];
+           e++) {
+        const auto r = model_.row_indices[e];
+        if (!marked[r]) {
+          marked[r] = true;
+          adjacency[i].push_back(r);
+        }
+      }
+    }
+    marked[i] = false;
+    for (const auto r : adjacency[i]) {
+      marked[r] = false;
+    }
+  }
+  cholesky_.analyze(m, adjacency);
+  normal_values_.assign(cholesky_.matrix_rows().size(), 0.0);
+  const auto normal_threads = std::min(
+      std::max<std::size_t>(nthreads, 1),
+      num_threads_for(normal_values_.size(), min_normal_entries_per_thread));
+  const auto factor_threads =
+      std::min(std::max<std::size_t>(nthreads, 1),
+               num_threads_for(cholesky_.factor_nonzeros(),
+                               min_factor_entries_per_thread));
+  product_threads_ = std::min(
+      std::max<std::size_t>(nthreads, 1),
+      num_threads_for(model_.values.size(), min_product_entries_per_thread));
+
+  double bound_norm = 0.0;
+  for (std::size_t j = 0; j < num_vars_; j++) {
+    if (has_lower_[j]) {
+      bound_norm = std::max(bound_norm, std::abs(model_.lower[j]));
+    }
+    if (has_upper_[j]) {
+      bound_norm = std::max(bound_norm, std::abs(model_.upper[j]));
+    }
+  }
+  starting_point(normal_threads, factor_threads);
+  const auto cost_norm = max_abs(model_.cost);
+
+  rp_.resize(m);
+  rl_.resize(num_vars_);
+  ru_.resize(num_vars_);
+  rd_.resize(num_vars_);
+  theta_.resize(num_vars_);
+  std::vector<double> rcl(num_vars_, 0.0);
+  std::vector<double> rcu(num_vars_, 0.0);
+  Direction affine;
+  Direction direction;
+
+  while (true) {
+    compute_residuals();
+    const auto mu = complementarity();
+
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start_;
+    if (elapsed.count() >= time_limit) {
+      return Status::TimeOut;
+    }
+    if (iterations_ >= iteration_limit) {
+      return Status::IterationLimit;
+    }
+
+    const auto primal_infeasibility =
+        std::max(max_abs(rp_), std::max(max_abs(rl_), max_abs(ru_))) /
+        (1.0 + bound_norm);
+    const auto dual_infeasibility = max_abs(rd_) / (1.0 + cost_norm);
+    double primal_objective = 0.0;
+    double dual_objective = 0.0;
+    for (std::size_t j = 0; j < num_vars_; j++) {
+      if (j < n) {
+        primal_objective += model_.cost[j] * x_[j];
+      }
+      if (has_lower_[j]) {
+        dual_objective += model_.lower[j] * zl_[j];
+      }
+      if (has_upper_[j]) {
+        dual_objective -= model_.upper[j] * zu_[j];
+      }
+    }
+    const auto gap = std::abs(primal_objective - dual_objective) /
+                     (1.0 + std::abs(primal_objective));
+    if (primal_infeasibility <= optimality_tolerance &&
+        dual_infeasibility <= optimality_tolerance &&
+        gap <= optimality_tolerance) {
+      return Status::Optimal;
+    }
+    if (iterations_ >= max_iterations ||
+        std::max(max_abs(x_), max_abs(y_)) > divergence_limit ||
+        std::max(max_abs(zl_), max_abs(zu_)) > divergence_limit ||
+        !std::isfinite(mu)) {
+      return Status::InfeasibleOrUnbounded;
+    }
+
+    for (std::size_t j = 0; j < num_vars_; j++) {
+      double inverse = 0.0;
+      if (has_lower_[j]) {
+        inverse += zl_[j] / wl_[j];
+      }
+      if (has_upper_[j]) {
+        inverse += zu_[j] / wu_[j];
+      }
+      if (!has_lower_[j] && !has_upper_[j]) {
+        inverse = free_regularization;
+      }
+      theta_[j] = 1.0 / inverse;
+    }
+    form_normal_matrix(normal_threads);
+    cholesky_.factorize(normal_values_, factor_threads);
+
+    // predictor: the affine scaling direction
+    for (std::size_t j = 0; j < num_vars_; j++) {
+      rcl[j] = -wl_[j] * zl_[j];
+      rcu[j] = -wu_[j] * zu_[j];
+    }
+    solve_newton(rcl, rcu, affine);
+    double primal_step;
+    double dual_step;
+    step_lengths(affine, primal_step, dual_step);
+    primal_step = std::min(primal_step, 1.0);
+    dual_step = std::min(dual_step, 1.0);
+    double sigma = 0.0;
+    if (num_bounds_ > 0 && mu > 0.0) {
+      double affine_total = 0.0;
+      for (std::size_t j = 0; j < num_vars_; j++) {
+        affine_total += (wl_[j] + primal_step * affine.wl[j]) *
+                            (zl_[j] + dual_step * affine.zl[j]) +
+                        (wu_[j] + primal_step * affine.wu[j]) *
+                            (zu_[j] + dual_step * affine.zu[j]);
+      }
+      const auto ratio =
+          affine_total / static_cast<double>(num_bounds_) / mu;
+      sigma = std::min(1.0, std::max(0.0, ratio * ratio * ratio));
+    }
+
+    // corrector: centering plus the second order term of the predictor
+    for (std::size_t j = 0; j < num_vars_; j++) {
+      if (has_lower_[j]) {
+        rcl[j] = sigma * mu - wl_[j] * zl_[j] - affine.wl[j] * affine.zl[j];
+      }
+      if (has_upper_[j]) {
+        rcu[j] = sigma * mu - wu_[j] * zu_[j] - affine.wu[j] * affine.zu[j];
+      }
+    }
+    solve_newton(rcl, rcu, direction);
+    step_lengths(direction, primal_step, dual_step);
+    primal_step = std::min(1.0, step_fraction * primal_step);
+    dual_step = std::min(1.0, step_fraction * dual_step);
+
+    for (std::size_t j = 0; j < num_vars_; j++) {
+      x_[j] += primal_step * direction.x[j];
+      wl_[j] += primal_step * direction.wl[j];
+      wu_[j] += primal_step * direction.wu[j];
+      zl_[j] += dual_step * direction.zl[j];
+      zu_[j] += dual_step * direction.zu[j];
+    }
+    for (std::size_t i = 0; i < m; i++) {
+      y_[i] += dual_step * direction.y[i];
+    }
+    iterations_++;
+  }
+}
+
+}  // namespace detail
+
+}  // namespace lpint
@@ -0,0 +1,479 @@
+#include "lpinterface/native/lphandle_native.hpp"
+
+#include <algorithm>
+
+#include "lpinterface/detail/objective_support.hpp"
+#include "lpinterface/detail/util.hpp"
+
+namespace lpint {
+
+namespace {
+
+using ConstraintDiff = std::vector<Constraint<double>>::difference_type;
+using VariableDiff = std::vector<Variable>::difference_type;
+
+Constraint<double> copy_constraint(const Constraint<double>& constraint) {
+  return Constraint<double>(Row<double>(constraint.row.values(),
+                                        constraint.row.nonzero_indices()),
+                            constraint.lower_bound, constraint.upper_bound);
+}
+
+// Final positions of entities that are inserted one after another, each
+// at the given position of the sequence at the time, into a sequence that
+// ends up with total entities. An entity ends up in the free slot of that
+// rank once the slots of all later insertions are taken, so the positions
+// are resolved from the last insertion back, with a Fenwick tree counting
+// the free slots.
+std::vector<std::size_t> final_positions(
+    const std::vector<std::size_t>& positions, const std::size_t total) {
+  std::vector<std::size_t> free_slots(total + 1);
+  std::size_t top = 1;
+  for (std::size_t i = 1; i <= total; i++) {
+    free_slots[i] = i & (~i + 1);
+    top = (i & (i - 1)) == 0 ? i : top;
+  }
+  std::vector<std::size_t> result(positions.size());
+  for (auto k = positions.size(); k-- > 0;) {
+    // the largest prefix with at most positions[k] free slots
+    std::size_t slot = 0;
+    auto rank = positions[k];
+    for (auto step = top; step > 0; step /= 2) {
+      if (slot + step <= total && free_slots[slot + step] <= rank) {
+        slot += step;
+        rank -= free_slots[slot];
+      }
+    }
+    result[k] = slot;
+    for (auto i = slot + 1; i <= total; i += i & (~i + 1)) {
+      free_slots[i]--;
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+Variable LinearProgramHandleNative::variable(std::size_t i) const {
+  return variables_.at(i);
+}
+
+std::vector<Variable> LinearProgramHandleNative::variables() const {
+  return variables_;
+}
+
+VariableBlock LinearProgramHandleNative::variable_block() const {
+  return VariableBlock(variables_);
+}
+
+VariableIdRange LinearProgramHandleNative::add_variables(
+    const std::vector<Variable>& vars) {
+  append_variables(vars);
+  return variable_ids_.add(vars.size());
+}
+
+VariableIdRange LinearProgramHandleNative::add_variables(
+    const VariableBlock& vars) {
+  append_variables(vars.variables());
+  return variable_ids_.add(vars.size());
+}
+
+VariableIdRange LinearProgramHandleNative::add_variables(
+    const std::size_t nvars) {
+  append_variables(std::vector<Variable>(nvars));
+  return variable_ids_.add(nvars);
+}
+
+void LinearProgramHandleNative::append_variables(
+    const std::vector<Variable>& vars) {
+  if (vars.empty()) {
+    return;
+  }
+  if (transaction_.active()) {
+    transaction_.record_add_variables(num_vars());
+  }
+  variables_.insert(variables_.end(), vars.begin(), vars.end());
+  objective_.values.resize(variables_.size(), 0.0);
+}
+
+ConstraintIdRange LinearProgramHandleNative::add_constraints(
+    const std::vector<Constraint<double>>& constraints) {
+  for (const auto& constraint : constraints) {
+    for (const auto j : constraint.row.nonzero_indices()) {
+      if (j < 0 || static_cast<std::size_t>(j) >= num_vars()) {
+        throw InvalidMatrixEntryException();
+      }
+    }
+  }
+  if (transaction_.active() && !constraints.empty()) {
+    transaction_.record_add_constraints(num_constraints());
+  }
+  constraints_.reserve(constraints_.size() + constraints.size());
+  for (const auto& constraint : constraints) {
+    constraints_.emplace_back(copy_constraint(constraint));
+  }
+  return constraint_ids_.add(constraints.size());
+}
+
+ConstraintIdRange LinearProgramHandleNative::add_constraints(
+    const ConstraintBatch<double>& batch) {
+  for (const auto j : batch.indices()) {
+    if (j < 0 || static_cast<std::size_t>(j) >= num_vars()) {
+      throw InvalidMatrixEntryException();
+    }
+  }
+  if (transaction_.active() && !batch.empty()) {
+    transaction_.record_add_constraints(num_constraints());
+  }
+  constraints_.reserve(constraints_.size() + batch.num_rows());
+  for (std::size_t i = 0; i < batch.num_rows(); i++) {
+    constraints_.emplace_back(batch.constraint(i));
+  }
+  return constraint_ids_.add(batch.num_rows());
+}
+
+void LinearProgramHandleNative::remove_variable(const std::size_t i) {
+  if (i >= num_vars()) {
+    throw std::out_of_range("Out of range variable index");
+  }
+  if (transaction_.active()) {
+    transaction_.record_remove_variable(i, variables_[i], column(i),
+                                        objective_.values[i],
+                                        variable_ids_.id(i));
+  }
+  // drop the entries of column i, and shift the later columns down
+  const auto removed = detail::checked_narrow<int>(i);
+  for (auto& constraint : constraints_) {
+    auto& values = constraint.row.values();
+    auto& indices = constraint.row.nonzero_indices();
+    std::size_t write = 0;
+    for (std::size_t k = 0; k < indices.size(); k++) {
+      if (indices[k] == removed) {
+        continue;
+      }
+      values[write] = values[k];
+      indices[write] = indices[k] > removed ? indices[k] - 1 : indices[k];
+      write++;
+    }
+    values.resize(write);
+    indices.resize(write);
+  }
+  variables_.erase(variables_.begin() + static_cast<VariableDiff>(i));
+  objective_.values.erase(objective_.values.begin() +
+                          static_cast<VariableDiff>(i));
+  variable_ids_.erase(i);
+}
+
+void LinearProgramHandleNative::remove_constraint(std::size_t i) {
+  if (i >= num_constraints()) {
+    throw std::out_of_range("Out of range constraint index");
+  }
+  if (transaction_.active()) {
+    transaction_.record_remove_constraint(i, constraint(i),
+                                          constraint_ids_.id(i));
+  }
+  constraints_.erase(constraints_.begin() + static_cast<ConstraintDiff>(i));
+  constraint_ids_.erase(i);
+}
+
+void LinearProgramHandleNative::set_variable_bounds(const std::size_t i,
+                                                    const double lower,
+                                                    const double upper) {
+  auto& var = variables_.at(i);
+  const Variable bounded(lower, upper);
+  if (transaction_.active()) {
+    transaction_.record_variable_bounds(i, var.lower(), var.upper());
+  }
+  var = bounded;
+}
+
+void LinearProgramHandleNative::set_constraint_bounds(const std::size_t i,
+                                                      const double lower,
+                                                      const double upper) {
+  auto& constraint = constraints_.at(i);
+  if (transaction_.active()) {
+    transaction_.record_constraint_bounds(i, constraint.lower_bound,
+                                          constraint.upper_bound);
+  }
+  constraint.lower_bound = lower;
+  constraint.upper_bound = upper;
+}
+
+void LinearProgramHandleNative::begin_transaction(const bool) {
+  transaction_.begin();
+}
+
+void LinearProgramHandleNative::commit() { transaction_.commit(); }
+
+void LinearProgramHandleNative::rollback() { transaction_.rollback(*this); }
+
+bool LinearProgramHandleNative::in_transaction() const {
+  return transaction_.active();
+}
+
+void LinearProgramHandleNative::truncate_constraints(const std::size_t n) {
+  if (n >= num_constraints()) {
+    return;
+  }
+  constraints_.erase(constraints_.begin() + static_cast<ConstraintDiff>(n),
+                     constraints_.end());
+  constraint_ids_.truncate(n);
+}
+
+void LinearProgramHandleNative::truncate_variables(const std::size_t n) {
+  while (num_vars() > n) {
+    // rows may still refer to the removed columns if constraints were
+    // added after the variables
+    const auto last = num_vars() - 1;
+    const auto removed = detail::checked_narrow<int>(last);
+    for (auto& constraint : constraints_) {
+      auto& indices = constraint.row.nonzero_indices();
+      for (std::size_t k = 0; k < indices.size(); k++) {
+        if (indices[k] == removed) {
+          indices.erase(indices.begin() + static_cast<VariableDiff>(k));
+          constraint.row.values().erase(constraint.row.values().begin() +
+                                        static_cast<VariableDiff>(k));
+          break;
+        }
+      }
+    }
+    variables_.pop_back();
+    objective_.values.pop_back();
+  }
+  variable_ids_.truncate(n);
+}
+
+void LinearProgramHandleNative::insert_constraint(const std::size_t i,
+                                                  const Constraint<double>& c,
+                                                  const ConstraintId id) {
+  constraints_.insert(constraints_.begin() + static_cast<ConstraintDiff>(i),
+                      copy_constraint(c));
+  constraint_ids_.insert(i, id);
+}
+
+void LinearProgramHandleNative::insert_constraints(
+    const std::vector<detail::TransactionLog::RemovedConstraint>& removed) {
+  for (const auto& entry : removed) {
+    insert_constraint(entry.position, *entry.constraint, entry.id);
+  }
+}
+
+void LinearProgramHandleNative::insert_variables(
+    const std::vector<detail::TransactionLog::RemovedVariable>& removed) {
+  if (removed.empty()) {
+    return;
+  }
+  const auto num_old = variables_.size();
+  const auto total = num_old + removed.size();
+  std::vector<std::size_t> positions;
+  positions.reserve(removed.size());
+  for (const auto& entry : removed) {
+    positions.push_back(entry.position);
+  }
+  positions = final_positions(positions, total);
+
+  // the entries in final order, and the new position of every old column
+  std::vector<std::size_t> order(removed.size());
+  for (std::size_t k = 0; k < order.size(); k++) {
+    order[k] = k;
+  }
+  std::sort(order.begin(), order.end(),
+            [&positions](const std::size_t a, const std::size_t b) {
+              return positions[a] < positions[b];
+            });
+  std::vector<int> shifted(num_old);
+  std::vector<Variable> variables;
+  std::vector<double> objective;
+  std::vector<std::pair<std::size_t, VariableId>> ids;
+  variables.reserve(total);
+  objective.reserve(total);
+  ids.reserve(removed.size());
+  std::size_t next = 0;
+  for (const auto k : order) {
+    while (variables.size() < positions[k]) {
+      shifted[next] = detail::checked_narrow<int>(variables.size());
+      variables.push_back(variables_[next]);
+      objective.push_back(objective_.values[next]);
+      next++;
+    }
+    variables.push_back(removed[k].variable);
+    objective.push_back(removed[k].objective);
+    ids.emplace_back(positions[k], removed[k].id);
+  }
+  for (; next < num_old; next++) {
+    shifted[next] = detail::checked_narrow<int>(variables.size());
+    variables.push_back(variables_[next]);
+    objective.push_back(objective_.values[next]);
+  }
+
+  for (auto& constraint : constraints_) {
+    for (auto& j : constraint.row.nonzero_indices()) {
+      j = shifted[static_cast<std::size_t>(j)];
+    }
+  }
+  for (std::size_t k = 0; k < removed.size(); k++) {
+    const auto& col = *removed[k].column;
+    const auto j = detail::checked_narrow<int>(positions[k]);
+    for (std::size_t e = 0; e < col.num_nonzero(); e++) {
+      auto& row = constraints_[static_cast<std::size_t>(
+                                   col.nonzero_indices()[e])]
+                      .row;
+      row.values().push_back(col.values()[e]);
+      row.nonzero_indices().push_back(j);
+    }
+  }
+  variables_.swap(variables);
+  objective_.values.swap(objective);
+  variable_ids_.insert(ids);
+}
+
+std::size_t LinearProgramHandleNative::position(const ConstraintId id) const {
+  return constraint_ids_.position(id);
+}
+
+std::size_t LinearProgramHandleNative::position(const VariableId id) const {
+  return variable_ids_.position(id);
+}
+
+ConstraintId LinearProgramHandleNative::constraint_id(
+    const std::size_t i) const {
+  return constraint_ids_.id(i);
+}
+
+VariableId LinearProgramHandleNative::variable_id(const std::size_t i) const {
+  return variable_ids_.id(i);
+}
+
+std::size_t LinearProgramHandleNative::num_vars() const {
+  return variables_.size();
+}
+
+std::size_t LinearProgramHandleNative::num_constraints() const {
+  return constraints_.size();
+}
+
+void LinearProgramHandleNative::set_objective_sense(
+    const OptimizationType objsense) {
+  if (transaction_.active()) {
+    transaction_.record_objective_sense(sense_);
+  }
+  sense_ = objsense;
+}
+
+void LinearProgramHandleNative::set_objective(
+    const Objective<double>& objective) {
+  if (num_vars() != objective.values.size()) {
+    throw MismatchedDimensionsException();
+  }
+  if (transaction_.active()) {
+    transaction_.record_objective(sparse_objective());
+  }
+  objective_.values = objective.values;
+}
+
+void LinearProgramHandleNative::set_objective(
+    const SparseObjective<double>& objective) {
+  detail::check_sparse_objective(objective, num_vars());
+  if (transaction_.active()) {
+    transaction_.record_objective(sparse_objective());
+  }
+  std::fill(objective_.values.begin(), objective_.values.end(), 0.0);
+  for (std::size_t k = 0; k < objective.num_nonzero(); k++) {
+    objective_.values[static_cast<std::size_t>(
+        objective.nonzero_indices()[k])] = objective.values()[k];
+  }
+}
+
+OptimizationType LinearProgramHandleNative::optimization_type() const {
+  return sense_;
+}
+
+Constraint<double> LinearProgramHandleNative::constraint(std::size_t i) const {
+  return copy_constraint(constraints_.at(i));
+}
+
+void LinearProgramHandleNative::read_constraint(
+    std::size_t i, Constraint<double>& buffer) const {
+  const auto& constraint = constraints_.at(i);
+  buffer.lower_bound = constraint.lower_bound;
+  buffer.upper_bound = constraint.upper_bound;
+  buffer.row.values() = constraint.row.values();
+  buffer.row.nonzero_indices() = constraint.row.nonzero_indices();
+}
+
+Column<double> LinearProgramHandleNative::column(std::size_t j) const {
+  if (j >= num_vars()) {
+    throw std::out_of_range("Out of range variable index");
+  }
+  const auto index = detail::checked_narrow<int>(j);
+  Column<double> col;
+  for (std::size_t i = 0; i < num_constraints(); i++) {
+    const auto& row = constraints_[i].row;
+    for (std::size_t k = 0; k < row.num_nonzero(); k++) {
+      if (row.nonzero_indices()[k] == index) {
+        col.values().push_back(row.values()[k]);
+        col.nonzero_indices().push_back(detail::checked_narrow<int>(i));
+      }
+    }
+  }
+  return col;
+}
+
+std::vector<Column<double>> LinearProgramHandleNative::columns() const {
+  // transpose in a single pass over the rows
+  std::vector<Column<double>> cols(num_vars());
+  for (std::size_t i = 0; i < num_constraints(); i++) {
+    const auto& row = constraints_[i].row;
+    const auto index = detail::checked_narrow<int>(i);
+    for (std::size_t k = 0; k < row.num_nonzero(); k++) {
+      auto& col = cols[static_cast<std::size_t>(row.nonzero_indices()[k])];
+      col.values().push_back(row.values()[k]);
+      col.nonzero_indices().push_back(index);
+    }
+  }
+  return cols;
+}
+
+std::vector<Constraint<double>> LinearProgramHandleNative::constraints() const {
+  std::vector<Constraint<double>> constraints;
+  constraints.reserve(num_constraints());
+  for (const auto& constraint : constraints_) {
+    constraints.emplace_back(copy_constraint(constraint));
+  }
+  return constraints;
+}
+
+Objective<double> LinearProgramHandleNative::objective() const {
+  return Objective<double>(std::vector<double>(objective_.values));
+}
+
+SparseObjective<double> LinearProgramHandleNative::sparse_objective() const {
+  SparseObjective<double> sparse;
+  for (std::size_t j = 0; j < num_vars(); j++) {
+    if (objective_.values[j] != 0.0) {
+      sparse.values().push_back(objective_.values[j]);
+      sparse.nonzero_indices().push_back(detail::checked_narrow<int>(j));
+    }
+  }
+  return sparse;
+}
+
+const std::vector<Constraint<double>>&
+LinearProgramHandleNative::cached_constraints() const {
+  // the model is stored in memory, so there is nothing to cache
+  return constraints_;
+}
+
+const Objective<double>& LinearProgramHandleNative::cached_objective() const {
+  return objective_;
+}
+
+const std::vector<Variable>& LinearProgramHandleNative::cached_variables()
+    const {
+  return variables_;
+}
+
+void LinearProgramHandleNative::clear_cache() {}
+
+void LinearProgramHandleNative::set_cache_enabled(bool) {}
+
+}  // namespace lpint
@@ -0,0 +1,159 @@
+#include "lpinterface/native/lpinterface_interior_point.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <utility>
+
+#include "lpinterface/native/computational_form.hpp"
+#include "lpinterface/native/dual_simplex.hpp"
+#include "lpinterface/native/interior_point.hpp"
+
+namespace lpint {
+
+namespace {
+
+// variables this far inside both bounds, relative to the bound, are
+// candidates for the crossover basis
+constexpr double interior_tolerance = 1e-6;
+
+// Basis for crossover: the variables furthest inside their bounds become
+// basic, the others nonbasic at their nearest bound. The simplex method
+// repairs a basis that is singular or has the wrong size.
+std::vector<detail::BasisStatus> crossover_basis(
+    const detail::ComputationalForm& form, const std::vector<double>& x) {
+  using detail::BasisStatus;
+  const auto num_vars = form.num_columns + form.num_rows;
+  std::vector<BasisStatus> basis(num_vars, BasisStatus::AtZero);
+  std::vector<std::pair<double, std::size_t>> candidates;
+  for (std::size_t j = 0; j < num_vars; j++) {
+    const auto lower = form.lower[j];
+    const auto upper = form.upper[j];
+    const auto to_lower = (x[j] - lower) / (1.0 + std::abs(lower));
+    const auto to_upper = (upper - x[j]) / (1.0 + std::abs(upper));
+    const auto interior = std::min(to_lower, to_upper);
+    if (interior > interior_tolerance) {
+      candidates.emplace_back(interior, j);
+    }
+    basis[j] = to_lower <= to_upper ? BasisStatus::AtLower
+                                    : BasisStatus::AtUpper;
+  }
+  std::sort(candidates.begin(), candidates.end(),
+            [](const std::pair<double, std::size_t>& a,
+               const std::pair<double, std::size_t>& b) {
+              return a.first > b.first;
+            });
+  const auto num_basic = std::min(candidates.size(), form.num_rows);
+  for (std::size_t k = 0; k < num_basic; k++) {
+    basis[candidates[k].second] = BasisStatus::Basic;
+  }
+  return basis;
+}
+
+}  // namespace
+
+NativeInteriorPointSolver::NativeInteriorPointSolver(
+    OptimizationType optim_type, const bool crossover)
+    : lp_(optim_type), crossover_(crossover) {}
+
+bool NativeInteriorPointSolver::parameter_supported(const Param param) const {
+  return param == Param::Threads || param == Param::Verbosity ||
+         param == Param::IterationLimit || param == Param::TimeLimit;
+}
+
+void NativeInteriorPointSolver::set_parameter(const Param param,
+                                              const int value) {
+  if (!parameter_supported(param)) throw UnsupportedParameterException();
+  if (value < 0) throw FailedToSetParameterException();
+  if (param == Param::Threads) {
+    nthreads_ = static_cast<std::size_t>(value);
+  } else if (param == Param::IterationLimit) {
+    iteration_limit_ = static_cast<std::size_t>(value);
+  } else if (param == Param::TimeLimit) {
+    time_limit_ = value;
+  }
+}
+
+void NativeInteriorPointSolver::set_parameter(const Param param,
+                                              const double value) {
+  if (!parameter_supported(param)) throw UnsupportedParameterException();
+  if (value < 0.0) throw FailedToSetParameterException();
+  if (param == Param::Threads) {
+    nthreads_ = static_cast<std::size_t>(value);
+  } else if (param == Param::IterationLimit) {
+    iteration_limit_ = static_cast<std::size_t>(value);
+  } else if (param == Param::TimeLimit) {
+    time_limit_ = value;
+  }
+}
+
+Status NativeInteriorPointSolver::solve() {
+  const auto start = std::chrono::steady_clock::now();
+  const auto num_vars = lp_.num_vars();
+  const auto nthreads =
+      nthreads_ > 0
+          ? nthreads_
+          : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+  auto form = detail::make_computational_form(lp_);
+
+  detail::InteriorPoint ipm(form);
+  status_ = ipm.solve(iteration_limit_, time_limit_, nthreads);
+  iterations_ = ipm.iterations();
+  crossover_iterations_ = 0;
+  std::vector<double> x = ipm.primal();
+  std::vector<double> y = ipm.dual();
+
+  if (crossover_ && (status_ == Status::Optimal ||
+                     status_ == Status::InfeasibleOrUnbounded)) {
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    const auto basis = status_ == Status::Optimal
+                           ? crossover_basis(form, x)
+                           : std::vector<detail::BasisStatus>();
+    detail::DualSimplex simplex(std::move(form));
+    if (!basis.empty()) {
+      simplex.set_basis(basis);
+    }
+    status_ = simplex.solve(iteration_limit_ - iterations_,
+                            time_limit_ - elapsed.count());
+    crossover_iterations_ = simplex.iterations();
+    x = simplex.primal();
+    y = simplex.dual();
+  }
+
+  solution_.primal.assign(x.begin(),
+                          x.begin() + static_cast<std::ptrdiff_t>(num_vars));
+  solution_.dual = std::move(y);
+  if (lp_.optimization_type() == OptimizationType::Maximize) {
+    for (auto& value : solution_.dual) {
+      value = -value;
+    }
+  }
+  const auto& objective = lp_.cached_objective().values;
+  solution_.objective_value = 0.0;
+  for (std::size_t j = 0; j < num_vars && j < objective.size(); j++) {
+    solution_.objective_value += objective[j] * solution_.primal[j];
+  }
+  return status_;
+}
+
+Status NativeInteriorPointSolver::solution_status() const { return status_; }
+
+const ILinearProgramHandle& NativeInteriorPointSolver::linear_program()
+    const {
+  return lp_;
+}
+
+ILinearProgramHandle& NativeInteriorPointSolver::linear_program() {
+  return lp_;
+}
+
+const Solution<double>& NativeInteriorPointSolver::get_solution() const {
+  if (status_ != Status::Optimal) {
+    throw ModelNotSolvedException();
+  }
+  return solution_;
+}
+
+}  // namespace lpint
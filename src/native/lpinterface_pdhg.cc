@@ -0,0 +1,87 @@
+#include "lpinterface/native/lpinterface_pdhg.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+#include "lpinterface/native/computational_form.hpp"
+#include "lpinterface/native/pdhg.hpp"
+
+namespace lpint {
+
+NativePdhgSolver::NativePdhgSolver(OptimizationType optim_type,
+                                   const double tolerance)
+    : lp_(optim_type), tolerance_(tolerance) {}
+
+bool NativePdhgSolver::parameter_supported(const Param param) const {
+  return param == Param::Threads || param == Param::Verbosity ||
+         param == Param::IterationLimit || param == Param::TimeLimit;
+}
+
+void NativePdhgSolver::set_parameter(const Param param, const int value) {
+  if (!parameter_supported(param)) throw UnsupportedParameterException();
+  if (value < 0) throw FailedToSetParameterException();
+  if (param == Param::Threads) {
+    nthreads_ = static_cast<std::size_t>(value);
+  } else if (param == Param::IterationLimit) {
+    iteration_limit_ = static_cast<std::size_t>(value);
+  } else if (param == Param::TimeLimit) {
+    time_limit_ = value;
+  }
+}
+
+void NativePdhgSolver::set_parameter(const Param param, const double value) {
+  if (!parameter_supported(param)) throw UnsupportedParameterException();
+  if (value < 0.0) throw FailedToSetParameterException();
+  if (param == Param::Threads) {
+    nthreads_ = static_cast<std::size_t>(value);
+  } else if (param == Param::IterationLimit) {
+    iteration_limit_ = static_cast<std::size_t>(value);
+  } else if (param == Param::TimeLimit) {
+    time_limit_ = value;
+  }
+}
+
+Status NativePdhgSolver::solve() {
+  const auto num_vars = lp_.num_vars();
+  const auto nthreads =
+      nthreads_ > 0
+          ? nthreads_
+          : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+
+  detail::Pdhg pdhg(detail::make_computational_form(lp_));
+  status_ = pdhg.solve(tolerance_, iteration_limit_, time_limit_, nthreads);
+  iterations_ = pdhg.iterations();
+  achieved_tolerance_ = pdhg.achieved_tolerance();
+
+  solution_.primal = pdhg.primal();
+  solution_.dual = pdhg.dual();
+  if (lp_.optimization_type() == OptimizationType::Maximize) {
+    for (auto& value : solution_.dual) {
+      value = -value;
+    }
+  }
+  const auto& objective = lp_.cached_objective().values;
+  solution_.objective_value = 0.0;
+  for (std::size_t j = 0; j < num_vars && j < objective.size(); j++) {
+    solution_.objective_value += objective[j] * solution_.primal[j];
+  }
+  return status_;
+}
+
+Status NativePdhgSolver::solution_status() const { return status_; }
+
+const ILinearProgramHandle& NativePdhgSolver::linear_program() const {
+  return lp_;
+}
+
+ILinearProgramHandle& NativePdhgSolver::linear_program() { return lp_; }
+
+const Solution<double>& NativePdhgSolver::get_solution() const {
+  if (status_ != Status::Optimal) {
+    throw ModelNotSolvedException();
+  }
+  return solution_;
+}
+
+}  // namespace lpint
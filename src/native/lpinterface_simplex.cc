@@ -0,0 +1,124 @@
+#include "lpinterface/native/lpinterface_simplex.hpp"
+
+#include <utility>
+
+#include "lpinterface/native/computational_form.hpp"
+#include "lpinterface/native/network_simplex.hpp"
+
+namespace lpint {
+
+NativeSimplexSolver::NativeSimplexSolver(OptimizationType optim_type)
+    : lp_(optim_type) {}
+
+bool NativeSimplexSolver::parameter_supported(const Param param) const {
+  return param == Param::Verbosity || param == Param::IterationLimit ||
+         param == Param::TimeLimit;
+}
+
+void NativeSimplexSolver::set_parameter(const Param param, const int value) {
+  if (!parameter_supported(param)) throw UnsupportedParameterException();
+  if (param == Param::TimeLimit) {
+    set_parameter(param, static_cast<double>(value));
+  } else if (param == Param::IterationLimit) {
+    if (value < 0) throw FailedToSetParameterException();
+    iteration_limit_ = static_cast<std::size_t>(value);
+  }
+}
+
+void NativeSimplexSolver::set_parameter(const Param param,
+                                        const double value) {
+  if (!parameter_supported(param)) throw UnsupportedParameterException();
+  if (param == Param::TimeLimit) {
+    if (value < 0.0) throw FailedToSetParameterException();
+    time_limit_ = value;
+  } else if (param == Param::IterationLimit) {
+    if (value < 0.0) throw FailedToSetParameterException();
+    iteration_limit_ = static_cast<std::size_t>(value);
+  }
+}
+
+Status NativeSimplexSolver::solve() {
+  const auto num_vars = lp_.num_vars();
+  const auto num_constraints = lp_.num_constraints();
+  auto model = detail::make_computational_form(lp_);
+
+  std::vector<double> x, y;
+  std::vector<detail::BasisStatus> final_basis;
+  const auto structure = detail::detect_network(model);
+  used_network_simplex_ = structure.kind == detail::NetworkKind::Pure;
+  if (used_network_simplex_) {
+    detail::NetworkSimplex network(model, structure);
+    status_ = network.solve(iteration_limit_, time_limit_);
+    iterations_ = network.iterations();
+    x = network.primal();
+    y = network.dual();
+    final_basis = network.basis();
+  } else {
+    detail::DualSimplex simplex(std::move(model));
+
+    // start from the basis of the previous solve
+    std::vector<detail::BasisStatus> basis(num_vars + num_constraints,
+                                           detail::BasisStatus::AtLower);
+    for (std::size_t j = 0; j < num_vars; j++) {
+      const auto it = variable_basis_.find(lp_.variable_id(j).value());
+      if (it != variable_basis_.end()) {
+        basis[j] = it->second;
+      }
+    }
+    for (std::size_t i = 0; i < num_constraints; i++) {
+      const auto it = constraint_basis_.find(lp_.constraint_id(i).value());
+      basis[num_vars + i] = it != constraint_basis_.end()
+                                ? it->second
+                                : detail::BasisStatus::Basic;
+    }
+    simplex.set_basis(basis);
+
+    status_ = simplex.solve(iteration_limit_, time_limit_);
+    iterations_ = simplex.iterations();
+    x = simplex.primal();
+    y = simplex.dual();
+    final_basis = simplex.basis();
+  }
+
+  variable_basis_.clear();
+  constraint_basis_.clear();
+  for (std::size_t j = 0; j < num_vars; j++) {
+    variable_basis_[lp_.variable_id(j).value()] = final_basis[j];
+  }
+  for (std::size_t i = 0; i < num_constraints; i++) {
+    constraint_basis_[lp_.constraint_id(i).value()] =
+        final_basis[num_vars + i];
+  }
+
+  solution_.primal.assign(x.begin(),
+                          x.begin() + static_cast<std::ptrdiff_t>(num_vars));
+  solution_.dual = std::move(y);
+  if (lp_.optimization_type() == OptimizationType::Maximize) {
+    for (auto& dual : solution_.dual) {
+      dual = -dual;
+    }
+  }
+  const auto& objective = lp_.cached_objective().values;
+  solution_.objective_value = 0.0;
+  for (std::size_t j = 0; j < num_vars && j < objective.size(); j++) {
+    solution_.objective_value += objective[j] * solution_.primal[j];
+  }
+  return status_;
+}
+
+Status NativeSimplexSolver::solution_status() const { return status_; }
+
+const ILinearProgramHandle& NativeSimplexSolver::linear_program() const {
+  return lp_;
+}
+
+ILinearProgramHandle& NativeSimplexSolver::linear_program() { return lp_; }
+
+const Solution<double>& NativeSimplexSolver::get_solution() const {
+  if (status_ != Status::Optimal) {
+    throw ModelNotSolvedException();
+  }
+  return solution_;
+}
+
+}  // namespace lpint
@@ -0,0 +1,536 @@
+#include "lpinterface/native/network_simplex.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "lpinterface/common.hpp"
+
+namespace lpint {
+
+namespace detail {
+
+namespace {
+
+// Union-find over the rows that also keeps the parity between every row
+// and the representative of its set.
+class ParityUnionFind {
+ public:
+  explicit ParityUnionFind(const std::size_t n) : parent_(n), parity_(n, 1) {
+    for (std::size_t i = 0; i < n; i++) {
+      parent_[i] = i;
+    }
+  }
+
+  // representative of i, with the parity of i relative to it
+  std::size_t find(std::size_t i, int& parity) {
+    parity = 1;
+    auto root = i;
+    while (parent_[root] != root) {
+      parity *= parity_[root];
+      root = parent_[root];
+    }
+    // compress the path, keeping the parities relative to the root
+    auto path_parity = parity;
+    while (parent_[i] != root) {
+      const auto next = parent_[i];
+      const auto next_parity = path_parity * parity_[i];
+      parent_[i] = root;
+      parity_[i] = path_parity;
+      i = next;
+      path_parity = next_parity;
+    }
+    return root;
+  }
+
+  // requires parity(i) * parity(k) == relation; returns false if that
+  // contradicts the relations added before
+  bool unite(const std::size_t i, const std::size_t k, const int relation) {
+    int parity_i, parity_k;
+    const auto root_i = find(i, parity_i);
+    const auto root_k = find(k, parity_k);
+    if (root_i == root_k) {
+      return parity_i * parity_k == relation;
+    }
+    parent_[root_i] = root_k;
+    parity_[root_i] = relation * parity_i * parity_k;
+    return true;
+  }
+
+ private:
+  std::vector<std::size_t> parent_;
+  std::vector<int> parity_;
+};
+
+}  // namespace
+
+NetworkStructure detect_network(const ComputationalForm& model) {
+  NetworkStructure structure;
+  bool unit = true;
+  for (std::size_t j = 0; j < model.num_columns; j++) {
+    const auto begin = model.column_starts[j];
+    const auto end = model.column_starts[j + 1];
+    if (end - begin > 2) {
+      return structure;
+    }
+    for (auto k = begin; k < end; k++) {
+      if (std::abs(model.values[k]) != 1.0) {
+        unit = false;
+      }
+    }
+  }
+  structure.kind = NetworkKind::Generalized;
+  if (!unit) {
+    return structure;
+  }
+
+  // the two entries of a column must have opposite signs after the
+  // reflection, so sign_i * sign_k = -a_ij * a_kj
+  ParityUnionFind rows(model.num_rows);
+  for (std::size_t j = 0; j < model.num_columns; j++) {
+    const auto begin = model.column_starts[j];
+    if (model.column_starts[j + 1] - begin != 2) {
+      continue;
+    }
+    const auto relation =
+        model.values[begin] * model.values[begin + 1] > 0.0 ? -1 : 1;
+    if (model.row_indices[begin] == model.row_indices[begin + 1] ||
+        !rows.unite(model.row_indices[begin], model.row_indices[begin + 1],
+                    relation)) {
+      return structure;
+    }
+  }
+  structure.kind = NetworkKind::Pure;
+  structure.row_signs.resize(model.num_rows);
+  for (std::size_t i = 0; i < model.num_rows; i++) {
+    int parity;
+    rows.find(i, parity);
+    structure.row_signs[i] = parity;
+  }
+  return structure;
+}
+
+NetworkSimplex::NetworkSimplex(const ComputationalForm& model,
+                               const NetworkStructure& structure)
+    : num_rows_(model.num_rows),
+      num_columns_(model.num_columns),
+      num_nodes_(model.num_rows + 1),
+      num_arcs_(model.num_columns + 2 * model.num_rows),
+      root_(model.num_rows),
+      row_signs_(structure.row_signs),
+      tail_(num_arcs_, root_),
+      head_(num_arcs_, root_),
+      cost_(num_arcs_, 0.0),
+      lower_(num_arcs_, 0.0),
+      upper_(num_arcs_, 0.0),
+      flow_(num_arcs_, 0.0),
+      state_(num_arcs_, State::AtLower),
+      original_cost_(num_arcs_, 0.0),
+      parent_(num_nodes_, num_nodes_),
+      parent_arc_(num_nodes_, num_arcs_),
+      first_child_(num_nodes_, num_nodes_),
+      next_sibling_(num_nodes_, num_nodes_),
+      previous_sibling_(num_nodes_, num_nodes_),
+      depth_(num_nodes_, 0),
+      potential_(num_nodes_, 0.0) {
+  // a column leaves the row where its reflected entry is +1 and enters
+  // the row where it is -1, or the root if there is no such row
+  for (std::size_t j = 0; j < num_columns_; j++) {
+    for (auto k = model.column_starts[j]; k < model.column_starts[j + 1];
+         k++) {
+      const auto i = model.row_indices[k];
+      if (row_signs_[i] * model.values[k] > 0.0) {
+        tail_[j] = i;
+      } else {
+        head_[j] = i;
+      }
+    }
+    original_cost_[j] = model.cost[j];
+    lower_[j] = model.lower[j];
+    upper_[j] = model.upper[j];
+  }
+  // the reflected logical of row i is an arc from the root into i, as
+  // the row states that the flow out of i through the columns is s_i
+  for (std::size_t i = 0; i < num_rows_; i++) {
+    const auto k = num_columns_ + i;
+    head_[k] = i;
+    const auto lower = model.lower[num_columns_ + i];
+    const auto upper = model.upper[num_columns_ + i];
+    lower_[k] = row_signs_[i] > 0.0 ? lower : -upper;
+    upper_[k] = row_signs_[i] > 0.0 ? upper : -lower;
+  }
+
+  double max_cost = 1.0;
+  for (const auto c : original_cost_) {
+    max_cost = std::max(max_cost, std::abs(c));
+  }
+  tolerance_ = 1e-9 * max_cost;
+  block_size_ = std::max<std::size_t>(
+      10, static_cast<std::size_t>(std::sqrt(static_cast<double>(num_arcs_))));
+}
+
+Status NetworkSimplex::solve(const std::size_t iteration_limit,
+                             const double time_limit) {
+  start_ = std::chrono::steady_clock::now();
+  iterations_ = 0;
+  next_arc_ = 0;
+  for (std::size_t k = 0; k < num_columns_ + num_rows_; k++) {
+    if (lower_[k] > upper_[k] + 1e-9) {
+      return Status::Infeasible;
+    }
+  }
+
+  // nonbasic arcs start at a bound, and the excess of every node is
+  // carried by its artificial arc
+  std::vector<double> excess(num_nodes_, 0.0);
+  for (std::size_t k = 0; k < num_columns_ + num_rows_; k++) {
+    if (!std::isinf(lower_[k])) {
+      state_[k] = State::AtLower;
+      flow_[k] = lower_[k];
+    } else if (!std::isinf(upper_[k])) {
+      state_[k] = State::AtUpper;
+      flow_[k] = upper_[k];
+    } else {
+      state_[k] = State::AtZero;
+      flow_[k] = 0.0;
+    }
+    excess[tail_[k]] += flow_[k];
+    excess[head_[k]] -= flow_[k];
+    cost_[k] = 0.0;
+  }
+  double max_excess = 1.0;
+  for (std::size_t i = 0; i < num_rows_; i++) {
+    // arcs with zero flow point to the root, so that the tree is
+    // strongly feasible
+    const auto k = num_columns_ + num_rows_ + i;
+    if (excess[i] > 0.0) {
+      tail_[k] = root_;
+      head_[k] = i;
+    } else {
+      tail_[k] = i;
+      head_[k] = root_;
+    }
+    flow_[k] = std::abs(excess[i]);
+    max_excess = std::max(max_excess, flow_[k]);
+    lower_[k] = 0.0;
+    upper_[k] = LPINT_INFINITY;
+    cost_[k] = 1.0;
+    state_[k] = State::Tree;
+  }
+
+  std::fill(first_child_.begin(), first_child_.end(), num_nodes_);
+  for (std::size_t i = 0; i < num_rows_; i++) {
+    parent_[i] = root_;
+    parent_arc_[i] = num_columns_ + num_rows_ + i;
+    add_child(root_, i);
+  }
+  potential_[root_] = 0.0;
+  depth_[root_] = 0;
+  for (std::size_t i = 0; i < num_rows_; i++) {
+    update_subtree(i);
+  }
+
+  // phase one: minimize the flow on the artificial arcs
+  const auto saved_tolerance = tolerance_;
+  tolerance_ = 1e-9;
+  auto result = iterate(iteration_limit, time_limit);
+  tolerance_ = saved_tolerance;
+  if (result == LoopResult::IterationLimit) {
+    return Status::IterationLimit;
+  }
+  if (result == LoopResult::TimeOut) {
+    return Status::TimeOut;
+  }
+  double infeasibility = 0.0;
+  for (std::size_t i = 0; i < num_rows_; i++) {
+    infeasibility += flow_[num_columns_ + num_rows_ + i];
+  }
+  if (infeasibility > 1e-9 * max_excess) {
+    return Status::Infeasible;
+  }
+
+  // phase two: the artificial arcs are fixed at zero
+  for (std::size_t k = 0; k < num_columns_ + num_rows_; k++) {
+    cost_[k] = original_cost_[k];
+  }
+  for (std::size_t i = 0; i < num_rows_; i++) {
+    const auto k = num_columns_ + num_rows_ + i;
+    flow_[k] = 0.0;
+    upper_[k] = 0.0;
+    cost_[k] = 0.0;
+  }
+  for (auto child = first_child_[root_]; child != num_nodes_;
+       child = next_sibling_[child]) {
+    update_subtree(child);
+  }
+  result = iterate(iteration_limit, time_limit);
+  switch (result) {
+    case LoopResult::Optimal:
+      return Status::Optimal;
+    case LoopResult::Unbounded:
+      return Status::Unbounded;
+    case LoopResult::IterationLimit:
+      return Status::IterationLimit;
+    case LoopResult::TimeOut:
+    default:
+      return Status::TimeOut;
+  }
+}
+
+NetworkSimplex::LoopResult NetworkSimplex::iterate(
+    const std::size_t iteration_limit, const double time_limit) {
+  while (true) {
+    if (iterations_ >= iteration_limit) {
+      return LoopResult::IterationLimit;
+    }
+    if (iterations_ % 64 == 0 && time_exceeded(time_limit)) {
+      return LoopResult::TimeOut;
+    }
+    double direction = 0.0;
+    const auto entering = find_entering(direction);
+    if (entering == num_arcs_) {
+      return LoopResult::Optimal;
+    }
+    if (!pivot(entering, direction)) {
+      return LoopResult::Unbounded;
+    }
+    iterations_++;
+  }
+}
+
+std::size_t NetworkSimplex::find_entering(double& direction) {
+  // scan blocks of arcs, starting where the last search stopped, and take
+  // the most violating arc of the first block that has one
+  std::size_t best_arc = num_arcs_;
+  double best = tolerance_;
+  std::size_t count = 0;
+  for (std::size_t n = 0; n < num_arcs_; n++) {
+    const auto k = next_arc_;
+    next_arc_ = k + 1 == num_arcs_ ? 0 : k + 1;
+    if (state_[k] != State::Tree && lower_[k] != upper_[k]) {
+      const auto d = reduced_cost(k);
+      double violation = 0.0;
+      double sign = 0.0;
+      if (state_[k] != State::AtUpper && -d > violation) {
+        violation = -d;
+        sign = 1.0;
+      }
+      if (state_[k] != State::AtLower && d > violation) {
+        violation = d;
+        sign = -1.0;
+      }
+      if (violation > best) {
+        best = violation;
+        best_arc = k;
+        direction = sign;
+      }
+    }
+    if (++count == block_size_) {
+      if (best_arc != num_arcs_) {
+        break;
+      }
+      count = 0;
+    }
+  }
+  return best_arc;
+}
+
+bool NetworkSimplex::pivot(const std::size_t entering,
+                           const double direction) {
+  // flow goes from first to second over the entering arc, and back
+  // through the tree from second up to the join and down to first
+  const auto first = direction > 0.0 ? tail_[entering] : head_[entering];
+  const auto second = direction > 0.0 ? head_[entering] : tail_[entering];
+  auto u = first;
+  auto v = second;
+  while (u != v) {
+    if (depth_[u] >= depth_[v]) {
+      u = parent_[u];
+    } else {
+      v = parent_[v];
+    }
+  }
+  const auto join = u;
+
+  // ratio test: of the blocking arcs, the last one in the direction of
+  // the cycle starting from the join leaves, which keeps the tree
+  // strongly feasible
+  double step = direction > 0.0 ? upper_[entering] - flow_[entering]
+                                : flow_[entering] - lower_[entering];
+  std::size_t leaving = num_nodes_;
+  bool first_side = false;
+  for (auto x = first; x != join; x = parent_[x]) {
+    const auto k = parent_arc_[x];
+    const auto residual =
+        head_[k] == x ? upper_[k] - flow_[k] : flow_[k] - lower_[k];
+    if (residual < step) {
+      step = residual;
+      leaving = x;
+      first_side = true;
+    }
+  }
+  for (auto x = second; x != join; x = parent_[x]) {
+    const auto k = parent_arc_[x];
+    const auto residual =
+        tail_[k] == x ? upper_[k] - flow_[k] : flow_[k] - lower_[k];
+    if (residual <= step) {
+      step = residual;
+      leaving = x;
+      first_side = false;
+    }
+  }
+  if (std::isinf(step)) {
+    return false;
+  }
+
+  if (step > 0.0) {
+    flow_[entering] += direction * step;
+    for (auto x = first; x != join; x = parent_[x]) {
+      const auto k = parent_arc_[x];
+      flow_[k] += head_[k] == x ? step : -step;
+    }
+    for (auto x = second; x != join; x = parent_[x]) {
+      const auto k = parent_arc_[x];
+      flow_[k] += tail_[k] == x ? step : -step;
+    }
+  }
+  if (leaving == num_nodes_) {
+    // bound flip
+    state_[entering] = direction > 0.0 ? State::AtUpper : State::AtLower;
+    flow_[entering] =
+        direction > 0.0 ? upper_[entering] : lower_[entering];
+    return true;
+  }
+
+  const auto left = parent_arc_[leaving];
+  const auto increased =
+      first_side ? head_[left] == leaving : tail_[left] == leaving;
+  state_[left] = increased ? State::AtUpper : State::AtLower;
+  flow_[left] = increased ? upper_[left] : lower_[left];
+  state_[entering] = State::Tree;
+
+  // the subtree below the leaving arc hangs from the entering arc now:
+  // reverse the path from its endpoint in the subtree up to the leaving
+  // arc
+  const auto inside = first_side ? first : second;
+  auto new_parent = first_side ? second : first;
+  auto new_arc = entering;
+  auto x = inside;
+  while (true) {
+    const auto old_parent = parent_[x];
+    const auto old_arc = parent_arc_[x];
+    remove_child(old_parent, x);
+    parent_[x] = new_parent;
+    parent_arc_[x] = new_arc;
+    add_child(new_parent, x);
+    if (x == leaving) {
+      break;
+    }
+    new_parent = x;
+    new_arc = old_arc;
+    x = old_parent;
+  }
+  update_subtree(inside);
+  return true;
+}
+
+void NetworkSimplex::add_child(const std::size_t parent,
+                               const std::size_t child) {
+  next_sibling_[child] = first_child_[parent];
+  previous_sibling_[child] = num_nodes_;
+  if (first_child_[parent] != num_nodes_) {
+    previous_sibling_[first_child_[parent]] = child;
+  }
+  first_child_[parent] = child;
+}
+
+void NetworkSimplex::remove_child(const std::size_t parent,
+                                  const std::size_t child) {
+  if (previous_sibling_[child] != num_nodes_) {
+    next_sibling_[previous_sibling_[child]] = next_sibling_[child];
+  } else {
+    first_child_[parent] = next_sibling_[child];
+  }
+  if (next_sibling_[child] != num_nodes_) {
+    previous_sibling_[next_sibling_[child]] = previous_sibling_[child];
+  }
+}
+
+void NetworkSimplex::update_subtree(const std::size_t node) {
+  // tree arcs have zero reduced cost
+  stack_.assign(1, node);
+  while (!stack_.empty()) {
+    const auto x = stack_.back();
+    stack_.pop_back();
+    const auto p = parent_[x];
+    const auto k = parent_arc_[x];
+    depth_[x] = depth_[p] + 1;
+    potential_[x] =
+        tail_[k] == p ? potential_[p] + cost_[k] : potential_[p] - cost_[k];
+    for (auto child = first_child_[x]; child != num_nodes_;
+         child = next_sibling_[child]) {
+      stack_.push_back(child);
+    }
+  }
+}
+
+bool NetworkSimplex::time_exceeded(const double time_limit) const {
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start_;
+  return elapsed.count() > time_limit;
+}
+
+std::vector<double> NetworkSimplex::primal() const {
+  std::vector<double> x(flow_.begin(),
+                        flow_.begin() + static_cast<std::ptrdiff_t>(
+                                            num_columns_ + num_rows_));
+  for (std::size_t i = 0; i < num_rows_; i++) {
+    x[num_columns_ + i] *= row_signs_[i];
+  }
+  return x;
+}
+
+std::vector<double> NetworkSimplex::dual() const {
+  // the reduced cost c_j + pi_tail - pi_head of a column equals
+  // c_j - a_j^T y for y_i = -sign_i pi_i
+  std::vector<double> y(num_rows_);
+  for (std::size_t i = 0; i < num_rows_; i++) {
+    y[i] = -row_signs_[i] * potential_[i];
+  }
+  return y;
+}
+
+std::vector<BasisStatus> NetworkSimplex::basis() const {
+  // artificial arcs left in the tree have no counterpart; DualSimplex
+  // completes the basis with logical variables
+  std::vector<BasisStatus> basis(num_columns_ + num_rows_);
+  for (std::size_t k = 0; k < basis.size(); k++) {
+    auto state = state_[k];
+    if (k >= num_columns_ && row_signs_[k - num_columns_] < 0.0) {
+      if (state == State::AtLower) {
+        state = State::AtUpper;
+      } else if (state == State::AtUpper) {
+        state = State::AtLower;
+      }
+    }
+    switch (state) {
+      case State::Tree:
+        basis[k] = BasisStatus::Basic;
+        break;
+      case State::AtUpper:
+        basis[k] = BasisStatus::AtUpper;
+        break;
+      case State::AtZero:
+        basis[k] = BasisStatus::AtZero;
+        break;
+      case State::AtLower:
+      default:
+        basis[k] = BasisStatus::AtLower;
+        break;
+    }
+  }
+  return basis;
+}
+
+}  // namespace detail
+
+}  // namespace lpint
@@ -0,0 +1,635 @@
+#include "lpinterface/native/pdhg.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+#include "lpinterface/detail/parallel.hpp"
+
+namespace lpint {
+
+namespace detail {
+
+namespace {
+
+// number of Ruiz equilibration passes
+constexpr std::size_t ruiz_iterations = 10;
+// the KKT error, termination and infeasibility are checked this often
+constexpr std::size_t evaluation_frequency = 64;
+// restart when the KKT error has decreased by this factor...
+constexpr double sufficient_decrease = 0.2;
+// ...or by this factor and stopped decreasing...
+constexpr double necessary_decrease = 0.8;
+// ...or after this fraction of all iterations without a restart
+constexpr double artificial_restart = 0.36;
+// the primal weight stays within this factor of its starting value
+constexpr double weight_range = 1e4;
+// relative violation of a ray accepted as a certificate of infeasibility
+constexpr double infeasibility_tolerance = 1e-6;
+// rays this small relative to the iterate are rounding noise
+constexpr double negligible_ray = 1e-8;
+// smallest number of nonzeros worth a thread
+constexpr std::size_t min_entries_per_thread = 1 << 15;
+
+double clamp(const double value, const double lower, const double upper) {
+  return std::min(std::max(value, lower), upper);
+}
+
+// Dot product of a sparse row or column with a dense vector. Independent
+// partial sums let the compiler overlap and vectorize the gathers.
+double sparse_dot(const double* values, const std::size_t* indices,
+                  const std::size_t count, const std::vector<double>& dense) {
+  double sum0 = 0.0;
+  double sum1 = 0.0;
+  double sum2 = 0.0;
+  double sum3 = 0.0;
+  std::size_t k = 0;
+  for (; k + 4 <= count; k += 4) {
+    sum0 += values[k] * dense[indices[k]];
+    sum1 += values[k + 1] * dense[indices[k + 1]];
+    sum2 += values[k + 2] * dense[indices[k + 2]];
+    sum3 += values[k + 3] * dense[indices[k + 3]];
+  }
+  for (; k < count; k++) {
+    sum0 += values[k] * dense[indices[k]];
+  }
+  return (sum0 + sum1) + (sum2 + sum3);
+}
+
+double norm(const std::vector<double>& a) {
+  double result = 0.0;
+  for (const auto value : a) {
+    result += value * value;
+  }
+  return std::sqrt(result);
+}
+
+double distance(const std::vector<double>& a, const std::vector<double>& b) {
+  double result = 0.0;
+  for (std::size_t k = 0; k < a.size(); k++) {
+    result += (a[k] - b[k]) * (a[k] - b[k]);
+  }
+  return std::sqrt(result);
+}
+
+}  // namespace
+
+Pdhg::Pdhg(ComputationalForm model)
+    : m_(model.num_rows),
+      n_(model.num_columns),
+      column_starts_(std::move(model.column_starts)),
+      row_indices_(std::move(model.row_indices)),
+      column_values_(std::move(model.values)),
+      cost_(std::move(model.cost)) {
+  const auto n = static_cast<std::ptrdiff_t>(n_);
+  lower_.assign(model.lower.begin(), model.lower.begin() + n);
+  upper_.assign(model.upper.begin(), model.upper.begin() + n);
+  row_lower_.assign(model.lower.begin() + n, model.lower.end());
+  row_upper_.assign(model.upper.begin() + n, model.upper.end());
+
+  for (const auto c : cost_) {
+    cost_norm_ += c * c;
+  }
+  cost_norm_ = std::sqrt(cost_norm_);
+  for (std::size_t i = 0; i < m_; i++) {
+    double bound = 0.0;
+    if (!std::isinf(row_lower_[i])) {
+      bound = std::abs(row_lower_[i]);
+    }
+    if (!std::isinf(row_upper_[i])) {
+      bound = std::max(bound, std::abs(row_upper_[i]));
+    }
+    bound_norm_ += bound * bound;
+  }
+  bound_norm_ = std::sqrt(bound_norm_);
+
+  scale();
+
+  row_starts_.assign(m_ + 1, 0);
+  for (const auto i : row_indices_) {
+    row_starts_[i + 1]++;
+  }
+  for (std::size_t i = 0; i < m_; i++) {
+    row_starts_[i + 1] += row_starts_[i];
+  }
+  column_indices_.resize(row_starts_.back());
+  row_values_.resize(row_starts_.back());
+  auto next = row_starts_;
+  for (std::size_t j = 0; j < n_; j++) {
+    for (auto k = column_starts_[j]; k < column_starts_[j + 1]; k++) {
+      const auto i = row_indices_[k];
+      column_indices_[next[i]] = j;
+      row_values_[next[i]] = column_values_[k];
+      next[i]++;
+    }
+  }
+}
+
+void Pdhg::scale() {
+  row_scale_.assign(m_, 1.0);
+  column_scale_.assign(n_, 1.0);
+  std::vector<double> row_factor(m_);
+  std::vector<double> column_factor(n_);
+  const auto apply = [&]() {
+    for (std::size_t i = 0; i < m_; i++) {
+      row_factor[i] = row_factor[i] > 0.0 ? 1.0 / std::sqrt(row_factor[i])
+                                          : 1.0;
+      row_scale_[i] *= row_factor[i];
+    }
+    for (std::size_t j = 0; j < n_; j++) {
+      column_factor[j] = column_factor[j] > 0.0
+                             ? 1.0 / std::sqrt(column_factor[j])
+                             : 1.0;
+      column_scale_[j] *= column_factor[j];
+      for (auto k = column_starts_[j]; k < column_starts_[j + 1]; k++) {
+        column_values_[k] *= row_factor[row_indices_[k]] * column_factor[j];
+      }
+    }
+  };
+
+  // Ruiz: divide by the square roots of the largest entries of every row
+  // and column, which brings them all towards one
+  for (std::size_t pass = 0; pass < ruiz_iterations; pass++) {
+    std::fill(row_factor.begin(), row_factor.end(), 0.0);
+    std::fill(column_factor.begin(), column_factor.end(), 0.0);
+    for (std::size_t j = 0; j < n_; j++) {
+      for (auto k = column_starts_[j]; k < column_starts_[j + 1]; k++) {
+        const auto value = std::abs(column_values_[k]);
+        column_factor[j] = std::max(column_factor[j], value);
+        row_factor[row_indices_[k]] =
+            std::max(row_factor[row_indices_[k]], value);
+      }
+    }
+    apply();
+  }
+  // Pock-Chambolle: the same with the sums of the absolute values, which
+  // bounds the norm of the scaled matrix by one
+  std::fill(row_factor.begin(), row_factor.end(), 0.0);
+  std::fill(column_factor.begin(), column_factor.end(), 0.0);
+  for (std::size_t j = 0; j < n_; j++) {
+    for (auto k = column_starts_[j]; k < column_starts_[j + 1]; k++) {
+      const auto value = std::abs(column_values_[k]);
+      column_factor[j] += value;
+      row_factor[row_indices_[k]] += value;
+    }
+  }
+  apply();
+
+  for (std::size_t j = 0; j < n_; j++) {
+    cost_[j] *= column_scale_[j];
+    lower_[j] /= column_scale_[j];
+    upper_[j] /= column_scale_[j];
+  }
+  for (std::size_t i = 0; i < m_; i++) {
+    row_lower_[i] *= row_scale_[i];
+    row_upper_[i] *= row_scale_[i];
+  }
+}
+
+void Pdhg::multiply(const std::vector<double>& x,
+                    std::vector<double>& result,
+                    const std::size_t nthreads) const {
+  result.resize(m_);
+  run_parallel(nthreads, [&](const std::size_t t) {
+    const auto end = part_begin(m_, nthreads, t + 1);
+    for (auto i = part_begin(m_, nthreads, t); i < end; i++) {
+      result[i] = sparse_dot(row_values_.data() + row_starts_[i],
+                             column_indices_.data() + row_starts_[i],
+                             row_starts_[i + 1] - row_starts_[i], x);
+    }
+  });
+}
+
+void Pdhg::step(const std::size_t nthreads) {
+  const auto& x = current_.x;
+  const auto& y = current_.y;
+  const auto& ax = current_.ax;
+  const auto& aty = current_.aty;
+  auto& next_x = next_.x;
+  auto& next_y = next_.y;
+  auto& next_ax = next_.ax;
+  // per thread: squared primal and dual movement, and their interaction
+  std::vector<double> sums(3 * nthreads);
+  const auto k = static_cast<double>(iterations_ + 1);
+  double used = 0.0;
+
+  // adaptive step size: try a step and accept it if it was not too long
+  // for the local curvature of the bilinear term, shrinking it otherwise
+  while (true) {
+    const auto primal_step = step_size_ / primal_weight_;
+    const auto dual_step = step_size_ * primal_weight_;
+    std::fill(sums.begin(), sums.end(), 0.0);
+    run_parallel(nthreads, [&](const std::size_t t) {
+      const auto end = part_begin(n_, nthreads, t + 1);
+      double movement = 0.0;
+      for (auto j = part_begin(n_, nthreads, t); j < end; j++) {
+        next_x[j] = clamp(x[j] - primal_step * (cost_[j] - aty[j]),
+                          lower_[j], upper_[j]);
+        movement += (next_x[j] - x[j]) * (next_x[j] - x[j]);
+      }
+      sums[3 * t] = movement;
+    });
+    run_parallel(nthreads, [&](const std::size_t t) {
+      const auto end = part_begin(m_, nthreads, t + 1);
+      double movement = 0.0;
+      double interaction = 0.0;
+      for (auto i = part_begin(m_, nthreads, t); i < end; i++) {
+        next_ax[i] = sparse_dot(row_values_.data() + row_starts_[i],
+                                column_indices_.data() + row_starts_[i],
+                                row_starts_[i + 1] - row_starts_[i], next_x);
+        // maximize y a_i or y b_i, whichever is smaller, minus the
+        // proximal term, around the extrapolated dual step
+        const auto v = y[i] - dual_step * (2.0 * next_ax[i] - ax[i]);
+        if (v + dual_step * row_lower_[i] > 0.0) {
+          next_y[i] = v + dual_step * row_lower_[i];
+        } else if (v + dual_step * row_upper_[i] < 0.0) {
+          next_y[i] = v + dual_step * row_upper_[i];
+        } else {
+          next_y[i] = 0.0;
+        }
+        const auto dy = next_y[i] - y[i];
+        movement += dy * dy;
+        interaction += dy * (next_ax[i] - ax[i]);
+      }
+      sums[3 * t + 1] = movement;
+      sums[3 * t + 2] = interaction;
+    });
+    double primal_movement = 0.0;
+    double dual_movement = 0.0;
+    double interaction = 0.0;
+    for (std::size_t t = 0; t < nthreads; t++) {
+      primal_movement += sums[3 * t];
+      dual_movement += sums[3 * t + 1];
+      interaction += sums[3 * t + 2];
+    }
+    const auto movement = 0.5 * (primal_weight_ * primal_movement +
+                                 dual_movement / primal_weight_);
+    const auto limit = std::abs(interaction) > 0.0
+                           ? movement / std::abs(interaction)
+                           : LPINT_INFINITY;
+    const auto next_step_size =
+        std::min((1.0 - std::pow(k + 1.0, -0.3)) * limit,
+                 (1.0 + std::pow(k + 1.0, -0.6)) * step_size_);
+    const auto accepted = step_size_ <= limit;
+    used = step_size_;
+    step_size_ = next_step_size;
+    if (accepted) {
+      break;
+    }
+  }
+
+  // A^T y of the new point, and the weighted sums for the average
+  run_parallel(nthreads, [&](const std::size_t t) {
+    const auto column_end = part_begin(n_, nthreads, t + 1);
+    for (auto j = part_begin(n_, nthreads, t); j < column_end; j++) {
+      next_.aty[j] = sparse_dot(column_values_.data() + column_starts_[j],
+                                row_indices_.data() + column_starts_[j],
+                                column_starts_[j + 1] - column_starts_[j],
+                                next_y);
+      sum_.x[j] += used * next_x[j];
+      sum_.aty[j] += used * next_.aty[j];
+    }
+    const auto row_end = part_begin(m_, nthreads, t + 1);
+    for (auto i = part_begin(m_, nthreads, t); i < row_end; i++) {
+      sum_.y[i] += used * next_y[i];
+      sum_.ax[i] += used * next_ax[i];
+    }
+  });
+  sum_weight_ += used;
+  std::swap(current_, next_);
+}
+
+Pdhg::Measures Pdhg::measure(const Point& point) const {
+  Measures result;
+  for (std::size_t i = 0; i < m_; i++) {
+    const auto violation = std::max(row_lower_[i] - point.ax[i], 0.0) +
+                           std::max(point.ax[i] - row_upper_[i], 0.0);
+    result.primal_residual += violation * violation /
+                              (row_scale_[i] * row_scale_[i]);
+    const auto y = point.y[i];
+    if (y > 0.0 && !std::isinf(row_lower_[i])) {
+      result.dual_objective += y * row_lower_[i];
+    } else if (y < 0.0 && !std::isinf(row_upper_[i])) {
+      result.dual_objective += y * row_upper_[i];
+    }
+  }
+  for (std::size_t j = 0; j < n_; j++) {
+    result.primal_objective += cost_[j] * point.x[j];
+    // reduced costs are supported by the bound on their side; whatever
+    // is left is dual infeasible
+    const auto reduced_cost = cost_[j] - point.aty[j];
+    double violation = 0.0;
+    if (reduced_cost > 0.0) {
+      if (std::isinf(lower_[j])) {
+        violation = reduced_cost;
+      } else {
+        result.dual_objective += reduced_cost * lower_[j];
+      }
+    } else if (reduced_cost < 0.0) {
+      if (std::isinf(upper_[j])) {
+        violation = reduced_cost;
+      } else {
+        result.dual_objective += reduced_cost * upper_[j];
+      }
+    }
+    result.dual_residual += violation * violation /
+                            (column_scale_[j] * column_scale_[j]);
+  }
+  result.primal_residual = std::sqrt(result.primal_residual);
+  result.dual_residual = std::sqrt(result.dual_residual);
+  return result;
+}
+
+double Pdhg::relative_error(const Measures& measures) const {
+  const auto gap =
+      std::abs(measures.primal_objective - measures.dual_objective) /
+      (1.0 + std::abs(measures.primal_objective) +
+       std::abs(measures.dual_objective));
+  return std::max(
+      std::max(measures.primal_residual / (1.0 + bound_norm_),
+               measures.dual_residual / (1.0 + cost_norm_)),
+      gap);
+}
+
+double Pdhg::kkt_error(const Measures& measures) const {
+  const auto weight = primal_weight_ * primal_weight_;
+  const auto gap = measures.primal_objective - measures.dual_objective;
+  return std::sqrt(
+      weight * measures.primal_residual * measures.primal_residual +
+      measures.dual_residual * measures.dual_residual / weight + gap * gap);
+}
+
+bool Pdhg::primal_infeasible(const Point& from, const Point& to) const {
+  // a dual ray: its objective must be clearly positive, while the reduced
+  // costs violate the sign conditions of the bounds only slightly. The
+  // parts of the ray on the wrong side of an infinite row bound stay
+  // bounded, so they are dropped rather than counted as a violation.
+  std::vector<double> reduced_costs(n_);
+  for (std::size_t j = 0; j < n_; j++) {
+    reduced_costs[j] = from.aty[j] - to.aty[j];
+  }
+  double objective = 0.0;
+  double size = 0.0;
+  double scaled_size = 0.0;
+  for (std::size_t i = 0; i < m_; i++) {
+    const auto ray = to.y[i] - from.y[i];
+    const auto bound = ray > 0.0 ? row_lower_[i] : row_upper_[i];
+    if (ray == 0.0) {
+      continue;
+    } else if (std::isinf(bound)) {
+      for (auto k = row_starts_[i]; k < row_starts_[i + 1]; k++) {
+        reduced_costs[column_indices_[k]] += row_values_[k] * ray;
+      }
+    } else {
+      objective += ray * bound;
+      size += ray * ray * row_scale_[i] * row_scale_[i];
+      scaled_size += ray * ray;
+    }
+  }
+  if (std::sqrt(scaled_size) <= negligible_ray * (1.0 + norm(to.y))) {
+    return false;
+  }
+  double violation = 0.0;
+  for (std::size_t j = 0; j < n_; j++) {
+    const auto reduced_cost = reduced_costs[j];
+    const auto bound = reduced_cost > 0.0 ? lower_[j] : upper_[j];
+    if (reduced_cost == 0.0) {
+      continue;
+    } else if (std::isinf(bound)) {
+      violation += reduced_cost * reduced_cost /
+                   (column_scale_[j] * column_scale_[j]);
+    } else {
+      objective += reduced_cost * bound;
+    }
+  }
+  return objective > infeasibility_tolerance * std::sqrt(size) *
+                         (1.0 + bound_norm_) &&
+         std::sqrt(violation) <= infeasibility_tolerance * objective;
+}
+
+bool Pdhg::dual_infeasible(const Point& from, const Point& to) const {
+  // a primal ray: it must clearly decrease the objective, while its row
+  // activities stay inside the recession cone of the row bounds up to a
+  // small violation. The parts of the ray against a finite bound on x
+  // stay bounded, so they are dropped.
+  std::vector<double> activities(m_);
+  for (std::size_t i = 0; i < m_; i++) {
+    activities[i] = to.ax[i] - from.ax[i];
+  }
+  double objective = 0.0;
+  double size = 0.0;
+  double scaled_size = 0.0;
+  for (std::size_t j = 0; j < n_; j++) {
+    const auto ray = to.x[j] - from.x[j];
+    if ((ray > 0.0 && !std::isinf(upper_[j])) ||
+        (ray < 0.0 && !std::isinf(lower_[j]))) {
+      for (auto k = column_starts_[j]; k < column_starts_[j + 1]; k++) {
+        activities[row_indices_[k]] -= column_values_[k] * ray;
+      }
+    } else {
+      objective += cost_[j] * ray;
+      size += ray * ray * column_scale_[j] * column_scale_[j];
+      scaled_size += ray * ray;
+    }
+  }
+  if (std::sqrt(scaled_size) <= negligible_ray * (1.0 + norm(to.x))) {
+    return false;
+  }
+  double violation = 0.0;
+  for (std::size_t i = 0; i < m_; i++) {
+    const auto activity = activities[i];
+    if ((activity > 0.0 && !std::isinf(row_upper_[i])) ||
+        (activity < 0.0 && !std::isinf(row_lower_[i]))) {
+      violation += activity * activity / (row_scale_[i] * row_scale_[i]);
+    }
+  }
+
+  return -objective > infeasibility_tolerance * std::sqrt(size) *
+                          (1.0 + cost_norm_) &&
+         std::sqrt(violation) <= -infeasibility_tolerance * objective;
+}
+
+void Pdhg::store_solution(const Point& point) {
+  primal_.resize(n_);
+  for (std::size_t j = 0; j < n_; j++) {
+    primal_[j] = point.x[j] * column_scale_[j];
+  }
+  dual_.resize(m_);
+  for (std::size_t i = 0; i < m_; i++) {
+    dual_[i] = point.y[i] * row_scale_[i];
+  }
+}
+
+Status Pdhg::solve(const double tolerance, const std::size_t iteration_limit,
+                   const double time_limit, const std::size_t nthreads) {
+  const auto start = std::chrono::steady_clock::now();
+  const auto threads =
+      std::min(std::max<std::size_t>(nthreads, 1),
+               num_threads_for(column_values_.size() + m_ + n_,
+                               min_entries_per_thread));
+  iterations_ = 0;
+  achieved_tolerance_ = LPINT_INFINITY;
+
+  current_.x.resize(n_);
+  for (std::size_t j = 0; j < n_; j++) {
+    current_.x[j] = clamp(0.0, lower_[j], upper_[j]);
+  }
+  current_.y.assign(m_, 0.0);
+  current_.aty.assign(n_, 0.0);
+  multiply(current_.x, current_.ax, threads);
+  next_ = current_;
+  restart_ = current_;
+  average_ = current_;
+  const auto reset_sums = [&]() {
+    sum_.x.assign(n_, 0.0);
+    sum_.y.assign(m_, 0.0);
+    sum_.ax.assign(m_, 0.0);
+    sum_.aty.assign(n_, 0.0);
+    sum_weight_ = 0.0;
+  };
+  reset_sums();
+
+  // the primal weight starts at the ratio of the scaled cost and bound
+  // norms; the step size at the inverse of the largest entry
+  double cost_norm = 0.0;
+  double bound_norm = 0.0;
+  for (std::size_t j = 0; j < n_; j++) {
+    cost_norm += cost_[j] * cost_[j];
+  }
+  for (std::size_t i = 0; i < m_; i++) {
+    double bound = 0.0;
+    if (!std::isinf(row_lower_[i])) {
+      bound = std::abs(row_lower_[i]);
+    }
+    if (!std::isinf(row_upper_[i])) {
+      bound = std::max(bound, std::abs(row_upper_[i]));
+    }
+    bound_norm += bound * bound;
+  }
+  const auto initial_weight = cost_norm > 1e-20 && bound_norm > 1e-20
+                                  ? std::sqrt(cost_norm / bound_norm)
+                                  : 1.0;
+  primal_weight_ = initial_weight;
+  double largest = 0.0;
+  for (const auto value : column_values_) {
+    largest = std::max(largest, std::abs(value));
+  }
+  step_size_ = largest > 0.0 ? 1.0 / largest : 1.0;
+
+  double restart_error = kkt_error(measure(current_));
+  double last_candidate_error = LPINT_INFINITY;
+  std::size_t since_restart = 0;
+
+  const auto finish = [&](const Status status) {
+    const auto current_error = relative_error(measure(current_));
+    achieved_tolerance_ = current_error;
+    store_solution(current_);
+    if (sum_weight_ > 0.0) {
+      const auto average_error = relative_error(measure(average_));
+      if (average_error < current_error) {
+        achieved_tolerance_ = average_error;
+        store_solution(average_);
+      }
+    }
+    return status;
+  };
+
+  while (true) {
+    if (iterations_ % evaluation_frequency == 0) {
+      if (sum_weight_ > 0.0) {
+        const auto scale = 1.0 / sum_weight_;
+        const auto average = [&](const std::vector<double>& sum,
+                                 std::vector<double>& result) {
+          for (std::size_t k = 0; k < sum.size(); k++) {
+            result[k] = scale * sum[k];
+          }
+        };
+        average(sum_.x, average_.x);
+        average(sum_.y, average_.y);
+        average(sum_.ax, average_.ax);
+        average(sum_.aty, average_.aty);
+      }
+      const auto current_measures = measure(current_);
+      const auto average_measures = measure(average_);
+      const auto use_average = sum_weight_ > 0.0 &&
+                               relative_error(average_measures) <
+                                   relative_error(current_measures);
+      const auto best_error =
+          use_average ? relative_error(average_measures)
+                      : relative_error(current_measures);
+      if (best_error <= tolerance) {
+        achieved_tolerance_ = best_error;
+        store_solution(use_average ? average_ : current_);
+        return Status::Optimal;
+      }
+      if (primal_infeasible(restart_, current_) ||
+          (since_restart > 0 && primal_infeasible(next_, current_))) {
+        return finish(Status::Infeasible);
+      }
+      if (dual_infeasible(restart_, current_) ||
+          (since_restart > 0 && dual_infeasible(next_, current_))) {
+        // a primal ray only proves unboundedness of a feasible problem
+        const auto feasible = current_measures.primal_residual <=
+                              tolerance * (1.0 + bound_norm_);
+        return finish(feasible ? Status::Unbounded
+                               : Status::InfeasibleOrUnbounded);
+      }
+
+      // restart from whichever of the current and average iterate has
+      // the smaller KKT error, if it decreased enough
+      const auto current_kkt = kkt_error(current_measures);
+      const auto average_kkt = sum_weight_ > 0.0
+                                   ? kkt_error(average_measures)
+                                   : LPINT_INFINITY;
+      const auto candidate_error = std::min(current_kkt, average_kkt);
+      const auto restart =
+          candidate_error <= sufficient_decrease * restart_error ||
+          (candidate_error <= necessary_decrease * restart_error &&
+           candidate_error > last_candidate_error) ||
+          static_cast<double>(since_restart) >=
+              artificial_restart * static_cast<double>(iterations_);
+      last_candidate_error = candidate_error;
+      if (restart) {
+        if (average_kkt < current_kkt) {
+          current_ = average_;
+        }
+        // balance the primal and dual distances moved since the last
+        // restart
+        const auto primal_distance = distance(current_.x, restart_.x);
+        const auto dual_distance = distance(current_.y, restart_.y);
+        if (primal_distance > 1e-10 && dual_distance > 1e-10) {
+          primal_weight_ = std::exp(0.5 * std::log(dual_distance /
+                                                   primal_distance) +
+                                    0.5 * std::log(primal_weight_));
+          primal_weight_ = clamp(primal_weight_,
+                                 initial_weight / weight_range,
+                                 initial_weight * weight_range);
+        }
+        restart_ = current_;
+        restart_error = kkt_error(measure(current_));
+        last_candidate_error = LPINT_INFINITY;
+        since_restart = 0;
+        reset_sums();
+      }
+    }
+
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (elapsed.count() >= time_limit) {
+      return finish(Status::TimeOut);
+    }
+    if (iterations_ >= iteration_limit) {
+      return finish(Status::IterationLimit);
+    }
+
+    step(threads);
+    iterations_++;
+    since_restart++;
+  }
+}
+
+}  // namespace detail
+
+}  // namespace lpint
@@ -0,0 +1,395 @@
+#include "lpinterface/native/sparse_cholesky.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <queue>
+#include <utility>
+
+#include "lpinterface/detail/parallel.hpp"
+
+namespace lpint {
+
+namespace detail {
+
+namespace {
+
+constexpr std::size_t none = static_cast<std::size_t>(-1);
+// supernodes with at least this many rows are factored with all threads
+constexpr std::size_t large_front = 128;
+// pivots below this fraction of the largest diagonal entry are replaced
+constexpr double relative_pivot_tolerance = 1e-14;
+// value replacing tiny pivots
+constexpr double huge_pivot = 1e128;
+
+// minimum degree ordering on the explicit elimination graph
+std::vector<std::size_t> minimum_degree(
+    const std::size_t size,
+    const std::vector<std::vector<std::size_t>>& adjacency) {
+  std::vector<std::vector<std::size_t>> graph(size);
+  for (std::size_t v = 0; v < size; v++) {
+    for (const auto u : adjacency[v]) {
+      if (u != v) {
+        graph[v].push_back(u);
+      }
+    }
+    std::sort(graph[v].begin(), graph[v].end());
+    graph[v].erase(std::unique(graph[v].begin(), graph[v].end()),
+                   graph[v].end());
+  }
+
+  using Entry = std::pair<std::size_t, std::size_t>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+  for (std::size_t v = 0; v < size; v++) {
+    queue.emplace(graph[v].size(), v);
+  }
+  std::vector<bool> eliminated(size, false);
+  std::vector<std::size_t> order;
+  order.reserve(size);
+  std::vector<std::size_t> merged;
+  while (!queue.empty()) {
+    const auto top = queue.top();
+    queue.pop();
+    const auto v = top.second;
+    // skip entries made stale by later degree changes
+    if (eliminated[v] || top.first != graph[v].size()) {
+      continue;
+    }
+    eliminated[v] = true;
+    order.push_back(v);
+
+    // eliminating v makes its neighbours a clique
+    const auto neighbours = std::move(graph[v]);
+    graph[v].clear();
+    for (const auto u : neighbours) {
+      const auto& current = graph[u];
+      merged.clear();
+      auto a = current.begin();
+      auto b = neighbours.begin();
+      while (a != current.end() || b != neighbours.end()) {
+        std::size_t next;
+        if (b == neighbours.end() || (a != current.end() && *a < *b)) {
+          next = *a++;
+        } else if (a == current.end() || *b < *a) {
+          next = *b++;
+        } else {
+          next = *a++;
+          ++b;
+        }
+        if (next != u && next != v) {
+          merged.push_back(next);
+        }
+      }
+      graph[u].swap(merged);
+      queue.emplace(graph[u].size(), u);
+    }
+  }
+  return order;
+}
+
+}  // namespace
+
+void SparseCholesky::analyze(
+    const std::size_t size,
+    const std::vector<std::vector<std::size_t>>& adjacency) {
+  size_ = size;
+  order_ = minimum_degree(size, adjacency);
+  position_.assign(size, 0);
+  for (std::size_t k = 0; k < size; k++) {
+    position_[order_[k]] = k;
+  }
+
+  // lower triangle of the reordered matrix
+  matrix_starts_.assign(1, 0);
+  matrix_rows_.clear();
+  std::vector<std::size_t> column;
+  for (std::size_t k = 0; k < size; k++) {
+    column.clear();
+    for (const auto u : adjacency[order_[k]]) {
+      if (position_[u] > k) {
+        column.push_back(position_[u]);
+      }
+    }
+    std::sort(column.begin(), column.end());
+    column.erase(std::unique(column.begin(), column.end()), column.end());
+    matrix_rows_.push_back(k);
+    matrix_rows_.insert(matrix_rows_.end(), column.begin(), column.end());
+    matrix_starts_.push_back(matrix_rows_.size());
+  }
+
+  // structure of every column of L below the diagonal, which is that of
+  // the matrix merged with those of its children in the elimination tree
+  std::vector<std::vector<std::size_t>> structure(size);
+  std::vector<std::size_t> parent(size, none);
+  std::vector<std::size_t> num_children(size, 0);
+  std::vector<std::vector<std::size_t>> children(size);
+  std::vector<std::size_t> merged;
+  for (std::size_t k = 0; k < size; k++) {
+    auto& current = structure[k];
+    current.assign(matrix_rows_.begin() +
+                       static_cast<std::ptrdiff_t>(matrix_starts_[k] + 1),
+                   matrix_rows_.begin() +
+                       static_cast<std::ptrdiff_t>(matrix_starts_[k + 1]));
+    for (const auto c : children[k]) {
+      merged.clear();
+      std::set_union(current.begin(), current.end(),
+                     structure[c].begin() + 1, structure[c].end(),
+                     std::back_inserter(merged));
+      current.swap(merged);
+    }
+    if (!current.empty()) {
+      parent[k] = current.front();
+      children[parent[k]].push_back(k);
+    }
+  }
+
+  // fundamental supernodes: chains of columns in which every column is the
+  // only child of the next and has the same structure below it
+  supernodes_.clear();
+  std::vector<std::size_t> supernode_of(size);
+  for (std::size_t k = 0; k < size; k++) {
+    if (k > 0 && parent[k - 1] == k && children[k].size() == 1 &&
+        structure[k].size() + 1 == structure[k - 1].size()) {
+      supernodes_.back().width++;
+    } else {
+      Supernode node;
+      node.first_column = k;
+      node.width = 1;
+      node.rows.push_back(k);
+      node.rows.insert(node.rows.end(), structure[k].begin(),
+                       structure[k].end());
+      node.parent = none;
+      supernodes_.push_back(std::move(node));
+    }
+    supernode_of[k] = supernodes_.size() - 1;
+  }
+  factor_nonzeros_ = 0;
+  large_.assign(supernodes_.size(), false);
+  for (std::size_t s = 0; s < supernodes_.size(); s++) {
+    auto& node = supernodes_[s];
+    const auto last = node.first_column + node.width - 1;
+    if (parent[last] != none) {
+      node.parent = supernode_of[parent[last]];
+      supernodes_[node.parent].children.push_back(s);
+    }
+    factor_nonzeros_ +=
+        node.rows.size() * node.width - node.width * (node.width - 1) / 2;
+    // the ancestors of a large supernode are large as well, so that the
+    // large ones can be factored after all others
+    if (node.rows.size() >= large_front || large_[s]) {
+      large_[s] = true;
+      if (node.parent != none) {
+        large_[node.parent] = true;
+      }
+    }
+  }
+  factor_.assign(supernodes_.size(), {});
+  updates_.assign(supernodes_.size(), {});
+}
+
+std::size_t SparseCholesky::factorize_supernode(
+    const std::size_t s, const std::vector<double>& values,
+    std::vector<std::size_t>& local, const std::size_t nthreads) {
+  const auto& node = supernodes_[s];
+  const auto& rows = node.rows;
+  const auto r = rows.size();
+  const auto w = node.width;
+  const auto f = node.first_column;
+
+  // dense frontal matrix, column-major, of which the lower triangle is used
+  std::vector<double> front(r * r, 0.0);
+  for (std::size_t k = 0; k < r; k++) {
+    local[rows[k]] = k;
+  }
+  for (std::size_t c = 0; c < w; c++) {
+    for (auto e = matrix_starts_[f + c]; e < matrix_starts_[f + c + 1];
+         e++) {
+      front[local[matrix_rows_[e]] + c * r] += values[e];
+    }
+  }
+  for (const auto child : node.children) {
+    const auto& child_rows = supernodes_[child].rows;
+    const auto child_width = supernodes_[child].width;
+    const auto u = child_rows.size() - child_width;
+    auto& update = updates_[child];
+    for (std::size_t a = 0; a < u; a++) {
+      const auto column = local[child_rows[child_width + a]] * r;
+      for (std::size_t b = a; b < u; b++) {
+        front[local[child_rows[child_width + b]] + column] +=
+            update[b + a * u];
+      }
+    }
+    std::vector<double>().swap(update);
+  }
+
+  // factor the columns of the supernode
+  std::size_t replaced = 0;
+  for (std::size_t k = 0; k < w; k++) {
+    auto& pivot = front[k + k * r];
+    if (!(pivot > pivot_tolerance_)) {
+      pivot = huge_pivot;
+      replaced++;
+    }
+    pivot = std::sqrt(pivot);
+    for (auto i = k + 1; i < r; i++) {
+      front[i + k * r] /= pivot;
+    }
+    for (auto c = k + 1; c < w; c++) {
+      const auto factor = front[c + k * r];
+      if (factor == 0.0) {
+        continue;
+      }
+      for (auto i = c; i < r; i++) {
+        front[i + c * r] -= front[i + k * r] * factor;
+      }
+    }
+  }
+  factor_[s].assign(front.begin(),
+                    front.begin() + static_cast<std::ptrdiff_t>(w * r));
+
+  // Schur complement of the remaining rows, by independent columns
+  const auto u = r - w;
+  if (u == 0) {
+    return replaced;
+  }
+  const auto update_column = [&](const std::size_t c) {
+    auto target = front.begin() + static_cast<std::ptrdiff_t>(c * r);
+    for (std::size_t k = 0; k < w; k++) {
+      const auto factor = front[c + k * r];
+      if (factor == 0.0) {
+        continue;
+      }
+      const auto source = front.begin() + static_cast<std::ptrdiff_t>(k * r);
+      for (auto i = c; i < r; i++) {
+        target[static_cast<std::ptrdiff_t>(i)] -=
+            source[static_cast<std::ptrdiff_t>(i)] * factor;
+      }
+    }
+  };
+  const auto nworkers = std::max<std::size_t>(1, std::min(nthreads, u));
+  run_parallel(nworkers, [&](const std::size_t t) {
+    // interleaved, since the columns get shorter to the right
+    for (auto c = w + t; c < r; c += nworkers) {
+      update_column(c);
+    }
+  });
+  auto& update = updates_[s];
+  update.assign(u * u, 0.0);
+  for (std::size_t a = 0; a < u; a++) {
+    for (std::size_t b = a; b < u; b++) {
+      update[b + a * u] = front[(w + b) + (w + a) * r];
+    }
+  }
+  return replaced;
+}
+
+std::size_t SparseCholesky::factorize(const std::vector<double>& values,
+                                      const std::size_t nthreads) {
+  double largest = 0.0;
+  for (std::size_t k = 0; k < size_; k++) {
+    largest = std::max(largest, std::abs(values[matrix_starts_[k]]));
+  }
+  pivot_tolerance_ = relative_pivot_tolerance * std::max(largest, 1.0);
+
+  const auto num_supernodes = supernodes_.size();
+  std::size_t replaced = 0;
+  if (nthreads <= 1) {
+    std::vector<std::size_t> local(size_);
+    for (std::size_t s = 0; s < num_supernodes; s++) {
+      replaced += factorize_supernode(s, values, local, 1);
+    }
+    return replaced;
+  }
+
+  // small supernodes as tasks, each ready once its children are done
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::vector<std::size_t> ready;
+  std::vector<std::size_t> pending(num_supernodes, 0);
+  std::size_t remaining = 0;
+  for (std::size_t s = 0; s < num_supernodes; s++) {
+    if (large_[s]) {
+      continue;
+    }
+    remaining++;
+    pending[s] = supernodes_[s].children.size();
+    if (pending[s] == 0) {
+      ready.push_back(s);
+    }
+  }
+  run_parallel(nthreads, [&](const std::size_t) {
+    std::vector<std::size_t> local(size_);
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      changed.wait(lock, [&]() { return !ready.empty() || remaining == 0; });
+      if (ready.empty()) {
+        return;
+      }
+      const auto s = ready.back();
+      ready.pop_back();
+      lock.unlock();
+      const auto count = factorize_supernode(s, values, local, 1);
+      lock.lock();
+      replaced += count;
+      remaining--;
+      const auto parent = supernodes_[s].parent;
+      if (parent != none && !large_[parent] && --pending[parent] == 0) {
+        ready.push_back(parent);
+      }
+      changed.notify_all();
+    }
+  });
+
+  // large supernodes in order, each with all threads
+  std::vector<std::size_t> local(size_);
+  for (std::size_t s = 0; s < num_supernodes; s++) {
+    if (large_[s]) {
+      replaced += factorize_supernode(s, values, local, nthreads);
+    }
+  }
+  return replaced;
+}
+
+void SparseCholesky::solve(std::vector<double>& rhs) const {
+  std::vector<double> x(size_);
+  for (std::size_t v = 0; v < size_; v++) {
+    x[position_[v]] = rhs[v];
+  }
+  for (std::size_t s = 0; s < supernodes_.size(); s++) {
+    const auto& node = supernodes_[s];
+    const auto& factor = factor_[s];
+    const auto r = node.rows.size();
+    for (std::size_t k = 0; k < node.width; k++) {
+      const auto value = x[node.first_column + k] / factor[k + k * r];
+      x[node.first_column + k] = value;
+      if (value == 0.0) {
+        continue;
+      }
+      for (auto i = k + 1; i < r; i++) {
+        x[node.rows[i]] -= factor[i + k * r] * value;
+      }
+    }
+  }
+  for (auto s = supernodes_.size(); s-- > 0;) {
+    const auto& node = supernodes_[s];
+    const auto& factor = factor_[s];
+    const auto r = node.rows.size();
+    for (auto k = node.width; k-- > 0;) {
+      auto value = x[node.first_column + k];
+      for (auto i = k + 1; i < r; i++) {
+        value -= factor[i + k * r] * x[node.rows[i]];
+      }
+      x[node.first_column + k] = value / factor[k + k * r];
+    }
+  }
+  for (std::size_t v = 0; v < size_; v++) {
+    rhs[v] = x[position_[v]];
+  }
+}
+
+}  // namespace detail
+
+}  // namespace lpint
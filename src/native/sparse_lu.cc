@@ -0,0 +1,361 @@
+#include "lpinterface/native/sparse_lu.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace lpint {
+
+namespace detail {
+
+namespace {
+
+// relative threshold on the pivot within its column, trading sparsity
+// for stability
+constexpr double pivot_threshold = 0.1;
+// entries below this magnitude are never chosen as pivots
+constexpr double pivot_tolerance = 1e-11;
+// number of sparsest columns searched for a pivot
+constexpr std::size_t search_columns = 4;
+// end of a column list, and count of a column that is in no list
+constexpr std::size_t none = static_cast<std::size_t>(-1);
+
+std::size_t find_entry(const SparseLU::SparseColumn& row,
+                       const std::size_t column) {
+  std::size_t k = 0;
+  while (row[k].first != column) {
+    k++;
+  }
+  return k;
+}
+
+void erase_value(std::vector<std::size_t>& values, const std::size_t value) {
+  const auto it = std::find(values.begin(), values.end(), value);
+  if (it != values.end()) {
+    *it = values.back();
+    values.pop_back();
+  }
+}
+
+// Columns of the active submatrix in doubly linked lists by their number
+// of entries, so that the sparsest columns are found without scanning
+// all columns at every pivot.
+class ColumnBuckets {
+ public:
+  explicit ColumnBuckets(const std::size_t size)
+      : head_(size + 1, none),
+        next_(size, none),
+        prev_(size, none),
+        count_(size, none) {}
+
+  // put column c in the list of the given count, or take it out of all
+  // lists if count is none
+  void move(const std::size_t c, const std::size_t count) {
+    if (count == count_[c]) {
+      return;
+    }
+    if (count_[c] != none) {
+      unlink(c);
+    }
+    count_[c] = count;
+    if (count == none) {
+      return;
+    }
+    next_[c] = head_[count];
+    prev_[c] = none;
+    if (head_[count] != none) {
+      prev_[head_[count]] = c;
+    }
+    head_[count] = c;
+    lowest_ = std::min(lowest_, count);
+  }
+
+  // collect up to max_columns of the nonempty columns with the fewest
+  // entries, in order of increasing count
+  void sparsest(const std::size_t max_columns,
+                std::vector<std::size_t>& columns) {
+    columns.clear();
+    lowest_ = std::max<std::size_t>(lowest_, 1);
+    while (lowest_ < head_.size() && head_[lowest_] == none) {
+      lowest_++;
+    }
+    for (auto count = lowest_;
+         count < head_.size() && columns.size() < max_columns; count++) {
+      for (auto c = head_[count];
+           c != none && columns.size() < max_columns; c = next_[c]) {
+        columns.push_back(c);
+      }
+    }
+  }
+
+ private:
+  void unlink(const std::size_t c) {
+    if (prev_[c] != none) {
+      next_[prev_[c]] = next_[c];
+    } else {
+      head_[count_[c]] = next_[c];
+    }
+    if (next_[c] != none) {
+      prev_[next_[c]] = prev_[c];
+    }
+  }
+
+  std::vector<std::size_t> head_;
+  std::vector<std::size_t> next_;
+  std::vector<std::size_t> prev_;
+  std::vector<std::size_t> count_;
+  // no nonempty list has a count below this
+  std::size_t lowest_ = 0;
+};
+
+}  // namespace
+
+std::vector<std::pair<std::size_t, std::size_t>> SparseLU::factorize(
+    const std::size_t size, const std::vector<SparseColumn>& columns) {
+  size_ = size;
+  pivot_row_.clear();
+  pivot_column_.clear();
+  pivot_value_.clear();
+  lower_.clear();
+  lower_rows_.clear();
+  upper_rows_.clear();
+  upper_columns_.clear();
+  etas_.clear();
+
+  // the active submatrix, by row with values and by column with row
+  // indices only
+  std::vector<SparseColumn> rows(size);
+  std::vector<std::vector<std::size_t>> column_rows(size);
+  for (std::size_t c = 0; c < size; c++) {
+    for (const auto& entry : columns[c]) {
+      if (entry.second != 0.0) {
+        rows[entry.first].emplace_back(c, entry.second);
+        column_rows[c].push_back(entry.first);
+      }
+    }
+  }
+  std::vector<bool> row_done(size, false);
+  std::vector<bool> column_done(size, false);
+  std::vector<std::size_t> mark(size, 0);
+  // inserting in reverse keeps columns of equal count in index order
+  ColumnBuckets buckets(size);
+  for (std::size_t c = size; c-- > 0;) {
+    buckets.move(c, column_rows[c].size());
+  }
+  std::vector<std::size_t> candidates;
+
+  for (std::size_t step = 0; step < size; step++) {
+    // the sparsest nonempty columns, in order of increasing count
+    buckets.sparsest(search_columns, candidates);
+
+    bool found = false;
+    std::size_t pivot_r = 0;
+    std::size_t pivot_c = 0;
+    double pivot = 0.0;
+    std::size_t best_cost = 0;
+    for (const auto c : candidates) {
+      double largest = 0.0;
+      for (const auto r : column_rows[c]) {
+        largest = std::max(
+            largest, std::abs(rows[r][find_entry(rows[r], c)].second));
+      }
+      const auto threshold = std::max(pivot_threshold * largest,
+                                      pivot_tolerance);
+      for (const auto r : column_rows[c]) {
+        const auto value = rows[r][find_entry(rows[r], c)].second;
+        if (std::abs(value) < threshold) {
+          continue;
+        }
+        const auto cost = (rows[r].size() - 1) * (column_rows[c].size() - 1);
+        if (!found || cost < best_cost ||
+            (cost == best_cost && std::abs(value) > std::abs(pivot))) {
+          found = true;
+          pivot_r = r;
+          pivot_c = c;
+          pivot = value;
+          best_cost = cost;
+        }
+      }
+      if (found && best_cost == 0) {
+        break;
+      }
+    }
+    if (!found) {
+      break;
+    }
+
+    // eliminate the pivot column from the other active rows
+    const auto& pivot_entries = rows[pivot_r];
+    SparseColumn multipliers;
+    for (const auto i : column_rows[pivot_c]) {
+      if (i == pivot_r) {
+        continue;
+      }
+      auto& row = rows[i];
+      const auto position = find_entry(row, pivot_c);
+      const auto multiplier = row[position].second / pivot;
+      multipliers.emplace_back(i, multiplier);
+      row[position] = row.back();
+      row.pop_back();
+      for (std::size_t k = 0; k < row.size(); k++) {
+        mark[row[k].first] = k + 1;
+      }
+      const auto original_size = row.size();
+      for (const auto& entry : pivot_entries) {
+        if (entry.first == pivot_c) {
+          continue;
+        }
+        if (mark[entry.first] != 0) {
+          row[mark[entry.first] - 1].second -= multiplier * entry.second;
+        } else {
+          row.emplace_back(entry.first, -multiplier * entry.second);
+          column_rows[entry.first].push_back(i);
+        }
+      }
+      for (std::size_t k = 0; k < original_size; k++) {
+        mark[row[k].first] = 0;
+      }
+    }
+
+    // only the columns of the pivot row gained or lost entries
+    SparseColumn upper;
+    for (const auto& entry : pivot_entries) {
+      if (entry.first != pivot_c) {
+        upper.push_back(entry);
+        erase_value(column_rows[entry.first], pivot_r);
+        buckets.move(entry.first, column_rows[entry.first].size());
+      }
+    }
+    buckets.move(pivot_c, none);
+    column_rows[pivot_c].clear();
+    rows[pivot_r].clear();
+    row_done[pivot_r] = true;
+    column_done[pivot_c] = true;
+
+    pivot_row_.push_back(pivot_r);
+    pivot_column_.push_back(pivot_c);
+    pivot_value_.push_back(pivot);
+    lower_.push_back(std::move(multipliers));
+    upper_rows_.push_back(std::move(upper));
+  }
+
+  std::vector<std::pair<std::size_t, std::size_t>> singular;
+  if (pivot_row_.size() < size) {
+    std::size_t r = 0;
+    for (std::size_t c = 0; c < size; c++) {
+      if (column_done[c]) {
+        continue;
+      }
+      while (row_done[r]) {
+        r++;
+      }
+      singular.emplace_back(c, r++);
+    }
+    return singular;
+  }
+
+  std::vector<std::size_t> step_of_column(size);
+  std::vector<std::size_t> step_of_row(size);
+  for (std::size_t k = 0; k < size; k++) {
+    step_of_column[pivot_column_[k]] = k;
+    step_of_row[pivot_row_[k]] = k;
+  }
+  upper_columns_.resize(size);
+  lower_rows_.resize(size);
+  for (std::size_t k = 0; k < size; k++) {
+    for (const auto& entry : upper_rows_[k]) {
+      upper_columns_[step_of_column[entry.first]].emplace_back(pivot_row_[k],
+                                                               entry.second);
+    }
+    for (const auto& entry : lower_[k]) {
+      lower_rows_[step_of_row[entry.first]].emplace_back(pivot_row_[k],
+                                                         entry.second);
+    }
+  }
+  return singular;
+}
+
+void SparseLU::ftran(std::vector<double>& rhs) const {
+  const auto nsteps = pivot_row_.size();
+  for (std::size_t k = 0; k < nsteps; k++) {
+    const auto value = rhs[pivot_row_[k]];
+    if (value == 0.0) {
+      continue;
+    }
+    for (const auto& entry : lower_[k]) {
+      rhs[entry.first] -= entry.second * value;
+    }
+  }
+  work_.assign(size_, 0.0);
+  for (std::size_t k = nsteps; k-- > 0;) {
+    const auto value = rhs[pivot_row_[k]] / pivot_value_[k];
+    work_[pivot_column_[k]] = value;
+    if (value == 0.0) {
+      continue;
+    }
+    for (const auto& entry : upper_columns_[k]) {
+      rhs[entry.first] -= entry.second * value;
+    }
+  }
+  for (const auto& eta : etas_) {
+    const auto value = work_[eta.position] / eta.pivot;
+    work_[eta.position] = value;
+    if (value == 0.0) {
+      continue;
+    }
+    for (const auto& entry : eta.column) {
+      work_[entry.first] -= entry.second * value;
+    }
+  }
+  rhs.swap(work_);
+}
+
+void SparseLU::btran(std::vector<double>& rhs) const {
+  for (auto it = etas_.rbegin(); it != etas_.rend(); ++it) {
+    double value = rhs[it->position];
+    for (const auto& entry : it->column) {
+      value -= entry.second * rhs[entry.first];
+    }
+    rhs[it->position] = value / it->pivot;
+  }
+  const auto nsteps = pivot_row_.size();
+  work_.assign(size_, 0.0);
+  for (std::size_t k = 0; k < nsteps; k++) {
+    const auto value = rhs[pivot_column_[k]] / pivot_value_[k];
+    work_[pivot_row_[k]] = value;
+    if (value == 0.0) {
+      continue;
+    }
+    for (const auto& entry : upper_rows_[k]) {
+      rhs[entry.first] -= entry.second * value;
+    }
+  }
+  // every row is final once the later steps are done, and is then
+  // subtracted from the pivot rows of the steps that eliminated it
+  for (std::size_t k = nsteps; k-- > 0;) {
+    const auto value = work_[pivot_row_[k]];
+    if (value == 0.0) {
+      continue;
+    }
+    for (const auto& entry : lower_rows_[k]) {
+      work_[entry.first] -= entry.second * value;
+    }
+  }
+  rhs.swap(work_);
+}
+
+void SparseLU::update(const std::size_t position,
+                      const std::vector<double>& alpha) {
+  Eta eta;
+  eta.position = position;
+  eta.pivot = alpha[position];
+  for (std::size_t i = 0; i < alpha.size(); i++) {
+    if (i != position && alpha[i] != 0.0) {
+      eta.column.emplace_back(i, alpha[i]);
+    }
+  }
+  etas_.push_back(std::move(eta));
+}
+
+}  // namespace detail
+
+}  // namespace lpint
@@ -6,40 +6,68 @@ namespace lpint {
 using namespace soplex;
 
 Variable LinearProgramHandleSoplex::variable(std::size_t i) const {
-  return Variable(soplex_->lowerReal(inverse_permutation_vars_[i]), 
-                  soplex_->upperReal(inverse_permutation_vars_[i]));
+  const auto col = internal_column(i);
+  return Variable(soplex_->lowerReal(col), soplex_->upperReal(col));
 }
 
 std::vector<Variable> LinearProgramHandleSoplex::variables() const {
-  std::vector<Variable> vars;
-  for (std::size_t i = 0; i < num_vars(); i++) {
-    vars.emplace_back(variable(i));
+  return variable_block().variables();
+}
+
+VariableBlock LinearProgramHandleSoplex::variable_block() const {
+  // soplex may store bounds scaled, so they are read back through the
+  // unscaling accessors
+  const auto nvars = num_vars();
+  std::vector<double> lower(nvars);
+  std::vector<double> upper(nvars);
+  for (std::size_t i = 0; i < nvars; i++) {
+    lower[i] = soplex_->lowerReal(internal_column(i));
+    upper[i] = soplex_->upperReal(internal_column(i));
   }
-  //for (const auto i : inverse_permutation_vars_) {
-  //  vars.emplace_back(soplex_->lowerReal(i), soplex_->upperReal(i));
-  //}
-  return vars;
+  return VariableBlock(std::move(lower), std::move(upper));
 }
 
-void LinearProgramHandleSoplex::add_variables(
+VariableIdRange LinearProgramHandleSoplex::add_variables(
     const std::vector<Variable>& vars) {
+  return add_variables(VariableBlock(vars));
+}
+
+VariableIdRange LinearProgramHandleSoplex::add_variables(
+    const VariableBlock& vars) {
+  if (vars.empty()) {
+    return variable_ids_.add(0);
+  }
+  if (transaction_.active()) {
+    transaction_.record_add_variables(num_vars());
+  }
+  const auto nvars = detail::checked_narrow<int>(vars.size());
+  LPColSet cols(nvars, 0);
   DSVector dummy(0);
-  for (const auto& var : vars) {
-    soplex_->addColReal(LPCol(0, dummy, var.upper(), var.lower()));
+  for (std::size_t i = 0; i < vars.size(); i++) {
+    cols.add(0.0, vars.lower()[i], dummy, vars.upper()[i]);
     permutation_vars_.push_back(permutation_vars_.size());
     inverse_permutation_vars_.push_back(inverse_permutation_vars_.size());
   }
+  soplex_->addColsReal(cols);
+  cache_.invalidate_variables();
+  cache_.invalidate_objective();
+  return variable_ids_.add(vars.size());
 }
 
-void LinearProgramHandleSoplex::add_variables(const std::size_t nvars) {
-  add_variables(std::vector<Variable>(nvars));
+VariableIdRange LinearProgramHandleSoplex::add_variables(
+    const std::size_t nvars) {
+  return add_variables(VariableBlock(nvars));
 }
 
-void LinearProgramHandleSoplex::add_constraints(
+ConstraintIdRange LinearProgramHandleSoplex::add_constraints(
     const std::vector<Constraint<double>>& constraints) {
+  if (transaction_.active()) {
+    transaction_.record_add_constraints(num_constraints());
+  }
   for (auto& constraint : constraints) {
-    DSVector ds_row(constraint.row.num_nonzero());
-    ds_row.add(constraint.row.num_nonzero(),
+    const auto nnz = detail::checked_narrow<int>(constraint.row.num_nonzero());
+    DSVector ds_row(nnz);
+    ds_row.add(nnz,
                constraint.row.nonzero_indices().data(),
                constraint.row.values().data());
     soplex_->addRowReal(
@@ -50,19 +78,68 @@ void LinearProgramHandleSoplex::add_constraints(
     permutation_.push_back(permutation_.size());
     inverse_permutation_.push_back(inverse_permutation_.size());
   }
+  cache_.append_constraints(constraints);
+  return constraint_ids_.add(constraints.size());
+}
+
+ConstraintIdRange LinearProgramHandleSoplex::add_constraints(
+    const ConstraintBatch<double>& batch) {
+  if (batch.empty()) {
+    return constraint_ids_.add(0);
+  }
+  if (transaction_.active()) {
+    transaction_.record_add_constraints(num_constraints());
+  }
+  const auto nrows = batch.num_rows();
+  // soplex sizes are int, so batches beyond 2^31 rows or nonzeros
+  // cannot be loaded
+  LPRowSet rows(detail::checked_narrow<int>(nrows),
+                detail::checked_narrow<int>(batch.num_nonzero()));
+  // a single row vector is reused for all rows, so building the row set
+  // does not allocate per row
+  DSVector ds_row;
+  const auto& starts = batch.row_starts();
+  for (std::size_t i = 0; i < nrows; i++) {
+    const auto start = starts[i];
+    ds_row.clear();
+    ds_row.add(static_cast<int>(batch.row_size(i)),
+               batch.indices().data() + start, batch.values().data() + start);
+    rows.add(batch.lower_bounds()[i], ds_row, batch.upper_bounds()[i]);
+    permutation_.push_back(permutation_.size());
+    inverse_permutation_.push_back(inverse_permutation_.size());
+  }
+  soplex_->addRowsReal(rows);
+  cache_.append_constraints(batch);
+  return constraint_ids_.add(nrows);
 }
 
 void LinearProgramHandleSoplex::remove_variable(const std::size_t i) {
-  soplex_->removeColReal(inverse_permutation_vars_[i]);
+  if (transaction_.active()) {
+    transaction_.record_remove_variable(
+        i, variable(i), column(i), soplex_->objReal(internal_column(i)),
+        variable_ids_.id(i));
+  }
+  soplex_->removeColReal(internal_column(i));
+  objective_support_.remove_index(i);
   std::swap(permutation_vars_[inverse_permutation_vars_[i]],
             permutation_vars_.back());
   permutation_vars_.pop_back();
-  permutation_vars_ = detail::rankify(permutation_vars_);
+  detail::remove_rank(permutation_vars_, i);
   inverse_permutation_vars_ = detail::inverse_permutation(permutation_vars_);
+  variable_ids_.erase(i);
+  // removing a column shifts the indices of all later columns, so every
+  // cached entity is stale
+  cache_.invalidate_constraints();
+  cache_.invalidate_objective();
+  cache_.invalidate_variables();
 }
 
 void LinearProgramHandleSoplex::remove_constraint(const std::size_t i) {
-  soplex_->removeRowReal(inverse_permutation_[i]);
+  if (transaction_.active()) {
+    transaction_.record_remove_constraint(i, constraint(i),
+                                          constraint_ids_.id(i));
+  }
+  soplex_->removeRowReal(detail::checked_narrow<int>(inverse_permutation_[i]));
   // calculate the new permutation and inverse permutation. Soplex removed
   // constraints by swapping them with then end of the constraint list
   // and shrinking the list.
@@ -71,23 +148,248 @@ void LinearProgramHandleSoplex::remove_constraint(const std::size_t i) {
   // shrink the permutation list
   permutation_.pop_back();
   // make sure all permutation indices are in the range [0, num_constraints]
-  permutation_ = detail::rankify(permutation_);
+  detail::remove_rank(permutation_, i);
   // compute the inverse of the updated permutation
   inverse_permutation_ = detail::inverse_permutation(permutation_);
+  constraint_ids_.erase(i);
+  cache_.erase_constraint(i);
+}
+
+void LinearProgramHandleSoplex::set_variable_bounds(const std::size_t i,
+                                                    const double lower,
+                                                    const double upper) {
+  if (lower > upper) {
+    throw InvalidVariableBoundsException();
+  }
+  const auto col = internal_column(i);
+  if (transaction_.active()) {
+    transaction_.record_variable_bounds(i, soplex_->lowerReal(col),
+                                        soplex_->upperReal(col));
+  }
+  soplex_->changeBoundsReal(col, lower, upper);
+  cache_.invalidate_variables();
+}
+
+void LinearProgramHandleSoplex::set_constraint_bounds(const std::size_t i,
+                                                      const double lower,
+                                                      const double upper) {
+  const auto row = detail::checked_narrow<int>(inverse_permutation_[i]);
+  if (transaction_.active()) {
+    transaction_.record_constraint_bounds(i, soplex_->lhsReal(row),
+                                          soplex_->rhsReal(row));
+  }
+  soplex_->changeRangeReal(row, lower, upper);
+  cache_.invalidate_constraints();
+}
+
+void LinearProgramHandleSoplex::begin_transaction(const bool restore_basis) {
+  transaction_.begin();
+  saved_row_basis_.clear();
+  saved_col_basis_.clear();
+  if (!restore_basis || !soplex_->hasBasis()) {
+    return;
+  }
+  // soplex stores the basis in its internal order, which rollback() does
+  // not necessarily restore, so the basis is saved in logical order
+  std::vector<SPxSolver::VarStatus> rows(num_constraints());
+  std::vector<SPxSolver::VarStatus> cols(num_vars());
+  soplex_->getBasis(rows.data(), cols.data());
+  saved_row_basis_.resize(rows.size());
+  saved_col_basis_.resize(cols.size());
+  for (std::size_t i = 0; i < rows.size(); i++) {
+    saved_row_basis_[i] = rows[inverse_permutation_[i]];
+  }
+  for (std::size_t j = 0; j < cols.size(); j++) {
+    saved_col_basis_[j] = cols[inverse_permutation_vars_[j]];
+  }
+}
+
+void LinearProgramHandleSoplex::commit() {
+  transaction_.commit();
+  saved_row_basis_.clear();
+  saved_col_basis_.clear();
+}
+
+void LinearProgramHandleSoplex::rollback() {
+  transaction_.rollback(*this);
+  if (saved_row_basis_.empty() && saved_col_basis_.empty()) {
+    return;
+  }
+  std::vector<SPxSolver::VarStatus> rows(saved_row_basis_.size());
+  std::vector<SPxSolver::VarStatus> cols(saved_col_basis_.size());
+  for (std::size_t i = 0; i < rows.size(); i++) {
+    rows[inverse_permutation_[i]] = saved_row_basis_[i];
+  }
+  for (std::size_t j = 0; j < cols.size(); j++) {
+    cols[inverse_permutation_vars_[j]] = saved_col_basis_[j];
+  }
+  soplex_->setBasis(rows.data(), cols.data());
+  saved_row_basis_.clear();
+  saved_col_basis_.clear();
+}
+
+bool LinearProgramHandleSoplex::in_transaction() const {
+  return transaction_.active();
+}
+
+void LinearProgramHandleSoplex::truncate_constraints(const std::size_t n) {
+  const auto nrows = num_constraints();
+  if (n >= nrows) {
+    return;
+  }
+  // mark the rows to remove by their internal index; soplex removes them
+  // all at once and returns the new internal index of every other row
+  // in the same array
+  std::vector<int> perm(nrows, 0);
+  for (auto i = n; i < nrows; i++) {
+    perm[inverse_permutation_[i]] = -1;
+  }
+  soplex_->removeRowsReal(perm.data());
+  inverse_permutation_.resize(n);
+  for (auto& row : inverse_permutation_) {
+    row = static_cast<std::size_t>(perm[row]);
+  }
+  permutation_ = detail::inverse_permutation(inverse_permutation_);
+  constraint_ids_.truncate(n);
+  cache_.invalidate_constraints();
+}
+
+void LinearProgramHandleSoplex::truncate_variables(const std::size_t n) {
+  const auto ncols = num_vars();
+  if (n >= ncols) {
+    return;
+  }
+  std::vector<int> perm(ncols, 0);
+  for (auto j = n; j < ncols; j++) {
+    perm[inverse_permutation_vars_[j]] = -1;
+  }
+  soplex_->removeColsReal(perm.data());
+  inverse_permutation_vars_.resize(n);
+  for (auto& col : inverse_permutation_vars_) {
+    col = static_cast<std::size_t>(perm[col]);
+  }
+  permutation_vars_ = detail::inverse_permutation(inverse_permutation_vars_);
+  objective_support_.truncate(n);
+  variable_ids_.truncate(n);
+  cache_.invalidate_constraints();
+  cache_.invalidate_objective();
+  cache_.invalidate_variables();
+}
+
+void LinearProgramHandleSoplex::insert_constraint(const std::size_t i,
+                                                  const Constraint<double>& c,
+                                                  const ConstraintId id) {
+  const auto nnz = detail::checked_narrow<int>(c.row.num_nonzero());
+  DSVector ds_row(nnz);
+  ds_row.add(nnz, c.row.nonzero_indices().data(), c.row.values().data());
+  soplex_->addRowReal(LPRow(c.lower_bound, ds_row, c.upper_bound));
+  // soplex appends the row, so only the permutation has to move it to i
+  detail::insert_rank(permutation_, i);
+  permutation_.push_back(i);
+  inverse_permutation_ = detail::inverse_permutation(permutation_);
+  constraint_ids_.insert(i, id);
+  cache_.invalidate_constraints();
+}
+
+void LinearProgramHandleSoplex::insert_variable(const std::size_t i,
+                                                const Variable& var,
+                                                const Column<double>& col,
+                                                const double objective,
+                                                const VariableId id) {
+  // the column refers to constraints by index, which have to be
+  // translated to soplex' internal row order
+  DSVector ds_col(detail::checked_narrow<int>(col.num_nonzero()));
+  for (std::size_t k = 0; k < col.num_nonzero(); k++) {
+    const auto row = static_cast<std::size_t>(col.nonzero_indices()[k]);
+    ds_col.add(detail::checked_narrow<int>(inverse_permutation_[row]),
+               col.values()[k]);
+  }
+  soplex_->addColReal(LPCol(objective, ds_col, var.upper(), var.lower()));
+  detail::insert_rank(permutation_vars_, i);
+  permutation_vars_.push_back(i);
+  inverse_permutation_vars_ = detail::inverse_permutation(permutation_vars_);
+  objective_support_.insert_index(i, objective != 0.0);
+  variable_ids_.insert(i, id);
+  cache_.invalidate_constraints();
+  cache_.invalidate_objective();
+  cache_.invalidate_variables();
+}
+
+void LinearProgramHandleSoplex::insert_constraints(
+    const std::vector<detail::TransactionLog::RemovedConstraint>& removed) {
+  for (const auto& entry : removed) {
+    insert_constraint(entry.position, *entry.constraint, entry.id);
+  }
+}
+
+void LinearProgramHandleSoplex::insert_variables(
+    const std::vector<detail::TransactionLog::RemovedVariable>& removed) {
+  for (const auto& entry : removed) {
+    insert_variable(entry.position, entry.variable, *entry.column,
+                    entry.objective, entry.id);
+  }
+}
+
+std::size_t LinearProgramHandleSoplex::position(const ConstraintId id) const {
+  return constraint_ids_.position(id);
+}
+
+std::size_t LinearProgramHandleSoplex::position(const VariableId id) const {
+  return variable_ids_.position(id);
+}
+
+ConstraintId LinearProgramHandleSoplex::constraint_id(
+    const std::size_t i) const {
+  return constraint_ids_.id(i);
+}
+
+VariableId LinearProgramHandleSoplex::variable_id(const std::size_t i) const {
+  return variable_ids_.id(i);
 }
 
 void LinearProgramHandleSoplex::set_objective(
     const Objective<double>& objective) {
-  if (num_vars() != objective.values.size()) {
+  const auto nvars = num_vars();
+  if (nvars != objective.values.size()) {
     throw MismatchedDimensionsException();
   }
-  VectorReal obj(static_cast<int>(objective.values.size()),
-                 const_cast<Objective<double>&>(objective).values.data());
+  if (transaction_.active()) {
+    transaction_.record_objective(sparse_objective());
+  }
+  // soplex moves columns around when removing them, so the objective
+  // has to be permuted into soplex' column order
+  DVector obj(detail::checked_narrow<int>(nvars));
+  for (std::size_t i = 0; i < nvars; i++) {
+    obj[internal_column(i)] = objective.values[i];
+  }
   soplex_->changeObjReal(obj);
+  objective_support_.assign_dense(objective.values);
+  cache_.invalidate_objective();
+}
+
+void LinearProgramHandleSoplex::set_objective(
+    const SparseObjective<double>& objective) {
+  detail::check_sparse_objective(objective, num_vars());
+  if (transaction_.active()) {
+    transaction_.record_objective(sparse_objective());
+  }
+  for (const auto i : objective_support_.assign_sparse(
+           objective.nonzero_indices())) {
+    soplex_->changeObjReal(internal_column(static_cast<std::size_t>(i)),
+                           0.0);
+  }
+  for (std::size_t k = 0; k < objective.num_nonzero(); k++) {
+    const auto i = static_cast<std::size_t>(objective.nonzero_indices()[k]);
+    soplex_->changeObjReal(internal_column(i), objective.values()[k]);
+  }
+  cache_.invalidate_objective();
 }
 
 void LinearProgramHandleSoplex::set_objective_sense(
     const OptimizationType objsense) {
+  if (transaction_.active()) {
+    transaction_.record_objective_sense(sense_);
+  }
   sense_ = objsense;
   if (!soplex_->setIntParam(SoPlex::OBJSENSE,
                             objsense == OptimizationType::Maximize
@@ -109,19 +411,52 @@ std::size_t LinearProgramHandleSoplex::num_constraints() const {
   return static_cast<std::size_t>(soplex_->numRowsReal());
 }
 
-Constraint<double> LinearProgramHandleSoplex::constraint(std::size_t ii) const {
-  auto i = inverse_permutation_[ii];
-  auto lb = soplex_->lhsReal(i);
-  auto ub = soplex_->rhsReal(i);
+Constraint<double> LinearProgramHandleSoplex::constraint(std::size_t i) const {
+  Constraint<double> constraint;
+  read_constraint(i, constraint);
+  return constraint;
+}
+
+void LinearProgramHandleSoplex::read_constraint(
+    std::size_t ii, Constraint<double>& buffer) const {
+  auto i = detail::checked_narrow<int>(inverse_permutation_[ii]);
+  buffer.lower_bound = soplex_->lhsReal(i);
+  buffer.upper_bound = soplex_->rhsReal(i);
 
-  Row<double> row;
-  const auto sv = soplex_->rowVectorRealInternal(i);
+  auto& values = buffer.row.values();
+  auto& indices = buffer.row.nonzero_indices();
+  values.clear();
+  indices.clear();
+  const auto& sv = soplex_->rowVectorRealInternal(i);
   for (std::size_t j = 0; j < static_cast<std::size_t>(sv.size()); j++) {
-    const auto element = sv.element(j);
-    row.nonzero_indices().push_back(element.idx);
-    row.values().push_back(element.val);
+    const auto element = sv.element(static_cast<int>(j));
+    indices.push_back(element.idx);
+    values.push_back(element.val);
   }
-  return Constraint<double>(std::move(row), lb, ub);
+}
+
+Column<double> LinearProgramHandleSoplex::column(std::size_t j) const {
+  // soplex keeps the constraint matrix column-wise as well, so columns
+  // are read directly; only the row indices have to be translated from
+  // soplex' internal order
+  Column<double> col;
+  const auto& sv = soplex_->colVectorRealInternal(internal_column(j));
+  for (std::size_t k = 0; k < static_cast<std::size_t>(sv.size()); k++) {
+    const auto element = sv.element(static_cast<int>(k));
+    col.nonzero_indices().push_back(detail::checked_narrow<int>(
+        permutation_[static_cast<std::size_t>(element.idx)]));
+    col.values().push_back(element.val);
+  }
+  return col;
+}
+
+std::vector<Column<double>> LinearProgramHandleSoplex::columns() const {
+  std::vector<Column<double>> cols;
+  cols.reserve(num_vars());
+  for (std::size_t j = 0; j < num_vars(); j++) {
+    cols.emplace_back(column(j));
+  }
+  return cols;
 }
 
 std::vector<Constraint<double>> LinearProgramHandleSoplex::constraints() const {
@@ -151,9 +486,40 @@ Objective<double> LinearProgramHandleSoplex::objective() const {
   const auto nvars = num_vars();
   std::vector<double> values;
   for (std::size_t i = 0; i < nvars; i++) {
-    values.push_back(soplex_->objReal(i));
+    values.push_back(soplex_->objReal(internal_column(i)));
   }
   return Objective<double>(std::move(values));
 }
 
+SparseObjective<double> LinearProgramHandleSoplex::sparse_objective() const {
+  const auto& indices = objective_support_.indices();
+  std::vector<double> values;
+  values.reserve(indices.size());
+  for (const auto i : indices) {
+    const auto col = internal_column(static_cast<std::size_t>(i));
+    values.push_back(soplex_->objReal(col));
+  }
+  return SparseObjective<double>(values, indices);
+}
+
+const std::vector<Constraint<double>>&
+LinearProgramHandleSoplex::cached_constraints() const {
+  return cache_.constraints([this] { return constraints(); });
+}
+
+const Objective<double>& LinearProgramHandleSoplex::cached_objective() const {
+  return cache_.objective([this] { return objective(); });
+}
+
+const std::vector<Variable>& LinearProgramHandleSoplex::cached_variables()
+    const {
+  return cache_.variables([this] { return variables(); });
+}
+
+void LinearProgramHandleSoplex::clear_cache() { cache_.clear(); }
+
+void LinearProgramHandleSoplex::set_cache_enabled(const bool enabled) {
+  cache_.set_enabled(enabled);
+}
+
 }  // namespace lpint
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "lpinterface.hpp"
+#include "lpinterface/auto_solver.hpp"
+#include "lpinterface/native/lpinterface_simplex.hpp"
+
+#include "testutil.hpp"
+#include "test_common.hpp"
+
+using namespace lpint;
+using namespace testing;
+
+// x0 + x1 <= 4, x0 - x1 = 1, 1 <= 1000 x1 <= 2000, 0 <= 0.5 x0 <= 2 and the
+// bounding rows 0 <= x0 <= 3 and 0 <= x1 <= 3
+static void add_model(ILinearProgramHandle& lp) {
+  lp.add_variables(std::vector<Variable>(2, Variable(0.0, LPINT_INFINITY)));
+  lp.set_objective(Objective<double>({1.0, 2.0}));
+  std::vector<Constraint<double>> constraints;
+  constraints.emplace_back(Row<double>({1.0, 1.0}, {0, 1}), -LPINT_INFINITY,
+                           4.0);
+  constraints.emplace_back(Row<double>({1.0, -1.0}, {0, 1}), 1.0, 1.0);
+  constraints.emplace_back(Row<double>({1000.0}, {1}), 1.0, 2000.0);
+  constraints.emplace_back(Row<double>({0.5}, {0}), 0.0, 2.0);
+  constraints.emplace_back(Row<double>({1.0}, {0}), 0.0, 3.0);
+  constraints.emplace_back(Row<double>({1.0}, {1}), 0.0, 3.0);
+  lp.add_constraints(constraints);
+}
+
+TEST(AutoSolver, AnalyzesModel) {
+  AutoSolver solver(OptimizationType::Maximize);
+  add_model(solver.linear_program());
+  for (const auto nthreads : {0u, 1u, 4u}) {
+    const auto statistics = analyze_model(solver.linear_program(), nthreads);
+    ASSERT_EQ(statistics.num_rows, 6);
+    ASSERT_EQ(statistics.num_columns, 2);
+    ASSERT_EQ(statistics.num_nonzero, 8);
+    ASSERT_DOUBLE_EQ(statistics.density, 8.0 / 12.0);
+    ASSERT_EQ(statistics.min_coefficient, 0.5);
+    ASSERT_EQ(statistics.max_coefficient, 1000.0);
+    ASSERT_EQ(statistics.coefficient_range(), 2000.0);
+    ASSERT_DOUBLE_EQ(statistics.ranged_fraction, 4.0 / 6.0);
+    ASSERT_DOUBLE_EQ(statistics.equality_fraction, 1.0 / 6.0);
+    ASSERT_DOUBLE_EQ(statistics.bound_fraction, 4.0 / 6.0);
+  }
+
+  const auto empty = analyze_model(NativeSimplexSolver().linear_program());
+  ASSERT_EQ(empty.num_nonzero, 0);
+  ASSERT_EQ(empty.density, 0.0);
+  ASSERT_EQ(empty.coefficient_range(), 1.0);
+}
+
+TEST(AutoSolver, PolicyChoices) {
+  SelectionPolicy policy;
+  ModelStatistics model;
+  model.num_rows = 100;
+  model.num_columns = 100;
+  model.num_nonzero = 1000;
+  model.min_coefficient = 1.0;
+  model.max_coefficient = 10.0;
+  auto choice = policy.choose(model);
+  ASSERT_EQ(choice.backend, NativeBackend::Simplex);
+  ASSERT_FALSE(choice.dualize);
+  ASSERT_FALSE(choice.scale);
+  ASSERT_EQ(choice.threads, 1);
+
+  // many rows per column, but not if most rows are ranged
+  model.num_rows = 1000;
+  ASSERT_TRUE(policy.choose(model).dualize);
+  model.ranged_fraction = 0.9;
+  ASSERT_FALSE(policy.choose(model).dualize);
+
+  model.max_coefficient = 1e6;
+  ASSERT_TRUE(policy.choose(model).scale);
+
+  model.num_nonzero = policy.equality_interior_point_nonzeros;
+  model.equality_fraction = 0.9;
+  choice = policy.choose(model, 2);
+  ASSERT_EQ(choice.backend, NativeBackend::InteriorPoint);
+  ASSERT_GE(choice.threads, 1);
+  ASSERT_LE(choice.threads, 2);
+
+  model.num_nonzero = policy.first_order_nonzeros;
+  choice = policy.choose(model);
+  ASSERT_EQ(choice.backend, NativeBackend::FirstOrder);
+  ASSERT_FALSE(choice.scale);
+}
+
+TEST(AutoSolver, SupportedParams) {
+  test_supported_params<AutoSolver>(
+    {
+      Param::Threads, Param::TimeLimit, Param::Verbosity, Param::IterationLimit
+    },
+    {
+      Param::ObjectiveSense, Param::Infinity, Param::PrimalOrDual
+    }
+  );
+  AutoSolver solver;
+  ASSERT_THROW(solver.set_parameter(Param::Threads, -1),
+               FailedToSetParameterException);
+}
+
+TEST(AutoSolver, RecordsDecisions) {
+  NativeSimplexSolver reference(OptimizationType::Maximize);
+  add_model(reference.linear_program());
+  ASSERT_EQ(reference.solve(), Status::Optimal);
+  const auto expected = reference.get_solution().objective_value;
+
+  // three rows per column, most of them ranged, and coefficients spanning
+  // 2000
+  SelectionPolicy policy;
+  policy.scaling_range = 1000.0;
+  policy.dualize_ranged_fraction = 1.0;
+  AutoSolver solver(OptimizationType::Maximize, policy);
+  add_model(solver.linear_program());
+  ASSERT_EQ(solver.solve(), Status::Optimal);
+  const auto& statistics = solver.statistics();
+  ASSERT_EQ(statistics.status, Status::Optimal);
+  ASSERT_EQ(statistics.model.num_rows, 6);
+  ASSERT_EQ(statistics.choice.backend, NativeBackend::Simplex);
+  ASSERT_TRUE(statistics.choice.dualize);
+  ASSERT_TRUE(statistics.choice.scale);
+  ASSERT_GE(statistics.analysis_seconds, 0.0);
+  ASSERT_GE(statistics.solve_seconds, 0.0);
+  ASSERT_NEAR(solver.get_solution().objective_value, expected, 1e-9);
+
+  // the policy is applied again on every solve
+  solver.policy().dualize_ratio = 10.0;
+  solver.policy().equality_interior_point_nonzeros = 0;
+  solver.policy().interior_point_equality_fraction = 0.0;
+  solver.set_parameter(Param::Threads, 1);
+  ASSERT_EQ(solver.solve(), Status::Optimal);
+  ASSERT_EQ(solver.statistics().choice.backend, NativeBackend::InteriorPoint);
+  ASSERT_FALSE(solver.statistics().choice.dualize);
+  ASSERT_EQ(solver.statistics().choice.threads, 1);
+  ASSERT_NEAR(solver.get_solution().objective_value, expected, 1e-6);
+}
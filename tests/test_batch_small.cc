@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <rapidcheck/gtest.h>
+
+#include <cmath>
+
+#include "lpinterface.hpp"
+#include "lpinterface/native/batch_small.hpp"
+#include "lpinterface/native/lpinterface_small.hpp"
+
+#include "generators.hpp"
+#include "testutil.hpp"
+#include "test_common.hpp"
+
+using namespace lpint;
+using namespace testing;
+
+constexpr const std::size_t ncols = 4;
+
+using Problem = SmallLp<ncols, 16>;
+
+TEST(BatchSmallLp, SupportedParams) {
+  BatchSmallLpSolver<ncols, 16> solver;
+  ASSERT_TRUE(solver.parameter_supported(Param::IterationLimit));
+  ASSERT_FALSE(solver.parameter_supported(Param::Threads));
+  ASSERT_THROW(solver.set_parameter(Param::Threads, 1),
+               UnsupportedParameterException);
+  ASSERT_THROW(solver.set_parameter(Param::IterationLimit, -1),
+               FailedToSetParameterException);
+}
+
+TEST(BatchSmallLp, MixedStatuses) {
+  SmallLp<2> optimal;
+  optimal.sense = OptimizationType::Maximize;
+  optimal.objective = {{1.0, 1.0}};
+  optimal.add_row({{1.0, 2.0}}, -LPINT_INFINITY, 4.0);
+  optimal.add_row({{3.0, 1.0}}, -LPINT_INFINITY, 6.0);
+
+  auto infeasible = optimal;
+  infeasible.add_row({{1.0, 1.0}}, 3.0, LPINT_INFINITY);
+
+  auto unbounded = optimal;
+  unbounded.num_rows = 1;
+  unbounded.lower[1] = -LPINT_INFINITY;
+
+  // more problems than lanes, so lanes are reused
+  BatchSmallLpSolver<2, 64, 4> solver;
+  const auto solutions =
+      solver.solve({optimal, infeasible, unbounded, optimal, infeasible});
+  ASSERT_EQ(solutions.size(), 5);
+  ASSERT_EQ(solver.statuses(),
+            std::vector<Status>({Status::Optimal, Status::Infeasible,
+                                 Status::Unbounded, Status::Optimal,
+                                 Status::Infeasible}));
+  for (const auto k : {0, 3}) {
+    const auto& solution = solutions[static_cast<std::size_t>(k)];
+    ASSERT_NEAR(solution.objective_value, 2.8, 1e-12);
+    ASSERT_NEAR(solution.primal[0], 1.6, 1e-12);
+    ASSERT_NEAR(solution.primal[1], 1.2, 1e-12);
+    ASSERT_EQ(solution.dual.size(), 2);
+    ASSERT_NEAR(solution.dual[0], 0.4, 1e-12);
+    ASSERT_NEAR(solution.dual[1], 0.2, 1e-12);
+  }
+  ASSERT_TRUE(solutions[1].primal.empty());
+
+  solver.set_parameter(Param::IterationLimit, 0);
+  solver.solve({optimal});
+  ASSERT_EQ(solver.statuses().front(), Status::IterationLimit);
+}
+
+// property: every problem gets the solution SmallLpSolver finds for it
+template <std::size_t Lanes>
+static void test_matches_small_solver() {
+  const auto coefficient = rc::gen::map(rc::gen::inRange(-20, 21),
+                                        [](int v) { return v / 4.0; });
+  const auto nproblems = *rc::gen::inRange<std::size_t>(1, 3 * Lanes);
+  std::vector<Problem> problems(nproblems);
+  for (auto& problem : problems) {
+    problem.sense = *rc::gen::element(OptimizationType::Minimize,
+                                      OptimizationType::Maximize);
+    for (std::size_t j = 0; j < ncols; j++) {
+      problem.objective[j] = *coefficient;
+      problem.upper[j] = *rc::gen::element(2.0, 5.0, LPINT_INFINITY);
+    }
+    const auto nconstr = *rc::gen::inRange<std::size_t>(1, 16);
+    for (std::size_t i = 0; i < nconstr; i++) {
+      std::array<double, ncols> row;
+      for (auto& value : row) {
+        value = *coefficient;
+      }
+      const auto lower = *rc::gen::inRange(-10, 10);
+      problem.add_row(row, lower, lower + *rc::gen::inRange(0, 10));
+    }
+  }
+
+  BatchSmallLpSolver<ncols, 16, Lanes> batch;
+  const auto solutions = batch.solve(problems);
+  SmallLpSolver<ncols, 16> solver;
+  for (std::size_t k = 0; k < nproblems; k++) {
+    RC_ASSERT(batch.statuses()[k] == solver.solve(problems[k]));
+    if (batch.statuses()[k] != Status::Optimal) {
+      continue;
+    }
+    RC_ASSERT(std::abs(solutions[k].objective_value -
+                       solver.objective_value()) <= 1e-9);
+    RC_ASSERT(solutions[k].dual.size() == problems[k].num_rows);
+  }
+}
+
+RC_GTEST_PROP(BatchSmallLp, MatchesSmallSolverFourLanes, ()) {
+  test_matches_small_solver<4>();
+}
+
+RC_GTEST_PROP(BatchSmallLp, MatchesSmallSolverSixteenLanes, ()) {
+  test_matches_small_solver<16>();
+}
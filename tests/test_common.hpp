@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <cmath>
+
 #include <gtest/gtest.h>
 #include <rapidcheck.h>
 
@@ -5,6 +8,7 @@
 #include "testutil.hpp"
 
 #include "lpinterface.hpp"
+#include "lpinterface/native/lpinterface_simplex.hpp"
 
 namespace lpint {
 
@@ -84,6 +88,65 @@ void test_add_retrieve_constraints(std::size_t ncols) {
   });
 }
 
+template <class Solver>
+void test_add_retrieve_constraint_batch(std::size_t ncols) {
+  templated_prop<Solver>("Constraints added as a batch are retrieved intact", [=]() {
+    auto nconstr = *rc::gen::inRange<std::size_t>(1, ncols);
+    auto constraints = *rc::gen::container<std::vector<Constraint<double>>>(
+      nconstr,
+      rc::genConstraint(
+        rc::genRow(
+          ncols,
+          rc::gen::nonZero<double>()),
+        rc::gen::arbitrary<double>()));
+
+    ConstraintBatch<double> batch;
+    for (const auto& constraint : constraints) {
+      batch.begin_row(constraint.lower_bound, constraint.upper_bound);
+      for (std::size_t j = 0; j < constraint.row.num_nonzero(); j++) {
+        batch.push(constraint.row.nonzero_indices()[j], constraint.row.values()[j]);
+      }
+      batch.end_row();
+    }
+
+    Solver solver(OptimizationType::Maximize);
+    solver.linear_program().add_variables(ncols);
+    solver.linear_program().add_constraints(batch);
+    RC_ASSERT(solver.linear_program().constraints() == constraints);
+  });
+}
+
+template <class Solver>
+void test_add_retrieve_compact_batch(std::size_t ncols) {
+  templated_prop<Solver>("Constraints staged in single precision are widened on load", [=]() {
+    auto nconstr = *rc::gen::inRange<std::size_t>(1, ncols);
+    auto constraints = *rc::gen::container<std::vector<Constraint<double>>>(
+      nconstr,
+      rc::genConstraint(
+        rc::genRow(
+          ncols,
+          rc::gen::map(rc::gen::nonZero<std::int16_t>(),
+                       [](std::int16_t x) { return static_cast<double>(x); })),
+        rc::gen::map(rc::gen::arbitrary<std::int16_t>(),
+                     [](std::int16_t x) { return static_cast<double>(x); })));
+
+    CompactConstraintBatch batch;
+    for (const auto& constraint : constraints) {
+      batch.begin_row_checked(constraint.lower_bound, constraint.upper_bound);
+      for (std::size_t j = 0; j < constraint.row.num_nonzero(); j++) {
+        batch.push_checked(constraint.row.nonzero_indices()[j], constraint.row.values()[j]);
+      }
+      batch.end_row();
+    }
+
+    Solver solver(OptimizationType::Maximize);
+    solver.linear_program().add_variables(ncols);
+    // force several chunks to be loaded
+    add_constraints_widened(solver.linear_program(), batch, ncols / 2);
+    RC_ASSERT(solver.linear_program().constraints() == constraints);
+  });
+}
+
 template <class Solver>
 void test_add_remove_constraints(std::size_t ncols) {
   templated_prop<Solver>("Adding and removing constraints works properly", [=]() {
@@ -127,6 +190,608 @@ void test_add_remove_constraints(std::size_t ncols) {
   });
 }
 
+template <class Solver>
+void test_remove_constraints_by_id(std::size_t ncols) {
+  templated_prop<Solver>("Constraint ids survive removal of other constraints", [=]() {
+    auto nconstr = *rc::gen::inRange<std::size_t>(1, ncols);
+    auto constraints = *rc::gen::container<std::vector<Constraint<double>>>(
+      nconstr,
+      rc::genConstraint(
+        rc::genRow(ncols, rc::gen::nonZero<double>()),
+        rc::gen::arbitrary<double>()));
+
+    Solver solver(OptimizationType::Maximize);
+    solver.linear_program().add_variables(ncols);
+    const auto ids = solver.linear_program().add_constraints(constraints);
+    RC_ASSERT(ids.size() == nconstr);
+
+    const auto removed = *rc::gen::container<std::vector<bool>>(
+      nconstr, rc::gen::arbitrary<bool>()).as("Removed constraints");
+    for (std::size_t k = 0; k < nconstr; k++) {
+      if (removed[k]) {
+        solver.linear_program().remove_constraint(ids[k]);
+      }
+    }
+
+    for (std::size_t k = 0; k < nconstr; k++) {
+      if (removed[k]) {
+        RC_ASSERT_THROWS_AS(solver.linear_program().position(ids[k]),
+                            InvalidIdException);
+      } else {
+        const auto pos = solver.linear_program().position(ids[k]);
+        RC_ASSERT(solver.linear_program().constraint_id(pos) == ids[k]);
+        RC_ASSERT(solver.linear_program().constraint(ids[k]) == constraints[k]);
+      }
+    }
+  });
+}
+
+template <class Solver>
+void test_cached_model_tracks_changes(std::size_t ncols) {
+  templated_prop<Solver>("Cached model data is equal to backend data after changes", [=]() {
+    auto gen_constraints = [=](std::size_t n) {
+      return *rc::gen::container<std::vector<Constraint<double>>>(
+        n,
+        rc::genConstraint(
+          rc::genRow(ncols, rc::gen::nonZero<double>()),
+          rc::gen::arbitrary<double>()));
+    };
+    Solver solver(OptimizationType::Maximize);
+    auto& lp = solver.linear_program();
+    lp.add_variables(ncols);
+    lp.set_objective(*rc::genSizedObjective(ncols, rc::gen::arbitrary<double>()));
+    lp.add_constraints(gen_constraints(*rc::gen::inRange<std::size_t>(1, ncols)));
+
+    RC_ASSERT(lp.cached_constraints() == lp.constraints());
+    RC_ASSERT(lp.cached_objective() == lp.objective());
+    RC_ASSERT(lp.cached_variables() == lp.variables());
+
+    // repeated reads return the same cached object
+    RC_ASSERT(&lp.cached_constraints() == &lp.cached_constraints());
+
+    lp.remove_constraint(*rc::gen::inRange<std::size_t>(0, lp.num_constraints()));
+    RC_ASSERT(lp.cached_constraints() == lp.constraints());
+
+    lp.add_constraints(gen_constraints(*rc::gen::inRange<std::size_t>(1, ncols)));
+    RC_ASSERT(lp.cached_constraints() == lp.constraints());
+
+    lp.set_objective(*rc::genSizedObjective(ncols, rc::gen::arbitrary<double>()));
+    RC_ASSERT(lp.cached_objective() == lp.objective());
+
+    lp.add_variables(*rc::gen::container<std::vector<Variable>>(rc::gen::arbitrary<Variable>()));
+    RC_ASSERT(lp.cached_variables() == lp.variables());
+    RC_ASSERT(lp.cached_objective() == lp.objective());
+
+    lp.clear_cache();
+    RC_ASSERT(lp.cached_constraints() == lp.constraints());
+  });
+}
+
+template <class Solver>
+void test_stream_constraints(std::size_t ncols) {
+  templated_prop<Solver>("Range queries and cursors agree with constraints()", [=]() {
+    auto nconstr = *rc::gen::inRange<std::size_t>(1, ncols);
+    auto constraints = *rc::gen::container<std::vector<Constraint<double>>>(
+      nconstr,
+      rc::genConstraint(
+        rc::genRow(ncols, rc::gen::nonZero<double>()),
+        rc::gen::arbitrary<double>()));
+
+    Solver solver(OptimizationType::Maximize);
+    solver.linear_program().add_variables(ncols);
+    solver.linear_program().add_constraints(constraints);
+    const auto all = solver.linear_program().constraints();
+
+    const auto first = *rc::gen::inRange<std::size_t>(0, nconstr + 1).as("First");
+    const auto last = *rc::gen::inRange<std::size_t>(first, nconstr + 1).as("Last");
+    const auto range = solver.linear_program().constraints(first, last);
+    RC_ASSERT(range.size() == last - first);
+    for (std::size_t i = first; i < last; i++) {
+      RC_ASSERT(range[i - first] == all[i]);
+    }
+    RC_ASSERT_THROWS_AS(solver.linear_program().constraints(0, nconstr + 1),
+                        std::out_of_range);
+
+    ConstraintCursor cursor(solver.linear_program());
+    std::size_t count = 0;
+    for (const auto& constraint : cursor) {
+      RC_ASSERT(cursor.index() == count);
+      RC_ASSERT(constraint == all[count++]);
+    }
+    RC_ASSERT(count == nconstr);
+  });
+}
+
+template <class Solver>
+void test_columns_match_rows(std::size_t ncols) {
+  templated_prop<Solver>("Columns are the transpose of the constraint rows", [=]() {
+    auto nconstr = *rc::gen::inRange<std::size_t>(1, ncols);
+    auto constraints = *rc::gen::container<std::vector<Constraint<double>>>(
+      nconstr,
+      rc::genConstraint(
+        rc::genRow(ncols, rc::gen::nonZero<double>()),
+        rc::gen::arbitrary<double>()));
+
+    Solver solver(OptimizationType::Maximize);
+    solver.linear_program().add_variables(ncols);
+    solver.linear_program().add_constraints(constraints);
+
+    std::vector<std::vector<double>> values(ncols);
+    std::vector<std::vector<int>> indices(ncols);
+    for (std::size_t i = 0; i < nconstr; i++) {
+      const auto& row = constraints[i].row;
+      for (std::size_t k = 0; k < row.num_nonzero(); k++) {
+        const auto j = static_cast<std::size_t>(row.nonzero_indices()[k]);
+        values[j].push_back(row.values()[k]);
+        indices[j].push_back(static_cast<int>(i));
+      }
+    }
+
+    const auto columns = solver.linear_program().columns();
+    RC_ASSERT(columns.size() == ncols);
+    for (std::size_t j = 0; j < ncols; j++) {
+      const Column<double> expected(values[j], indices[j]);
+      RC_ASSERT(solver.linear_program().column(j) == expected);
+      RC_ASSERT(columns[j] == expected);
+    }
+  });
+}
+
+template <class Solver>
+void test_transaction_rollback(std::size_t ncols) {
+  templated_prop<Solver>("Rolling back a transaction restores the model", [=]() {
+    auto gen_constraints = [=](std::size_t n) {
+      return *rc::gen::container<std::vector<Constraint<double>>>(
+        n,
+        rc::genConstraint(
+          rc::genRow(ncols, rc::gen::nonZero<double>()),
+          rc::gen::arbitrary<double>()));
+    };
+    Solver solver(OptimizationType::Maximize);
+    auto& lp = solver.linear_program();
+    lp.add_variables(ncols);
+    lp.set_objective(*rc::genSizedObjective(ncols, rc::gen::arbitrary<double>()));
+    const auto ids = lp.add_constraints(gen_constraints(*rc::gen::inRange<std::size_t>(1, ncols)));
+
+    const auto constraints = lp.constraints();
+    const auto objective = lp.objective();
+    const auto variables = lp.variables();
+
+    RC_ASSERT_THROWS_AS(lp.commit(), InvalidTransactionStateException);
+    lp.begin_transaction();
+    RC_ASSERT(lp.in_transaction());
+    RC_ASSERT_THROWS_AS(lp.begin_transaction(), InvalidTransactionStateException);
+
+    const auto removed = *rc::gen::inRange<std::size_t>(0, ids.size()).as("Removed constraint");
+    lp.remove_constraint(ids[removed]);
+    lp.add_constraints(gen_constraints(*rc::gen::inRange<std::size_t>(1, ncols)));
+    lp.set_constraint_bounds(0, -1.0, 1.0);
+    lp.set_variable_bounds(*rc::gen::inRange<std::size_t>(0, ncols), -2.0, 2.0);
+    lp.set_objective(*rc::genSizedObjective(ncols, rc::gen::arbitrary<double>()));
+    lp.set_objective_sense(OptimizationType::Minimize);
+    lp.rollback();
+
+    RC_ASSERT(!lp.in_transaction());
+    RC_ASSERT(lp.constraints() == constraints);
+    RC_ASSERT(lp.objective() == objective);
+    RC_ASSERT(lp.variables() == variables);
+    RC_ASSERT(lp.optimization_type() == OptimizationType::Maximize);
+    for (std::size_t k = 0; k < ids.size(); k++) {
+      RC_ASSERT(lp.position(ids[k]) == k);
+    }
+
+    // committed changes are kept
+    lp.begin_transaction();
+    lp.remove_constraint(ids[removed]);
+    lp.commit();
+    RC_ASSERT(lp.num_constraints() == constraints.size() - 1);
+    RC_ASSERT_THROWS_AS(lp.rollback(), InvalidTransactionStateException);
+  });
+
+  templated_prop<Solver>("Rolling back restores removed variables", [=]() {
+    Solver solver(OptimizationType::Maximize);
+    auto& lp = solver.linear_program();
+    const auto ids = lp.add_variables(ncols);
+    lp.set_objective(*rc::genSizedObjective(ncols, rc::gen::arbitrary<double>()));
+    lp.add_constraints(*rc::gen::container<std::vector<Constraint<double>>>(
+      *rc::gen::inRange<std::size_t>(1, ncols),
+      rc::genConstraint(
+        rc::genRow(ncols, rc::gen::nonZero<double>()),
+        rc::gen::arbitrary<double>())));
+    const auto objective = lp.objective();
+    const auto variables = lp.variables();
+    const auto constraints = lp.constraints();
+
+    lp.begin_transaction();
+    const auto removed = *rc::gen::container<std::vector<bool>>(
+      ncols, rc::gen::arbitrary<bool>()).as("Removed variables");
+    for (std::size_t k = 0; k < ncols; k++) {
+      if (removed[k]) {
+        lp.remove_variable(ids[k]);
+      }
+    }
+    lp.add_variables(*rc::gen::inRange<std::size_t>(1, ncols));
+    lp.rollback();
+
+    RC_ASSERT(lp.num_vars() == ncols);
+    RC_ASSERT(lp.objective() == objective);
+    RC_ASSERT(lp.variables() == variables);
+    RC_ASSERT(lp.constraints() == constraints);
+    for (std::size_t k = 0; k < ncols; k++) {
+      RC_ASSERT(lp.position(ids[k]) == k);
+    }
+  });
+
+  templated_prop<Solver>("Rolling back restores a partly zero objective", [=]() {
+    Solver solver(OptimizationType::Maximize);
+    auto& lp = solver.linear_program();
+    lp.add_variables(ncols);
+    std::vector<double> values(ncols, 0.0);
+    const auto nonzero = *rc::gen::inRange<std::size_t>(0, ncols).as("Nonzero coefficient");
+    values[nonzero] = 3.0;
+    lp.set_objective(Objective<double>(std::vector<double>(values)));
+
+    lp.begin_transaction();
+    lp.set_objective(Objective<double>(std::vector<double>(ncols, 7.0)));
+    lp.rollback();
+    RC_ASSERT(lp.objective().values == values);
+
+    // a sparse objective zeroes every coefficient it does not list
+    lp.set_objective(SparseObjective<double>({5.0}, {static_cast<int>(ncols - 1)}));
+    std::vector<double> expected(ncols, 0.0);
+    expected[ncols - 1] = 5.0;
+    RC_ASSERT(lp.objective().values == expected);
+  });
+}
+
+template <class Solver>
+void test_staged_changes(std::size_t ncols) {
+  templated_prop<Solver>("Staged changes give the same model as direct changes", [=]() {
+    auto nconstr = *rc::gen::inRange<std::size_t>(1, ncols);
+    auto constraints = *rc::gen::container<std::vector<Constraint<double>>>(
+      nconstr,
+      rc::genConstraint(
+        rc::genRow(ncols, rc::gen::nonZero<double>()),
+        rc::gen::arbitrary<double>()));
+    const auto lower = *rc::gen::arbitrary<double>();
+    const auto upper = lower + 1.0;
+    const auto removed = *rc::gen::inRange<std::size_t>(0, nconstr).as("Removed constraint");
+    const auto bounded = *rc::gen::inRange<std::size_t>(0, ncols).as("Bounded variable");
+    // nonzero costs everywhere, of which only one is changed
+    const auto objective = *rc::genSizedObjective(ncols, rc::gen::nonZero<double>());
+    const auto changed = *rc::gen::inRange<std::size_t>(0, ncols).as("Changed cost");
+
+    Solver direct(OptimizationType::Maximize);
+    direct.linear_program().add_variables(ncols);
+    direct.linear_program().add_constraints(constraints);
+    direct.linear_program().set_objective(objective);
+    direct.linear_program().remove_constraint(removed);
+    direct.linear_program().set_variable_bounds(bounded, lower, upper);
+    direct.linear_program().add_variables(std::vector<Variable>{Variable(0.0, 1.0)});
+    auto new_objective = objective.values;
+    new_objective[changed] = 4.0;
+    new_objective.push_back(2.0);
+    direct.linear_program().set_objective(Objective<double>(std::move(new_objective)));
+
+    StagedSolver<Solver> staged(OptimizationType::Maximize);
+    const auto vars = staged.linear_program().add_variables(ncols);
+    const auto ids = staged.linear_program().add_constraints(constraints);
+    staged.linear_program().set_objective(objective);
+    auto& changes = staged.changes();
+    changes.set_objective_coefficient(vars[changed], 4.0);
+    changes.set_constraint_bounds(ids[removed], -1.0, 1.0);
+    changes.remove_constraint(ids[removed]);
+    RC_ASSERT_THROWS_AS(changes.set_constraint_bounds(ids[removed], -1.0, 1.0),
+                        InvalidIdException);
+    changes.set_variable_bounds(vars[bounded], -1.0, 1.0);
+    changes.set_variable_bounds(vars[bounded], lower, upper);
+    const auto cancelled = changes.add_variable(Variable(), 3.0);
+    changes.remove_variable(cancelled);
+    const auto added = changes.add_variable(Variable(-1.0, 1.0));
+    changes.set_variable_bounds(added, 0.0, 1.0);
+    changes.set_objective_coefficient(added, 2.0);
+
+    // nothing reaches the backend before the changes are flushed
+    RC_ASSERT(staged.solver().linear_program().num_constraints() == nconstr);
+    staged.flush();
+    RC_ASSERT(changes.empty());
+    RC_ASSERT_THROWS_AS(changes.resolve(cancelled), InvalidIdException);
+    RC_ASSERT(staged.linear_program().position(changes.resolve(added)) == ncols);
+
+    RC_ASSERT(staged.linear_program().constraints() == direct.linear_program().constraints());
+    RC_ASSERT(staged.linear_program().variables() == direct.linear_program().variables());
+    RC_ASSERT(staged.linear_program().objective() == direct.linear_program().objective());
+  });
+}
+
+template <class Solver>
+void test_model_diff(std::size_t ncols) {
+  templated_prop<Solver>("Applying a model diff reproduces the new model", [=]() {
+    auto nconstr = *rc::gen::inRange<std::size_t>(2, ncols);
+    auto constraints = *rc::gen::container<std::vector<Constraint<double>>>(
+      nconstr,
+      rc::genConstraint(
+        rc::genRow(ncols, rc::gen::nonZero<double>()),
+        rc::gen::arbitrary<double>()));
+    auto added = *rc::genConstraint(
+      rc::genRow(ncols, rc::gen::nonZero<double>()),
+      rc::gen::arbitrary<double>());
+    const auto removed = *rc::gen::inRange<std::size_t>(0, nconstr).as("Removed constraint");
+    const auto bounded = *rc::gen::inRange<std::size_t>(0, ncols).as("Bounded variable");
+    // nonzero costs everywhere, of which only one changes
+    const auto objective = *rc::genSizedObjective(ncols, rc::gen::nonZero<double>());
+    const auto changed = *rc::gen::inRange<std::size_t>(0, ncols).as("Changed cost");
+    auto new_objective = objective.values;
+    new_objective[changed] += 1.0;
+
+    Solver old_solver(OptimizationType::Maximize);
+    auto& old_lp = old_solver.linear_program();
+    old_lp.add_variables(ncols);
+    old_lp.add_constraints(constraints);
+    old_lp.set_objective(objective);
+    RC_ASSERT(diff(old_lp, old_lp).empty());
+
+    Solver new_solver(OptimizationType::Maximize);
+    auto& new_lp = new_solver.linear_program();
+    new_lp.add_variables(ncols);
+    new_lp.add_constraints(constraints);
+    new_lp.remove_constraint(removed);
+    new_lp.set_variable_bounds(bounded, -1.0, 1.0);
+    new_lp.add_constraints(std::vector<Constraint<double>>{std::move(added)});
+    new_lp.set_objective(Objective<double>(std::move(new_objective)));
+
+    const auto d = diff(old_lp, new_lp);
+    RC_ASSERT(d.objective.size() <= 1);
+    RC_ASSERT(d.added_constraints.size() <= 1);
+    RC_ASSERT(d.removed_constraints.size() <= 1);
+    RC_ASSERT(d.variable_bounds.size() <= 1);
+    d.apply(old_lp);
+
+    RC_ASSERT(old_lp.variables() == new_lp.variables());
+    RC_ASSERT(old_lp.objective() == new_lp.objective());
+    RC_ASSERT(diff(old_lp, new_lp).empty());
+  });
+}
+
+template <class Solver>
+void test_presolve(std::size_t ncols) {
+  templated_prop<Solver>("Presolving keeps the optimum of the original model", [=]() {
+    const auto coefficient = rc::gen::map(rc::gen::inRange(1, 100), [](int v) {
+      return static_cast<double>(v);
+    });
+    auto nconstr = *rc::gen::inRange<std::size_t>(1, ncols);
+    std::vector<Constraint<double>> constraints;
+    for (std::size_t i = 0; i < nconstr; i++) {
+      constraints.emplace_back(*rc::genRow(ncols, coefficient), -LPINT_INFINITY,
+                               *coefficient);
+    }
+    // add a scaled duplicate of the first row, and a singleton row
+    std::vector<double> scaled(constraints.front().row.values());
+    std::for_each(scaled.begin(), scaled.end(), [](double& v) { v *= 2.0; });
+    const auto indices = constraints.front().row.nonzero_indices();
+    const auto upper = constraints.front().upper_bound;
+    constraints.emplace_back(Row<double>(scaled, indices), -LPINT_INFINITY, upper);
+    const auto singleton = *rc::gen::inRange<int>(0, static_cast<int>(ncols));
+    constraints.emplace_back(Row<double>({1.0}, {singleton}), -LPINT_INFINITY, 1.0);
+    const auto objective = *rc::genSizedObjective(ncols, coefficient);
+    const auto fixed = *rc::gen::inRange<std::size_t>(0, ncols).as("Fixed variable");
+
+    const auto build = [&](LinearProgramSolver& solver) {
+      auto& lp = solver.linear_program();
+      lp.add_variables(std::vector<Variable>(ncols, Variable(0.0, 10.0)));
+      lp.set_variable_bounds(fixed, 0.0, 0.0);
+      lp.add_constraints(constraints);
+      lp.set_objective(objective);
+      solver.set_parameter(Param::Verbosity, 0);
+    };
+    Solver solver(OptimizationType::Maximize);
+    PresolvedSolver<Solver> presolved(OptimizationType::Maximize);
+    build(solver);
+    build(presolved);
+    RC_ASSERT(solver.solve() == Status::Optimal);
+    RC_ASSERT(presolved.solve() == Status::Optimal);
+    RC_ASSERT(!presolved.reductions().empty());
+
+    const auto& expected = solver.get_solution();
+    const auto& solution = presolved.get_solution();
+    const auto tolerance = 1e-6 * (1.0 + std::abs(expected.objective_value));
+    RC_ASSERT(std::abs(solution.objective_value - expected.objective_value) <= tolerance);
+    RC_ASSERT(solution.primal.size() == ncols);
+    RC_ASSERT(solution.dual.size() == constraints.size());
+
+    // the primal solution is feasible, and the duals price out every column
+    // that is strictly between its bounds
+    std::vector<double> reduced_cost(objective.values);
+    for (std::size_t i = 0; i < constraints.size(); i++) {
+      const auto& row = constraints[i].row;
+      double activity = 0.0;
+      for (std::size_t k = 0; k < row.num_nonzero(); k++) {
+        const auto j = static_cast<std::size_t>(row.nonzero_indices()[k]);
+        activity += row.values()[k] * solution.primal[j];
+        reduced_cost[j] -= row.values()[k] * solution.dual[i];
+      }
+      RC_ASSERT(activity <= constraints[i].upper_bound + 1e-6);
+    }
+    for (std::size_t j = 0; j < ncols; j++) {
+      RC_ASSERT(solution.primal[j] >= -1e-6);
+      RC_ASSERT(solution.primal[j] <= 10.0 + 1e-6);
+      if (solution.primal[j] > 1e-6 && solution.primal[j] < 10.0 - 1e-6) {
+        RC_ASSERT(std::abs(reduced_cost[j]) <= 1e-6 * (1.0 + std::abs(objective.values[j])));
+      }
+    }
+  });
+}
+
+template <class Solver>
+void test_dualize(std::size_t ncols) {
+  templated_prop<Solver>("Solving the dual keeps the optimum of the original model", [=]() {
+    const auto coefficient = rc::gen::map(rc::gen::inRange(-20, 21), [](int v) {
+      return v / 4.0;
+    });
+    // rows of every kind, many more than there are columns
+    auto nconstr = *rc::gen::inRange<std::size_t>(2 * ncols, 4 * ncols);
+    std::vector<Constraint<double>> constraints;
+    for (std::size_t i = 0; i < nconstr; i++) {
+      const auto lower = static_cast<double>(*rc::gen::inRange(-20, 0));
+      const auto upper = static_cast<double>(*rc::gen::inRange(0, 20));
+      constraints.emplace_back(*rc::genRow(ncols, coefficient),
+                               *rc::gen::element(-LPINT_INFINITY, lower),
+                               *rc::gen::element(upper, LPINT_INFINITY));
+    }
+    // free columns, columns with one finite bound, and boxed columns
+    std::vector<Variable> variables;
+    for (std::size_t j = 0; j < ncols; j++) {
+      variables.emplace_back(*rc::gen::element(-LPINT_INFINITY, -2.0, 0.0),
+                             *rc::gen::element(3.0, LPINT_INFINITY));
+    }
+    const auto objective = *rc::genSizedObjective(ncols, coefficient);
+    const auto sense = *rc::gen::element(OptimizationType::Minimize,
+                                         OptimizationType::Maximize);
+
+    const auto build = [&](LinearProgramSolver& solver) {
+      auto& lp = solver.linear_program();
+      lp.add_variables(variables);
+      lp.add_constraints(constraints);
+      lp.set_objective(objective);
+      solver.set_parameter(Param::Verbosity, 0);
+    };
+    Solver solver(sense);
+    DualizedSolver<Solver> dualized(sense);
+    build(solver);
+    build(dualized);
+    const auto status = solver.solve();
+    const auto dual_status = dualized.solve();
+    RC_ASSERT(dualized.dualized());
+    if (status != Status::Optimal) {
+      RC_ASSERT(dual_status != Status::Optimal);
+      return;
+    }
+    RC_ASSERT(dual_status == Status::Optimal);
+
+    const auto& expected = solver.get_solution();
+    const auto& solution = dualized.get_solution();
+    const auto tolerance = 1e-6 * (1.0 + std::abs(expected.objective_value));
+    RC_ASSERT(std::abs(solution.objective_value - expected.objective_value) <= tolerance);
+    RC_ASSERT(solution.primal.size() == ncols);
+    RC_ASSERT(solution.dual.size() == constraints.size());
+
+    // the primal solution is feasible, and the duals price out every column
+    // that is strictly between its bounds
+    std::vector<double> reduced_cost(objective.values);
+    for (std::size_t i = 0; i < constraints.size(); i++) {
+      const auto& row = constraints[i].row;
+      double activity = 0.0;
+      for (std::size_t k = 0; k < row.num_nonzero(); k++) {
+        const auto j = static_cast<std::size_t>(row.nonzero_indices()[k]);
+        activity += row.values()[k] * solution.primal[j];
+        reduced_cost[j] -= row.values()[k] * solution.dual[i];
+      }
+      RC_ASSERT(activity >= constraints[i].lower_bound - 1e-6);
+      RC_ASSERT(activity <= constraints[i].upper_bound + 1e-6);
+    }
+    for (std::size_t j = 0; j < ncols; j++) {
+      RC_ASSERT(solution.primal[j] >= variables[j].lower() - 1e-6);
+      RC_ASSERT(solution.primal[j] <= variables[j].upper() + 1e-6);
+      if (solution.primal[j] > variables[j].lower() + 1e-6 &&
+          solution.primal[j] < variables[j].upper() - 1e-6) {
+        RC_ASSERT(std::abs(reduced_cost[j]) <= 1e-6 * (1.0 + std::abs(objective.values[j])));
+      }
+    }
+  });
+}
+
+// The solver is constructed with OptimizationType::Maximize followed by
+// args, and its objective may differ from that of the native simplex by
+// tolerance relative to the optimum.
+template <class Solver, class... Args>
+void test_objective_matches_simplex(std::size_t ncols,
+                                    std::size_t max_constraints,
+                                    double tolerance, Args... args) {
+  templated_prop<Solver>("The optimum agrees with the native simplex optimum", [=]() {
+    const auto coefficient = rc::gen::map(rc::gen::inRange(-20, 21), [](int v) {
+      return v / 4.0;
+    });
+    auto nconstr = *rc::gen::inRange<std::size_t>(1, max_constraints);
+    std::vector<Constraint<double>> constraints;
+    for (std::size_t i = 0; i < nconstr; i++) {
+      constraints.emplace_back(*rc::genRow(ncols, coefficient), -LPINT_INFINITY,
+                               *rc::gen::inRange(0, 10));
+    }
+    const auto objective = *rc::genSizedObjective(ncols, coefficient);
+    const auto threads = *rc::gen::inRange(1, 5);
+
+    const auto build = [&](LinearProgramSolver& solver) {
+      auto& lp = solver.linear_program();
+      lp.add_variables(std::vector<Variable>(ncols, Variable(0.0, 4.0)));
+      lp.add_constraints(constraints);
+      lp.set_objective(objective);
+    };
+
+    NativeSimplexSolver simplex(OptimizationType::Maximize);
+    build(simplex);
+    RC_ASSERT(simplex.solve() == Status::Optimal);
+    const auto expected = simplex.get_solution().objective_value;
+
+    Solver solver(OptimizationType::Maximize, args...);
+    build(solver);
+    if (solver.parameter_supported(Param::Threads)) {
+      solver.set_parameter(Param::Threads, threads);
+    }
+    RC_ASSERT(solver.solve() == Status::Optimal);
+    RC_ASSERT(std::abs(solver.get_solution().objective_value - expected) <=
+              tolerance * (1.0 + std::abs(expected)));
+  });
+}
+
+template <class Solver>
+void test_scaling(std::size_t ncols) {
+  templated_prop<Solver>("Scaling keeps the optimum of the original model", [=]() {
+    // coefficients spread over many orders of magnitude
+    const auto coefficient = rc::gen::map(
+      rc::gen::pair(rc::gen::inRange(1, 10), rc::gen::inRange(-6, 7)),
+      [](const std::pair<int, int>& p) {
+        return static_cast<double>(p.first) * std::pow(10.0, p.second);
+      });
+    auto nconstr = *rc::gen::inRange<std::size_t>(1, ncols);
+    std::vector<Constraint<double>> constraints;
+    for (std::size_t i = 0; i < nconstr; i++) {
+      constraints.emplace_back(*rc::genRow(ncols, coefficient), -LPINT_INFINITY,
+                               *coefficient);
+    }
+    const auto objective = *rc::genSizedObjective(ncols, coefficient);
+
+    const auto build = [&](LinearProgramSolver& solver) {
+      auto& lp = solver.linear_program();
+      lp.add_variables(std::vector<Variable>(ncols, Variable(0.0, 1.0)));
+      lp.add_constraints(constraints);
+      lp.set_objective(objective);
+      solver.set_parameter(Param::Verbosity, 0);
+    };
+    Solver solver(OptimizationType::Maximize);
+    ScaledSolver<Solver> scaled(OptimizationType::Maximize);
+    build(solver);
+    build(scaled);
+    RC_ASSERT(solver.solve() == Status::Optimal);
+    RC_ASSERT(scaled.solve() == Status::Optimal);
+
+    const auto& expected = solver.get_solution();
+    const auto& solution = scaled.get_solution();
+    const auto tolerance = 1e-6 * (1.0 + std::abs(expected.objective_value));
+    RC_ASSERT(std::abs(solution.objective_value - expected.objective_value) <= tolerance);
+    RC_ASSERT(solution.primal.size() == ncols);
+    RC_ASSERT(solution.dual.size() == constraints.size());
+    for (const auto& constraint : constraints) {
+      const auto& row = constraint.row;
+      double activity = 0.0;
+      for (std::size_t k = 0; k < row.num_nonzero(); k++) {
+        activity += row.values()[k] *
+          solution.primal[static_cast<std::size_t>(row.nonzero_indices()[k])];
+      }
+      RC_ASSERT(activity <= constraint.upper_bound * (1.0 + 1e-6) + 1e-6);
+    }
+  });
+}
+
 template <class Solver>
 void test_num_constraints(std::size_t nrows, std::size_t ncols) {
   templated_prop<Solver>("Number of constraints properly retrieved", [=]() {
@@ -163,6 +828,31 @@ void test_add_retrieve_objective(std::size_t ncols) {
   });
 }
 
+template <class Solver>
+void test_set_sparse_objective(std::size_t ncols) {
+  templated_prop<Solver>("Sparse objective only sets the given coefficients", [=]() {
+    auto dense = *rc::genSizedObjective(ncols, rc::gen::nonZero<double>());
+    const auto nnz = *rc::gen::inRange<std::size_t>(0, ncols);
+    const auto indices = *rc::gen::unique<std::vector<int>>(
+        nnz, rc::gen::inRange<int>(0, static_cast<int>(ncols)));
+    const auto values = *rc::gen::container<std::vector<double>>(
+        nnz, rc::gen::nonZero<double>());
+
+    Solver solver(OptimizationType::Maximize);
+    solver.linear_program().add_variables(ncols);
+    solver.linear_program().set_objective(dense);
+    solver.linear_program().set_objective(SparseObjective<double>(values, indices));
+
+    std::vector<double> expected(ncols, 0.0);
+    for (std::size_t k = 0; k < nnz; k++) {
+      expected[static_cast<std::size_t>(indices[k])] = values[k];
+    }
+    RC_ASSERT(solver.linear_program().objective().values == expected);
+    RC_ASSERT(solver.linear_program().sparse_objective()
+        == SparseObjective<double>(values, indices));
+  });
+}
+
 template <class Solver>
 void test_supported_params(std::initializer_list<Param> supported, 
                            std::initializer_list<Param> not_supported) {
@@ -206,6 +896,48 @@ void test_add_retrieve_vars() {
   });
 }
 
+template <class Solver>
+void test_add_retrieve_variable_block() {
+  templated_prop<Solver>("Retrieved variable block is equal to inserted block", [=]() {
+    auto vars = *rc::gen::container<std::vector<Variable>>(rc::gen::arbitrary<Variable>());
+    const VariableBlock block(vars);
+    Solver solver;
+    solver.linear_program().add_variables(block);
+    RC_ASSERT(block == solver.linear_program().variable_block());
+    RC_ASSERT(vars == solver.linear_program().variables());
+  });
+}
+
+template <class Solver>
+void test_remove_vars_by_id() {
+  templated_prop<Solver>("Variable ids survive removal of other variables", [=]() {
+    const auto vars = *rc::gen::container<std::vector<Variable>>(rc::gen::arbitrary<Variable>())
+      .as("Variables");
+    Solver solver;
+    const auto ids = solver.linear_program().add_variables(vars);
+
+    const auto removed = *rc::gen::container<std::vector<bool>>(
+      vars.size(), rc::gen::arbitrary<bool>()).as("Removed variables");
+    // remove back to front, so that ids are exercised out of order
+    for (std::size_t k = vars.size(); k-- > 0;) {
+      if (removed[k]) {
+        solver.linear_program().remove_variable(ids[k]);
+      }
+    }
+
+    std::size_t expected_position = 0;
+    for (std::size_t k = 0; k < vars.size(); k++) {
+      if (removed[k]) {
+        RC_ASSERT_THROWS_AS(solver.linear_program().variable(ids[k]),
+                            InvalidIdException);
+      } else {
+        RC_ASSERT(solver.linear_program().position(ids[k]) == expected_position++);
+        RC_ASSERT(solver.linear_program().variable(ids[k]) == vars[k]);
+      }
+    }
+  });
+}
+
 template <class Solver>
 void test_add_remove_vars() {
   templated_prop<Solver>("Removing variables from LP preserves ordering", [=]() {
@@ -1,10 +1,27 @@
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include <gtest/gtest.h>
 #include <rapidcheck/gtest.h>
 
+#include "lpinterface/change_log.hpp"
+#include "lpinterface/compact_batch.hpp"
+#include "lpinterface/concurrent_builder.hpp"
+#include "lpinterface/constraint_batch.hpp"
 #include "lpinterface/data_objects.hpp"
+#include "lpinterface/detail/id_map.hpp"
+#include "lpinterface/detail/model_cache.hpp"
+#include "lpinterface/detail/util.hpp"
+#include "lpinterface/entity_id.hpp"
 #include "lpinterface/errors.hpp"
+#include "lpinterface/native/lphandle_native.hpp"
+#include "lpinterface/presolve.hpp"
+#include "lpinterface/scaling.hpp"
+#include "lpinterface/triplet_batch.hpp"
 
 #include "generators.hpp"
 
@@ -43,3 +60,572 @@ RC_GTEST_PROP(DataObjects, VariableThrowsIfLowerBoundGreaterThanUpperBound,
     RC_ASSERT_THROWS_AS(Variable(lb, ub), InvalidVariableBoundsException);
   }
 }
+
+RC_GTEST_PROP(DataObjects, ConstraintBatchRowsEqualPushedConstraints, ()) {
+  const auto constraints = *rc::gen::container<std::vector<Constraint<double>>>(
+      rc::genConstraint(rc::genRow(100, rc::gen::nonZero<double>()),
+                        rc::gen::arbitrary<double>()));
+
+  ConstraintBatch<double> batch;
+  for (const auto& constraint : constraints) {
+    batch.begin_row(constraint.lower_bound, constraint.upper_bound);
+    for (std::size_t j = 0; j < constraint.row.num_nonzero(); j++) {
+      batch.push(constraint.row.nonzero_indices()[j],
+                 constraint.row.values()[j]);
+    }
+    batch.end_row();
+  }
+
+  RC_ASSERT(batch.num_rows() == constraints.size());
+  for (std::size_t i = 0; i < constraints.size(); i++) {
+    RC_ASSERT(batch.constraint(i) == constraints[i]);
+  }
+}
+
+TEST(DataObjects, ConstraintBatchThrowsIfDuplicateNonzeros) {
+  ConstraintBatch<double> batch;
+  batch.begin_row(0.0, 1.0);
+  batch.push(3, 1.0);
+  EXPECT_THROW(batch.push(3, 2.0), InvalidMatrixEntryException);
+  batch.end_row();
+  // the same index may appear again in the next row
+  batch.begin_row(0.0, 1.0);
+  EXPECT_NO_THROW(batch.push(3, 2.0));
+  batch.end_row();
+
+  // long rows with large indices are checked as well
+  const int large = 1 << 30;
+  batch.begin_row(0.0, 1.0);
+  for (int k = 0; k < 100; k++) {
+    batch.push(large - k, 1.0);
+  }
+  EXPECT_THROW(batch.push(large - 7, 2.0), InvalidMatrixEntryException);
+  batch.accumulate(large, 2.0);
+  batch.end_row();
+  EXPECT_EQ(batch.row_size(2), 100u);
+  EXPECT_EQ(batch.values()[batch.row_starts()[2]], 3.0);
+  batch.begin_row(0.0, 1.0);
+  EXPECT_NO_THROW(batch.push(large, 2.0));
+  batch.end_row();
+}
+
+TEST(DataObjects, ConstraintBatchThrowsIfRowNotOpen) {
+  ConstraintBatch<double> batch;
+  EXPECT_THROW(batch.push(0, 1.0), InvalidRowStateException);
+  EXPECT_THROW(batch.end_row(), InvalidRowStateException);
+  batch.begin_row(0.0, 1.0);
+  EXPECT_THROW(batch.begin_row(0.0, 1.0), InvalidRowStateException);
+}
+
+TEST(DataObjects, ConstraintBatchClearRetainsCapacity) {
+  ConstraintBatch<double> batch;
+  batch.reserve(10, 100);
+  batch.begin_row(0.0, 1.0);
+  batch.push(0, 1.0);
+  batch.end_row();
+  batch.clear();
+  EXPECT_TRUE(batch.empty());
+  EXPECT_EQ(batch.num_nonzero(), 0u);
+  EXPECT_GE(batch.values().capacity(), 100u);
+}
+
+TEST(DataObjects, MatrixEntrySupportsWideIndices) {
+  const std::int64_t big = std::int64_t(1) << 40;
+  Row<double, std::int64_t> row({1.0, 2.0}, {0, big});
+  EXPECT_EQ(row.nonzero_indices()[1], big);
+  EXPECT_THROW((Row<double, std::int64_t>({1.0, 2.0}, {big, big})),
+               InvalidMatrixEntryException);
+
+  ConstraintBatch<double, std::int64_t> batch;
+  batch.begin_row(0.0, 1.0);
+  batch.push(3, 1.0);
+  batch.end_row();
+  EXPECT_TRUE(batch.constraint(0).row ==
+              (Row<double, std::int64_t>({1.0}, {3})));
+}
+
+TEST(DataObjects, CheckedNarrowThrowsOnOverflow) {
+  const auto int_max = std::numeric_limits<int>::max();
+  EXPECT_EQ(detail::checked_narrow<int>(std::size_t(int_max)), int_max);
+  EXPECT_EQ(detail::checked_narrow<int>(std::int64_t(-1)), -1);
+  EXPECT_THROW(detail::checked_narrow<int>(std::size_t(int_max) + 1),
+               IndexOverflowException);
+  EXPECT_THROW(detail::checked_narrow<std::size_t>(-1), IndexOverflowException);
+  EXPECT_THROW(detail::checked_narrow<int>(std::int64_t(1) << 40),
+               IndexOverflowException);
+}
+
+TEST(DataObjects, IdMapTracksPositionsAcrossErasure) {
+  detail::IdMap<ConstraintId> ids;
+  const auto first = ids.add(3);
+  const auto second = ids.add(2);
+  ASSERT_EQ(first.size(), 3);
+  EXPECT_EQ(second[0], ConstraintId(3));
+
+  ids.erase(1);
+  EXPECT_EQ(ids.size(), 4);
+  EXPECT_EQ(ids.position(first[0]), 0);
+  EXPECT_EQ(ids.position(first[2]), 1);
+  EXPECT_EQ(ids.position(second[1]), 3);
+  EXPECT_EQ(ids.id(2), second[0]);
+  EXPECT_THROW(ids.position(first[1]), InvalidIdException);
+  EXPECT_THROW(ids.position(ConstraintId(5)), InvalidIdException);
+
+  // ids are never reused
+  EXPECT_EQ(ids.add(1)[0], ConstraintId(5));
+}
+
+TEST(DataObjects, IdMapReinsertsErasedIds) {
+  detail::IdMap<VariableId> ids;
+  const auto range = ids.add(4);
+  ids.erase(1);
+  ids.insert(1, range[1]);
+  for (std::size_t k = 0; k < range.size(); k++) {
+    EXPECT_EQ(ids.position(range[k]), k);
+  }
+
+  ids.truncate(2);
+  EXPECT_EQ(ids.size(), 2);
+  EXPECT_THROW(ids.position(range[2]), InvalidIdException);
+  EXPECT_EQ(ids.add(1)[0], VariableId(4));
+}
+
+TEST(DataObjects, ChangeLogCoalescesRedundantChanges) {
+  ChangeLog changes;
+  const auto constraint = changes.add_constraint(
+      Constraint<double>(Row<double>({1.0}, {0}), 0.0, 1.0));
+  const auto variable = changes.add_variable(Variable());
+  changes.set_objective_coefficient(variable, 1.0);
+  changes.remove_constraint(constraint);
+  changes.remove_variable(variable);
+  EXPECT_TRUE(changes.empty());
+  EXPECT_THROW(changes.remove_variable(variable), InvalidIdException);
+
+  changes.set_variable_bounds(VariableId(0), 0.0, 1.0);
+  changes.set_objective_coefficient(VariableId(0), 1.0);
+  EXPECT_FALSE(changes.empty());
+  changes.remove_variable(VariableId(0));
+  EXPECT_THROW(changes.set_variable_bounds(VariableId(0), 0.0, 1.0),
+               InvalidIdException);
+  EXPECT_THROW(changes.set_variable_bounds(VariableId(1), 1.0, 0.0),
+               InvalidVariableBoundsException);
+
+  changes.clear();
+  EXPECT_TRUE(changes.empty());
+}
+
+TEST(DataObjects, ChangeLogChecksRowsBeforeApplying) {
+  LinearProgramHandleNative lp(OptimizationType::Maximize);
+  const auto ids = lp.add_variables(2);
+  ChangeLog changes;
+  changes.set_variable_bounds(ids[0], 0.0, 1.0);
+  changes.remove_variable(ids[1]);
+  // after the removal only position 0 is left
+  changes.add_constraint(
+      Constraint<double>(Row<double>({1.0, 1.0}, {0, 1}), 0.0, 1.0));
+  EXPECT_THROW(changes.apply(lp), InvalidMatrixEntryException);
+  EXPECT_EQ(lp.num_vars(), 2u);
+  EXPECT_EQ(lp.num_constraints(), 0u);
+  EXPECT_EQ(lp.cached_variables()[0].upper(), LPINT_INFINITY);
+  EXPECT_FALSE(changes.empty());
+
+  // a new variable makes position 1 valid again
+  changes.add_variable(Variable());
+  changes.apply(lp);
+  EXPECT_EQ(lp.num_vars(), 2u);
+  EXPECT_EQ(lp.num_constraints(), 1u);
+  EXPECT_EQ(lp.cached_variables()[0].upper(), 1.0);
+}
+
+TEST(DataObjects, ConcurrentBuilderOrdersBlocksDeterministically) {
+  constexpr std::size_t nthreads = 4;
+  constexpr std::size_t nrows = 100;
+  ConcurrentModelBuilder builder(7);
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < nthreads; t++) {
+    threads.emplace_back([&builder, t]() {
+      auto producer = builder.producer(t);
+      for (std::size_t i = 0; i < nrows; i++) {
+        producer.begin_row(static_cast<double>(t), static_cast<double>(i));
+        producer.push(static_cast<int>(t), 1.0);
+        producer.end_row();
+      }
+      producer.add_variable(Variable(), static_cast<double>(t));
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  const auto block = builder.collect();
+  ASSERT_EQ(block.constraints.num_rows(), nthreads * nrows);
+  for (std::size_t k = 0; k < block.constraints.num_rows(); k++) {
+    EXPECT_EQ(block.constraints.lower_bounds()[k],
+              static_cast<double>(k / nrows));
+    EXPECT_EQ(block.constraints.upper_bounds()[k],
+              static_cast<double>(k % nrows));
+    EXPECT_EQ(block.constraints.indices()[k], static_cast<int>(k / nrows));
+  }
+  EXPECT_EQ(block.objective, std::vector<double>({0.0, 1.0, 2.0, 3.0}));
+  EXPECT_TRUE(builder.collect().constraints.empty());
+}
+
+TEST(DataObjects, ConcurrentBuilderMapsLocalVariables) {
+  LinearProgramHandleNative lp(OptimizationType::Maximize);
+  lp.add_variables(std::vector<Variable>(2, Variable()));
+  lp.set_objective(Objective<double>({1.0, 2.0}));
+
+  ConcurrentModelBuilder builder(1);
+  for (std::size_t t = 0; t < 2; t++) {
+    auto producer = builder.producer(t);
+    const auto x = producer.add_variable(Variable(), 3.0 + 10.0 * t);
+    const auto y = producer.add_variable(Variable());
+    EXPECT_EQ(x, 0u);
+    EXPECT_EQ(y, 1u);
+    producer.begin_row(0.0, 1.0);
+    producer.push(0, 1.0);
+    producer.push_local(y, 2.0);
+    EXPECT_THROW(producer.push_local(2, 1.0), InvalidMatrixEntryException);
+    producer.end_row();
+    // the open row is dropped when the producer is destroyed, the
+    // completed row is kept
+    producer.begin_row(0.0, 1.0);
+    producer.push_local(x, 1.0);
+  }
+  builder.flush(lp);
+
+  ASSERT_EQ(lp.num_vars(), 6u);
+  EXPECT_EQ(lp.cached_objective().values,
+            std::vector<double>({1.0, 2.0, 3.0, 0.0, 13.0, 0.0}));
+  ASSERT_EQ(lp.num_constraints(), 2u);
+  EXPECT_EQ(lp.cached_constraints()[0].row.nonzero_indices(),
+            std::vector<int>({0, 3}));
+  EXPECT_EQ(lp.cached_constraints()[1].row.nonzero_indices(),
+            std::vector<int>({0, 5}));
+}
+
+TEST(DataObjects, ConcurrentBuilderKeepsModelOnInvalidRows) {
+  LinearProgramHandleNative lp(OptimizationType::Maximize);
+  lp.add_variables(std::vector<Variable>(2, Variable()));
+
+  ConcurrentModelBuilder builder;
+  {
+    auto producer = builder.producer(0);
+    EXPECT_THROW(builder.producer(0), DuplicateProducerIdException);
+    const auto x = producer.add_variable(Variable(), 1.0);
+    producer.begin_row(0.0, 1.0);
+    // both entries end up at position 2
+    producer.push(2, 1.0);
+    producer.push_local(x, 1.0);
+    producer.end_row();
+  }
+  // the blocks of the destroyed producer have not been collected yet
+  EXPECT_THROW(builder.producer(0), DuplicateProducerIdException);
+  EXPECT_THROW(builder.flush(lp), InvalidMatrixEntryException);
+  EXPECT_EQ(lp.num_vars(), 2u);
+  EXPECT_EQ(lp.num_constraints(), 0u);
+  EXPECT_EQ(lp.cached_objective().values, std::vector<double>({0.0, 0.0}));
+
+  // the blocks were kept
+  const auto block = builder.collect();
+  EXPECT_EQ(block.constraints.num_rows(), 1u);
+  EXPECT_EQ(block.variables.size(), 1u);
+  EXPECT_NO_THROW(builder.producer(0));
+
+  // rows referring to variables past the new ones are rejected as well
+  {
+    auto producer = builder.producer(1);
+    producer.begin_row(0.0, 1.0);
+    producer.push(2, 1.0);
+    producer.end_row();
+  }
+  EXPECT_THROW(builder.flush(lp), InvalidMatrixEntryException);
+  EXPECT_EQ(lp.num_constraints(), 0u);
+}
+
+TEST(DataObjects, TripletBatchSortsByRowAndSumsDuplicates) {
+  TripletBatch<double> triplets;
+  triplets.add_row(0.0, 1.0);
+  triplets.add_row(-1.0, 0.0);
+  triplets.add_row(2.0, 2.0);
+  triplets.add(2, 0, 1.0);
+  triplets.add(0, 3, 2.0);
+  triplets.add(2, 4, 1.0);
+  triplets.add(0, 1, 5.0);
+  triplets.add(2, 0, 0.5);
+  triplets.add(0, 3, -1.0);
+  // duplicates summing to zero are dropped
+  triplets.add(1, 2, 3.0);
+  triplets.add(2, 4, -1.0);
+  triplets.add(1, 2, -3.0);
+
+  for (const std::size_t nthreads : {1u, 2u, 4u}) {
+    const auto batch = triplets.to_batch(nthreads);
+    ASSERT_EQ(batch.num_rows(), 3);
+    EXPECT_EQ(batch.row_starts(), std::vector<std::size_t>({0, 2, 2, 3}));
+    EXPECT_EQ(batch.indices(), std::vector<int>({3, 1, 0}));
+    EXPECT_EQ(batch.values(), std::vector<double>({1.0, 5.0, 1.5}));
+    EXPECT_EQ(batch.lower_bounds(), std::vector<double>({0.0, -1.0, 2.0}));
+  }
+  EXPECT_THROW(triplets.add(3, 0, 1.0), std::out_of_range);
+  EXPECT_THROW(triplets.add(0, -1, 1.0), InvalidMatrixEntryException);
+}
+
+TEST(DataObjects, TripletBatchMatchesSerialConversionInParallel) {
+  constexpr std::size_t nrows = 1000;
+  constexpr std::size_t ncols = 50;
+  TripletBatch<double> triplets;
+  for (std::size_t r = 0; r < nrows; r++) {
+    triplets.add_row(0.0, static_cast<double>(r));
+  }
+  // a fixed pseudo-random sequence with many duplicates
+  std::size_t state = 1;
+  for (std::size_t k = 0; k < 20 * nrows; k++) {
+    state = state * 6364136223846793005u + 1442695040888963407u;
+    triplets.add((state >> 33) % nrows, static_cast<int>((state >> 17) % ncols),
+                 static_cast<double>(k % 7));
+  }
+  const auto serial = triplets.to_batch(1);
+  const auto parallel = triplets.to_batch(8);
+  EXPECT_EQ(serial.row_starts(), parallel.row_starts());
+  EXPECT_EQ(serial.indices(), parallel.indices());
+  EXPECT_EQ(serial.values(), parallel.values());
+}
+
+TEST(DataObjects, PresolveSolvesBoundOnlyModel) {
+  LinearProgramHandleNative lp(OptimizationType::Maximize);
+  lp.add_variables(2);
+  lp.add_variables(std::vector<Variable>{Variable(1.0, 1.0)});
+  lp.set_objective(Objective<double>({1.0, 1.0, 0.0}));
+  std::vector<Constraint<double>> constraints;
+  constraints.emplace_back(Row<double>({1.0}, {0}), -LPINT_INFINITY, 2.0);
+  constraints.emplace_back(Row<double>({2.0}, {1}), -LPINT_INFINITY, 6.0);
+  constraints.emplace_back(Row<double>(), -1.0, 1.0);
+  constraints.emplace_back(Row<double>({1.0, 1.0}, {0, 2}), -LPINT_INFINITY,
+                           10.0);
+  lp.add_constraints(constraints);
+
+  Presolver presolver(lp);
+  ASSERT_EQ(presolver.presolve(), Status::Optimal);
+  EXPECT_EQ(presolver.num_reduced_vars(), 0u);
+  EXPECT_EQ(presolver.num_reduced_constraints(), 0u);
+
+  const auto solution = presolver.postsolve(Solution<double>());
+  EXPECT_EQ(solution.primal, (std::vector<double>{2.0, 3.0, 1.0}));
+  EXPECT_EQ(solution.dual, (std::vector<double>{1.0, 0.5, 0.0, 0.0}));
+  EXPECT_EQ(solution.objective_value, 5.0);
+}
+
+TEST(DataObjects, PresolveMergesParallelRows) {
+  LinearProgramHandleNative lp(OptimizationType::Maximize);
+  lp.add_variables(2);
+  lp.set_objective(Objective<double>({1.0, 1.0}));
+  std::vector<Constraint<double>> constraints;
+  constraints.emplace_back(Row<double>({2.0, 4.0}, {0, 1}), -LPINT_INFINITY,
+                           100.0);
+  constraints.emplace_back(Row<double>({2.0, 1.0}, {1, 0}), -LPINT_INFINITY,
+                           7.0);
+  constraints.emplace_back(Row<double>({-1.0, -2.0}, {0, 1}), -LPINT_INFINITY,
+                           0.0);
+  lp.add_constraints(constraints);
+
+  Presolver presolver(lp);
+  ASSERT_EQ(presolver.presolve(4), Status::NoInformation);
+  EXPECT_EQ(presolver.num_reduced_vars(), 2u);
+  ASSERT_EQ(presolver.num_reduced_constraints(), 1u);
+
+  LinearProgramHandleNative reduced;
+  presolver.load_reduced(reduced);
+  const auto row = reduced.constraint(0);
+  EXPECT_EQ(row.row.values(), (std::vector<double>{2.0, 4.0}));
+  EXPECT_EQ(row.lower_bound, 0.0);
+  EXPECT_EQ(row.upper_bound, 14.0);
+
+  // optimum of the reduced model: x = (7, 0) with the row at its upper bound
+  Solution<double> optimum{{7.0, 0.0}, {0.5}, 7.0};
+  const auto solution = presolver.postsolve(optimum);
+  EXPECT_EQ(solution.primal, (std::vector<double>{7.0, 0.0}));
+  EXPECT_EQ(solution.dual, (std::vector<double>{0.0, 1.0, 0.0}));
+  EXPECT_EQ(solution.objective_value, 7.0);
+}
+
+TEST(DataObjects, ScalerBalancesMatrixInParallel) {
+  LinearProgramHandleNative lp(OptimizationType::Minimize);
+  lp.add_variables(3);
+  lp.set_objective(Objective<double>({1e3, 1.0, 0.0}));
+  std::vector<Constraint<double>> constraints;
+  constraints.emplace_back(Row<double>({1e4, 1e-2}, {0, 1}), -LPINT_INFINITY,
+                           1e4);
+  constraints.emplace_back(Row<double>({3.0, 5e5}, {1, 2}), 1.0,
+                           LPINT_INFINITY);
+  constraints.emplace_back(Row<double>({7e-3}, {2}), 0.0, 1.0);
+  lp.add_constraints(constraints);
+
+  Scaler serial(lp);
+  serial.scale(4, true, 1);
+  Scaler parallel(lp);
+  parallel.scale(4, true, 3);
+  EXPECT_EQ(serial.row_scale(), parallel.row_scale());
+  EXPECT_EQ(serial.column_scale(), parallel.column_scale());
+  for (const auto factor : serial.column_scale()) {
+    EXPECT_EQ(std::exp2(std::round(std::log2(factor))), factor);
+  }
+
+  // after equilibration, the largest entry of every column is close to one
+  LinearProgramHandleNative scaled;
+  serial.load_scaled(scaled);
+  for (const auto& column : scaled.columns()) {
+    double largest = 0.0;
+    for (const auto value : column.values()) {
+      largest = std::max(largest, std::abs(value));
+    }
+    EXPECT_GE(largest, 0.5);
+    EXPECT_LE(largest, 2.0);
+  }
+
+  const Solution<double> solution{{1.0, 2.0, 3.0}, {1.0, 1.0, 1.0}, 4.0};
+  const auto unscaled = serial.unscale(solution);
+  const auto w = serial.objective_scale();
+  for (std::size_t j = 0; j < 3; j++) {
+    EXPECT_EQ(unscaled.primal[j],
+              solution.primal[j] * serial.column_scale()[j]);
+    EXPECT_EQ(unscaled.dual[j], serial.row_scale()[j] / w);
+  }
+  EXPECT_EQ(unscaled.objective_value, 4.0 / w);
+}
+
+TEST(DataObjects, IdRangeIteratesConsecutiveIds) {
+  const VariableIdRange range(VariableId(4), 3);
+  std::vector<VariableId> ids(range.begin(), range.end());
+  EXPECT_EQ(ids, std::vector<VariableId>(
+                     {VariableId(4), VariableId(5), VariableId(6)}));
+}
+
+TEST(DataObjects, ModelCacheLoadsLazilyPerEntity) {
+  detail::ModelCache cache;
+  int loads = 0;
+  auto load_objective = [&loads] {
+    loads++;
+    return Objective<double>({1.0, 2.0});
+  };
+  auto load_variables = [&loads] {
+    loads++;
+    return std::vector<Variable>(2);
+  };
+  EXPECT_EQ(cache.objective(load_objective).values.size(), 2);
+  cache.objective(load_objective);
+  cache.variables(load_variables);
+  EXPECT_EQ(loads, 2);
+
+  // invalidating the objective keeps the variables cached
+  cache.invalidate_objective();
+  cache.objective(load_objective);
+  cache.variables(load_variables);
+  EXPECT_EQ(loads, 3);
+
+  cache.clear();
+  cache.variables(load_variables);
+  EXPECT_EQ(loads, 4);
+
+  // added constraints are appended to the cached ones
+  auto load_constraints = [&loads] {
+    loads++;
+    std::vector<Constraint<double>> constraints;
+    constraints.emplace_back(Row<double>({1.0}, {0}), 0.0, 1.0);
+    return constraints;
+  };
+  cache.constraints(load_constraints);
+  std::vector<Constraint<double>> added;
+  added.emplace_back(Row<double>({2.0}, {1}), 0.0, 2.0);
+  cache.append_constraints(added);
+  ConstraintBatch<double> batch;
+  batch.begin_row(0.0, 3.0);
+  batch.push(0, 3.0);
+  batch.end_row();
+  cache.append_constraints(batch);
+  const auto& constraints = cache.constraints(load_constraints);
+  EXPECT_EQ(loads, 5);
+  ASSERT_EQ(constraints.size(), 3u);
+  EXPECT_EQ(constraints[1], added[0]);
+  EXPECT_EQ(constraints[2], batch.constraint(0));
+
+  // a disabled cache loads on every access
+  cache.set_enabled(false);
+  cache.variables(load_variables);
+  cache.variables(load_variables);
+  EXPECT_EQ(loads, 7);
+  cache.set_enabled(true);
+  cache.variables(load_variables);
+  cache.variables(load_variables);
+  EXPECT_EQ(loads, 8);
+}
+
+TEST(DataObjects, CompactBatchDetectsLosslessConversion) {
+  ConstraintBatch<double> batch;
+  batch.begin_row(-LPINT_INFINITY, 4.0);
+  batch.push(0, 0.5);
+  batch.push(65535, -3.0);
+  batch.end_row();
+  EXPECT_TRUE((is_losslessly_convertible<float, std::uint16_t>(batch)));
+
+  auto compact = convert_batch<float, std::uint16_t>(batch);
+  EXPECT_EQ(compact.num_nonzero(), 2u);
+  EXPECT_EQ(compact.indices()[1], 65535);
+  EXPECT_EQ(compact.values()[0], 0.5f);
+
+  batch.begin_row(0.0, 1.0);
+  batch.push(65536, 1.0);
+  batch.end_row();
+  EXPECT_FALSE((is_losslessly_convertible<float, std::uint16_t>(batch)));
+  EXPECT_THROW((convert_batch<float, std::uint16_t>(batch)),
+               IndexOverflowException);
+}
+
+TEST(DataObjects, CompactBatchThrowsOnLossyValues) {
+  CompactConstraintBatch batch;
+  EXPECT_THROW(batch.begin_row_checked(0.0, 0.1), LossyConversionException);
+  batch.begin_row_checked(0.0, 1.0);
+  EXPECT_THROW(batch.push_checked(0, 1.0 / 3.0), LossyConversionException);
+  EXPECT_THROW(batch.push_checked(-1, 1.0), IndexOverflowException);
+  EXPECT_NO_THROW(batch.push_checked(7, 0.25));
+  // values beyond the range of float are rejected before converting them
+  EXPECT_THROW(batch.push_checked(8, 1e300), LossyConversionException);
+  EXPECT_THROW(batch.push_checked(8, -1e39), LossyConversionException);
+  batch.end_row();
+  EXPECT_NO_THROW(batch.begin_row_checked(-LPINT_INFINITY, LPINT_INFINITY));
+
+  ConstraintBatch<double> wide;
+  wide.begin_row(0.0, 1e300);
+  wide.end_row();
+  EXPECT_FALSE((is_losslessly_convertible<float, std::uint16_t>(wide)));
+}
+
+TEST(DataObjects, VariableBlockValidatesBounds) {
+  EXPECT_THROW(VariableBlock({0.0, 2.0}, {1.0, 1.0}),
+               InvalidVariableBoundsException);
+  EXPECT_THROW(VariableBlock({0.0, 0.0}, {1.0}), MismatchedDimensionsException);
+
+  VariableBlock block({-1.0, 0.0}, {1.0, LPINT_INFINITY});
+  EXPECT_THROW(block.push_back(1.0, 0.0), InvalidVariableBoundsException);
+  block.push_back(2.0, 3.0);
+  EXPECT_EQ(block.size(), 3u);
+  EXPECT_EQ(block.variable(2), Variable(2.0, 3.0));
+}
+
+TEST(DataObjects, VariableBlockRoundTripsVariables) {
+  const std::vector<Variable> vars = {Variable(), Variable(-1.0, 1.0),
+                                      Variable(2.0, 2.0)};
+  const VariableBlock block(vars);
+  EXPECT_EQ(block.variables(), vars);
+  EXPECT_EQ(VariableBlock(3).variables(), std::vector<Variable>(3));
+}
+
+TEST(DataObjects, VariableBlockMovesArraysOut) {
+  VariableBlock block({-1.0, 0.0}, {1.0, 2.0});
+  const auto* data = block.lower().data();
+  auto lower = std::move(block).lower();
+  auto upper = std::move(block).upper();
+  EXPECT_EQ(lower.data(), data);
+  EXPECT_EQ(lower, std::vector<double>({-1.0, 0.0}));
+  EXPECT_EQ(upper, std::vector<double>({1.0, 2.0}));
+}
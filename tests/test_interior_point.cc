@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <rapidcheck/gtest.h>
+
+#include <cmath>
+
+#include "lpinterface.hpp"
+#include "lpinterface/native/lpinterface_interior_point.hpp"
+#include "lpinterface/native/lpinterface_simplex.hpp"
+
+#include "generators.hpp"
+#include "testutil.hpp"
+#include "test_common.hpp"
+
+using namespace lpint;
+using namespace testing;
+
+constexpr const std::size_t ncols = 20;
+
+TEST(NativeInteriorPoint, AddAndRetrieveObjective) {
+  test_add_retrieve_objective<NativeInteriorPointSolver>(ncols);
+}
+
+TEST(NativeInteriorPoint, UnsolvedModelThrowsOnAccess) {
+  test_model_not_solved_acces_throw<NativeInteriorPointSolver>();
+}
+
+TEST(NativeInteriorPoint, SupportedParams) {
+  test_supported_params<NativeInteriorPointSolver>(
+    {
+      Param::Threads, Param::TimeLimit, Param::Verbosity,
+      Param::IterationLimit
+    },
+    {
+      Param::ObjectiveSense, Param::Infinity
+    }
+  );
+}
+
+TEST(NativeInteriorPoint, CrossoverFindsVertex) {
+  NativeInteriorPointSolver solver(OptimizationType::Maximize, true);
+  auto& lp = solver.linear_program();
+  lp.add_variables(3);
+  lp.set_objective(Objective<double>({1, 1, 2}));
+  std::vector<Constraint<double>> constraints;
+  constraints.emplace_back(Row<double>({1, 2, 3}, {0, 1, 2}), -LPINT_INFINITY,
+                           4.0);
+  constraints.emplace_back(Row<double>({1, 1}, {0, 1}), 1.0, LPINT_INFINITY);
+  lp.add_constraints(constraints);
+
+  ASSERT_EQ(solver.solve(), Status::Optimal);
+  const auto solution = solver.get_solution();
+  ASSERT_EQ(solution.primal, (std::vector<double>{4.0, 0.0, 0.0}));
+  ASSERT_NEAR(solution.objective_value, 4.0, 1e-12);
+}
+
+TEST(NativeInteriorPoint, CrossoverDetectsInfeasibleAndUnbounded) {
+  NativeInteriorPointSolver solver(OptimizationType::Maximize, true);
+  auto& lp = solver.linear_program();
+  lp.add_variables(std::vector<Variable>(2, Variable(0.0, LPINT_INFINITY)));
+  lp.set_objective(Objective<double>({1.0, 1.0}));
+  std::vector<Constraint<double>> constraints;
+  constraints.emplace_back(Row<double>({1.0, -1.0}, {0, 1}), -LPINT_INFINITY,
+                           1.0);
+  const auto ids = lp.add_constraints(constraints);
+  ASSERT_EQ(solver.solve(), Status::Unbounded);
+
+  lp.set_variable_bounds(1, 0.0, 0.0);
+  lp.set_constraint_bounds(ids[0], -LPINT_INFINITY, -1.0);
+  ASSERT_EQ(solver.solve(), Status::Infeasible);
+}
+
+TEST(NativeInteriorPoint, ObjectiveMatchesSimplex) {
+  // without and with crossover
+  test_objective_matches_simplex<NativeInteriorPointSolver>(ncols, ncols, 1e-6,
+                                                            false);
+  test_objective_matches_simplex<NativeInteriorPointSolver>(ncols, ncols, 1e-6,
+                                                            true);
+}
@@ -0,0 +1,49 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "lpinterface/common.hpp"
+#include "lpinterface/constraint_batch.hpp"
+#include "lpinterface/data_objects.hpp"
+#include "lpinterface/linexpr.hpp"
+
+using namespace lpint;
+
+TEST(LinExpr, EmitsTermsInOrder) {
+  VarRange x(0, 4);
+  Var y(4);
+  ConstraintBatch<double> batch;
+  add_row(batch, 3 * x[1] + 2 * x[3] - y <= 5);
+  ASSERT_EQ(batch.num_rows(), 1);
+  EXPECT_EQ(batch.values(), std::vector<double>({3.0, 2.0, -1.0}));
+  EXPECT_EQ(batch.indices(), std::vector<int>({1, 3, 4}));
+  EXPECT_EQ(batch.lower_bounds()[0], -LPINT_INFINITY);
+  EXPECT_EQ(batch.upper_bounds()[0], 5.0);
+}
+
+TEST(LinExpr, MergesDuplicateTerms) {
+  VarRange x(0, 3);
+  ConstraintBatch<double> batch;
+  add_row(batch, x[0] + 2 * x[2] - 4 * (x[0] - x[1]) >= 1);
+  EXPECT_EQ(batch.values(), std::vector<double>({-3.0, 2.0, 4.0}));
+  EXPECT_EQ(batch.indices(), std::vector<int>({0, 2, 1}));
+}
+
+TEST(LinExpr, MovesConstantsIntoBounds) {
+  VarRange x(0, 2);
+  ConstraintBatch<double> batch;
+  add_row(batch, 2 * (x[0] + 1) == x[1] - 3);
+  add_row(batch, ranged(-1.0, x[0] - 2, 4.0));
+  EXPECT_EQ(batch.values(), std::vector<double>({2.0, -1.0, 1.0}));
+  EXPECT_EQ(batch.lower_bounds(), std::vector<double>({-5.0, 1.0}));
+  EXPECT_EQ(batch.upper_bounds(), std::vector<double>({-5.0, 6.0}));
+}
+
+TEST(LinExpr, MatchesHandWrittenConstraint) {
+  VarRange x(0, 5);
+  ConstraintBatch<double> batch;
+  add_row(batch, ranged(1.0, sum(x) - x[2], 2.0));
+  const auto expected = Constraint<double>(
+      Row<double>({1.0, 1.0, 1.0, 1.0}, {0, 1, 3, 4}), 1.0, 2.0);
+  EXPECT_EQ(batch.constraint(0), expected);
+}
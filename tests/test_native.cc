@@ -0,0 +1,312 @@
+#include <gtest/gtest.h>
+#include <rapidcheck/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+#include "lpinterface.hpp"
+#include "lpinterface/native/dual_simplex.hpp"
+#include "lpinterface/native/lphandle_native.hpp"
+#include "lpinterface/native/lpinterface_simplex.hpp"
+#include "lpinterface/native/network_simplex.hpp"
+
+#include "generators.hpp"
+#include "testutil.hpp"
+#include "test_common.hpp"
+
+using namespace lpint;
+using namespace testing;
+
+constexpr const std::size_t ncols = 20;
+
+TEST(NativeSimplex, AddAndRetrieveObjective) {
+  test_add_retrieve_objective<NativeSimplexSolver>(ncols);
+}
+
+TEST(NativeSimplex, UnsolvedModelThrowsOnAccess) {
+  test_model_not_solved_acces_throw<NativeSimplexSolver>();
+}
+
+TEST(NativeSimplex, SupportedParams) {
+  test_supported_params<NativeSimplexSolver>(
+    {
+      Param::TimeLimit, Param::Verbosity, Param::IterationLimit
+    },
+    {
+      Param::Threads, Param::ObjectiveSense, Param::Infinity
+    }
+  );
+}
+
+TEST(NativeSimplex, DetectsInfeasibleAndUnbounded) {
+  NativeSimplexSolver solver(OptimizationType::Maximize);
+  auto& lp = solver.linear_program();
+  lp.add_variables(std::vector<Variable>(2, Variable(0.0, LPINT_INFINITY)));
+  lp.set_objective(Objective<double>({1.0, 1.0}));
+  std::vector<Constraint<double>> constraints;
+  constraints.emplace_back(Row<double>({1.0, -1.0}, {0, 1}), -LPINT_INFINITY,
+                           1.0);
+  const auto ids = lp.add_constraints(constraints);
+  ASSERT_EQ(solver.solve(), Status::Unbounded);
+
+  lp.set_variable_bounds(1, 0.0, 0.0);
+  lp.set_constraint_bounds(ids[0], -LPINT_INFINITY, -1.0);
+  ASSERT_EQ(solver.solve(), Status::Infeasible);
+  ASSERT_THROW(solver.get_solution(), ModelNotSolvedException);
+}
+
+TEST(NativeSimplex, DetectsInvertedRowBounds) {
+  // a single entry of -1 makes a network, -2 does not
+  for (const double scale : {1.0, 2.0}) {
+    NativeSimplexSolver solver(OptimizationType::Maximize);
+    auto& lp = solver.linear_program();
+    lp.add_variables(std::vector<Variable>(1, Variable(0.0, 10.0)));
+    lp.set_objective(Objective<double>({1.0}));
+    std::vector<Constraint<double>> constraints;
+    constraints.emplace_back(Row<double>({-scale}, {0}), -3.0 * scale,
+                             -3.5 * scale);
+    lp.add_constraints(constraints);
+    ASSERT_EQ(solver.solve(), Status::Infeasible);
+    ASSERT_EQ(solver.used_network_simplex(), scale == 1.0);
+  }
+}
+
+// transportation problem from two sources to two sinks; every entry is +1,
+// so it is a network once the sink rows are reflected
+static void add_transportation(ILinearProgramHandle& lp,
+                               const std::vector<double>& supply,
+                               const std::vector<double>& demand) {
+  lp.add_variables(std::vector<Variable>(4, Variable(0.0, LPINT_INFINITY)));
+  lp.set_objective(Objective<double>({1.0, 3.0, 2.0, 1.0}));
+  std::vector<Constraint<double>> constraints;
+  constraints.emplace_back(Row<double>({1.0, 1.0}, {0, 1}), -LPINT_INFINITY,
+                           supply[0]);
+  constraints.emplace_back(Row<double>({1.0, 1.0}, {2, 3}), -LPINT_INFINITY,
+                           supply[1]);
+  constraints.emplace_back(Row<double>({1.0, 1.0}, {0, 2}), demand[0],
+                           LPINT_INFINITY);
+  constraints.emplace_back(Row<double>({1.0, 1.0}, {1, 3}), demand[1],
+                           LPINT_INFINITY);
+  lp.add_constraints(constraints);
+}
+
+TEST(NativeSimplex, DetectsNetworkStructure) {
+  NativeSimplexSolver solver(OptimizationType::Minimize);
+  auto& lp = solver.linear_program();
+  add_transportation(lp, {5.0, 7.0}, {4.0, 6.0});
+  auto structure = detail::detect_network(detail::make_computational_form(lp));
+  ASSERT_EQ(structure.kind, detail::NetworkKind::Pure);
+  ASSERT_EQ(structure.row_signs.size(), 4);
+  ASSERT_EQ(structure.row_signs[0], structure.row_signs[1]);
+  ASSERT_EQ(structure.row_signs[0], -structure.row_signs[2]);
+  ASSERT_EQ(structure.row_signs[2], structure.row_signs[3]);
+
+  // a third entry in a column leaves no network at all
+  std::vector<Constraint<double>> row;
+  row.emplace_back(Row<double>({1.0}, {0}), -LPINT_INFINITY, 10.0);
+  lp.add_constraints(row);
+  structure = detail::detect_network(detail::make_computational_form(lp));
+  ASSERT_EQ(structure.kind, detail::NetworkKind::None);
+
+  // a gain on an arc leaves a generalized network, solved by dual simplex
+  NativeSimplexSolver gains(OptimizationType::Maximize);
+  auto& gains_lp = gains.linear_program();
+  gains_lp.add_variables(std::vector<Variable>(2, Variable(0.0, 3.0)));
+  gains_lp.set_objective(Objective<double>({1.0, 1.0}));
+  std::vector<Constraint<double>> constraints;
+  constraints.emplace_back(Row<double>({1.0, 2.0}, {0, 1}), -LPINT_INFINITY,
+                           4.0);
+  constraints.emplace_back(Row<double>({1.0, -1.0}, {0, 1}), -LPINT_INFINITY,
+                           1.0);
+  gains_lp.add_constraints(constraints);
+  structure =
+      detail::detect_network(detail::make_computational_form(gains_lp));
+  ASSERT_EQ(structure.kind, detail::NetworkKind::Generalized);
+  ASSERT_EQ(gains.solve(), Status::Optimal);
+  ASSERT_FALSE(gains.used_network_simplex());
+}
+
+TEST(NativeSimplex, SolvesNetworkModel) {
+  NativeSimplexSolver solver(OptimizationType::Minimize);
+  add_transportation(solver.linear_program(), {5.0, 7.0}, {4.0, 6.0});
+  ASSERT_EQ(solver.solve(), Status::Optimal);
+  ASSERT_TRUE(solver.used_network_simplex());
+  const auto& solution = solver.get_solution();
+  ASSERT_NEAR(solution.objective_value, 10.0, 1e-12);
+  const std::vector<double> primal = {4.0, 0.0, 0.0, 6.0};
+  const std::vector<double> dual = {0.0, 0.0, 1.0, 1.0};
+  for (std::size_t j = 0; j < primal.size(); j++) {
+    ASSERT_NEAR(solution.primal[j], primal[j], 1e-12);
+  }
+  ASSERT_EQ(solution.dual.size(), dual.size());
+  for (std::size_t i = 0; i < dual.size(); i++) {
+    ASSERT_NEAR(solution.dual[i], dual[i], 1e-12);
+  }
+
+  // the sinks demand more than the sources supply
+  NativeSimplexSolver infeasible(OptimizationType::Minimize);
+  add_transportation(infeasible.linear_program(), {5.0, 7.0}, {4.0, 9.0});
+  ASSERT_EQ(infeasible.solve(), Status::Infeasible);
+  ASSERT_TRUE(infeasible.used_network_simplex());
+}
+
+// property: on random networks with reflected rows, root arcs and free,
+// boxed and ranged bounds, the network simplex finds the same status and
+// optimum as the dual simplex, and its duals are dual feasible
+RC_GTEST_PROP(NativeSimplex, NetworkSimplexMatchesDualSimplex, ()) {
+  const auto nrows = *rc::gen::inRange<std::size_t>(1, 8);
+  const auto narcs = *rc::gen::inRange<std::size_t>(1, 16);
+  const auto capacity = rc::gen::map(
+      rc::gen::inRange(1, 10), [](int v) { return static_cast<double>(v); });
+
+  // arcs leave their tail row and enter their head row; arcs with a single
+  // entry join their row to the root
+  std::vector<std::vector<double>> values(nrows);
+  std::vector<std::vector<int>> indices(nrows);
+  std::vector<Variable> variables;
+  std::vector<double> cost;
+  for (std::size_t j = 0; j < narcs; j++) {
+    const auto column = static_cast<int>(j);
+    const auto tail = *rc::gen::inRange<std::size_t>(0, nrows);
+    const auto head = *rc::gen::inRange<std::size_t>(0, nrows + 1);
+    if (head == tail || head == nrows) {
+      values[tail].push_back(*rc::gen::element(1.0, -1.0));
+      indices[tail].push_back(column);
+    } else {
+      values[tail].push_back(1.0);
+      indices[tail].push_back(column);
+      values[head].push_back(-1.0);
+      indices[head].push_back(column);
+    }
+    const auto cap = *capacity;
+    const auto bounds = *rc::gen::element(
+        std::make_pair(-LPINT_INFINITY, LPINT_INFINITY),
+        std::make_pair(0.0, LPINT_INFINITY), std::make_pair(0.0, cap),
+        std::make_pair(-cap, cap));
+    variables.emplace_back(bounds.first, bounds.second);
+    cost.push_back(static_cast<double>(*rc::gen::inRange(-5, 6)));
+  }
+  std::vector<Constraint<double>> constraints;
+  for (std::size_t i = 0; i < nrows; i++) {
+    const auto b = static_cast<double>(*rc::gen::inRange(-10, 11));
+    const auto width = *capacity;
+    auto bounds = *rc::gen::element(
+        std::make_pair(b, b), std::make_pair(b - width, b),
+        std::make_pair(-LPINT_INFINITY, b), std::make_pair(b, LPINT_INFINITY),
+        std::make_pair(-LPINT_INFINITY, LPINT_INFINITY));
+    // reflect the row
+    if (*rc::gen::arbitrary<bool>()) {
+      for (auto& value : values[i]) {
+        value = -value;
+      }
+      bounds = std::make_pair(-bounds.second, -bounds.first);
+    }
+    constraints.emplace_back(Row<double>(values[i], indices[i]), bounds.first,
+                             bounds.second);
+  }
+
+  LinearProgramHandleNative lp(OptimizationType::Minimize);
+  lp.add_variables(variables);
+  lp.set_objective(Objective<double>(std::vector<double>(cost)));
+  lp.add_constraints(constraints);
+  const auto model = detail::make_computational_form(lp);
+  const auto structure = detail::detect_network(model);
+  RC_ASSERT(structure.kind == detail::NetworkKind::Pure);
+
+  detail::NetworkSimplex network(model, structure);
+  const auto status = network.solve(100000, LPINT_INFINITY);
+  detail::DualSimplex simplex(model);
+  std::vector<detail::BasisStatus> basis(narcs + nrows,
+                                         detail::BasisStatus::AtLower);
+  std::fill(basis.begin() + static_cast<std::ptrdiff_t>(narcs), basis.end(),
+            detail::BasisStatus::Basic);
+  simplex.set_basis(basis);
+  const auto expected_status = simplex.solve(100000, LPINT_INFINITY);
+  RC_ASSERT(status == expected_status);
+  if (status != Status::Optimal) {
+    return;
+  }
+
+  const auto x = network.primal();
+  const auto y = network.dual();
+  double objective = 0.0;
+  double expected = 0.0;
+  for (std::size_t j = 0; j < narcs; j++) {
+    objective += model.cost[j] * x[j];
+    expected += model.cost[j] * simplex.primal()[j];
+  }
+  RC_ASSERT(std::abs(objective - expected) <=
+            1e-9 * (1.0 + std::abs(expected)));
+
+  // reduced costs of the columns of [A -I]; a variable may only be above
+  // its lower bound with a nonpositive reduced cost, and below its upper
+  // bound with a nonnegative one
+  constexpr double tolerance = 1e-9;
+  for (std::size_t j = 0; j < narcs + nrows; j++) {
+    double reduced = 0.0;
+    if (j < narcs) {
+      reduced = model.cost[j];
+      for (auto k = model.column_starts[j]; k < model.column_starts[j + 1];
+           k++) {
+        reduced -= model.values[k] * y[model.row_indices[k]];
+      }
+    } else {
+      reduced = y[j - narcs];
+    }
+    if (x[j] > model.lower[j] + tolerance) {
+      RC_ASSERT(reduced <= tolerance);
+    }
+    if (x[j] < model.upper[j] - tolerance) {
+      RC_ASSERT(reduced >= -tolerance);
+    }
+  }
+}
+
+// property: solving again after changing bounds and adding a constraint
+// gives the same optimum as solving the changed model from scratch
+RC_GTEST_PROP(NativeSimplex, WarmSolveMatchesColdSolve, ()) {
+  const auto coefficient = rc::gen::map(rc::gen::inRange(-20, 21),
+                                        [](int v) { return v / 4.0; });
+  auto nconstr = *rc::gen::inRange<std::size_t>(1, ncols);
+  std::vector<Constraint<double>> constraints;
+  for (std::size_t i = 0; i < nconstr; i++) {
+    constraints.emplace_back(*rc::genRow(ncols, coefficient), -LPINT_INFINITY,
+                             *rc::gen::inRange(0, 10));
+  }
+  const auto objective = *rc::genSizedObjective(ncols, coefficient);
+  const auto changed = *rc::gen::inRange<std::size_t>(0, ncols);
+  const auto new_upper = *rc::gen::inRange(0, 5) / 2.0;
+  const auto cut = *rc::genRow(ncols, coefficient);
+
+  const auto build = [&](NativeSimplexSolver& solver) {
+    auto& lp = solver.linear_program();
+    lp.add_variables(std::vector<Variable>(ncols, Variable(0.0, 4.0)));
+    lp.add_constraints(constraints);
+    lp.set_objective(objective);
+  };
+  const auto change = [&](NativeSimplexSolver& solver) {
+    auto& lp = solver.linear_program();
+    lp.set_variable_bounds(changed, 0.0, new_upper);
+    std::vector<Constraint<double>> added;
+    added.emplace_back(Row<double>(cut.values(), cut.nonzero_indices()),
+                       -LPINT_INFINITY, 1.0);
+    lp.add_constraints(added);
+  };
+
+  NativeSimplexSolver warm(OptimizationType::Maximize);
+  build(warm);
+  RC_ASSERT(warm.solve() == Status::Optimal);
+  change(warm);
+
+  NativeSimplexSolver cold(OptimizationType::Maximize);
+  build(cold);
+  change(cold);
+
+  RC_ASSERT(warm.solve() == Status::Optimal);
+  RC_ASSERT(cold.solve() == Status::Optimal);
+  const auto expected = cold.get_solution().objective_value;
+  RC_ASSERT(std::abs(warm.get_solution().objective_value - expected) <=
+            1e-6 * (1.0 + std::abs(expected)));
+}
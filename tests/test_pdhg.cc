@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include <rapidcheck/gtest.h>
+
+#include <cmath>
+
+#include "lpinterface.hpp"
+#include "lpinterface/native/lpinterface_pdhg.hpp"
+#include "lpinterface/native/lpinterface_simplex.hpp"
+
+#include "generators.hpp"
+#include "testutil.hpp"
+#include "test_common.hpp"
+
+using namespace lpint;
+using namespace testing;
+
+constexpr const std::size_t ncols = 20;
+
+TEST(NativePdhg, AddAndRetrieveObjective) {
+  test_add_retrieve_objective<NativePdhgSolver>(ncols);
+}
+
+TEST(NativePdhg, UnsolvedModelThrowsOnAccess) {
+  test_model_not_solved_acces_throw<NativePdhgSolver>();
+}
+
+TEST(NativePdhg, SupportedParams) {
+  test_supported_params<NativePdhgSolver>(
+    {
+      Param::Threads, Param::TimeLimit, Param::Verbosity,
+      Param::IterationLimit
+    },
+    {
+      Param::ObjectiveSense, Param::Infinity
+    }
+  );
+}
+
+TEST(NativePdhg, ReportsAchievedTolerance) {
+  NativePdhgSolver solver(OptimizationType::Maximize, 1e-8);
+  auto& lp = solver.linear_program();
+  lp.add_variables(3);
+  lp.set_objective(Objective<double>({1, 1, 2}));
+  std::vector<Constraint<double>> constraints;
+  constraints.emplace_back(Row<double>({1, 2, 3}, {0, 1, 2}), -LPINT_INFINITY,
+                           4.0);
+  constraints.emplace_back(Row<double>({1, 1}, {0, 1}), 1.0, LPINT_INFINITY);
+  lp.add_constraints(constraints);
+
+  solver.set_parameter(Param::IterationLimit, 1);
+  ASSERT_EQ(solver.solve(), Status::IterationLimit);
+  ASSERT_GT(solver.achieved_tolerance(), 1e-8);
+
+  solver.set_parameter(Param::IterationLimit, 100000);
+  ASSERT_EQ(solver.solve(), Status::Optimal);
+  ASSERT_LE(solver.achieved_tolerance(), 1e-8);
+  const auto solution = solver.get_solution();
+  ASSERT_NEAR(solution.objective_value, 4.0, 1e-6);
+  ASSERT_NEAR(solution.primal[0], 4.0, 1e-6);
+}
+
+TEST(NativePdhg, DetectsInfeasible) {
+  NativePdhgSolver solver(OptimizationType::Maximize);
+  auto& lp = solver.linear_program();
+  lp.add_variables(std::vector<Variable>(2, Variable(0.0, LPINT_INFINITY)));
+  lp.set_objective(Objective<double>({1.0, 1.0}));
+  std::vector<Constraint<double>> constraints;
+  constraints.emplace_back(Row<double>({1.0, 1.0}, {0, 1}), -LPINT_INFINITY,
+                           -1.0);
+  lp.add_constraints(constraints);
+  ASSERT_EQ(solver.solve(), Status::Infeasible);
+  ASSERT_THROW(solver.get_solution(), ModelNotSolvedException);
+}
+
+TEST(NativePdhg, ObjectiveMatchesSimplex) {
+  test_objective_matches_simplex<NativePdhgSolver>(ncols, ncols, 1e-5, 1e-7);
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <rapidcheck/gtest.h>
+
+#include <cmath>
+
+#include "lpinterface.hpp"
+#include "lpinterface/native/lpinterface_simplex.hpp"
+#include "lpinterface/native/lpinterface_small.hpp"
+
+#include "generators.hpp"
+#include "testutil.hpp"
+#include "test_common.hpp"
+
+using namespace lpint;
+using namespace testing;
+
+constexpr const std::size_t ncols = 6;
+
+using SmallSolver = SmallLpSolver<ncols, 32>;
+
+TEST(SmallLp, AddAndRetrieveObjective) {
+  test_add_retrieve_objective<SmallSolver>(ncols);
+}
+
+TEST(SmallLp, UnsolvedModelThrowsOnAccess) {
+  test_model_not_solved_acces_throw<SmallSolver>();
+}
+
+TEST(SmallLp, SupportedParams) {
+  test_supported_params<SmallSolver>(
+    {
+      Param::Verbosity, Param::IterationLimit
+    },
+    {
+      Param::Threads, Param::TimeLimit, Param::ObjectiveSense, Param::Infinity
+    }
+  );
+}
+
+TEST(SmallLp, FullProblem) { test_full_problem<SmallLpSolver<3>>(); }
+
+TEST(SmallLp, DirectInterface) {
+  SmallLp<2> lp;
+  lp.sense = OptimizationType::Maximize;
+  lp.objective = {{1.0, 1.0}};
+  lp.add_row({{1.0, 2.0}}, -LPINT_INFINITY, 4.0);
+  lp.add_row({{3.0, 1.0}}, -LPINT_INFINITY, 6.0);
+
+  SmallLpSolver<2> solver;
+  ASSERT_EQ(solver.solve(lp), Status::Optimal);
+  ASSERT_NEAR(solver.objective_value(), 2.8, 1e-12);
+  ASSERT_NEAR(solver.primal()[0], 1.6, 1e-12);
+  ASSERT_NEAR(solver.primal()[1], 1.2, 1e-12);
+  ASSERT_NEAR(solver.dual()[0], 0.4, 1e-12);
+  ASSERT_NEAR(solver.dual()[1], 0.2, 1e-12);
+
+  lp.add_row({{1.0, 1.0}}, 3.0, LPINT_INFINITY);
+  ASSERT_EQ(solver.solve(lp), Status::Infeasible);
+
+  lp.num_rows = 1;
+  lp.lower[1] = -LPINT_INFINITY;
+  ASSERT_EQ(solver.solve(lp), Status::Unbounded);
+}
+
+TEST(SmallLp, TooLargeProblemThrows) {
+  SmallLpSolver<2, 1> solver;
+  solver.linear_program().add_variables(3);
+  ASSERT_THROW(solver.solve(), MismatchedDimensionsException);
+
+  SmallLp<2, 1> lp;
+  lp.add_row({{1.0, 1.0}}, 0.0, 1.0);
+  ASSERT_THROW(lp.add_row({{1.0, 1.0}}, 0.0, 1.0),
+               MismatchedDimensionsException);
+}
+
+TEST(SmallLp, ObjectiveMatchesSimplex) {
+  test_objective_matches_simplex<SmallSolver>(ncols, 32, 1e-9);
+}
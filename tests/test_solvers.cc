@@ -1,4 +1,5 @@
 #include "lpinterface.hpp"
+#include "lpinterface/native/lpinterface_simplex.hpp"
 
 #ifdef LPINT_GUROBI_SUPPORTED
 #include "lpinterface/gurobi/lpinterface_gurobi.hpp"
@@ -24,7 +25,37 @@ struct ConstraintProperties {
   template <class Solver>
   static void exec() {
     test_add_retrieve_constraints<Solver>(ncols);
+    test_add_retrieve_constraint_batch<Solver>(ncols);
+    test_add_retrieve_compact_batch<Solver>(ncols);
     test_add_remove_constraints<Solver>(ncols);
+    test_remove_constraints_by_id<Solver>(ncols);
+    test_cached_model_tracks_changes<Solver>(ncols);
+    test_stream_constraints<Solver>(ncols);
+    test_columns_match_rows<Solver>(ncols);
+    test_transaction_rollback<Solver>(ncols);
+    test_staged_changes<Solver>(ncols);
+    test_model_diff<Solver>(ncols);
+  }
+};
+
+struct PresolveProperties {
+  template <class Solver>
+  static void exec() {
+    test_presolve<Solver>(ncols);
+  }
+};
+
+struct ScalingProperties {
+  template <class Solver>
+  static void exec() {
+    test_scaling<Solver>(ncols);
+  }
+};
+
+struct DualizeProperties {
+  template <class Solver>
+  static void exec() {
+    test_dualize<Solver>(ncols);
   }
 };
 
@@ -50,12 +81,21 @@ struct FullProblemTests {
   }
 };
 
+struct ObjectiveProperties {
+  template <class Solver>
+  static void exec() {
+    test_set_sparse_objective<Solver>(ncols);
+  }
+};
+
 struct Variables {
   template <class Solver>
   static void exec() {
     test_num_vars<Solver>();
     test_add_retrieve_vars<Solver>();
+    test_add_retrieve_variable_block<Solver>();
     test_add_remove_vars<Solver>();
+    test_remove_vars_by_id<Solver>();
   }
 };
 
@@ -63,6 +103,18 @@ TEST(Solvers, Constraints) {
   for_each_type<ConstraintProperties, LPINT_SUPPORTED_SOLVERS>();
 }
 
+TEST(Solvers, Presolve) {
+  for_each_type<PresolveProperties, LPINT_SUPPORTED_SOLVERS>();
+}
+
+TEST(Solvers, Scaling) {
+  for_each_type<ScalingProperties, LPINT_SUPPORTED_SOLVERS>();
+}
+
+TEST(Solvers, Dualize) {
+  for_each_type<DualizeProperties, LPINT_SUPPORTED_SOLVERS>();
+}
+
 TEST(Solvers, TimeLimit) {
   for_each_type<TimeLimitProperties, LPINT_SUPPORTED_SOLVERS>();
 }
@@ -75,6 +127,10 @@ TEST(Solvers, FullProblem) {
   for_each_type<FullProblemTests, LPINT_SUPPORTED_SOLVERS>();
 }
 
+TEST(Solvers, Objective) {
+  for_each_type<ObjectiveProperties, LPINT_SUPPORTED_SOLVERS>();
+}
+
 TEST(Solvers, Vars) {
   for_each_type<Variables, LPINT_SUPPORTED_SOLVERS>();
 }
\ No newline at end of file